@@ -386,6 +386,34 @@ protected:
     assets[name] = asset;
   }
 
+  /**
+   * Any function which returns the class of an event, as an index
+   * into the weights passed to `process::ProcessBase::prioritize`.
+   */
+  typedef lambda::function<size_t(const Event&)> EventClassifier;
+
+  /**
+   * Splits the events of this process into classes which are queued
+   * separately and served in a weighted round robin: the class whose
+   * turn it is gets up to `weights[i]` consecutive events served, as
+   * long as it has any queued, before the next class with queued
+   * events takes its turn.
+   *
+   * The `classifier` is invoked by the threads that enqueue the
+   * events, so it must be thread-safe and cheap. Terminate events
+   * are not classified: a terminate which is not injected is still
+   * served after all the events enqueued before it, in every class.
+   *
+   * **NOTE**: Only the events within a class are served in the order
+   * in which they were enqueued. Events that a process relies on
+   * being ordered must therefore be put into the same class.
+   *
+   * MUST be invoked before the process is spawned.
+   */
+  void prioritize(
+      const std::vector<size_t>& weights,
+      const EventClassifier& classifier);
+
   /**
    * Returns the number of events of the given type currently on the
    * event queue. MUST be invoked from within the process itself in
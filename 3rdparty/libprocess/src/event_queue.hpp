@@ -14,13 +14,19 @@
 #define __PROCESS_EVENT_QUEUE_HPP__
 
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <process/event.hpp>
 #include <process/http.hpp>
 
+#include <stout/check.hpp>
 #include <stout/json.hpp>
+#include <stout/lambda.hpp>
+#include <stout/none.hpp>
+#include <stout/option.hpp>
 #include <stout/stringify.hpp>
 #include <stout/synchronized.hpp>
 
@@ -65,10 +71,44 @@ namespace process {
 // this efficiently we require only a single consumer, which fits well
 // into the actor model because there will only ever be a single
 // thread consuming an actors events at a time.
+//
+// Notes on classes of events:
+//
+// By default all events are in a single class and are dequeued in
+// the order in which they were enqueued. After `prioritize()` the
+// events are split into several classes by a classifier, and each
+// class is queued separately. The classes take turns in a weighted
+// round robin: the class whose turn it is gets up to its weight of
+// consecutive events dequeued, as long as it has any queued. Only
+// the events within a class keep their order, with the exception of
+// terminate events: an injected one is put into the first class (and
+// the events before it are purged when it is served, see
+// `ProcessManager::resume()`), while one that is not injected is only
+// dequeued after all the events enqueued before it, in every class.
 class EventQueue
 {
 public:
-  EventQueue() : producer(this), consumer(this) {}
+  EventQueue() : producer(this), consumer(this)
+  {
+    initialize({1}, nullptr);
+  }
+
+  // Splits the queue into `weights.size()` classes of events, see
+  // `ProcessBase::prioritize()`. Must be called before any events are
+  // enqueued.
+  void prioritize(
+      const std::vector<size_t>& weights,
+      const lambda::function<size_t(const Event&)>& classifier)
+  {
+    CHECK(!weights.empty());
+    CHECK(consumer.empty());
+
+    foreach (size_t weight, weights) {
+      CHECK_GT(weight, 0u);
+    }
+
+    initialize(weights, classifier);
+  }
 
   class Producer
   {
@@ -105,137 +145,357 @@ private:
   friend class Producer;
   friend class Consumer;
 
-#ifndef LOCK_FREE_EVENT_QUEUE
+  // Returns the class of the event. Terminate events are not passed
+  // to the classifier, they always belong to the first class.
+  size_t classify(const Event& event) const
+  {
+    if (classifier == nullptr || event.is<TerminateEvent>()) {
+      return 0;
+    }
+
+    const size_t index = classifier(event);
+    CHECK_LT(index, weights.size());
+    return index;
+  }
+
+  // Returns whether the event is a terminate event which was not
+  // injected, i.e., which must be served after all the events that
+  // were enqueued before it.
+  static bool isBarrier(const Event& event)
+  {
+    return event.is<TerminateEvent>() && !event.as<TerminateEvent>().inject;
+  }
+
   void enqueue(Event* event)
   {
-    bool enqueued = false;
-    synchronized (mutex) {
-      if (comissioned) {
-        events.push_back(event);
-        enqueued = true;
+    // A terminate event which is not injected must be served after
+    // all the events enqueued before it, in every class. We enqueue a
+    // copy of it into each of the other classes as a barrier and the
+    // event itself into the first class, see `next()`. The first
+    // class is done last so that all the barriers are enqueued once
+    // the consumer has seen the one in the first class.
+    if (weights.size() > 1 && isBarrier(*event)) {
+      const TerminateEvent& terminate = event->as<TerminateEvent>();
+
+      for (size_t index = weights.size() - 1; index > 0; index--) {
+        enqueue(index, new TerminateEvent(terminate.from, false));
       }
+
+      enqueue(0, event);
+      return;
     }
 
-    if (!enqueued) {
-      delete event;
+    enqueue(classify(*event), event);
+  }
+
+  // Returns the next event to serve, or `nullptr` if there is none.
+  // Only called by the consumer.
+  Event* fetch()
+  {
+    if (pending == nullptr) {
+      pending = next();
     }
+
+    return pending;
   }
 
   Event* dequeue()
   {
-    Event* event = nullptr;
+    // Semantics are the consumer _must_ call `empty()` before calling
+    // `dequeue()` which means an event must be present.
+    Event* event = CHECK_NOTNULL(fetch());
+    pending = nullptr;
+    return event;
+  }
+
+  bool empty()
+  {
+    return fetch() == nullptr;
+  }
 
-    synchronized (mutex) {
-      if (events.size() > 0) {
-        Event* event = events.front();
-        events.pop_front();
+  // Dequeues the next event to serve from the classes, in a weighted
+  // round robin. A class whose barrier has been dequeued is not served
+  // until every class has reached its barrier, at which point the
+  // terminate event is returned.
+  Event* next()
+  {
+    while (true) {
+      Option<size_t> index = select();
+      if (index.isNone()) {
+        return nullptr;
+      }
+
+      served++;
+
+      Event* event = CHECK_NOTNULL(dequeue(index.get()));
+
+      if (weights.size() == 1 || !isBarrier(*event)) {
         return event;
       }
-    }
 
-    // Semantics are the consumer _must_ call `empty()` before calling
-    // `dequeue()` which means an event must be present.
-    return CHECK_NOTNULL(event);
+      barriers[index.get()] = event;
+
+      foreach (Event* barrier, barriers) {
+        if (barrier == nullptr) {
+          event = nullptr;
+          break;
+        }
+      }
+
+      if (event != nullptr) {
+        // Only the event in the first class is served, the others
+        // are copies.
+        event = barriers[0];
+
+        for (size_t i = 1; i < barriers.size(); i++) {
+          delete barriers[i];
+        }
+
+        barriers = std::vector<Event*>(weights.size(), nullptr);
+
+        return event;
+      }
+    }
   }
 
-  bool empty()
+  // Returns the class to dequeue the next event from, or `None()` if
+  // no class has any events available.
+  Option<size_t> select()
   {
-    synchronized (mutex) {
-      return events.size() == 0;
+    auto available = [this](size_t index) {
+      return barriers[index] == nullptr && !empty(index);
+    };
+
+    if (served < weights[current] && available(current)) {
+      return current;
+    }
+
+    for (size_t i = 1; i <= weights.size(); i++) {
+      const size_t index = (current + i) % weights.size();
+      if (available(index)) {
+        current = index;
+        served = 0;
+        return index;
+      }
     }
+
+    return None();
   }
 
   void decomission()
   {
-    synchronized (mutex) {
-      comissioned = false;
-      while (!events.empty()) {
-        Event* event = events.front();
-        events.pop_front();
-        delete event;
-      }
+    drain();
+
+    delete pending;
+    pending = nullptr;
+
+    foreach (Event* barrier, barriers) {
+      delete barrier;
     }
+
+    barriers = std::vector<Event*>(weights.size(), nullptr);
   }
 
   template <typename T>
   size_t count()
   {
-    synchronized (mutex) {
-      return std::count_if(
-          events.begin(),
-          events.end(),
-          [](const Event* event) {
-            return event->is<T>();
-          });
+    // The other classes only hold the copies of the terminate events
+    // which are barriers, so we skip those.
+    size_t count = 0;
+    for_each([&count](size_t index, const Event* event) {
+      if (event->is<T>() && (index == 0 || !event->is<TerminateEvent>())) {
+        count++;
+      }
+    });
+
+    if (pending != nullptr && pending->is<T>()) {
+      count++;
+    }
+
+    if (barriers[0] != nullptr && barriers[0]->is<T>()) {
+      count++;
     }
+
+    return count;
   }
 
   operator JSON::Array()
   {
     JSON::Array array;
+
+    if (pending != nullptr) {
+      array.values.push_back(JSON::Object(*pending));
+    }
+
+    for_each([&array](size_t, const Event* event) {
+      array.values.push_back(JSON::Object(*event));
+    });
+
+    return array;
+  }
+
+  // The weights of the classes of events.
+  std::vector<size_t> weights;
+
+  // Used by producers to determine the class of an event; `nullptr`
+  // if there is only a single class.
+  lambda::function<size_t(const Event&)> classifier;
+
+  // The remaining fields are only accessed by the consumer.
+
+  // The class whose turn it is, and how many consecutive events have
+  // been dequeued from it.
+  size_t current = 0;
+  size_t served = 0;
+
+  // The event to serve next, if it has already been dequeued by a
+  // call to `empty()`.
+  Event* pending = nullptr;
+
+  // The barriers which have been dequeued, one for each class.
+  std::vector<Event*> barriers;
+
+#ifndef LOCK_FREE_EVENT_QUEUE
+  void initialize(
+      const std::vector<size_t>& _weights,
+      const lambda::function<size_t(const Event&)>& _classifier)
+  {
+    synchronized (mutex) {
+      weights = _weights;
+      classifier = _classifier;
+      events = std::vector<std::deque<Event*>>(weights.size());
+      barriers = std::vector<Event*>(weights.size(), nullptr);
+      current = 0;
+      served = 0;
+    }
+  }
+
+  void enqueue(size_t index, Event* event)
+  {
+    bool enqueued = false;
     synchronized (mutex) {
-      foreach (Event* event, events) {
-        array.values.push_back(JSON::Object(*event));
+      if (comissioned) {
+        events[index].push_back(event);
+        enqueued = true;
+      }
+    }
+
+    if (!enqueued) {
+      delete event;
+    }
+  }
+
+  Event* dequeue(size_t index)
+  {
+    synchronized (mutex) {
+      if (events[index].empty()) {
+        return nullptr;
+      }
+
+      Event* event = events[index].front();
+      events[index].pop_front();
+      return event;
+    }
+  }
+
+  bool empty(size_t index)
+  {
+    synchronized (mutex) {
+      return events[index].empty();
+    }
+  }
+
+  // Deletes the queued events and drops any further ones.
+  void drain()
+  {
+    synchronized (mutex) {
+      comissioned = false;
+      foreach (std::deque<Event*>& queue, events) {
+        while (!queue.empty()) {
+          Event* event = queue.front();
+          queue.pop_front();
+          delete event;
+        }
+      }
+    }
+  }
+
+  template <typename F>
+  void for_each(F&& f)
+  {
+    synchronized (mutex) {
+      for (size_t index = 0; index < events.size(); index++) {
+        foreach (const Event* event, events[index]) {
+          f(index, event);
+        }
       }
     }
-    return array;
   }
 
   std::mutex mutex;
-  std::deque<Event*> events;
+
+  // The queued events of each class.
+  std::vector<std::deque<Event*>> events;
+
   bool comissioned = true;
 #else // LOCK_FREE_EVENT_QUEUE
-  void enqueue(Event* event)
+  void initialize(
+      const std::vector<size_t>& _weights,
+      const lambda::function<size_t(const Event&)>& _classifier)
+  {
+    weights = _weights;
+    classifier = _classifier;
+    barriers = std::vector<Event*>(weights.size(), nullptr);
+    current = 0;
+    served = 0;
+
+    queues.clear();
+    for (size_t i = 0; i < weights.size(); i++) {
+      queues.emplace_back(new MpscLinkedQueue<Event>());
+    }
+  }
+
+  void enqueue(size_t index, Event* event)
   {
     if (comissioned.load()) {
-      queue.enqueue(event);
+      queues[index]->enqueue(event);
     } else {
       delete event;
     }
   }
 
-  Event* dequeue()
+  Event* dequeue(size_t index)
   {
-    return queue.dequeue();
+    return queues[index]->dequeue();
   }
 
-  bool empty()
+  bool empty(size_t index)
   {
-    return queue.empty();
+    return queues[index]->empty();
   }
 
-  void decomission()
+  void drain()
   {
     comissioned.store(true);
-    while (!empty()) {
-      delete dequeue();
-    }
-  }
-
-  template <typename T>
-  size_t count()
-  {
-    size_t count = 0;
-    queue.for_each([&count](Event* event) {
-      if (event->is<T>()) {
-        count++;
+    foreach (const std::unique_ptr<MpscLinkedQueue<Event>>& queue, queues) {
+      while (!queue->empty()) {
+        delete queue->dequeue();
       }
-    });
-    return count;
+    }
   }
 
-  operator JSON::Array()
+  template <typename F>
+  void for_each(F&& f)
   {
-    JSON::Array array;
-    queue.for_each([&array](Event* event) {
-      array.values.push_back(JSON::Object(*event));
-    });
-
-    return array;
+    for (size_t index = 0; index < queues.size(); index++) {
+      queues[index]->for_each([&f, index](Event* event) {
+        f(index, event);
+      });
+    }
   }
 
-  // Underlying queue of items.
-  MpscLinkedQueue<Event> queue;
+  // Underlying queues of items, one for each class of events.
+  std::vector<std::unique_ptr<MpscLinkedQueue<Event>>> queues;
 
   // Whether or not the event queue has been decomissioned. This must
   // be atomic as it can be read by a producer even though it's only
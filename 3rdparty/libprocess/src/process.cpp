@@ -3479,6 +3479,18 @@ size_t ProcessBase::eventCount<TerminateEvent>()
 }
 
 
+void ProcessBase::prioritize(
+    const vector<size_t>& weights,
+    const EventClassifier& classifier)
+{
+  CHECK(state.load() == State::BOTTOM)
+    << "Events of process '" << pid << "' must be prioritized before"
+    << " it is spawned";
+
+  events->prioritize(weights, classifier);
+}
+
+
 void ProcessBase::enqueue(Event* event)
 {
   CHECK_NOTNULL(event);
@@ -87,6 +87,7 @@ using process::Owned;
 using process::PID;
 using process::Process;
 using process::ProcessBase;
+using process::Promise;
 using process::run;
 using process::Subprocess;
 using process::TerminateEvent;
@@ -676,6 +677,117 @@ TEST_F(ProcessTest, Order)
 }
 
 
+class PrioritizedProcess : public Process<PrioritizedProcess>
+{
+public:
+  PrioritizedProcess()
+  {
+    // Messages named "high" are in the first class and all other
+    // events in the second one.
+    prioritize({2, 1}, [](const Event& event) -> size_t {
+      if (event.is<MessageEvent>() &&
+          event.as<MessageEvent>().message.name == "high") {
+        return 0;
+      }
+      return 1;
+    });
+  }
+
+  void initialize() override
+  {
+    install("high", &PrioritizedProcess::high);
+    install("low", &PrioritizedProcess::low);
+  }
+
+  // Blocks the process until `unblock` is satisfied, so that events
+  // can be queued up in the meantime.
+  void block(const Future<Nothing>& unblock)
+  {
+    blocked.set(Nothing());
+    unblock.await();
+  }
+
+  void high(const UPID&, const string&) { serve("high"); }
+  void low(const UPID&, const string&) { serve("low"); }
+
+  Promise<Nothing> blocked;
+  Promise<Nothing> done;
+  vector<string> served;
+
+private:
+  void serve(const string& name)
+  {
+    served.push_back(name);
+    if (served.size() == 6) {
+      done.set(Nothing());
+    }
+  }
+};
+
+
+// Tests that the classes of events of a process are served in a
+// weighted round robin, and in order within a class.
+TEST_F(ProcessTest, Prioritize)
+{
+  PrioritizedProcess process;
+  PID<PrioritizedProcess> pid = spawn(process);
+
+  Promise<Nothing> unblock;
+  dispatch(pid, &PrioritizedProcess::block, unblock.future());
+
+  AWAIT_READY(process.blocked.future());
+
+  post(pid, "low");
+  post(pid, "low");
+  post(pid, "low");
+  post(pid, "high");
+  post(pid, "high");
+  post(pid, "high");
+
+  unblock.set(Nothing());
+
+  AWAIT_READY(process.done.future());
+
+  // The blocking dispatch was the turn of the second class, so the
+  // first class gets its two events served before the classes take
+  // turns again.
+  EXPECT_EQ(
+      vector<string>({"high", "high", "low", "high", "low", "low"}),
+      process.served);
+
+  terminate(pid);
+  wait(pid);
+}
+
+
+// Tests that a terminate which is not injected is served after all
+// the events of a prioritized process that were enqueued before it,
+// in every class, and before the events enqueued after it.
+TEST_F(ProcessTest, PrioritizeTerminate)
+{
+  PrioritizedProcess process;
+  PID<PrioritizedProcess> pid = spawn(process);
+
+  Promise<Nothing> unblock;
+  dispatch(pid, &PrioritizedProcess::block, unblock.future());
+
+  AWAIT_READY(process.blocked.future());
+
+  post(pid, "high");
+  post(pid, "low");
+  post(pid, "low");
+  terminate(pid, false);
+  post(pid, "high");
+  post(pid, "low");
+
+  unblock.set(Nothing());
+
+  wait(pid);
+
+  EXPECT_EQ(vector<string>({"high", "low", "low"}), process.served);
+}
+
+
 class DonateProcess : public Process<DonateProcess>
 {
 public:
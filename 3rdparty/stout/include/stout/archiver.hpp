@@ -20,6 +20,11 @@
 #include <archive.h>
 #include <archive_entry.h>
 
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <stout/error.hpp>
 #include <stout/nothing.hpp>
 #include <stout/path.hpp>
 #include <stout/try.hpp>
@@ -37,10 +42,13 @@ namespace archiver {
 //   ARCHIVE_EXTRACT_FFLAGS
 //   ARCHIVE_EXTRACT_PERM
 //   ARCHIVE_EXTRACT_TIME
+// If a filter is specified, it is called with every entry before the
+// entry is extracted, and the extraction fails if the filter fails.
 inline Try<Nothing> extract(
   const std::string& source,
   const std::string& destination,
-  const int flags = ARCHIVE_EXTRACT_TIME)
+  const int flags = ARCHIVE_EXTRACT_TIME,
+  const std::function<Try<Nothing>(struct archive_entry*)>& filter = nullptr)
 {
   // Get references to libarchive for reading/handling a compressed file.
   std::unique_ptr<struct archive, std::function<void(struct archive*)>> reader(
@@ -113,6 +121,13 @@ inline Try<Nothing> extract(
           archive_error_string(reader.get()));
     }
 
+    if (filter) {
+      Try<Nothing> filtered = filter(entry);
+      if (filtered.isError()) {
+        return Error(filtered.error());
+      }
+    }
+
     // If a destination path is specified, update the entry to reflect it.
     // We assume the destination directory already exists.
     if (!destination.empty()) {
@@ -85,6 +85,52 @@ TEST_F(ArchiverTest, ExtractTarGzFile)
 }
 
 
+
+// The filter is called with every entry before it is extracted, and
+// the extraction fails without extracting the entry if the filter
+// fails.
+TEST_F(ArchiverTest, ExtractWithFilter)
+{
+  string dir = path::join(sandbox.get(), "somedir");
+  ASSERT_SOME(os::mkdir(dir));
+
+  Try<string> path = os::mktemp(path::join(dir, "XXXXXX"));
+  ASSERT_SOME(path);
+
+  // Same contents as the hello.tar.gz file above.
+  ASSERT_SOME(os::write(path.get(), base64::decode(
+      "H4sICE61jVoAA2hlbGxvLnRhcgDtzjEOwjAQRNGtOcXSU9hx7FyBa0RgK0IR"
+      "RsYIcfsEaGhQqggh/VfsFLPFDHEcs6zLzEJon2k7bz7zrQliXdM6Nx/vxVgb"
+      "uiBqVt71crvWvqjKKaZ0yOnr31L/p/b5fnxoHWKJO730pZ5j2W5+vQoAAAAA"
+      "AAAAAAAAAAAAsGQC2DPIjgAoAAA=").get()));
+
+  string extractedFile = path::join(sandbox.get(), "hello");
+
+  EXPECT_ERROR(archiver::extract(
+      path.get(),
+      "",
+      ARCHIVE_EXTRACT_TIME,
+      [](struct archive_entry* entry) -> Try<Nothing> {
+        return Error(archive_entry_pathname_utf8(entry));
+      }));
+
+  EXPECT_FALSE(os::exists(extractedFile));
+
+  string pathname;
+
+  EXPECT_SOME(archiver::extract(
+      path.get(),
+      "",
+      ARCHIVE_EXTRACT_TIME,
+      [&pathname](struct archive_entry* entry) -> Try<Nothing> {
+        pathname = archive_entry_pathname_utf8(entry);
+        return Nothing();
+      }));
+
+  EXPECT_EQ("hello", pathname);
+  ASSERT_SOME_EQ("Howdy there, partner!\n", os::read(extractedFile));
+}
+
 TEST_F(ArchiverTest, ExtractTarFile)
 {
   // Construct a hello.tar file that can be extracted.
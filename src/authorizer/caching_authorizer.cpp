@@ -0,0 +1,86 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "authorizer/caching_authorizer.hpp"
+
+#include <process/clock.hpp>
+
+#include <stout/check.hpp>
+#include <stout/stringify.hpp>
+#include <stout/synchronized.hpp>
+
+using std::string;
+
+using process::Clock;
+using process::Future;
+using process::Owned;
+using process::Time;
+
+namespace mesos {
+namespace internal {
+
+CachingAuthorizer::CachingAuthorizer(
+    Authorizer* _authorizer,
+    const Duration& _ttl,
+    size_t capacity)
+  : authorizer(CHECK_NOTNULL(_authorizer)),
+    ttl(_ttl),
+    cache(capacity) {}
+
+
+Future<bool> CachingAuthorizer::authorized(
+    const authorization::Request& request)
+{
+  return authorizer->authorized(request);
+}
+
+
+Future<Owned<ObjectApprover>> CachingAuthorizer::getObjectApprover(
+    const Option<authorization::Subject>& subject,
+    const authorization::Action& action)
+{
+  const string key = stringify(static_cast<int>(action)) +
+    (subject.isSome() ? "/" + subject->SerializeAsString() : "");
+
+  const Time now = Clock::now();
+
+  synchronized (mutex) {
+    Option<Entry> entry = cache.get(key);
+
+    // Failed approvers are not reused, so that they are retried.
+    if (entry.isSome() &&
+        entry->expiry > now &&
+        !entry->approver.isFailed() &&
+        !entry->approver.isDiscarded()) {
+      // The approver is shared, so one caller must not be able to
+      // discard it for the others.
+      return undiscardable(entry->approver);
+    }
+  }
+
+  // We do not hold the lock while calling into the authorizer.
+  Future<Owned<ObjectApprover>> approver =
+    authorizer->getObjectApprover(subject, action);
+
+  synchronized (mutex) {
+    cache.put(key, Entry{approver, now + ttl});
+  }
+
+  return undiscardable(approver);
+}
+
+} // namespace internal {
+} // namespace mesos {
@@ -0,0 +1,84 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __AUTHORIZER_CACHING_AUTHORIZER_HPP__
+#define __AUTHORIZER_CACHING_AUTHORIZER_HPP__
+
+#include <mutex>
+#include <string>
+
+#include <mesos/authorizer/authorizer.hpp>
+
+#include <process/future.hpp>
+#include <process/owned.hpp>
+#include <process/time.hpp>
+
+#include <stout/cache.hpp>
+#include <stout/duration.hpp>
+#include <stout/option.hpp>
+
+namespace mesos {
+namespace internal {
+
+// An authorizer which caches the object approvers of another
+// authorizer per subject and action, so that the approvers can be
+// shared across requests instead of being created for every request.
+//
+// Cached approvers expire after `ttl`, which bounds how long changes
+// in the decisions of the underlying authorizer (e.g. of a module
+// which reloads its policies) take to be observed. A new cache must be
+// created if the underlying authorizer is replaced.
+//
+// NOTE: Requests which are authorized directly through `authorized()`
+// are forwarded to the underlying authorizer.
+class CachingAuthorizer : public Authorizer
+{
+public:
+  CachingAuthorizer(
+      Authorizer* authorizer,
+      const Duration& ttl,
+      size_t capacity);
+
+  ~CachingAuthorizer() override {}
+
+  process::Future<bool> authorized(
+      const authorization::Request& request) override;
+
+  process::Future<process::Owned<ObjectApprover>> getObjectApprover(
+      const Option<authorization::Subject>& subject,
+      const authorization::Action& action) override;
+
+private:
+  CachingAuthorizer(const CachingAuthorizer&) = delete;
+  CachingAuthorizer& operator=(const CachingAuthorizer&) = delete;
+
+  struct Entry
+  {
+    process::Future<process::Owned<ObjectApprover>> approver;
+    process::Time expiry;
+  };
+
+  Authorizer* authorizer;
+  const Duration ttl;
+
+  std::mutex mutex;
+  Cache<std::string, Entry> cache;
+};
+
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __AUTHORIZER_CACHING_AUTHORIZER_HPP__
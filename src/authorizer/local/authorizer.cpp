@@ -16,6 +16,7 @@
 
 #include "authorizer/local/authorizer.hpp"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -30,6 +31,7 @@
 #include <process/protobuf.hpp>
 
 #include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
 #include <stout/none.hpp>
 #include <stout/option.hpp>
 #include <stout/path.hpp>
@@ -43,6 +45,8 @@
 #include "common/parse.hpp"
 #include "common/protobuf_utils.hpp"
 
+using std::pair;
+using std::shared_ptr;
 using std::string;
 using std::vector;
 
@@ -170,11 +174,153 @@ static bool allows(const ACL::Entity& request, const ACL::Entity& acl)
 }
 
 
+// The ACLs of a single action, compiled into indexes on the values of
+// their subjects and objects. This allows finding the ACLs which may
+// match a request without comparing the request against every ACL.
+//
+// ACLs with ANY or NONE subjects (objects) can match a request with
+// any subject (object) and cannot be looked up by value, so they are
+// always considered. This is also the case for recursive role ACLs,
+// whose objects match by prefix (see `LocalHierarchicalRoleApprover`).
+//
+// NOTE: Only the candidate ACLs are found using the indexes; they are
+// visited in their original order, so that the first matching ACL
+// still decides a request.
+class CompiledACLs
+{
+public:
+  explicit CompiledACLs(const vector<GenericACL>& _acls)
+    : acls(_acls)
+  {
+    for (size_t i = 0; i < acls.size(); i++) {
+      subjects.add(i, acls[i].subjects);
+      objects.add(i, acls[i].objects);
+    }
+  }
+
+  // Visits the ACLs which may match the given subject and object, in
+  // order, until `f` returns a decision. Returns None if no ACL yields
+  // a decision.
+  template <typename F>
+  Option<bool> find(
+      const ACL::Entity& subject,
+      const ACL::Entity& object,
+      const F& f) const
+  {
+    // We visit the candidates of whichever of the subject or object is
+    // more selective. They are the union of two disjoint ordered lists
+    // which we merge while visiting them.
+    pair<const vector<size_t>*, const vector<size_t>*> candidates =
+      subjects.candidates(subject);
+
+    pair<const vector<size_t>*, const vector<size_t>*> objectCandidates =
+      objects.candidates(object);
+
+    if (objectCandidates.first->size() + objectCandidates.second->size() <
+        candidates.first->size() + candidates.second->size()) {
+      candidates = objectCandidates;
+    }
+
+    const vector<size_t>& first = *candidates.first;
+    const vector<size_t>& second = *candidates.second;
+
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < first.size() || j < second.size()) {
+      size_t acl;
+      if (j == second.size() || (i < first.size() && first[i] < second[j])) {
+        acl = first[i++];
+      } else {
+        acl = second[j++];
+      }
+
+      Option<bool> decision = f(acls[acl]);
+      if (decision.isSome()) {
+        return decision;
+      }
+    }
+
+    return None();
+  }
+
+private:
+  // Maps the values of one of the entities of the ACLs to the
+  // (ordered) indices of the ACLs with those values.
+  class Index
+  {
+  public:
+    void add(size_t acl, const ACL::Entity& entity)
+    {
+      all.push_back(acl);
+
+      if (entity.type() != ACL::Entity::SOME || recursive(entity)) {
+        wildcards.push_back(acl);
+        return;
+      }
+
+      foreach (const string& value, entity.values()) {
+        vector<size_t>& acls = values[value];
+
+        // The same value could be listed twice.
+        if (acls.empty() || acls.back() != acl) {
+          acls.push_back(acl);
+        }
+      }
+    }
+
+    // Returns the ACLs whose entity may match the given entity of a
+    // request, as two disjoint ordered lists.
+    pair<const vector<size_t>*, const vector<size_t>*> candidates(
+        const ACL::Entity& request) const
+    {
+      // A request with SOME values only matches ACLs which contain all
+      // of them, so it suffices to look up the first value. Note that
+      // a request without any values matches every ACL.
+      if (request.type() == ACL::Entity::SOME) {
+        if (request.values().empty()) {
+          return {&all, &none};
+        }
+
+        auto iterator = values.find(request.values(0));
+        if (iterator != values.end()) {
+          return {&iterator->second, &wildcards};
+        }
+      }
+
+      // Requests with ANY or NONE only match ACLs with ANY or NONE.
+      return {&none, &wildcards};
+    }
+
+  private:
+    static bool recursive(const ACL::Entity& entity)
+    {
+      foreach (const string& value, entity.values()) {
+        if (strings::endsWith(value, "/%")) {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    hashmap<string, vector<size_t>> values;
+    vector<size_t> wildcards;
+    vector<size_t> all;
+    const vector<size_t> none;
+  };
+
+  const vector<GenericACL> acls;
+  Index subjects;
+  Index objects;
+};
+
+
 class LocalAuthorizerObjectApprover : public ObjectApprover
 {
 public:
   LocalAuthorizerObjectApprover(
-      const vector<GenericACL>& acls,
+      const shared_ptr<const CompiledACLs>& acls,
       const Option<authorization::Subject>& subject,
       const authorization::Action& action,
       bool permissive)
@@ -440,26 +586,31 @@ public:
       }
     }
 
-    return approved(acls_, aclSubject, aclObject);
+    return approved(*acls_, aclSubject, aclObject);
   }
 
 private:
   bool approved(
-      const vector<GenericACL>& acls,
+      const CompiledACLs& acls,
       const ACL::Entity& subject,
       const ACL::Entity& object) const
   {
     // Authorize subject/object.
-    foreach (const GenericACL& acl, acls) {
-      if (matches(subject, acl.subjects) && matches(object, acl.objects)) {
-        return allows(subject, acl.subjects) && allows(object, acl.objects);
-      }
-    }
+    Option<bool> decision = acls.find(
+        subject,
+        object,
+        [&](const GenericACL& acl) -> Option<bool> {
+          if (matches(subject, acl.subjects) && matches(object, acl.objects)) {
+            return allows(subject, acl.subjects) && allows(object, acl.objects);
+          }
+
+          return None();
+        });
 
-    return permissive_; // None of the ACLs match.
+    return decision.getOrElse(permissive_); // None of the ACLs match.
   }
 
-  const vector<GenericACL> acls_;
+  const shared_ptr<const CompiledACLs> acls_;
   const Option<authorization::Subject> subject_;
   const authorization::Action action_;
   const bool permissive_;
@@ -470,8 +621,8 @@ class LocalNestedContainerObjectApprover : public ObjectApprover
 {
 public:
   LocalNestedContainerObjectApprover(
-      const vector<GenericACL>& userAcls,
-      const vector<GenericACL>& parentAcls,
+      const shared_ptr<const CompiledACLs>& userAcls,
+      const shared_ptr<const CompiledACLs>& parentAcls,
       const Option<authorization::Subject>& subject,
       const authorization::Action& action,
       bool permissive)
@@ -578,7 +729,7 @@ class LocalHierarchicalRoleApprover : public ObjectApprover
 {
 public:
   LocalHierarchicalRoleApprover(
-      const vector<GenericACL>& acls,
+      const shared_ptr<const CompiledACLs>& acls,
       const Option<authorization::Subject>& subject,
       const authorization::Action& action,
       bool permissive)
@@ -693,7 +844,7 @@ public:
           // The framework needs to be allowed to register under
           // all the roles it requests.
           foreach (const ACL::Entity& entity, objects) {
-            if (!approved(acls_, entitySubject_, entity)) {
+            if (!approved(*acls_, entitySubject_, entity)) {
               return false;
             }
           }
@@ -745,12 +896,12 @@ public:
         entityObject.type() == ACL::Entity::ANY ||
         entityObject.values_size() == 1);
 
-    return approved(acls_, entitySubject_, entityObject);
+    return approved(*acls_, entitySubject_, entityObject);
   }
 
 private:
   bool approved(
-      const vector<GenericACL>& acls,
+      const CompiledACLs& acls,
       const ACL::Entity& subject,
       const ACL::Entity& object) const
   {
@@ -760,23 +911,30 @@ private:
     ACL::Entity aclAny;
     aclAny.set_type(ACL::Entity::ANY);
 
-    foreach (const GenericACL& acl, acls) {
-      if (!isRecursiveACL(acl)) {
-        // If `acl` is not recursive, treat it as a normal acl.
-        if (matches(subject, acl.subjects) && matches(object, acl.objects)) {
-          return allows(subject, acl.subjects) && allows(object, acl.objects);
-        }
-      } else if (object.type() == ACL::Entity::SOME &&
-          isNestedHierarchy(acl.objects.values(0), object.values(0))) {
-        // Partial validation was done when verifying that the object is
-        // a nested hierarchy.
-        if (matches(subject, acl.subjects) && matches(object, aclAny)) {
-          return allows(subject, acl.subjects) && allows(object, aclAny);
-        }
-      }
-    }
+    Option<bool> decision = acls.find(
+        subject,
+        object,
+        [&](const GenericACL& acl) -> Option<bool> {
+          if (!isRecursiveACL(acl)) {
+            // If `acl` is not recursive, treat it as a normal acl.
+            if (matches(subject, acl.subjects) &&
+                matches(object, acl.objects)) {
+              return allows(subject, acl.subjects) &&
+                     allows(object, acl.objects);
+            }
+          } else if (object.type() == ACL::Entity::SOME &&
+              isNestedHierarchy(acl.objects.values(0), object.values(0))) {
+            // Partial validation was done when verifying that the object
+            // is a nested hierarchy.
+            if (matches(subject, acl.subjects) && matches(object, aclAny)) {
+              return allows(subject, acl.subjects) && allows(object, aclAny);
+            }
+          }
 
-    return permissive_;
+          return None();
+        });
+
+    return decision.getOrElse(permissive_);
   }
 
   static bool isRecursiveACL(const GenericACL& acl)
@@ -795,7 +953,7 @@ private:
     return strings::startsWith(child, parent.substr(0, parent.size() - 1));
   }
 
-  vector<GenericACL> acls_;
+  shared_ptr<const CompiledACLs> acls_;
   Option<authorization::Subject> subject_;
   authorization::Action action_;
   bool permissive_;
@@ -809,6 +967,20 @@ public:
   LocalAuthorizerProcess(const ACLs& _acls)
     : ProcessBase(process::ID::generate("local-authorizer")), acls(_acls) {}
 
+  void initialize() override
+  {
+    // Compile the ACLs of all actions upfront, so that the first
+    // requests for each action do not have to wait for it.
+    const google::protobuf::EnumDescriptor* descriptor =
+      authorization::Action_descriptor();
+
+    for (int i = 0; i < descriptor->value_count(); i++) {
+      getObjectApprover(
+          None(),
+          static_cast<authorization::Action>(descriptor->value(i)->number()));
+    }
+  }
+
   Future<bool> authorized(const authorization::Request& request)
   {
     Option<authorization::Subject> subject;
@@ -879,9 +1051,9 @@ public:
     return acls;
   }
 
-  Future<Owned<ObjectApprover>> getHierarchicalRoleApprover(
-      const Option<authorization::Subject>& subject,
-      const authorization::Action& action) const
+  static vector<GenericACL> createHierarchicalRoleACLs(
+      const authorization::Action& action,
+      const ACLs& acls)
   {
     vector<GenericACL> hierarchicalRoleACLs;
     switch (action) {
@@ -985,14 +1157,30 @@ public:
         UNREACHABLE();
     }
 
+    return hierarchicalRoleACLs;
+  }
+
+  Future<Owned<ObjectApprover>> getHierarchicalRoleApprover(
+      const Option<authorization::Subject>& subject,
+      const authorization::Action& action)
+  {
+    if (!compiledACLs.contains(action)) {
+      compiledACLs[action] = std::make_shared<const CompiledACLs>(
+          createHierarchicalRoleACLs(action, acls));
+    }
+
     return Owned<ObjectApprover>(
         new LocalHierarchicalRoleApprover(
-            hierarchicalRoleACLs, subject, action, acls.permissive()));
+            compiledACLs.at(action), subject, action, acls.permissive()));
   }
 
-  Future<Owned<ObjectApprover>> getNestedContainerObjectApprover(
-      const Option<authorization::Subject>& subject,
-      const authorization::Action& action) const
+  // Returns the ACLs for running a nested container (session) as a
+  // given user, and the ACLs for running it under a parent container
+  // running as a given user.
+  static pair<vector<GenericACL>, vector<GenericACL>>
+  createNestedContainerACLs(
+      const authorization::Action& action,
+      const ACLs& acls)
   {
     CHECK(action == authorization::LAUNCH_NESTED_CONTAINER ||
           action == authorization::LAUNCH_NESTED_CONTAINER_SESSION);
@@ -1039,9 +1227,29 @@ public:
       }
     }
 
+    return {runAsUserAcls, parentRunningAsUserAcls};
+  }
+
+  Future<Owned<ObjectApprover>> getNestedContainerObjectApprover(
+      const Option<authorization::Subject>& subject,
+      const authorization::Action& action)
+  {
+    CHECK(action == authorization::LAUNCH_NESTED_CONTAINER ||
+          action == authorization::LAUNCH_NESTED_CONTAINER_SESSION);
+
+    if (!compiledACLs.contains(action)) {
+      pair<vector<GenericACL>, vector<GenericACL>> nestedContainerACLs =
+        createNestedContainerACLs(action, acls);
+
+      compiledACLs[action] =
+        std::make_shared<const CompiledACLs>(nestedContainerACLs.first);
+      compiledParentACLs[action] =
+        std::make_shared<const CompiledACLs>(nestedContainerACLs.second);
+    }
+
     return Owned<ObjectApprover>(new LocalNestedContainerObjectApprover(
-        runAsUserAcls,
-        parentRunningAsUserAcls,
+        compiledACLs.at(action),
+        compiledParentACLs.at(action),
         subject,
         action,
         acls.permissive()));
@@ -1205,19 +1413,24 @@ public:
       case authorization::MARK_RESOURCE_PROVIDER_GONE:
       case authorization::VIEW_RESOURCE_PROVIDER:
       case authorization::UNKNOWN: {
-        Result<vector<GenericACL>> genericACLs =
-          createGenericACLs(action, acls);
-        if (genericACLs.isError()) {
-          return Failure(genericACLs.error());
-        }
-        if (genericACLs.isNone()) {
-          // If we could not create acls, we deny all objects.
-          return Owned<ObjectApprover>(new RejectingObjectApprover());
+        if (!compiledACLs.contains(action)) {
+          Result<vector<GenericACL>> genericACLs =
+            createGenericACLs(action, acls);
+          if (genericACLs.isError()) {
+            return Failure(genericACLs.error());
+          }
+          if (genericACLs.isNone()) {
+            // If we could not create acls, we deny all objects.
+            return Owned<ObjectApprover>(new RejectingObjectApprover());
+          }
+
+          compiledACLs[action] =
+            std::make_shared<const CompiledACLs>(genericACLs.get());
         }
 
         return Owned<ObjectApprover>(
             new LocalAuthorizerObjectApprover(
-                genericACLs.get(), subject, action, acls.permissive()));
+                compiledACLs.at(action), subject, action, acls.permissive()));
       }
     }
 
@@ -1616,6 +1829,13 @@ private:
   }
 
   ACLs acls;
+
+  // The compiled ACLs of each action, which are shared by all the
+  // approvers for that action since the ACLs never change. For nested
+  // containers, the ACLs for the parent container are kept separately.
+  hashmap<authorization::Action, shared_ptr<const CompiledACLs>> compiledACLs;
+  hashmap<authorization::Action, shared_ptr<const CompiledACLs>>
+    compiledParentACLs;
 };
 
 
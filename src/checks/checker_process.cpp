@@ -16,6 +16,7 @@
 
 #include "checks/checker_process.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -35,7 +36,9 @@
 #include <process/delay.hpp>
 #include <process/future.hpp>
 #include <process/io.hpp>
+#include <process/loop.hpp>
 #include <process/protobuf.hpp>
+#include <process/socket.hpp>
 #include <process/subprocess.hpp>
 #include <process/time.hpp>
 
@@ -43,6 +46,7 @@
 #include <stout/duration.hpp>
 #include <stout/error.hpp>
 #include <stout/foreach.hpp>
+#include <stout/ip.hpp>
 #include <stout/jsonify.hpp>
 #include <stout/nothing.hpp>
 #include <stout/option.hpp>
@@ -56,6 +60,7 @@
 
 #include <stout/os/environment.hpp>
 #include <stout/os/killtree.hpp>
+#include <stout/os/socket.hpp>
 
 #include "checks/checks_runtime.hpp"
 #include "checks/checks_types.hpp"
@@ -73,11 +78,18 @@
 namespace http = process::http;
 
 using process::Failure;
+using process::Break;
+using process::Continue;
+using process::ControlFlow;
 using process::Future;
 using process::Owned;
 using process::Promise;
 using process::Subprocess;
 
+using process::network::inet::Socket;
+
+using process::network::internal::SocketImpl;
+
 using std::map;
 using std::shared_ptr;
 using std::string;
@@ -96,6 +108,12 @@ constexpr char HTTP_CHECK_COMMAND[] = "curl.exe";
 constexpr char TCP_CHECK_COMMAND[] = "mesos-tcp-connect.exe";
 #endif // __WINDOWS__
 
+#ifndef __WINDOWS__
+// Upper bound on the size of the status line of an HTTP response read
+// by in-process HTTP checks, e.g., "HTTP/1.1 200 OK\r\n".
+constexpr size_t MAX_HTTP_STATUS_LINE_SIZE = 1024;
+#endif // __WINDOWS__
+
 
 #ifdef __linux__
 // TODO(alexr): Instead of defining this ad-hoc clone function, provide a
@@ -308,11 +326,17 @@ void CheckerProcess::performCheck()
   //
   // Explanations:
   // - A, B, C: Standard check launched directly by the library's user, i.e.,
-  //   the executor. Specifically, it launches the given command for CMD checks,
-  //   `curl` for HTTP checks, and `mesos-tcp-connect` for TCP checks.
+  //   the executor. Specifically, it launches the given command for CMD checks.
+  //   On POSIX systems, HTTP and TCP checks are performed in-process over
+  //   libprocess sockets; `curl` is only launched for HTTPS checks and to
+  //   follow redirects. On Windows, it launches `curl` for HTTP checks and
+  //   `mesos-tcp-connect` for TCP checks.
   // - A*, B*, C*: On Linux, the proper namespaces will be entered, which are
   //   the optional "mnt" for CMD and the required "net" for Docker HTTP/TCP.
   //   These checks are executed by the library's user, i.e., the executor.
+  //   For in-process HTTP/TCP checks, only the socket is created in the "net"
+  //   namespace of the task by a long-lived helper thread, see
+  //   `CheckerProcess::socket()`.
   // - D: Delegate the command to Docker by wrapping the command with
   //   `docker exec` to run in the container's namespaces.
   // - E, F: On Windows, delegate the network checks to Docker by wrapping the
@@ -1027,10 +1051,218 @@ Future<int> CheckerProcess::httpCheck(
   const string url =
     http.scheme + "://" + http.domain + ":" + stringify(http.port) + http.path;
 
-  return _httpCheck(httpCheckCommand(HTTP_CHECK_COMMAND, url), plain);
+  const vector<string> argv = httpCheckCommand(HTTP_CHECK_COMMAND, url);
+
+#ifndef __WINDOWS__
+  // Plain HTTP checks are performed in-process to avoid forking a `curl`
+  // process for every check. We still rely on `curl` for HTTPS and to
+  // follow redirects, which health endpoints rarely respond with.
+  if (http.scheme == "http" &&
+      (http.path.empty() || strings::startsWith(http.path, "/"))) {
+    return inProcessHttpCheck(http, plain)
+      .then(defer(self(), [=](int statusCode) -> Future<int> {
+        if (statusCode >= 300 && statusCode < 400) {
+          VLOG(1) << name << " for task '" << taskId << "' was redirected"
+                  << " (" << statusCode << "), retrying with "
+                  << HTTP_CHECK_COMMAND;
+
+          return _httpCheck(argv, plain);
+        }
+
+        return statusCode;
+      }));
+  }
+#endif // __WINDOWS__
+
+  return _httpCheck(argv, plain);
+}
+
+
+#ifndef __WINDOWS__
+// Reads the status line of an HTTP response from the socket and returns
+// the status code of the response. The rest of the response is ignored.
+static Future<int> readHttpStatusCode(Socket socket)
+{
+  const size_t size = MAX_HTTP_STATUS_LINE_SIZE;
+
+  shared_ptr<char> data(new char[size], std::default_delete<char[]>());
+  shared_ptr<string> buffer(new string());
+
+  return process::loop(
+      [=]() mutable {
+        return socket.recv(data.get(), size);
+      },
+      [=](size_t length) -> Future<ControlFlow<int>> {
+        if (length == 0) {
+          return Failure("Connection closed before receiving a response");
+        }
+
+        buffer->append(data.get(), length);
+
+        const size_t end = buffer->find("\r\n");
+        if (end == string::npos) {
+          if (buffer->size() > MAX_HTTP_STATUS_LINE_SIZE) {
+            return Failure("Status line of the response is too long");
+          }
+
+          return Continue();
+        }
+
+        // The status line looks like "HTTP/1.1 200 OK".
+        const string line = buffer->substr(0, end);
+        const vector<string> tokens = strings::tokenize(line, " ");
+
+        if (tokens.size() < 2 || !strings::startsWith(tokens[0], "HTTP/")) {
+          return Failure("Malformed status line '" + line + "'");
+        }
+
+        Try<int> statusCode = numify<int>(tokens[1]);
+        if (statusCode.isError()) {
+          return Failure(
+              "Malformed status code in status line '" + line + "': " +
+              statusCode.error());
+        }
+
+        return Break(statusCode.get());
+      });
+}
+
+
+Future<int> CheckerProcess::inProcessHttpCheck(
+    const check::Http& http,
+    const Option<runtime::Plain>& plain)
+{
+  const string path = http.path.empty() ? "/" : http.path;
+
+  VLOG(1) << "Sending 'GET " << path << "' to " << http.domain << ":"
+          << http.port << " for " << name << " of task '" << taskId << "'";
+
+  const string request =
+    "GET " + path + " HTTP/1.1\r\n"
+    "Host: " + http.domain + ":" + stringify(http.port) + "\r\n"
+    "Accept: */*\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+  const Duration timeout = checkTimeout;
+
+  return connect(http.domain, http.port, plain)
+    .then([request](Socket socket) {
+      return socket.send(request)
+        .then([socket]() {
+          return readHttpStatusCode(socket);
+        });
+    })
+    .after(timeout, [timeout](Future<int> future) {
+      future.discard();
+
+      return Failure("HTTP request timed out after " + stringify(timeout));
+    });
+}
+
+
+// Creates a nonblocking TCP socket of the given address family.
+static Try<int_fd> createSocket(int family)
+{
+#if defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
+  return net::socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+#else
+  Try<int_fd> s = net::socket(family, SOCK_STREAM, 0);
+  if (s.isError()) {
+    return Error(s.error());
+  }
+
+  Try<Nothing> nonblock = os::nonblock(s.get());
+  if (nonblock.isError()) {
+    os::close(s.get());
+    return Error("Failed to set O_NONBLOCK: " + nonblock.error());
+  }
+
+  Try<Nothing> cloexec = os::cloexec(s.get());
+  if (cloexec.isError()) {
+    os::close(s.get());
+    return Error("Failed to set FD_CLOEXEC: " + cloexec.error());
+  }
+
+  return s;
+#endif // defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
+}
+
+
+Future<int_fd> CheckerProcess::socket(
+    int family,
+    const Option<runtime::Plain>& plain)
+{
+#ifdef __linux__
+  if (plain.isSome() &&
+      plain->taskPid.isSome() &&
+      std::find(plain->namespaces.begin(), plain->namespaces.end(), "net") !=
+        plain->namespaces.end()) {
+    // A socket belongs to the network namespace it was created in, hence
+    // it is enough to create the socket in the namespace of the task; it
+    // can then be connected from any thread. Instead of forking a helper
+    // for every check, the sockets are created by a thread which lives as
+    // long as this checker.
+    if (namespaceRunner.get() == nullptr) {
+      namespaceRunner.reset(new ns::NamespaceRunner());
+    }
+
+    return namespaceRunner->run<int_fd>(
+        path::join("/proc", stringify(plain->taskPid.get()), "ns", "net"),
+        "net",
+        [family]() {
+          return createSocket(family);
+        });
+  }
+#endif // __linux__
+
+  return createSocket(family);
 }
 
 
+Future<Socket> CheckerProcess::connect(
+    const string& domain,
+    int port,
+    const Option<runtime::Plain>& plain)
+{
+  // IPv6 addresses are enclosed in brackets, e.g., "[::1]".
+  Try<net::IP> ip = net::IP::parse(strings::trim(domain, strings::ANY, "[]"));
+  if (ip.isError()) {
+    return Failure("Failed to parse '" + domain + "': " + ip.error());
+  }
+
+  const process::network::inet::Address address(
+      ip.get(), static_cast<uint16_t>(port));
+
+  // If the check times out while the socket is being created, the
+  // discard request propagates to this future and the continuation
+  // below is skipped, hence close the socket instead of leaking it.
+  return socket(ip->family(), plain)
+    .onAny([](const Future<int_fd>& future) {
+      if (future.isReady() && future.hasDiscard()) {
+        os::close(future.get());
+      }
+    })
+    .then(defer(self(), [address](int_fd s) -> Future<Socket> {
+      // NOTE: We explicitly use the POLL implementation, even if SSL is
+      // enabled, since the checks talk plain HTTP or TCP.
+      Try<Socket> socket = Socket::create(s, SocketImpl::Kind::POLL);
+      if (socket.isError()) {
+        os::close(s);
+        return Failure("Failed to create socket: " + socket.error());
+      }
+
+      Socket _socket = socket.get();
+
+      return _socket.connect(address)
+        .then([_socket]() {
+          return _socket;
+        });
+    }));
+}
+#endif // __WINDOWS__
+
+
 Future<int> CheckerProcess::_httpCheck(
     const vector<string>& cmdArgv,
     const Option<runtime::Plain>& plain)
@@ -1217,6 +1449,7 @@ Future<int> CheckerProcess::dockerHttpCheck(
 #endif // __WINDOWS__
 
 
+#ifdef __WINDOWS__
 static vector<string> tcpCommand(
   const string& command,
   const string& domain,
@@ -1228,18 +1461,51 @@ static vector<string> tcpCommand(
     "--port=" + stringify(port)
   };
 }
+#endif // __WINDOWS__
 
 
 Future<bool> CheckerProcess::tcpCheck(
     const check::Tcp& tcp,
     const Option<runtime::Plain>& plain)
 {
+#ifndef __WINDOWS__
+  // TCP checks are performed in-process to avoid forking a
+  // TCP_CHECK_COMMAND process for every check.
+  VLOG(1) << "Connecting to " << tcp.domain << ":" << tcp.port << " for "
+          << name << " of task '" << taskId << "'";
+
+  // TODO(alexr): Use lambda named captures for
+  // these cached values once they are available.
+  const string _name = name;
+  const Duration timeout = checkTimeout;
+  const TaskID _taskId = taskId;
+
+  return connect(tcp.domain, tcp.port, plain)
+    .then([](const Socket&) {
+      return true;
+    })
+    .repair([_name, _taskId](const Future<bool>& future) {
+      // We cannot distinguish a system error (e.g., failing to enter the
+      // network namespace of the task) from an actual connection failure,
+      // hence treat all of them as connection failure.
+      VLOG(1) << _name << " for task '" << _taskId << "' failed to"
+              << " connect: " << future.failure();
+
+      return false;
+    })
+    .after(timeout, [timeout](Future<bool> future) {
+      future.discard();
+
+      return Failure("TCP connection timed out after " + stringify(timeout));
+    });
+#else
   const string command = path::join(tcp.launcherDir, TCP_CHECK_COMMAND);
 
   const vector<string> argv =
     tcpCommand(command, tcp.domain, static_cast<uint16_t>(tcp.port));
 
   return _tcpCheck(argv, plain);
+#endif // __WINDOWS__
 }
 
 Future<bool> CheckerProcess::_tcpCheck(
@@ -26,7 +26,9 @@
 
 #include <process/future.hpp>
 #include <process/http.hpp>
+#include <process/owned.hpp>
 #include <process/protobuf.hpp>
+#include <process/socket.hpp>
 
 #include <stout/duration.hpp>
 #include <stout/option.hpp>
@@ -37,6 +39,10 @@
 #include "checks/checks_runtime.hpp"
 #include "checks/checks_types.hpp"
 
+#ifdef __linux__
+#include "linux/ns.hpp"
+#endif // __linux__
+
 namespace mesos {
 namespace internal {
 namespace checks {
@@ -141,6 +147,26 @@ private:
       const Stopwatch& stopwatch,
       const process::Future<int>& future);
 
+#ifndef __WINDOWS__
+  // Sends the HTTP request of the check over a libprocess socket and
+  // returns the status code of the response.
+  process::Future<int> inProcessHttpCheck(
+      const check::Http& http,
+      const Option<runtime::Plain>& plain);
+
+  // Returns a nonblocking socket of the given address family. If the task
+  // runs in a separate network namespace, the socket is created in it.
+  process::Future<int_fd> socket(
+      int family,
+      const Option<runtime::Plain>& plain);
+
+  // Connects to the given address from the network namespace of the task.
+  process::Future<process::network::inet::Socket> connect(
+      const std::string& domain,
+      int port,
+      const Option<runtime::Plain>& plain);
+#endif // __WINDOWS__
+
   // The docker HTTP health check is only performed differently on Windows.
 #ifdef __WINDOWS__
   process::Future<int> dockerHttpCheck(
@@ -187,6 +213,12 @@ private:
   // Contains the ID of the most recently terminated nested container
   // that was used to perform a COMMAND check.
   Option<ContainerID> previousCheckContainerId;
+
+#ifdef __linux__
+  // Creates the sockets of HTTP and TCP checks in the network namespace
+  // of the task; lazily initialized by the first such check.
+  process::Owned<ns::NamespaceRunner> namespaceRunner;
+#endif // __linux__
 };
 
 } // namespace checks {
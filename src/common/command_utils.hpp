@@ -62,6 +62,14 @@ process::Future<Nothing> untar(
 // TODO(Jojy): Add more overloads/options for untar (eg., keep existing files)
 
 
+/**
+ * Computes SHA 256 checksum of a file.
+ *
+ * @param input path of the file whose SHA 256 checksum has to be computed.
+ */
+process::Future<std::string> sha256(const Path& input);
+
+
 /**
  * Computes SHA 512 checksum of a file.
  *
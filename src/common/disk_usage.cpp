@@ -0,0 +1,86 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __WINDOWS__
+#include <fts.h>
+
+#include <sys/stat.h>
+#endif // __WINDOWS__
+
+#include <stout/error.hpp>
+
+#include "common/disk_usage.hpp"
+
+using std::string;
+
+namespace mesos {
+namespace internal {
+
+Try<Bytes> diskUsage(const string& path)
+{
+#ifdef __WINDOWS__
+  return Error("Measuring the disk usage is not supported on Windows");
+#else
+  char* paths[] = {const_cast<char*>(path.c_str()), nullptr};
+
+  FTS* tree = ::fts_open(paths, FTS_NOCHDIR | FTS_PHYSICAL | FTS_XDEV, nullptr);
+  if (tree == nullptr) {
+    return ErrnoError();
+  }
+
+  Bytes usage;
+
+  FTSENT* node;
+  // NOTE: `fts_read` sets `errno` to zero once the traversal is done.
+  while ((node = ::fts_read(tree)) != nullptr) {
+    switch (node->fts_info) {
+      case FTS_DEFAULT:
+      case FTS_F:
+      case FTS_SL:
+      case FTS_SLNONE:
+      case FTS_DP:
+        // NOTE: `st_blocks` is in units of 512 bytes regardless of
+        // the block size of the filesystem.
+        usage += Bytes(node->fts_statp->st_blocks * 512);
+        break;
+      case FTS_DNR:
+      case FTS_ERR:
+      case FTS_NS: {
+        Error error = ErrnoError(node->fts_errno);
+        ::fts_close(tree);
+        return error;
+      }
+      default:
+        break;
+    }
+  }
+
+  if (errno != 0) {
+    Error error = ErrnoError();
+    ::fts_close(tree);
+    return error;
+  }
+
+  if (::fts_close(tree) != 0) {
+    return ErrnoError();
+  }
+
+  return usage;
+#endif // __WINDOWS__
+}
+
+} // namespace internal {
+} // namespace mesos {
@@ -0,0 +1,42 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __COMMON_DISK_USAGE_HPP__
+#define __COMMON_DISK_USAGE_HPP__
+
+#include <string>
+
+#include <stout/bytes.hpp>
+#include <stout/try.hpp>
+
+namespace mesos {
+namespace internal {
+
+/**
+ * Returns the disk space occupied by the files and directories under
+ * the given path, without crossing file system boundaries. This walks
+ * the whole tree, so callers should avoid doing it on an actor.
+ *
+ * NOTE: This is not supported on Windows.
+ *
+ * @param path file or directory to measure.
+ */
+Try<Bytes> diskUsage(const std::string& path);
+
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __COMMON_DISK_USAGE_HPP__
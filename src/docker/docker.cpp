@@ -137,6 +137,17 @@ Try<Owned<Docker>> Docker::create(
     return docker;
   }
 
+  Try<Nothing> validateEnvironment = Docker::validateEnvironment(*docker);
+  if (validateEnvironment.isError()) {
+    return Error(validateEnvironment.error());
+  }
+
+  return docker;
+}
+
+
+Try<Nothing> Docker::validateEnvironment(const Docker& docker)
+{
 #ifdef __linux__
   // Make sure that cgroups are mounted, and at least the 'cpu'
   // subsystem is attached.
@@ -149,12 +160,7 @@ Try<Owned<Docker>> Docker::create(
   }
 #endif // __linux__
 
-  Try<Nothing> validateVersion = docker->validateVersion(Version(1, 8, 0));
-  if (validateVersion.isError()) {
-    return Error(validateVersion.error());
-  }
-
-  return docker;
+  return docker.validateVersion(Version(1, 8, 0));
 }
 
 
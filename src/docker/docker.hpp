@@ -329,14 +329,20 @@ protected:
          socket(DEFAULT_DOCKER_HOST_PREFIX + _socket),
          config(_config) {}
 
+  // Validates that docker can be used on this host, i.e., that the
+  // cgroups are mounted (on Linux) and that docker is recent enough.
+  static Try<Nothing> validateEnvironment(const Docker& docker);
+
+  // Parses the version reported by docker, e.g.,
+  // "Docker version 1.8.0, build 0d03096".
+  static process::Future<Version> __version(
+      const process::Future<std::string>& output);
+
 private:
   static process::Future<Version> _version(
       const std::string& cmd,
       const process::Subprocess& s);
 
-  static process::Future<Version> __version(
-      const process::Future<std::string>& output);
-
   static process::Future<Nothing> _stop(
       const Docker& docker,
       const std::string& containerName,
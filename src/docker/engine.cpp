@@ -0,0 +1,688 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <deque>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include <process/after.hpp>
+#include <process/collect.hpp>
+#include <process/defer.hpp>
+#include <process/dispatch.hpp>
+#include <process/http.hpp>
+#include <process/id.hpp>
+#include <process/loop.hpp>
+#include <process/network.hpp>
+#include <process/process.hpp>
+
+#include <stout/check.hpp>
+#include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/json.hpp>
+#include <stout/path.hpp>
+#include <stout/strings.hpp>
+#include <stout/stringify.hpp>
+
+#include "docker/engine.hpp"
+
+#include "slave/constants.hpp"
+
+namespace http = process::http;
+namespace unix = process::network::unix;
+
+using std::deque;
+using std::list;
+using std::string;
+using std::vector;
+
+using process::Break;
+using process::Continue;
+using process::ControlFlow;
+using process::Failure;
+using process::Future;
+using process::Owned;
+using process::Process;
+using process::Promise;
+
+using process::after;
+using process::collect;
+using process::defer;
+using process::dispatch;
+using process::loop;
+using process::spawn;
+using process::terminate;
+using process::wait;
+
+using mesos::internal::slave::DOCKER_ENGINE_MAX_CONNECTIONS;
+
+
+static http::Request request(
+    const string& method,
+    const string& path,
+    const hashmap<string, string>& query = {})
+{
+  http::Request request;
+  request.method = method;
+  request.keepAlive = true;
+
+  // The 'Host' header is meaningless for UNIX sockets, so we use the
+  // same placeholder as the docker CLI.
+  request.url.domain = "docker";
+  request.url.path = path;
+  request.url.query = query;
+
+  return request;
+}
+
+
+// Returns the error message of a failed Docker Engine API request.
+static string message(const http::Response& response)
+{
+  Try<JSON::Object> json = JSON::parse<JSON::Object>(response.body);
+  if (json.isSome()) {
+    Result<JSON::String> message = json->at<JSON::String>("message");
+    if (message.isSome()) {
+      return message->value;
+    }
+  }
+
+  return response.body;
+}
+
+
+template <typename T>
+static Future<T> failure(
+    const string& operation,
+    const http::Response& response)
+{
+  return Failure(
+      "Failed to " + operation + ": " + response.status + "; message='" +
+      strings::trim(message(response)) + "'");
+}
+
+
+// The event stream of a container, see `DockerEngineProcess::subscribe`.
+struct Events
+{
+  http::Connection connection;
+  http::Pipe::Reader reader;
+};
+
+
+class DockerEngineProcess : public Process<DockerEngineProcess>
+{
+public:
+  explicit DockerEngineProcess(const unix::Address& _address)
+    : ProcessBase(process::ID::generate("docker-engine")),
+      address(_address),
+      active(0) {}
+
+  Future<http::Response> send(const http::Request& request);
+
+  Future<Docker::Container> inspect(
+      const string& containerName,
+      const Option<Duration>& retryInterval);
+
+  Future<vector<Docker::Container>> ps(
+      bool all,
+      const Option<string>& prefix);
+
+private:
+  // Returns `None` if the container does not exist (yet).
+  Future<Option<Docker::Container>> _inspect(const string& containerName);
+
+  // Waits for the container to start, inspecting it again whenever
+  // the daemon reports an event of the container. Polls the container
+  // every `retryInterval` if there is no event stream.
+  Future<Docker::Container> waitStarted(
+      const string& containerName,
+      const Duration& retryInterval,
+      const Option<http::Pipe::Reader>& events);
+
+  // Subscribes to the events of the given container on a connection
+  // of its own, since the response never ends. Returns `None` if the
+  // events are not available, in which case the caller should poll.
+  Future<Option<Events>> subscribe(const string& containerName);
+
+  Future<http::Connection> acquire();
+  void release(const http::Connection& connection, bool reusable);
+
+  Future<http::Connection> connect();
+  void connectWaiters();
+
+  const unix::Address address;
+
+  // Connections to the daemon which are not in use.
+  //
+  // NOTE: This is a list since `http::Connection` is not assignable.
+  list<http::Connection> idle;
+
+  // Number of connections which are in use or being established.
+  size_t active;
+
+  // Requests waiting for a connection, since the maximum number of
+  // connections to the daemon has been reached.
+  deque<Owned<Promise<http::Connection>>> waiters;
+};
+
+
+Future<http::Response> DockerEngineProcess::send(const http::Request& request)
+{
+  return acquire()
+    .then(defer(self(), [=](http::Connection connection) {
+      return connection.send(request)
+        .onAny(defer(self(), [=](const Future<http::Response>& response) {
+          release(connection, response.isReady());
+        }));
+    }));
+}
+
+
+Future<Docker::Container> DockerEngineProcess::inspect(
+    const string& containerName,
+    const Option<Duration>& retryInterval)
+{
+  if (retryInterval.isNone()) {
+    return _inspect(containerName)
+      .then([containerName](const Option<Docker::Container>& container)
+          -> Future<Docker::Container> {
+        if (container.isNone()) {
+          return Failure("No such container: " + containerName);
+        }
+
+        return container.get();
+      });
+  }
+
+  // Subscribe to the events of the container before inspecting it, so
+  // that the container starting in between is not missed.
+  return subscribe(containerName)
+    .then(defer(self(), [=](const Option<Events>& events) {
+      if (events.isNone()) {
+        return waitStarted(containerName, retryInterval.get(), None());
+      }
+
+      Events _events = events.get();
+
+      return waitStarted(containerName, retryInterval.get(), _events.reader)
+        .onAny([_events](const Future<Docker::Container>&) mutable {
+          _events.reader.close();
+          _events.connection.disconnect();
+        });
+    }));
+}
+
+
+Future<vector<Docker::Container>> DockerEngineProcess::ps(
+    bool all,
+    const Option<string>& prefix)
+{
+  hashmap<string, string> query;
+  if (all) {
+    query["all"] = "1";
+  }
+
+  return send(request("GET", "/containers/json", query))
+    .then(defer(self(), [=](const http::Response& response)
+        -> Future<vector<Docker::Container>> {
+      if (response.code != http::Status::OK) {
+        return failure<vector<Docker::Container>>(
+            "list containers", response);
+      }
+
+      Try<JSON::Array> containers = JSON::parse<JSON::Array>(response.body);
+      if (containers.isError()) {
+        return Failure("Failed to parse JSON: " + containers.error());
+      }
+
+      vector<Future<Docker::Container>> futures;
+
+      foreach (const JSON::Value& value, containers->values) {
+        if (!value.is<JSON::Object>()) {
+          return Failure("Failed to parse JSON: container is not an object");
+        }
+
+        Result<JSON::Array> names =
+          value.as<JSON::Object>().at<JSON::Array>("Names");
+
+        if (!names.isSome() ||
+            names->values.empty() ||
+            !names->values.front().is<JSON::String>()) {
+          return Failure("Failed to find the name of a container");
+        }
+
+        // Unlike `docker ps`, the API prefixes the names with a '/'.
+        const string name = strings::remove(
+            names->values.front().as<JSON::String>().value,
+            "/",
+            strings::PREFIX);
+
+        if (prefix.isNone() || strings::startsWith(name, prefix.get())) {
+          futures.push_back(inspect(name, None()));
+        }
+      }
+
+      // NOTE: The number of concurrent requests is bounded by the
+      // connection pool, so the containers are inspected all at once.
+      return collect(futures);
+    }));
+}
+
+
+Future<Option<Docker::Container>> DockerEngineProcess::_inspect(
+    const string& containerName)
+{
+  return send(request("GET", "/containers/" + containerName + "/json"))
+    .then([containerName](const http::Response& response)
+        -> Future<Option<Docker::Container>> {
+      if (response.code == http::Status::NOT_FOUND) {
+        return None();
+      }
+
+      if (response.code != http::Status::OK) {
+        return failure<Option<Docker::Container>>(
+            "inspect container '" + containerName + "'", response);
+      }
+
+      // `Docker::Container` is parsed from the output of `docker
+      // inspect`, which is an array of the objects returned by the API.
+      Try<Docker::Container> container =
+        Docker::Container::create("[" + response.body + "]");
+
+      if (container.isError()) {
+        return Failure("Unable to create container: " + container.error());
+      }
+
+      return container.get();
+    });
+}
+
+
+Future<Docker::Container> DockerEngineProcess::waitStarted(
+    const string& containerName,
+    const Duration& retryInterval,
+    const Option<http::Pipe::Reader>& events)
+{
+  return loop(
+      self(),
+      [=]() {
+        return _inspect(containerName);
+      },
+      [=](const Option<Docker::Container>& container)
+          -> Future<ControlFlow<Docker::Container>> {
+        if (container.isSome() && container->started) {
+          return Break(container.get());
+        }
+
+        auto retry = [=]() {
+          VLOG(1) << "Retrying inspect of container '" << containerName
+                  << "' since it is not yet started, interval: "
+                  << retryInterval;
+
+          return after(retryInterval)
+            .then([]() -> ControlFlow<Docker::Container> {
+              return Continue();
+            });
+        };
+
+        if (events.isNone()) {
+          return retry();
+        }
+
+        // Inspect the container again once the daemon reports an
+        // event of the container. If the daemon closed the event
+        // stream, reading it keeps returning EOF (or the failure), so
+        // we fall back to polling.
+        http::Pipe::Reader reader = events.get();
+
+        return reader.read()
+          .then([=](const string& data) -> Future<ControlFlow<Docker::Container>> {
+            if (data.empty()) {
+              return retry();
+            }
+
+            return Continue();
+          })
+          .repair([=](const Future<ControlFlow<Docker::Container>>&) {
+            return retry();
+          });
+      });
+}
+
+
+Future<Option<Events>> DockerEngineProcess::subscribe(
+    const string& containerName)
+{
+  JSON::Object filters;
+  filters.values["type"] = JSON::Array({JSON::String("container")});
+  filters.values["container"] = JSON::Array({JSON::String(containerName)});
+
+  const http::Request events =
+    request("GET", "/events", {{"filters", stringify(filters)}});
+
+  return http::connect(address, http::Scheme::HTTP)
+    .then([=](http::Connection connection) {
+      return connection.send(events, true)
+        .then([=](const http::Response& response) mutable
+            -> Future<Option<Events>> {
+          if (response.code != http::Status::OK ||
+              response.type != http::Response::PIPE) {
+            connection.disconnect();
+            return failure<Option<Events>>("get events", response);
+          }
+
+          CHECK_SOME(response.reader);
+
+          return Events{connection, response.reader.get()};
+        });
+    })
+    .repair([containerName](const Future<Option<Events>>& future) {
+      LOG(WARNING) << "Failed to subscribe to the events of container '"
+                   << containerName << "', falling back to polling: "
+                   << future.failure();
+
+      return Option<Events>::none();
+    });
+}
+
+
+Future<http::Connection> DockerEngineProcess::acquire()
+{
+  if (!idle.empty()) {
+    http::Connection connection = idle.back();
+    idle.pop_back();
+    active++;
+    return connection;
+  }
+
+  if (active < DOCKER_ENGINE_MAX_CONNECTIONS) {
+    return connect();
+  }
+
+  Owned<Promise<http::Connection>> waiter(new Promise<http::Connection>());
+  waiters.push_back(waiter);
+
+  return waiter->future();
+}
+
+
+void DockerEngineProcess::release(
+    const http::Connection& connection,
+    bool reusable)
+{
+  CHECK_GT(active, 0u);
+
+  if (!reusable) {
+    active--;
+    http::Connection(connection).disconnect();
+    connectWaiters();
+    return;
+  }
+
+  if (!waiters.empty()) {
+    Owned<Promise<http::Connection>> waiter = waiters.front();
+    waiters.pop_front();
+    waiter->set(connection);
+    return;
+  }
+
+  active--;
+  idle.push_back(connection);
+}
+
+
+Future<http::Connection> DockerEngineProcess::connect()
+{
+  active++;
+
+  return http::connect(address, http::Scheme::HTTP)
+    .onAny(defer(self(), [=](const Future<http::Connection>& connection) {
+      if (!connection.isReady()) {
+        active--;
+        connectWaiters();
+        return;
+      }
+
+      // Forget about the connection once the daemon closes it, in
+      // case it is idle by then.
+      http::Connection(connection.get()).disconnected()
+        .onAny(defer(self(), [=](const Future<Nothing>&) {
+          idle.remove(connection.get());
+        }));
+    }));
+}
+
+
+void DockerEngineProcess::connectWaiters()
+{
+  while (!waiters.empty() && active < DOCKER_ENGINE_MAX_CONNECTIONS) {
+    Owned<Promise<http::Connection>> waiter = waiters.front();
+    waiters.pop_front();
+    waiter->associate(connect());
+  }
+}
+
+
+Try<Owned<Docker>> DockerEngine::create(
+    const string& path,
+    const string& socket,
+    bool validate,
+    const Option<JSON::Object>& config)
+{
+  if (!path::absolute(socket)) {
+    return Error("Invalid Docker socket path: " + socket);
+  }
+
+  Try<unix::Address> address = unix::Address::create(socket);
+  if (address.isError()) {
+    return Error(
+        "Failed to create address for Docker socket '" + socket + "': " +
+        address.error());
+  }
+
+  Owned<DockerEngineProcess> process(new DockerEngineProcess(address.get()));
+
+  Owned<Docker> docker(new DockerEngine(path, socket, config, process));
+  if (!validate) {
+    return docker;
+  }
+
+  Try<Nothing> validateEnvironment = Docker::validateEnvironment(*docker);
+  if (validateEnvironment.isError()) {
+    return Error(validateEnvironment.error());
+  }
+
+  return docker;
+}
+
+
+DockerEngine::DockerEngine(
+    const string& path,
+    const string& socket,
+    const Option<JSON::Object>& config,
+    const Owned<DockerEngineProcess>& _process)
+  : Docker(path, socket, config),
+    process(_process)
+{
+  spawn(process.get());
+}
+
+
+DockerEngine::~DockerEngine()
+{
+  terminate(process.get());
+  wait(process.get());
+}
+
+
+Future<Version> DockerEngine::version() const
+{
+  return dispatch(
+      process.get(),
+      &DockerEngineProcess::send,
+      request("GET", "/version"))
+    .then([](const http::Response& response) -> Future<Version> {
+      if (response.code != http::Status::OK) {
+        return failure<Version>("get docker version", response);
+      }
+
+      Try<JSON::Object> json = JSON::parse<JSON::Object>(response.body);
+      if (json.isError()) {
+        return Failure("Failed to parse JSON: " + json.error());
+      }
+
+      Result<JSON::String> version = json->at<JSON::String>("Version");
+      if (!version.isSome()) {
+        return Failure("Unable to find docker version in response");
+      }
+
+      return Docker::__version(version->value);
+    });
+}
+
+
+// Performs the equivalent of 'docker rm -v (-f) CONTAINER'.
+static Future<Nothing> remove(
+    DockerEngineProcess* process,
+    const string& containerName,
+    bool force)
+{
+  VLOG(1) << "Removing container '" << containerName << "'";
+
+  hashmap<string, string> query = {{"v", "1"}};
+  if (force) {
+    query["force"] = "1";
+  }
+
+  return dispatch(
+      process,
+      &DockerEngineProcess::send,
+      request("DELETE", "/containers/" + containerName, query))
+    .then([=](const http::Response& response) -> Future<Nothing> {
+      if (response.code != http::Status::NO_CONTENT) {
+        return failure<Nothing>(
+            "remove container '" + containerName + "'", response);
+      }
+
+      return Nothing();
+    });
+}
+
+
+// NOTE: As with the docker CLI, a failure to remove the container is
+// only logged when `remove` is set (MESOS-7777).
+Future<Nothing> DockerEngine::stop(
+    const string& containerName,
+    const Duration& timeout,
+    bool remove) const
+{
+  int timeoutSecs = (int) timeout.secs();
+  if (timeoutSecs < 0) {
+    return Failure("A negative timeout cannot be applied to docker stop: " +
+                   stringify(timeoutSecs));
+  }
+
+  VLOG(1) << "Stopping container '" << containerName << "'";
+
+  DockerEngineProcess* process = this->process.get();
+
+  return dispatch(
+      process,
+      &DockerEngineProcess::send,
+      request(
+          "POST",
+          "/containers/" + containerName + "/stop",
+          {{"t", stringify(timeoutSecs)}}))
+    .then([=](const http::Response& response) -> Future<Nothing> {
+      // The daemon responds with 'Not Modified' if the container has
+      // already been stopped.
+      const bool stopped =
+        response.code == http::Status::NO_CONTENT ||
+        response.code == http::Status::NOT_MODIFIED;
+
+      if (remove) {
+        return ::remove(process, containerName, !stopped)
+          .repair([=](const Future<Nothing>& future) {
+            LOG(ERROR) << "Unable to remove Docker container '"
+                       << containerName + "': " << future.failure();
+            return Nothing();
+          });
+      }
+
+      if (!stopped) {
+        return failure<Nothing>(
+            "stop container '" + containerName + "'", response);
+      }
+
+      return Nothing();
+    });
+}
+
+
+Future<Nothing> DockerEngine::kill(
+    const string& containerName,
+    int signal) const
+{
+  VLOG(1) << "Sending signal " << signal << " to container '"
+          << containerName << "'";
+
+  return dispatch(
+      process.get(),
+      &DockerEngineProcess::send,
+      request(
+          "POST",
+          "/containers/" + containerName + "/kill",
+          {{"signal", stringify(signal)}}))
+    .then([=](const http::Response& response) -> Future<Nothing> {
+      if (response.code != http::Status::NO_CONTENT) {
+        return failure<Nothing>(
+            "kill container '" + containerName + "'", response);
+      }
+
+      return Nothing();
+    });
+}
+
+
+Future<Nothing> DockerEngine::rm(
+    const string& containerName,
+    bool force) const
+{
+  return ::remove(process.get(), containerName, force);
+}
+
+
+Future<Docker::Container> DockerEngine::inspect(
+    const string& containerName,
+    const Option<Duration>& retryInterval) const
+{
+  return dispatch(
+      process.get(),
+      &DockerEngineProcess::inspect,
+      containerName,
+      retryInterval);
+}
+
+
+Future<vector<Docker::Container>> DockerEngine::ps(
+    bool all,
+    const Option<string>& prefix) const
+{
+  return dispatch(process.get(), &DockerEngineProcess::ps, all, prefix);
+}
@@ -0,0 +1,95 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __DOCKER_ENGINE_HPP__
+#define __DOCKER_ENGINE_HPP__
+
+#include <string>
+#include <vector>
+
+#include <process/future.hpp>
+#include <process/owned.hpp>
+
+#include <stout/duration.hpp>
+#include <stout/json.hpp>
+#include <stout/none.hpp>
+#include <stout/nothing.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+#include <stout/version.hpp>
+
+#include "docker/docker.hpp"
+
+// Forward declaration.
+class DockerEngineProcess;
+
+// Docker abstraction which talks to the Docker Engine API over the
+// daemon's UNIX socket instead of forking the docker CLI for every
+// operation. Requests are sent over a bounded pool of persistent
+// connections, and waiting for a container to start subscribes to
+// the daemon's event stream instead of polling `docker inspect`.
+//
+// NOTE: Containers are still run and images are still pulled with the
+// docker CLI: `run` hands the output of the container to the caller
+// and `pull` relies on the docker config for registry credentials.
+class DockerEngine : public Docker
+{
+public:
+  static Try<process::Owned<Docker>> create(
+      const std::string& path,
+      const std::string& socket,
+      bool validate = true,
+      const Option<JSON::Object>& config = None());
+
+  ~DockerEngine() override;
+
+  process::Future<Version> version() const override;
+
+  process::Future<Nothing> stop(
+      const std::string& containerName,
+      const Duration& timeout = Seconds(0),
+      bool remove = false) const override;
+
+  process::Future<Nothing> kill(
+      const std::string& containerName,
+      int signal) const override;
+
+  process::Future<Nothing> rm(
+      const std::string& containerName,
+      bool force = false) const override;
+
+  process::Future<Container> inspect(
+      const std::string& containerName,
+      const Option<Duration>& retryInterval = None()) const override;
+
+  process::Future<std::vector<Container>> ps(
+      bool all = false,
+      const Option<std::string>& prefix = None()) const override;
+
+private:
+  DockerEngine(
+      const std::string& path,
+      const std::string& socket,
+      const Option<JSON::Object>& config,
+      const process::Owned<DockerEngineProcess>& process);
+
+  DockerEngine(const DockerEngine&) = delete;
+  DockerEngine& operator=(const DockerEngine&) = delete;
+
+  process::Owned<DockerEngineProcess> process;
+};
+
+#endif // __DOCKER_ENGINE_HPP__
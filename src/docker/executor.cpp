@@ -58,6 +58,10 @@
 #include "docker/docker.hpp"
 #include "docker/executor.hpp"
 
+#ifndef __WINDOWS__
+#include "docker/engine.hpp"
+#endif // __WINDOWS__
+
 #include "logging/flags.hpp"
 #include "logging/logging.hpp"
 
@@ -1105,10 +1109,22 @@ int main(int argc, char** argv)
   // The 2nd argument for docker create is set to false so we skip
   // validation when creating a docker abstraction, as the slave
   // should have already validated docker.
+#ifdef __WINDOWS__
   Try<Owned<Docker>> docker = Docker::create(
       flags.docker.get(),
       flags.docker_socket.get(),
       false);
+#else
+  Try<Owned<Docker>> docker = flags.docker_engine_api
+    ? DockerEngine::create(
+          flags.docker.get(),
+          flags.docker_socket.get(),
+          false)
+    : Docker::create(
+          flags.docker.get(),
+          flags.docker_socket.get(),
+          false);
+#endif // __WINDOWS__
 
   if (docker.isError()) {
     EXIT(EXIT_FAILURE)
@@ -27,10 +27,12 @@
 #include <stout/os.hpp>
 #include <stout/path.hpp>
 #include <stout/protobuf.hpp>
+#include <stout/recordio.hpp>
 #include <stout/strings.hpp>
 
 #include <stout/os/constants.hpp>
 #include <stout/os/copyfile.hpp>
+#include <stout/os/write.hpp>
 
 #include <mesos/mesos.hpp>
 
@@ -475,6 +477,36 @@ static Try<string> fetch(
 }
 
 
+// Creates the fetcher cache directory of the given user.
+static Try<Nothing> createCacheDirectory(
+    const string& cacheDirectory,
+    const Option<string>& user)
+{
+  // If this user has fetched anything into the cache before, their cache
+  // directory will already exist. Set `recursive = true` when calling
+  // `os::mkdir` to ensure no error is returned in this case.
+  Try<Nothing> mkdir = os::mkdir(cacheDirectory, true);
+  if (mkdir.isError()) {
+    return mkdir;
+  }
+
+  if (user.isSome()) {
+    // Fetching is performed as the task's user,
+    // so chown the cache directory.
+
+    // TODO(coffler): Fix Windows chown handling, see MESOS-8063.
+#ifndef __WINDOWS__
+    Try<Nothing> chown = os::chown(user.get(), cacheDirectory, false);
+    if (chown.isError()) {
+      return chown;
+    }
+#endif // __WINDOWS__
+  }
+
+  return Nothing();
+}
+
+
 // Checks to see if it's necessary to create a fetcher cache directory for this
 // user, and creates it if so.
 static Try<Nothing> createCacheDirectory(const FetcherInfo& fetcherInfo)
@@ -485,39 +517,240 @@ static Try<Nothing> createCacheDirectory(const FetcherInfo& fetcherInfo)
 
   foreach (const FetcherInfo::Item& item, fetcherInfo.items()) {
     if (item.action() != FetcherInfo::Item::BYPASS_CACHE) {
-      // If this user has fetched anything into the cache before, their cache
-      // directory will already exist. Set `recursive = true` when calling
-      // `os::mkdir` to ensure no error is returned in this case.
-      Try<Nothing> mkdir = os::mkdir(fetcherInfo.cache_directory(), true);
-      if (mkdir.isError()) {
-        return mkdir;
-      }
+      return createCacheDirectory(
+          fetcherInfo.cache_directory(),
+          fetcherInfo.has_user()
+            ? Option<string>::some(fetcherInfo.user())
+            : Option<string>::none());
+    }
+  }
+
+  return Nothing();
+}
+
+
+static Try<FetcherInfo> parseFetcherInfo(const string& json)
+{
+  Try<JSON::Object> parse = JSON::parse<JSON::Object>(json);
+  if (parse.isError()) {
+    return Error("Failed to parse JSON: " + parse.error());
+  }
+
+  return ::protobuf::parse<FetcherInfo>(parse.get());
+}
+
+
+// Fetches all items of the given `FetcherInfo` into its sandbox
+// directory. Calls `fetched` with the index of each item once the
+// item has been fetched.
+static Try<Nothing> fetch(
+    const FetcherInfo& fetcherInfo,
+    const lambda::function<void(int)>& fetched)
+{
+  const string sandboxDirectory = fetcherInfo.sandbox_directory();
+
+  const Option<string> cacheDirectory =
+    fetcherInfo.has_cache_directory()
+      ? Option<string>::some(fetcherInfo.cache_directory())
+      : Option<string>::none();
+
+  const Option<string> frameworksHome =
+    fetcherInfo.has_frameworks_home()
+      ? Option<string>::some(fetcherInfo.frameworks_home())
+      : Option<string>::none();
+
+  const Option<Duration> stallTimeout =
+    fetcherInfo.has_stall_timeout()
+      ? Nanoseconds(fetcherInfo.stall_timeout().nanoseconds())
+      : Option<Duration>::none();
+
+  // Fetch each URI to a local file and chmod if necessary.
+  for (int i = 0; i < fetcherInfo.items_size(); i++) {
+    const FetcherInfo::Item& item = fetcherInfo.items(i);
+
+    Try<string> result = fetch(
+        item, cacheDirectory, sandboxDirectory, frameworksHome, stallTimeout);
+
+    if (result.isError()) {
+      return Error(
+          "Failed to fetch '" + item.uri().value() + "': " + result.error());
+    }
+
+    LOG(INFO) << "Fetched '" << item.uri().value()
+              << "' to '" << result.get() << "'";
+
+    fetched(i);
+  }
+
+  return Nothing();
+}
 
-      if (fetcherInfo.has_user()) {
-        // Fetching is performed as the task's user,
-        // so chown the cache directory.
 
-        // TODO(coffler): Fix Windows chown handling, see MESOS-8063.
 #ifndef __WINDOWS__
-        Try<Nothing> chown = os::chown(
-            fetcherInfo.user(),
-            fetcherInfo.cache_directory(),
-            false);
-
-        if (chown.isError()) {
-          return chown;
-        }
-#endif // __WINDOWS__
-      }
+// Points stdout and stderr to the files of the same name in the given
+// sandbox directory, which the agent creates before each fetch.
+static Try<Nothing> redirect(const string& sandboxDirectory)
+{
+  const vector<std::pair<string, int>> files = {
+    {"stdout", STDOUT_FILENO},
+    {"stderr", STDERR_FILENO}
+  };
+
+  foreach (const auto& file, files) {
+    const string path = path::join(sandboxDirectory, file.first);
 
-      break;
+    Try<int_fd> fd = os::open(path, O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (fd.isError()) {
+      return Error("Failed to open '" + path + "': " + fd.error());
     }
+
+    if (::dup2(fd.get(), file.second) < 0) {
+      ErrnoError error("Failed to redirect to '" + path + "'");
+      os::close(fd.get());
+      return error;
+    }
+
+    os::close(fd.get());
   }
 
   return Nothing();
 }
 
 
+// Runs the fetcher as a long-lived worker of the agent, which saves
+// launching a fetcher for every container. The worker reads the
+// `FetcherInfo` of each fetch as a "Record-IO" encoded JSON object
+// from stdin and performs the fetches one after the other. For each
+// fetch, it reports the index of every fetched item and finally the
+// outcome of the fetch as "Record-IO" encoded JSON objects on stdout:
+//
+//   {"type": "FETCHED", "index": 0}
+//   {"type": "SUCCEEDED"}
+//   {"type": "FAILED", "message": "..."}
+//
+// While fetching, stdout and stderr are redirected into the sandbox.
+// The worker exits once stdin is closed.
+static int work()
+{
+  // Keep the original stdout for the results, so that nothing else
+  // (e.g., the output of a Hadoop client) can be written to it.
+  Try<int> results = os::dup(STDOUT_FILENO);
+  if (results.isError()) {
+    LOG(ERROR) << "Failed to duplicate stdout: " << results.error();
+    return EXIT_FAILURE;
+  }
+
+  Try<int> log = os::dup(STDERR_FILENO);
+  if (log.isError()) {
+    LOG(ERROR) << "Failed to duplicate stderr: " << log.error();
+    return EXIT_FAILURE;
+  }
+
+  foreach (int fd, vector<int>({results.get(), log.get()})) {
+    Try<Nothing> cloexec = os::cloexec(fd);
+    if (cloexec.isError()) {
+      LOG(ERROR) << "Failed to set FD_CLOEXEC: " << cloexec.error();
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (::dup2(log.get(), STDOUT_FILENO) < 0) {
+    PLOG(ERROR) << "Failed to redirect stdout";
+    return EXIT_FAILURE;
+  }
+
+  ::recordio::Encoder<JSON::Object> encoder(
+      [](const JSON::Object& object) {
+        return stringify(object);
+      });
+
+  ::recordio::Decoder<FetcherInfo> decoder(parseFetcherInfo);
+
+  auto report = [&](const JSON::Object& object) {
+    Try<Nothing> write = os::write(results.get(), encoder.encode(object));
+    if (write.isError()) {
+      EXIT(EXIT_FAILURE) << "Failed to report to the agent: " << write.error();
+    }
+  };
+
+  char buffer[4096];
+
+  while (true) {
+    ssize_t length = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+    if (length < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (length < 0) {
+      PLOG(ERROR) << "Failed to read from stdin";
+      return EXIT_FAILURE;
+    }
+
+    if (length == 0) {
+      // The agent is done with this worker.
+      return EXIT_SUCCESS;
+    }
+
+    Try<std::deque<Try<FetcherInfo>>> records =
+      decoder.decode(string(buffer, length));
+
+    if (records.isError()) {
+      LOG(ERROR) << "Failed to decode fetch request: " << records.error();
+      return EXIT_FAILURE;
+    }
+
+    foreach (const Try<FetcherInfo>& fetcherInfo, records.get()) {
+      if (fetcherInfo.isError()) {
+        LOG(ERROR) << "Failed to parse FetcherInfo: " << fetcherInfo.error();
+        return EXIT_FAILURE;
+      }
+
+      JSON::Object result;
+
+      Try<Nothing> redirected = redirect(fetcherInfo->sandbox_directory());
+      if (redirected.isError()) {
+        result.values["type"] = "FAILED";
+        result.values["message"] = redirected.error();
+        report(result);
+        continue;
+      }
+
+      LOG(INFO) << "Fetcher Info: " << stringify(JSON::protobuf(fetcherInfo.get()));
+
+      Try<Nothing> fetched = fetch(fetcherInfo.get(), [&](int index) {
+        JSON::Object object;
+        object.values["type"] = "FETCHED";
+        object.values["index"] = index;
+        report(object);
+      });
+
+      if (fetched.isError()) {
+        LOG(ERROR) << fetched.error();
+
+        result.values["type"] = "FAILED";
+        result.values["message"] = fetched.error();
+      } else {
+        LOG(INFO) << "Successfully fetched all URIs into "
+                  << "'" << fetcherInfo->sandbox_directory() << "'";
+
+        result.values["type"] = "SUCCEEDED";
+      }
+
+      // Stop writing into the sandbox before reporting the result, as
+      // the agent might start the container right away.
+      if (::dup2(log.get(), STDOUT_FILENO) < 0 ||
+          ::dup2(log.get(), STDERR_FILENO) < 0) {
+        PLOG(ERROR) << "Failed to restore stdout and stderr";
+        return EXIT_FAILURE;
+      }
+
+      report(result);
+    }
+  }
+}
+#endif // __WINDOWS__
+
+
 // This "fetcher program" is invoked by the slave's fetcher actor
 // (Fetcher, FetcherProcess) to "fetch" URIs into the sandbox directory
 // of a given task. Its parameters are provided in the form of the env
@@ -530,6 +763,10 @@ static Try<Nothing> createCacheDirectory(const FetcherInfo& fetcherInfo)
 // bookkeeping is centralized in the slave's fetcher actor, which can
 // have multiple instances of this fetcher program running at any
 // given time. Exit code: 0 if entirely successful, otherwise 1.
+//
+// If the env var MESOS_FETCHER_WORKER is set, the fetcher program
+// keeps running and performs the fetches the actor sends on stdin for
+// the user of the given FetcherInfo instead, see `work()`.
 int main(int argc, char* argv[])
 {
   GOOGLE_PROTOBUF_VERIFY_VERSION;
@@ -561,19 +798,27 @@ int main(int argc, char* argv[])
 
   LOG(INFO) << "Fetcher Info: " << jsonFetcherInfo.get();
 
-  Try<JSON::Object> parse = JSON::parse<JSON::Object>(jsonFetcherInfo.get());
-  CHECK_SOME(parse) << "Failed to parse MESOS_FETCHER_INFO: " << parse.error();
-
-  Try<FetcherInfo> fetcherInfo = ::protobuf::parse<FetcherInfo>(parse.get());
+  Try<FetcherInfo> fetcherInfo = parseFetcherInfo(jsonFetcherInfo.get());
   CHECK_SOME(fetcherInfo)
     << "Failed to parse FetcherInfo: " << fetcherInfo.error();
 
   CHECK(!fetcherInfo->sandbox_directory().empty())
     << "Missing sandbox directory";
 
-  const string sandboxDirectory = fetcherInfo->sandbox_directory();
+  // The agent runs the fetcher as a worker which serves many fetches
+  // for the user of the given `FetcherInfo`, see `work()`.
+  const bool worker = os::getenv("MESOS_FETCHER_WORKER").isSome();
+
+  // A worker cannot create the cache directory for later fetches once
+  // it dropped its privileges, hence it always creates it upfront.
+  Try<Nothing> result = worker && fetcherInfo->has_cache_directory()
+    ? createCacheDirectory(
+          fetcherInfo->cache_directory(),
+          fetcherInfo->has_user()
+            ? Option<string>::some(fetcherInfo->user())
+            : Option<string>::none())
+    : createCacheDirectory(fetcherInfo.get());
 
-  Try<Nothing> result = createCacheDirectory(fetcherInfo.get());
   if (result.isError()) {
     EXIT(EXIT_FAILURE)
       << "Could not create the fetcher cache directory: " << result.error();
@@ -592,36 +837,19 @@ int main(int argc, char* argv[])
 #endif // __WINDOWS__
   }
 
-  const Option<string> cacheDirectory =
-    fetcherInfo->has_cache_directory()
-      ? Option<string>::some(fetcherInfo->cache_directory())
-      : Option<string>::none();
-
-  const Option<string> frameworksHome =
-    fetcherInfo->has_frameworks_home()
-      ? Option<string>::some(fetcherInfo->frameworks_home())
-      : Option<string>::none();
-
-  const Option<Duration> stallTimeout =
-    fetcherInfo->has_stall_timeout()
-      ? Nanoseconds(fetcherInfo->stall_timeout().nanoseconds())
-      : Option<Duration>::none();
+#ifndef __WINDOWS__
+  if (worker) {
+    return work();
+  }
+#endif // __WINDOWS__
 
-  // Fetch each URI to a local file and chmod if necessary.
-  foreach (const FetcherInfo::Item& item, fetcherInfo->items()) {
-    Try<string> fetched = fetch(
-        item, cacheDirectory, sandboxDirectory, frameworksHome, stallTimeout);
-    if (fetched.isError()) {
-      EXIT(EXIT_FAILURE)
-        << "Failed to fetch '" << item.uri().value() << "': " + fetched.error();
-    } else {
-      LOG(INFO) << "Fetched '" << item.uri().value()
-                << "' to '" << fetched.get() << "'";
-    }
+  result = fetch(fetcherInfo.get(), [](int) {});
+  if (result.isError()) {
+    EXIT(EXIT_FAILURE) << result.error();
   }
 
   LOG(INFO) << "Successfully fetched all URIs into "
-            << "'" << sandboxDirectory << "'";
+            << "'" << fetcherInfo->sandbox_directory() << "'";
 
   return 0;
 }
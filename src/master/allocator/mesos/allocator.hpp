@@ -17,13 +17,21 @@
 #ifndef __MASTER_ALLOCATOR_MESOS_ALLOCATOR_HPP__
 #define __MASTER_ALLOCATOR_MESOS_ALLOCATOR_HPP__
 
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #include <mesos/allocator/allocator.hpp>
 
 #include <process/dispatch.hpp>
 #include <process/future.hpp>
 #include <process/process.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/hashmap.hpp>
+#include <stout/option.hpp>
+#include <stout/synchronized.hpp>
 #include <stout/try.hpp>
 
 namespace mesos {
@@ -33,6 +41,70 @@ namespace allocator {
 
 class MesosAllocatorProcess;
 
+
+// The arguments of an `addSlave()` call.
+struct AddSlaveCall
+{
+  SlaveID slaveId;
+  SlaveInfo slaveInfo;
+  std::vector<SlaveInfo::Capability> capabilities;
+  Option<Unavailability> unavailability;
+  Resources total;
+  hashmap<FrameworkID, Resources> used;
+};
+
+
+// The arguments of a `recoverResources()` call.
+struct RecoverResourcesCall
+{
+  FrameworkID frameworkId;
+  SlaveID slaveId;
+  Resources resources;
+  Option<Filters> filters;
+};
+
+
+// Calls of the same kind which are handled by the allocator process
+// as a single event. Calls can be added to the batch until the
+// allocator process drains it.
+template <typename Call>
+class CallBatch
+{
+public:
+  // Returns false if the batch has already been drained, in which
+  // case `call` is left untouched.
+  bool add(Call&& call)
+  {
+    bool added = false;
+
+    synchronized (mutex) {
+      if (!drained) {
+        calls.push_back(std::move(call));
+        added = true;
+      }
+    }
+
+    return added;
+  }
+
+  std::vector<Call> drain()
+  {
+    std::vector<Call> result;
+
+    synchronized (mutex) {
+      drained = true;
+      std::swap(result, calls);
+    }
+
+    return result;
+  }
+
+private:
+  std::mutex mutex;
+  bool drained = false;
+  std::vector<Call> calls;
+};
+
 // A wrapper for Process-based allocators. It redirects all function
 // invocations to the underlying AllocatorProcess and manages its
 // lifetime. We ensure the template parameter AllocatorProcess
@@ -177,7 +249,22 @@ private:
   MesosAllocator(const MesosAllocator&); // Not copyable.
   MesosAllocator& operator=(const MesosAllocator&); // Not assignable.
 
+  // Closes the open batches, so that the calls made afterwards are
+  // handled by the allocator process after the calls of the batches.
+  void closeBatches();
+
   MesosAllocatorProcess* process;
+
+  // The batches of `addSlave()` and `recoverResources()` calls which
+  // have been dispatched but not yet handled by the allocator process.
+  // Consecutive calls of the same kind are added to the open batch
+  // rather than being dispatched one by one, which coalesces the many
+  // calls the master makes during a failover or when many tasks
+  // terminate at once. Any other call closes the batches to preserve
+  // the order of the calls.
+  std::mutex mutex;
+  std::shared_ptr<CallBatch<AddSlaveCall>> addSlaveCalls;
+  std::shared_ptr<CallBatch<RecoverResourcesCall>> recoverResourcesCalls;
 };
 
 
@@ -297,6 +384,35 @@ public:
       const Resources& resources,
       const Option<Filters>& filters) = 0;
 
+  // Makes the `addSlave()` and `recoverResources()` calls of a batch,
+  // see `MesosAllocator`. Allocators can override these in order to
+  // handle the calls of a batch together.
+  virtual void addSlaves(
+      const std::shared_ptr<CallBatch<AddSlaveCall>>& batch)
+  {
+    foreach (const AddSlaveCall& call, batch->drain()) {
+      addSlave(
+          call.slaveId,
+          call.slaveInfo,
+          call.capabilities,
+          call.unavailability,
+          call.total,
+          call.used);
+    }
+  }
+
+  virtual void recoverResourcesBatch(
+      const std::shared_ptr<CallBatch<RecoverResourcesCall>>& batch)
+  {
+    foreach (const RecoverResourcesCall& call, batch->drain()) {
+      recoverResources(
+          call.frameworkId,
+          call.slaveId,
+          call.resources,
+          call.filters);
+    }
+  }
+
   virtual void suppressOffers(
       const FrameworkID& frameworkId,
       const std::set<std::string>& roles) = 0;
@@ -360,6 +476,8 @@ inline void MesosAllocator<AllocatorProcess>::initialize(
               const hashmap<SlaveID, UnavailableResources>&)>&
       inverseOfferCallback)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::initialize,
@@ -374,6 +492,8 @@ inline void MesosAllocator<AllocatorProcess>::recover(
     const int expectedAgentCount,
     const hashmap<std::string, Quota>& quotas)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::recover,
@@ -390,6 +510,8 @@ inline void MesosAllocator<AllocatorProcess>::addFramework(
     bool active,
     const std::set<std::string>& suppressedRoles)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::addFramework,
@@ -405,6 +527,8 @@ template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::removeFramework(
     const FrameworkID& frameworkId)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::removeFramework,
@@ -416,6 +540,8 @@ template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::activateFramework(
     const FrameworkID& frameworkId)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::activateFramework,
@@ -427,6 +553,8 @@ template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::deactivateFramework(
     const FrameworkID& frameworkId)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::deactivateFramework,
@@ -440,6 +568,8 @@ inline void MesosAllocator<AllocatorProcess>::updateFramework(
     const FrameworkInfo& frameworkInfo,
     const std::set<std::string>& suppressedRoles)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::updateFramework,
@@ -458,15 +588,23 @@ inline void MesosAllocator<AllocatorProcess>::addSlave(
     const Resources& total,
     const hashmap<FrameworkID, Resources>& used)
 {
-  process::dispatch(
-      process,
-      &MesosAllocatorProcess::addSlave,
-      slaveId,
-      slaveInfo,
-      capabilities,
-      unavailability,
-      total,
-      used);
+  AddSlaveCall call{
+      slaveId, slaveInfo, capabilities, unavailability, total, used};
+
+  synchronized (mutex) {
+    recoverResourcesCalls.reset();
+
+    if (addSlaveCalls.get() == nullptr ||
+        !addSlaveCalls->add(std::move(call))) {
+      addSlaveCalls.reset(new CallBatch<AddSlaveCall>());
+      addSlaveCalls->add(std::move(call));
+
+      process::dispatch(
+          process,
+          &MesosAllocatorProcess::addSlaves,
+          addSlaveCalls);
+    }
+  }
 }
 
 
@@ -474,6 +612,8 @@ template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::removeSlave(
     const SlaveID& slaveId)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::removeSlave,
@@ -488,6 +628,8 @@ inline void MesosAllocator<AllocatorProcess>::updateSlave(
     const Option<Resources>& total,
     const Option<std::vector<SlaveInfo::Capability>>& capabilities)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::updateSlave,
@@ -503,6 +645,8 @@ void MesosAllocator<AllocatorProcess>::addResourceProvider(
     const Resources& total,
     const hashmap<FrameworkID, Resources>& used)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::addResourceProvider,
@@ -516,6 +660,8 @@ template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::activateSlave(
     const SlaveID& slaveId)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::activateSlave,
@@ -527,6 +673,8 @@ template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::deactivateSlave(
     const SlaveID& slaveId)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::deactivateSlave,
@@ -538,6 +686,8 @@ template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::updateWhitelist(
     const Option<hashset<std::string>>& whitelist)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::updateWhitelist,
@@ -550,6 +700,8 @@ inline void MesosAllocator<AllocatorProcess>::requestResources(
     const FrameworkID& frameworkId,
     const std::vector<Request>& requests)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::requestResources,
@@ -565,6 +717,8 @@ inline void MesosAllocator<AllocatorProcess>::updateAllocation(
     const Resources& offeredResources,
     const std::vector<ResourceConversion>& conversions)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::updateAllocation,
@@ -581,6 +735,8 @@ MesosAllocator<AllocatorProcess>::updateAvailable(
     const SlaveID& slaveId,
     const std::vector<Offer::Operation>& operations)
 {
+  closeBatches();
+
   return process::dispatch(
       process,
       &MesosAllocatorProcess::updateAvailable,
@@ -594,6 +750,8 @@ inline void MesosAllocator<AllocatorProcess>::updateUnavailability(
     const SlaveID& slaveId,
     const Option<Unavailability>& unavailability)
 {
+  closeBatches();
+
   return process::dispatch(
       process,
       &MesosAllocatorProcess::updateUnavailability,
@@ -610,6 +768,8 @@ inline void MesosAllocator<AllocatorProcess>::updateInverseOffer(
     const Option<mesos::allocator::InverseOfferStatus>& status,
     const Option<Filters>& filters)
 {
+  closeBatches();
+
   return process::dispatch(
       process,
       &MesosAllocatorProcess::updateInverseOffer,
@@ -627,6 +787,8 @@ inline process::Future<
             hashmap<FrameworkID, mesos::allocator::InverseOfferStatus>>>
   MesosAllocator<AllocatorProcess>::getInverseOfferStatuses()
 {
+  closeBatches();
+
   return process::dispatch(
       process,
       &MesosAllocatorProcess::getInverseOfferStatuses);
@@ -640,13 +802,22 @@ inline void MesosAllocator<AllocatorProcess>::recoverResources(
     const Resources& resources,
     const Option<Filters>& filters)
 {
-  process::dispatch(
-      process,
-      &MesosAllocatorProcess::recoverResources,
-      frameworkId,
-      slaveId,
-      resources,
-      filters);
+  RecoverResourcesCall call{frameworkId, slaveId, resources, filters};
+
+  synchronized (mutex) {
+    addSlaveCalls.reset();
+
+    if (recoverResourcesCalls.get() == nullptr ||
+        !recoverResourcesCalls->add(std::move(call))) {
+      recoverResourcesCalls.reset(new CallBatch<RecoverResourcesCall>());
+      recoverResourcesCalls->add(std::move(call));
+
+      process::dispatch(
+          process,
+          &MesosAllocatorProcess::recoverResourcesBatch,
+          recoverResourcesCalls);
+    }
+  }
 }
 
 
@@ -655,6 +826,8 @@ inline void MesosAllocator<AllocatorProcess>::suppressOffers(
     const FrameworkID& frameworkId,
     const std::set<std::string>& roles)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::suppressOffers,
@@ -668,6 +841,8 @@ inline void MesosAllocator<AllocatorProcess>::reviveOffers(
     const FrameworkID& frameworkId,
     const std::set<std::string>& roles)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::reviveOffers,
@@ -681,6 +856,8 @@ inline void MesosAllocator<AllocatorProcess>::setQuota(
     const std::string& role,
     const Quota& quota)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::setQuota,
@@ -693,6 +870,8 @@ template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::removeQuota(
     const std::string& role)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::removeQuota,
@@ -704,6 +883,8 @@ template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::updateWeights(
     const std::vector<WeightInfo>& weightInfos)
 {
+  closeBatches();
+
   process::dispatch(
       process,
       &MesosAllocatorProcess::updateWeights,
@@ -714,6 +895,8 @@ inline void MesosAllocator<AllocatorProcess>::updateWeights(
 template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::pause()
 {
+  closeBatches();
+
   process::dispatch(process, &MesosAllocatorProcess::pause);
 }
 
@@ -721,10 +904,21 @@ inline void MesosAllocator<AllocatorProcess>::pause()
 template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::resume()
 {
+  closeBatches();
+
   process::dispatch(process, &MesosAllocatorProcess::resume);
 }
 
 
+template <typename AllocatorProcess>
+inline void MesosAllocator<AllocatorProcess>::closeBatches()
+{
+  synchronized (mutex) {
+    addSlaveCalls.reset();
+    recoverResourcesCalls.reset();
+  }
+}
+
 } // namespace allocator {
 } // namespace master {
 } // namespace internal {
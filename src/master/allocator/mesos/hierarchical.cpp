@@ -27,6 +27,7 @@
 #include <mesos/type_utils.hpp>
 
 #include <process/after.hpp>
+#include <process/clock.hpp>
 #include <process/delay.hpp>
 #include <process/dispatch.hpp>
 #include <process/event.hpp>
@@ -51,6 +52,7 @@ using mesos::allocator::InverseOfferStatus;
 using mesos::allocator::Options;
 
 using process::after;
+using process::Clock;
 using process::Continue;
 using process::ControlFlow;
 using process::Failure;
@@ -186,7 +188,8 @@ void HierarchicalAllocatorProcess::initialize(
         return after(allocationInterval);
       },
       [_self](const Nothing&) {
-        return dispatch(_self, &HierarchicalAllocatorProcess::allocate)
+        return dispatch(
+            _self, &HierarchicalAllocatorProcess::periodicAllocation)
           .then([]() -> ControlFlow<Nothing> { return Continue(); });
       });
 }
@@ -338,6 +341,10 @@ void HierarchicalAllocatorProcess::removeFramework(
                  const Resources& allocated,
                  allocation) {
       untrackAllocatedResources(slaveId, frameworkId, allocated);
+
+      if (slaves.contains(slaveId)) {
+        dirtySlaves.insert(slaveId);
+      }
     }
 
     untrackFrameworkUnderRole(frameworkId, role);
@@ -516,6 +523,9 @@ void HierarchicalAllocatorProcess::updateFramework(
   framework.roles = newRoles;
   framework.suppressedRoles = suppressedRoles;
   framework.capabilities = frameworkInfo.capabilities();
+
+  // The framework might now be able to receive resources on any agent.
+  allSlavesDirty = true;
 }
 
 
@@ -635,6 +645,7 @@ void HierarchicalAllocatorProcess::removeSlave(
 
   slaves.erase(slaveId);
   allocationCandidates.erase(slaveId);
+  dirtySlaves.erase(slaveId);
 
   // Note that we DO NOT actually delete any filters associated with
   // this slave, that will occur when the delayed
@@ -766,6 +777,8 @@ void HierarchicalAllocatorProcess::removeFilters(const SlaveID& slaveId)
     }
   }
 
+  dirtySlaves.insert(slaveId);
+
   LOG(INFO) << "Removed all filters for agent " << slaveId;
 }
 
@@ -777,6 +790,7 @@ void HierarchicalAllocatorProcess::activateSlave(
   CHECK(slaves.contains(slaveId));
 
   slaves.at(slaveId).activated = true;
+  dirtySlaves.insert(slaveId);
 
   LOG(INFO) << "Agent " << slaveId << " reactivated";
 }
@@ -800,6 +814,7 @@ void HierarchicalAllocatorProcess::updateWhitelist(
   CHECK(initialized);
 
   whitelist = _whitelist;
+  allSlavesDirty = true;
 
   if (whitelist.isSome()) {
     LOG(INFO) << "Updated agent whitelist: " << stringify(whitelist.get());
@@ -873,6 +888,7 @@ void HierarchicalAllocatorProcess::updateAllocation(
   // Update the per-slave allocation.
   slave.unallocate(offeredResources);
   slave.allocate(updatedOfferedResources);
+  dirtySlaves.insert(slaveId);
 
   // Update the allocation in the framework sorter.
   frameworkSorter->update(
@@ -1073,6 +1089,7 @@ void HierarchicalAllocatorProcess::updateInverseOffer(
     // We always remove the outstanding offer so that we will send a new offer
     // out the next time we schedule inverse offers.
     maintenance.offersOutstanding.erase(frameworkId);
+    dirtySlaves.insert(slaveId);
 
     // If the response is `Some`, this means the framework responded. Otherwise
     // if it is `None` the inverse offer timed out or was rescinded.
@@ -1226,6 +1243,7 @@ void HierarchicalAllocatorProcess::recoverResources(
       << slave.getAllocated() << " does not contain " << resources;
 
     slave.unallocate(resources);
+    dirtySlaves.insert(slaveId);
 
     VLOG(1) << "Recovered " << resources
             << " (total: " << slave.getTotal()
@@ -1414,6 +1432,8 @@ void HierarchicalAllocatorProcess::setQuota(
 
   metrics.setQuota(role, quota);
 
+  allSlavesDirty = true;
+
   // TODO(alexr): Print all quota info for the role.
   LOG(INFO) << "Set quota " << quota.info.guarantee() << " for role '" << role
             << "'";
@@ -1446,6 +1466,8 @@ void HierarchicalAllocatorProcess::removeQuota(
 
   metrics.removeQuota(role);
 
+  allSlavesDirty = true;
+
   // NOTE: Since quota changes do not result in rebalancing of
   // offered resources, we do not trigger an allocation here; the
   // quota change will be reflected in subsequent allocations.
@@ -1467,6 +1489,8 @@ void HierarchicalAllocatorProcess::updateWeights(
     roleSorter->updateWeight(weightInfo.role(), weightInfo.weight());
   }
 
+  allSlavesDirty = true;
+
   // NOTE: Since weight changes do not result in rebalancing of
   // offered resources, we do not trigger an allocation here; the
   // weight change will be reflected in subsequent allocations.
@@ -1492,6 +1516,10 @@ void HierarchicalAllocatorProcess::resume()
     VLOG(1) << "Allocation resumed";
 
     paused = false;
+
+    // Changes made while the allocation was paused were not recorded
+    // as allocation candidates.
+    allSlavesDirty = true;
   }
 }
 
@@ -1502,6 +1530,46 @@ Future<Nothing> HierarchicalAllocatorProcess::allocate()
 }
 
 
+Future<Nothing> HierarchicalAllocatorProcess::periodicAllocation()
+{
+  // All agents are considered every `FULL_ALLOCATION_INTERVAL` as a
+  // safety net against changes which are not tracked as dirty agents.
+  bool full = allSlavesDirty ||
+    lastFullAllocation.isNone() ||
+    Clock::now() - lastFullAllocation.get() >= FULL_ALLOCATION_INTERVAL;
+
+  // With quota, the resources which can be allocated on an agent
+  // depend on the resources available on the other agents (see the
+  // headroom in `__allocate()`), so a change on one agent can affect
+  // the allocation on all of them.
+  if (!quotas.empty() && !dirtySlaves.empty()) {
+    full = true;
+  }
+
+  if (full) {
+    return allocate();
+  }
+
+  hashset<SlaveID> slaveIds = dirtySlaves;
+
+  // Inverse offers for agents with scheduled maintenance are
+  // (re-)sent by the allocation, see `deallocate()`.
+  foreachpair (const SlaveID& slaveId, const Slave& slave, slaves) {
+    if (slave.maintenance.isSome()) {
+      slaveIds.insert(slaveId);
+    }
+  }
+
+  if (slaveIds.empty()) {
+    VLOG(2) << "Skipped allocation because no agent has changed";
+
+    return Nothing();
+  }
+
+  return allocate(slaveIds);
+}
+
+
 Future<Nothing> HierarchicalAllocatorProcess::allocate(
     const SlaveID& slaveId)
 {
@@ -1558,6 +1626,17 @@ Nothing HierarchicalAllocatorProcess::_allocate()
   VLOG(1) << "Performed allocation for " << allocationCandidates.size()
           << " agents in " << stopwatch.elapsed();
 
+  // The candidates are a subset of the known agents, see `removeSlave()`.
+  if (allocationCandidates.size() == slaves.size()) {
+    dirtySlaves.clear();
+    allSlavesDirty = false;
+    lastFullAllocation = Clock::now();
+  } else {
+    foreach (const SlaveID& slaveId, allocationCandidates) {
+      dirtySlaves.erase(slaveId);
+    }
+  }
+
   // Clear the candidates on completion of the allocation run.
   allocationCandidates.clear();
 
@@ -1582,14 +1661,50 @@ void HierarchicalAllocatorProcess::__allocate()
   vector<SlaveID> slaveIds;
   slaveIds.reserve(allocationCandidates.size());
 
+  // Determine once whether any framework can receive resources from
+  // agents with GPUs or in remote regions, so that such agents can be
+  // skipped below rather than checked against every framework (see
+  // `isCapableOfReceivingAgent()`).
+  bool gpuCapableFrameworks = false;
+  bool regionAwareFrameworks = false;
+
+  foreachvalue (const Framework& framework, frameworks) {
+    gpuCapableFrameworks |= framework.capabilities.gpuResources;
+    regionAwareFrameworks |= framework.capabilities.regionAware;
+  }
+
   // Filter out non-whitelisted, removed, and deactivated slaves
   // in order not to send offers for them.
+  //
+  // We also filter out the slaves which cannot be allocated from in
+  // this cycle: those whose available resources are not allocatable
+  // (e.g., fully allocated slaves), since the resources allocated
+  // below are always a subset of the available resources, and those
+  // which no framework is capable of receiving.
   foreach (const SlaveID& slaveId, allocationCandidates) {
-    if (isWhitelisted(slaveId) &&
-        slaves.contains(slaveId) &&
-        slaves.at(slaveId).activated) {
-      slaveIds.push_back(slaveId);
+    if (!isWhitelisted(slaveId) ||
+        !slaves.contains(slaveId) ||
+        !slaves.at(slaveId).activated) {
+      continue;
+    }
+
+    const Slave& slave = slaves.at(slaveId);
+
+    if (!allocatable(slave.getAvailable())) {
+      continue;
     }
+
+    if (options.filterGpuResources &&
+        slave.hasGpu() &&
+        !gpuCapableFrameworks) {
+      continue;
+    }
+
+    if (!regionAwareFrameworks && isRemoteSlave(slave)) {
+      continue;
+    }
+
+    slaveIds.push_back(slaveId);
   }
 
   // Randomize the order in which slaves' resources are allocated.
@@ -2261,6 +2376,10 @@ void HierarchicalAllocatorProcess::_expire(
     }
   }
 
+  if (slaves.contains(slaveId)) {
+    dirtySlaves.insert(slaveId);
+  }
+
   delete offerFilter;
 }
 
@@ -2309,6 +2428,10 @@ void HierarchicalAllocatorProcess::expire(
     }
   }
 
+  if (slaves.contains(slaveId)) {
+    dirtySlaves.insert(slaveId);
+  }
+
   delete inverseOfferFilter;
 }
 
@@ -2627,6 +2750,7 @@ bool HierarchicalAllocatorProcess::updateSlaveTotal(
   }
 
   slave.updateTotal(total);
+  dirtySlaves.insert(slaveId);
 
   hashmap<std::string, Resources> oldReservations = oldTotal.reservations();
   hashmap<std::string, Resources> newReservations = total.reservations();
@@ -25,6 +25,7 @@
 #include <process/future.hpp>
 #include <process/id.hpp>
 #include <process/owned.hpp>
+#include <process/time.hpp>
 
 #include <stout/boundedhashmap.hpp>
 #include <stout/duration.hpp>
@@ -273,6 +274,7 @@ public:
       const std::function<Sorter*()>& quotaRoleSorterFactory)
     : initialized(false),
       paused(true),
+      allSlavesDirty(true),
       metrics(*this),
       completedFrameworkMetrics(0),
       roleSorter(roleSorterFactory()),
@@ -417,6 +419,11 @@ protected:
   typedef HierarchicalAllocatorProcess Self;
   typedef HierarchicalAllocatorProcess This;
 
+  // Allocate any allocatable resources from the agents which are
+  // dirty, i.e., on which the allocation may have changed since they
+  // were last allocated. This is run every allocation interval.
+  process::Future<Nothing> periodicAllocation();
+
   // Allocate any allocatable resources from all known agents.
   process::Future<Nothing> allocate();
 
@@ -477,6 +484,18 @@ protected:
   bool initialized;
   bool paused;
 
+  // Agents on which the allocation may have changed since they were
+  // last allocated, e.g., because resources were recovered or offer
+  // filters expired on them. Changes which may affect the allocation
+  // on any agent, e.g., quota or weight changes, are tracked with
+  // `allSlavesDirty` instead. Changes which trigger an allocation
+  // right away (e.g., `addFramework()`) are not tracked.
+  hashset<SlaveID> dirtySlaves;
+  bool allSlavesDirty;
+
+  // The last time the allocation considered all known agents.
+  Option<process::Time> lastFullAllocation;
+
   mesos::allocator::Options options;
 
   // Recovery data.
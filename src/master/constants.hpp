@@ -55,6 +55,15 @@ constexpr Bytes MIN_MEM = Megabytes(32);
 // layer.
 constexpr Duration DEFAULT_AUTHENTICATION_V0_TIMEOUT = Seconds(15);
 
+// Default duration for which the master reuses the object approvers
+// of a principal across HTTP requests, when the default (local)
+// authorizer is used.
+constexpr Duration DEFAULT_OBJECT_APPROVERS_CACHE_TTL = Seconds(10);
+
+// Maximum number of object approvers (per principal and action) which
+// the master keeps cached.
+constexpr size_t MAX_CACHED_OBJECT_APPROVERS = 10000;
+
 // Default interval the master uses to send heartbeats to an HTTP
 // scheduler.
 constexpr Duration DEFAULT_HEARTBEAT_INTERVAL = Seconds(15);
@@ -112,6 +121,26 @@ constexpr Duration WHITELIST_WATCH_INTERVAL = Seconds(5);
 // Default number of tasks (limit) for /master/tasks endpoint.
 constexpr size_t TASK_LIMIT = 100;
 
+// Maximum number of scheduler calls and status updates the master
+// serves in a row while other events are queued.
+constexpr size_t CONTROL_EVENTS_WEIGHT = 10;
+
+// Number of tasks of an `ACCEPT` call which are validated together
+// off the master actor.
+constexpr size_t TASK_VALIDATION_BATCH_SIZE = 100;
+
+// Number of reregistering agents whose messages are validated together
+// off the master actor.
+constexpr size_t AGENT_REREGISTRATION_BATCH_SIZE = 50;
+
+// Maximum number of tasks in a single record of a streamed
+// `GET_STATE` response.
+constexpr size_t STREAMED_STATE_TASKS_PER_RECORD = 1000;
+
+// Maximum number of offers in a single `OFFERS` event sent to an
+// HTTP framework.
+constexpr size_t MAX_OFFERS_PER_EVENT = 1000;
+
 constexpr Duration DEFAULT_REGISTRY_GC_INTERVAL = Minutes(15);
 
 constexpr Duration DEFAULT_REGISTRY_MAX_AGENT_AGE = Weeks(2);
@@ -145,6 +174,11 @@ constexpr char DEFAULT_ALLOCATOR[] = "hierarchical";
 // The default interval between allocations.
 constexpr Duration DEFAULT_ALLOCATION_INTERVAL = Seconds(1);
 
+// Interval at which the periodic allocation considers all agents
+// rather than only the agents on which the allocation may have
+// changed since the last allocation.
+constexpr Duration FULL_ALLOCATION_INTERVAL = Minutes(1);
+
 // Name of the default, local authorizer.
 constexpr char DEFAULT_AUTHORIZER[] = "local";
 
@@ -557,6 +557,18 @@ mesos::internal::master::Flags::Flags()
       "Currently there is no support for multiple authorizers.",
       DEFAULT_AUTHORIZER);
 
+  add(&Flags::object_approvers_cache_ttl,
+      "object_approvers_cache_ttl",
+      "Duration for which the master reuses the object approvers created\n"
+      "by the authorizer for a principal across HTTP requests, instead of\n"
+      "creating new approvers for every request. This bounds how long it\n"
+      "takes for changes in the decisions of an authorizer module to be\n"
+      "observed by the master's HTTP endpoints. Set to zero to disable\n"
+      "the cache. If not set, the cache is only enabled for the default\n"
+      "`" + string(DEFAULT_AUTHORIZER) + "` authorizer, whose ACLs cannot\n"
+      "change at runtime, with a TTL of " +
+      stringify(DEFAULT_OBJECT_APPROVERS_CACHE_TTL) + ".");
+
   add(&Flags::http_authenticators,
       "http_authenticators",
       "HTTP authenticator implementation to use when handling requests to\n"
@@ -599,6 +611,15 @@ mesos::internal::master::Flags::Flags()
       "Maximum number of completed tasks per framework to store in memory.",
       DEFAULT_MAX_COMPLETED_TASKS_PER_FRAMEWORK);
 
+  add(&Flags::compress_completed_tasks,
+      "compress_completed_tasks",
+      "Whether the master should compress the completed tasks it keeps\n"
+      "in memory. Completed tasks are always stored serialized and are\n"
+      "only decoded when they are queried; compressing them further\n"
+      "reduces the memory used at the expense of CPU time when the\n"
+      "state endpoints are queried.",
+      false);
+
   add(&Flags::max_unreachable_tasks_per_framework,
       "max_unreachable_tasks_per_framework",
       "Maximum number of unreachable tasks per framework to store in memory.",
@@ -88,11 +88,13 @@ public:
   Duration agent_ping_timeout;
   size_t max_agent_ping_timeouts;
   std::string authorizers;
+  Option<Duration> object_approvers_cache_ttl;
   std::string http_authenticators;
   Option<std::string> http_framework_authenticators;
   size_t max_operator_event_stream_subscribers;
   size_t max_completed_frameworks;
   size_t max_completed_tasks_per_framework;
+  bool compress_completed_tasks;
   size_t max_unreachable_tasks_per_framework;
   Option<std::string> master_contender;
   Option<std::string> master_detector;
@@ -14,6 +14,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string>
+
+#include <stout/check.hpp>
+#include <stout/gzip.hpp>
+#include <stout/try.hpp>
+
 #include "master/master.hpp"
 
 #include "common/heartbeater.hpp"
@@ -23,6 +29,47 @@ namespace mesos {
 namespace internal {
 namespace master {
 
+CompletedTask::CompletedTask(const Task& task, bool compress)
+  : slaveId(task.slave_id()),
+    state(task.state()),
+    compressed(false)
+{
+  CHECK(task.SerializeToString(&data));
+
+  if (compress) {
+    Try<std::string> compressed_ = gzip::compress(data);
+
+    // Small tasks can grow when compressed, in which case we keep
+    // them uncompressed.
+    if (compressed_.isError()) {
+      LOG(WARNING) << "Failed to compress completed task "
+                   << task.task_id() << ": " << compressed_.error();
+    } else if (compressed_->size() < data.size()) {
+      data = std::move(compressed_.get());
+      compressed = true;
+    }
+  }
+
+  data.shrink_to_fit();
+}
+
+
+Task CompletedTask::get() const
+{
+  Task task;
+
+  if (compressed) {
+    Try<std::string> decompressed = gzip::decompress(data);
+    CHECK_SOME(decompressed);
+    CHECK(task.ParseFromString(decompressed.get()));
+  } else {
+    CHECK(task.ParseFromString(data));
+  }
+
+  return task;
+}
+
+
 Framework::Framework(
     Master* const master,
     const Flags& masterFlags,
@@ -70,7 +117,8 @@ Framework::Framework(
     reregisteredTime(time),
     completedTasks(masterFlags.max_completed_tasks_per_framework),
     unreachableTasks(masterFlags.max_unreachable_tasks_per_framework),
-    metrics(_info, masterFlags.publish_per_framework_metrics)
+    metrics(_info, masterFlags.publish_per_framework_metrics),
+    compressCompletedTasks(masterFlags.compress_completed_tasks)
 {
   CHECK(_info.has_id());
 
@@ -196,14 +244,15 @@ void Framework::recoverResources(Task* task)
 }
 
 
-void Framework::addCompletedTask(Task&& task)
+void Framework::addCompletedTask(const Task& task)
 {
   // TODO(neilc): We currently allow frameworks to reuse the task
   // IDs of completed tasks (although this is discouraged). This
   // means that there might be multiple completed tasks with the
   // same task ID. We should consider rejecting attempts to reuse
   // task IDs (MESOS-6779).
-  completedTasks.push_back(process::Owned<Task>(new Task(std::move(task))));
+  completedTasks.push_back(process::Owned<CompletedTask>(
+      new CompletedTask(task, compressCompletedTasks)));
 }
 
 
@@ -234,7 +283,7 @@ void Framework::removeTask(Task* task, bool unreachable)
 
     // TODO(bmahler): This moves a potentially non-terminal task into
     // the completed list!
-    addCompletedTask(Task(*task));
+    addCompletedTask(*task);
   }
 
   tasks.erase(task->task_id());
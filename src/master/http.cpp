@@ -264,12 +264,32 @@ Future<Response> Master::Http::api(
     acceptType = ContentType::JSON;
   } else if (request.acceptsMediaType(APPLICATION_PROTOBUF)) {
     acceptType = ContentType::PROTOBUF;
+  } else if (call.type() == mesos::master::Call::GET_STATE &&
+             request.acceptsMediaType(APPLICATION_RECORDIO)) {
+    acceptType = ContentType::RECORDIO;
   } else {
     return NotAcceptable(
         string("Expecting 'Accept' to allow ") +
         "'" + APPLICATION_PROTOBUF + "' or '" + APPLICATION_JSON + "'");
   }
 
+  // The state can be streamed as a sequence of RecordIO encoded
+  // messages, the media type of which is negotiated separately.
+  Option<ContentType> messageAcceptType;
+  if (streamingMediaType(acceptType)) {
+    // Note that `acceptsMediaType()` returns true if the given headers
+    // field does not exist, i.e. by default we return JSON here.
+    if (request.acceptsMediaType(MESSAGE_ACCEPT, APPLICATION_JSON)) {
+      messageAcceptType = ContentType::JSON;
+    } else if (request.acceptsMediaType(MESSAGE_ACCEPT, APPLICATION_PROTOBUF)) {
+      messageAcceptType = ContentType::PROTOBUF;
+    } else {
+      return NotAcceptable(
+          string("Expecting '") + MESSAGE_ACCEPT + "' to allow " +
+          APPLICATION_JSON + " or " + APPLICATION_PROTOBUF);
+    }
+  }
+
   switch (call.type()) {
     case mesos::master::Call::UNKNOWN:
       return NotImplemented();
@@ -299,6 +319,11 @@ Future<Response> Master::Http::api(
       return readFile(call, principal, acceptType);
 
     case mesos::master::Call::GET_STATE:
+      if (streamingMediaType(acceptType)) {
+        CHECK_SOME(messageAcceptType);
+        return streamState(call, principal, messageAcceptType.get());
+      }
+
       return getState(call, principal, acceptType);
 
     case mesos::master::Call::GET_AGENTS:
@@ -418,7 +443,7 @@ Future<Response> Master::Http::subscribe(
           mesos::master::Event event;
           event.set_type(mesos::master::Event::SUBSCRIBED);
           *event.mutable_subscribed()->mutable_get_state() =
-            _getState(approvers);
+            _getState(approvers, mesos::master::Call::GetState());
 
           event.mutable_subscribed()->set_heartbeat_interval_seconds(
               DEFAULT_HEARTBEAT_INTERVAL.secs());
@@ -1463,7 +1488,8 @@ Future<Response> Master::Http::getState(
           mesos::master::Response response;
           response.set_type(mesos::master::Response::GET_STATE);
 
-          *response.mutable_get_state() = _getState(approvers);
+          *response.mutable_get_state() =
+            _getState(approvers, call.get_state());
 
           return OK(
               serialize(contentType, evolve(response)), stringify(contentType));
@@ -1472,24 +1498,118 @@ Future<Response> Master::Http::getState(
 
 
 mesos::master::Response::GetState Master::Http::_getState(
-    const Owned<ObjectApprovers>& approvers) const
+    const Owned<ObjectApprovers>& approvers,
+    const mesos::master::Call::GetState& query,
+    const Option<lambda::function<
+        void(mesos::master::Response::GetState*)>>& flush) const
 {
   // NOTE: This function must be blocking instead of returning a
   // `Future`. This is because `subscribe()` needs to atomically
   // add subscriber to `subscribers` map and send the captured state
   // in `SUBSCRIBED` without being interleaved by any other events.
 
+  // Only the parts of the state in the field mask are computed.
+  const set<string> fields(query.fields().begin(), query.fields().end());
+
+  auto included = [&fields](const string& field) {
+    return fields.empty() || fields.count(field) > 0;
+  };
+
   mesos::master::Response::GetState getState;
 
-  *getState.mutable_get_tasks() = _getTasks(approvers);
-  *getState.mutable_get_executors() = _getExecutors(approvers);
-  *getState.mutable_get_frameworks() = _getFrameworks(approvers);
-  *getState.mutable_get_agents() = _getAgents(approvers);
+  // When streaming, each part of the state is flushed as soon as it
+  // has been computed, and the tasks are flushed in batches.
+  auto flushed = [&flush, &getState]() {
+    if (flush.isSome()) {
+      flush.get()(&getState);
+      getState.Clear();
+    }
+  };
+
+  if (included("get_tasks")) {
+    if (flush.isSome()) {
+      _getTasks(
+          approvers,
+          query.get_tasks(),
+          [&flush](mesos::master::Response::GetTasks* getTasks) {
+            mesos::master::Response::GetState part;
+            part.mutable_get_tasks()->Swap(getTasks);
+            flush.get()(&part);
+          });
+    } else {
+      *getState.mutable_get_tasks() = _getTasks(approvers, query.get_tasks());
+    }
+  }
+
+  if (included("get_executors")) {
+    *getState.mutable_get_executors() = _getExecutors(approvers);
+    flushed();
+  }
+
+  if (included("get_frameworks")) {
+    *getState.mutable_get_frameworks() = _getFrameworks(approvers);
+    flushed();
+  }
+
+  if (included("get_agents")) {
+    *getState.mutable_get_agents() = _getAgents(approvers);
+    flushed();
+  }
 
   return getState;
 }
 
 
+Future<Response> Master::Http::streamState(
+    const mesos::master::Call& call,
+    const Option<Principal>& principal,
+    ContentType messageContentType) const
+{
+  CHECK_EQ(mesos::master::Call::GET_STATE, call.type());
+
+  return ObjectApprovers::create(
+      master->authorizer,
+      principal,
+      {VIEW_FRAMEWORK, VIEW_TASK, VIEW_EXECUTOR, VIEW_ROLE})
+    .then(defer(
+        master->self(),
+        [=](const Owned<ObjectApprovers>& approvers) -> Response {
+          Pipe pipe;
+          OK ok;
+
+          ok.headers["Content-Type"] = APPLICATION_RECORDIO;
+          ok.headers[MESSAGE_CONTENT_TYPE] = stringify(messageContentType);
+          ok.type = Response::PIPE;
+          ok.reader = pipe.reader();
+
+          StreamingHttpConnection<v1::master::Response> http(
+              pipe.writer(), messageContentType);
+
+          // NOTE: The whole state is written in a single turn of the
+          // master actor, so the records form a consistent snapshot.
+          // Each part is encoded and dropped before the next part is
+          // computed. However, the pipe has no backpressure, so all
+          // the encoded records are buffered until the client reads
+          // them, i.e., the peak memory is still proportional to the
+          // size of the state.
+          _getState(
+              approvers,
+              call.get_state(),
+              [&http](mesos::master::Response::GetState* getState) {
+                mesos::master::Response response;
+                response.set_type(mesos::master::Response::GET_STATE);
+                response.mutable_get_state()->Swap(getState);
+
+                http.send(response);
+              });
+
+          http.close();
+
+          return ok;
+        }));
+}
+
+
 class Master::Http::FlagsError : public Error
 {
 public:
@@ -2435,8 +2555,22 @@ void Master::Http::processRequestsBatch() const
   CHECK(!batchedRequests.empty())
     << "Bug in state batching logic: No requests to process";
 
-  // Produce the responses in parallel.
+  // Take a view of the master state once for the whole batch. The
+  // responses are then produced in parallel from the view, so the
+  // master actor does not need to wait for them and can continue
+  // to process events while the responses are being rendered.
   //
+  // The view only copies the state rendered by the handlers of the
+  // batch, e.g., a batch of '/roles' requests does not copy the tasks.
+  vector<ReadOnlyRequestHandler> handlers;
+  handlers.reserve(batchedRequests.size());
+
+  foreach (const BatchedRequest& request, batchedRequests) {
+    handlers.push_back(request.handler);
+  }
+
+  const ReadOnlyHandler readonlyHandler(master, handlers);
+
   // TODO(alexr): Consider abstracting this into `parallel_async` or
   // `foreach_parallel`, see MESOS-8587.
   //
@@ -2444,9 +2578,10 @@ void Master::Http::processRequestsBatch() const
   // `process::async` once it supports moving.
   foreach (BatchedRequest& request, batchedRequests) {
     request.promise.associate(process::async(
-        [this](ReadOnlyRequestHandler handler,
-               const hashmap<std::string, std::string>& queryParameters,
-               const process::Owned<ObjectApprovers>& approvers) {
+        [readonlyHandler](
+            ReadOnlyRequestHandler handler,
+            const hashmap<std::string, std::string>& queryParameters,
+            const process::Owned<ObjectApprovers>& approvers) {
           return (readonlyHandler.*handler)(queryParameters, approvers);
         },
         request.handler,
@@ -2454,18 +2589,8 @@ void Master::Http::processRequestsBatch() const
         request.approvers));
   }
 
-  // Block the master actor until all workers have generated state responses.
-  // It is crucial not to allow the master actor to continue and possibly
-  // modify its state while a worker is reading it.
-  //
-  // NOTE: There is the potential for deadlock since we are blocking 1 working
-  // thread here, see MESOS-8256.
-  vector<Future<Response>> responses;
-  foreach (const BatchedRequest& request, batchedRequests) {
-    responses.push_back(request.promise.future());
-  }
-  process::await(responses).await();
-
+  // NOTE: The promises have been associated with the futures returned
+  // by `async`, so destroying them does not abandon the responses.
   batchedRequests.clear();
 }
 
@@ -3029,7 +3154,8 @@ Future<Response> Master::Http::getTasks(
           mesos::master::Response response;
           response.set_type(mesos::master::Response::GET_TASKS);
 
-          *response.mutable_get_tasks() = _getTasks(approvers);
+          *response.mutable_get_tasks() =
+            _getTasks(approvers, call.get_tasks());
 
           return OK(
               serialize(contentType, evolve(response)), stringify(contentType));
@@ -3038,13 +3164,50 @@ Future<Response> Master::Http::getTasks(
 
 
 mesos::master::Response::GetTasks Master::Http::_getTasks(
-    const Owned<ObjectApprovers>& approvers) const
+    const Owned<ObjectApprovers>& approvers,
+    const mesos::master::Call::GetTasks& query,
+    const Option<lambda::function<
+        void(mesos::master::Response::GetTasks*)>>& flush) const
 {
+  const hashset<FrameworkID> frameworkIds(
+      set<FrameworkID>(query.framework_ids().begin(),
+                       query.framework_ids().end()));
+
+  const hashset<SlaveID> slaveIds(
+      set<SlaveID>(query.slave_ids().begin(), query.slave_ids().end()));
+
+  const hashset<string> roles(
+      set<string>(query.roles().begin(), query.roles().end()));
+
+  // Returns whether a task on `slaveId` with `resources` matches the
+  // agent and role filters of the query.
+  auto matches = [&slaveIds, &roles](
+      const SlaveID& slaveId,
+      const RepeatedPtrField<Resource>& resources) {
+    if (!slaveIds.empty() && !slaveIds.contains(slaveId)) {
+      return false;
+    }
+
+    if (roles.empty()) {
+      return true;
+    }
+
+    foreach (const Resource& resource, resources) {
+      if (resource.has_allocation_info() &&
+          roles.contains(resource.allocation_info().role())) {
+        return true;
+      }
+    }
+
+    return false;
+  };
+
   // Construct framework list with both active and completed frameworks.
   vector<const Framework*> frameworks;
   foreachvalue (Framework* framework, master->frameworks.registered) {
-    // Skip unauthorized frameworks.
-    if (!approvers->approved<VIEW_FRAMEWORK>(framework->info)) {
+    // Skip unauthorized frameworks or frameworks which are filtered out.
+    if ((!frameworkIds.empty() && !frameworkIds.contains(framework->id())) ||
+        !approvers->approved<VIEW_FRAMEWORK>(framework->info)) {
       continue;
     }
 
@@ -3053,61 +3216,178 @@ mesos::master::Response::GetTasks Master::Http::_getTasks(
 
   foreachvalue (const Owned<Framework>& framework,
                 master->frameworks.completed) {
-    // Skip unauthorized frameworks.
-    if (!approvers->approved<VIEW_FRAMEWORK>(framework->info)) {
+    // Skip unauthorized frameworks or frameworks which are filtered out.
+    if ((!frameworkIds.empty() && !frameworkIds.contains(framework->id())) ||
+        !approvers->approved<VIEW_FRAMEWORK>(framework->info)) {
       continue;
     }
 
     frameworks.push_back(framework.get());
   }
 
+  // Page through the frameworks in a stable order, so that subsequent
+  // pages do not overlap as long as the tasks do not change.
+  const bool paged = query.has_offset() || query.has_limit();
+
+  if (paged) {
+    std::sort(
+        frameworks.begin(),
+        frameworks.end(),
+        [](const Framework* left, const Framework* right) {
+          return left->id() < right->id();
+        });
+  }
+
+  uint64_t skip = query.offset();
+  Option<uint64_t> remaining =
+    query.has_limit() ? Option<uint64_t>(query.limit()) : None();
+
+  // Returns whether the next matching task is on the requested page.
+  auto page = [&skip, &remaining]() {
+    if (skip > 0) {
+      --skip;
+      return false;
+    }
+
+    if (remaining.isSome()) {
+      if (remaining.get() == 0) {
+        return false;
+      }
+
+      remaining = remaining.get() - 1;
+    }
+
+    return true;
+  };
+
+  auto full = [&remaining]() {
+    return remaining.isSome() && remaining.get() == 0;
+  };
+
+  // The optional fields of `Task` which are not in the field mask.
+  vector<const google::protobuf::FieldDescriptor*> clearedFields;
+  if (query.fields_size() > 0) {
+    const set<string> fields(query.fields().begin(), query.fields().end());
+
+    const google::protobuf::Descriptor* descriptor = Task::descriptor();
+    for (int i = 0; i < descriptor->field_count(); i++) {
+      const google::protobuf::FieldDescriptor* field = descriptor->field(i);
+      if (!field->is_required() && fields.count(field->name()) == 0) {
+        clearedFields.push_back(field);
+      }
+    }
+  }
+
+  auto project = [&clearedFields](Task* task) {
+    const google::protobuf::Reflection* reflection = task->GetReflection();
+    foreach (const google::protobuf::FieldDescriptor* field, clearedFields) {
+      reflection->ClearField(task, field);
+    }
+  };
+
   mesos::master::Response::GetTasks getTasks;
 
-  vector<const Task*> tasks;
+  // Passes the gathered tasks to `flush` once there are enough of them.
+  size_t gathered = 0;
+  auto added = [&flush, &getTasks, &gathered]() {
+    if (flush.isSome() && ++gathered == STREAMED_STATE_TASKS_PER_RECORD) {
+      flush.get()(&getTasks);
+      getTasks.Clear();
+      gathered = 0;
+    }
+  };
+
   foreach (const Framework* framework, frameworks) {
+    if (full()) {
+      break;
+    }
+
     // Pending tasks.
     foreachvalue (const TaskInfo& taskInfo, framework->pendingTasks) {
-      // Skip unauthorized tasks.
-      if (!approvers->approved<VIEW_TASK>(taskInfo, framework->info)) {
+      if (full()) {
+        break;
+      }
+
+      // Skip unauthorized tasks or tasks which are filtered out.
+      if (!matches(taskInfo.slave_id(), taskInfo.resources()) ||
+          !approvers->approved<VIEW_TASK>(taskInfo, framework->info) ||
+          !page()) {
         continue;
       }
 
-      *getTasks.add_pending_tasks() =
-        protobuf::createTask(taskInfo, TASK_STAGING, framework->id());
+      Task* task = getTasks.add_pending_tasks();
+      *task = protobuf::createTask(taskInfo, TASK_STAGING, framework->id());
+      project(task);
+      added();
     }
 
     // Active tasks.
     foreachvalue (Task* task, framework->tasks) {
+      if (full()) {
+        break;
+      }
+
       CHECK_NOTNULL(task);
-      // Skip unauthorized tasks.
-      if (!approvers->approved<VIEW_TASK>(*task, framework->info)) {
+      // Skip unauthorized tasks or tasks which are filtered out.
+      if (!matches(task->slave_id(), task->resources()) ||
+          !approvers->approved<VIEW_TASK>(*task, framework->info) ||
+          !page()) {
         continue;
       }
 
-      getTasks.add_tasks()->CopyFrom(*task);
+      Task* copy = getTasks.add_tasks();
+      copy->CopyFrom(*task);
+      project(copy);
+      added();
     }
 
     // Unreachable tasks.
     foreachvalue (const Owned<Task>& task, framework->unreachableTasks) {
-      // Skip unauthorized tasks.
-      if (!approvers->approved<VIEW_TASK>(*task, framework->info)) {
+      if (full()) {
+        break;
+      }
+
+      // Skip unauthorized tasks or tasks which are filtered out.
+      if (!matches(task->slave_id(), task->resources()) ||
+          !approvers->approved<VIEW_TASK>(*task, framework->info) ||
+          !page()) {
         continue;
       }
 
-      getTasks.add_unreachable_tasks()->CopyFrom(*task);
+      Task* copy = getTasks.add_unreachable_tasks();
+      copy->CopyFrom(*task);
+      project(copy);
+      added();
     }
 
-    // Completed tasks.
-    foreach (const Owned<Task>& task, framework->completedTasks) {
-      // Skip unauthorized tasks.
-      if (!approvers->approved<VIEW_TASK>(*task, framework->info)) {
+    // Completed tasks, which are decoded directly into the response.
+    foreach (const Owned<CompletedTask>& completedTask,
+             framework->completedTasks) {
+      if (full()) {
+        break;
+      }
+
+      Task* task = getTasks.add_completed_tasks();
+      *task = completedTask->get();
+
+      // Skip unauthorized tasks or tasks which are filtered out.
+      if (!matches(task->slave_id(), task->resources()) ||
+          !approvers->approved<VIEW_TASK>(*task, framework->info) ||
+          !page()) {
+        getTasks.mutable_completed_tasks()->RemoveLast();
         continue;
       }
 
-      getTasks.add_completed_tasks()->CopyFrom(*task);
+      project(task);
+      added();
     }
   }
 
+  if (flush.isSome() && gathered > 0) {
+    flush.get()(&getTasks);
+    getTasks.Clear();
+  }
+
   return getTasks;
 }
 
@@ -21,6 +21,7 @@
 #include <fstream>
 #include <functional>
 #include <iomanip>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <set>
@@ -43,6 +44,7 @@
 
 #include <mesos/scheduler/scheduler.hpp>
 
+#include <process/async.hpp>
 #include <process/check.hpp>
 #include <process/collect.hpp>
 #include <process/defer.hpp>
@@ -69,12 +71,15 @@
 #include <stout/option.hpp>
 #include <stout/path.hpp>
 #include <stout/stringify.hpp>
+#include <stout/synchronized.hpp>
 #include <stout/unreachable.hpp>
 #include <stout/utils.hpp>
 #include <stout/uuid.hpp>
 
 #include "authentication/cram_md5/authenticator.hpp"
 
+#include "authorizer/caching_authorizer.hpp"
+
 #include "common/authorization.hpp"
 #include "common/build.hpp"
 #include "common/http.hpp"
@@ -99,6 +104,7 @@
 #include "watcher/whitelist_watcher.hpp"
 
 using std::list;
+using std::pair;
 using std::reference_wrapper;
 using std::set;
 using std::shared_ptr;
@@ -107,7 +113,9 @@ using std::tie;
 using std::tuple;
 using std::vector;
 
+using process::async;
 using process::await;
+using process::collect;
 using process::wait; // Necessary on some OS's to disambiguate.
 using process::Clock;
 using process::ExitedEvent;
@@ -306,6 +314,25 @@ private:
 };
 
 
+// Returns the duration for which the master reuses object approvers,
+// if any. Unless configured otherwise, approvers are only reused for
+// the local authorizer, as authorizer modules may revoke permissions
+// at any time.
+static Option<Duration> objectApproversCacheTtl(const Flags& flags)
+{
+  Duration ttl = flags.object_approvers_cache_ttl.getOrElse(
+      flags.authorizers == DEFAULT_AUTHORIZER
+        ? DEFAULT_OBJECT_APPROVERS_CACHE_TTL
+        : Duration::zero());
+
+  if (ttl <= Duration::zero()) {
+    return None();
+  }
+
+  return ttl;
+}
+
+
 Master::Master(
     Allocator* _allocator,
     Registrar* _registrar,
@@ -323,7 +350,17 @@ Master::Master(
     files(_files),
     contender(_contender),
     detector(_detector),
-    authorizer(_authorizer),
+    cachingAuthorizer(
+        _authorizer.isSome() && objectApproversCacheTtl(_flags).isSome()
+          ? Option<Owned<Authorizer>>(Owned<Authorizer>(new CachingAuthorizer(
+                _authorizer.get(),
+                objectApproversCacheTtl(_flags).get(),
+                MAX_CACHED_OBJECT_APPROVERS)))
+          : None()),
+    authorizer(
+        cachingAuthorizer.isSome()
+          ? Option<Authorizer*>(cachingAuthorizer->get())
+          : _authorizer),
     frameworks(flags),
     subscribers(this, flags.max_operator_event_stream_subscribers),
     authenticator(None()),
@@ -332,6 +369,67 @@ Master::Master(
 {
   slaves.limiter = _slaveRemovalLimiter;
 
+  // Scheduler calls and status updates are served ahead of the bulk of
+  // the master's work (e.g., agent reregistrations, operator requests
+  // and dispatches), so that e.g. `KILL` and `ACKNOWLEDGE` calls are
+  // not held up by a reregistration storm or a flood of '/state'
+  // requests.
+  //
+  // NOTE: Events are only served in order within their class. All the
+  // messages and calls of schedulers are therefore in the same class,
+  // together with the `ExitedEvent`s of frameworks which are ordered
+  // with respect to them. The `ExitedEvent`s of agents stay in the
+  // default class, so that they are not handled before a preceding
+  // (re-)registration of the agent. A status update which overtakes
+  // the reregistration of its agent is ignored and retried by the
+  // agent.
+  {
+    const hashset<string> messages = {
+      scheduler::Call().GetTypeName(),
+      SubmitSchedulerRequest().GetTypeName(),
+      RegisterFrameworkMessage().GetTypeName(),
+      ReregisterFrameworkMessage().GetTypeName(),
+      UnregisterFrameworkMessage().GetTypeName(),
+      DeactivateFrameworkMessage().GetTypeName(),
+      ResourceRequestMessage().GetTypeName(),
+      LaunchTasksMessage().GetTypeName(),
+      ReviveOffersMessage().GetTypeName(),
+      KillTaskMessage().GetTypeName(),
+      StatusUpdateAcknowledgementMessage().GetTypeName(),
+      FrameworkToExecutorMessage().GetTypeName(),
+      ReconcileTasksMessage().GetTypeName(),
+      StatusUpdateMessage().GetTypeName(),
+      UpdateOperationStatusMessage().GetTypeName()
+    };
+
+    const string schedulerPath = "/" + self().id + "/api/v1/scheduler";
+    const shared_ptr<LinkedFrameworks> linkedFrameworks =
+      this->linkedFrameworks;
+
+    prioritize(
+        {CONTROL_EVENTS_WEIGHT, 1},
+        [messages, schedulerPath, linkedFrameworks](
+            const process::Event& event) -> size_t {
+          bool control = false;
+
+          if (event.is<MessageEvent>()) {
+            control =
+              messages.contains(event.as<MessageEvent>().message.name);
+          } else if (event.is<process::HttpEvent>()) {
+            control =
+              event.as<process::HttpEvent>().request->url.path ==
+                schedulerPath;
+          } else if (event.is<ExitedEvent>()) {
+            synchronized (linkedFrameworks->mutex) {
+              control = linkedFrameworks->pids.contains(
+                  event.as<ExitedEvent>().pid);
+            }
+          }
+
+          return control ? 0 : 1;
+        });
+  }
+
   // NOTE: We populate 'info_' here instead of inside 'initialize()'
   // because 'StandaloneMasterDetector' needs access to the info.
 
@@ -1379,6 +1477,18 @@ Nothing Master::_agentReregisterTimeout(const SlaveID& slaveId)
 }
 
 
+void Master::linkFramework(const UPID& pid)
+{
+  // The PID is known to the event classifier before the link is
+  // established, so that its `ExitedEvent` is classified correctly.
+  synchronized (linkedFrameworks->mutex) {
+    linkedFrameworks->pids.insert(pid);
+  }
+
+  link(pid);
+}
+
+
 void Master::_exited(Framework* framework)
 {
   LOG(INFO) << "Framework " << *framework << " disconnected";
@@ -3088,7 +3198,7 @@ void Master::_subscribe(
 
       // Relink to the framework. This might be necessary if the
       // framework link previously broke.
-      link(framework->pid.get());
+      linkFramework(framework->pid.get());
 
       // Reactivate the framework.
       // NOTE: We do this after recovering resources (above) so that
@@ -3408,11 +3518,8 @@ void Master::suppress(
 }
 
 
-vector<string> Master::filterRoles(
-    const Owned<ObjectApprovers>& approvers) const
+set<string> Master::knownRoles() const
 {
-  JSON::Object object;
-
   // Compute the role names to return results for. When an explicit
   // role whitelist has been configured, we use that list of names.
   // When using implicit roles, the right behavior is a bit more
@@ -3438,6 +3545,15 @@ vector<string> Master::filterRoles(
     roleList.insert(quotas.begin(), quotas.end());
   }
 
+  return roleList;
+}
+
+
+vector<string> Master::filterRoles(
+    const Owned<ObjectApprovers>& approvers) const
+{
+  const set<string> roleList = knownRoles();
+
   vector<string> filteredRoleList;
   filteredRoleList.reserve(roleList.size());
 
@@ -4632,15 +4748,67 @@ void Master::accept(
     }
   }
 
-  // Wait for all the tasks to be authorized.
-  await(futures)
+  // The stateless validation of the tasks is done in parallel off the
+  // master actor, while the tasks are being authorized. Like the
+  // authorizations, the results are in the order of the tasks in
+  // `accept.operations()`.
+  //
+  // NOTE: The tasks are only referenced by the validations; `accept`
+  // is not touched again before all of them have completed.
+  Owned<scheduler::Call::Accept> accept_(
+      new scheduler::Call::Accept(std::move(accept)));
+
+  // The tasks to validate, and whether they are part of a task group.
+  vector<pair<const TaskInfo*, bool>> tasks;
+
+  foreach (const Offer::Operation& operation, accept_->operations()) {
+    if (operation.type() == Offer::Operation::LAUNCH) {
+      foreach (const TaskInfo& task, operation.launch().task_infos()) {
+        tasks.emplace_back(&task, false);
+      }
+    } else if (operation.type() == Offer::Operation::LAUNCH_GROUP) {
+      foreach (const TaskInfo& task,
+               operation.launch_group().task_group().tasks()) {
+        tasks.emplace_back(&task, true);
+      }
+    }
+  }
+
+  vector<Future<vector<Option<Error>>>> validations;
+
+  for (size_t i = 0; i < tasks.size(); i += TASK_VALIDATION_BATCH_SIZE) {
+    const vector<pair<const TaskInfo*, bool>> batch(
+        tasks.begin() + i,
+        tasks.begin() + std::min(i + TASK_VALIDATION_BATCH_SIZE, tasks.size()));
+
+    validations.push_back(async([batch]() {
+      vector<Option<Error>> errors;
+      errors.reserve(batch.size());
+
+      foreach (const auto& task, batch) {
+        errors.push_back(
+            task.second
+              ? validation::task::group::validateStateless(*task.first)
+              : validation::task::validateStateless(*task.first));
+      }
+
+      return errors;
+    }));
+  }
+
+  Future<vector<Future<bool>>> authorizations = await(futures);
+  Future<vector<vector<Option<Error>>>> validated = collect(validations);
+
+  // Wait for all the tasks to be authorized and validated.
+  await(authorizations, validated)
     .onAny(defer(self(),
                  &Master::_accept,
                  framework->id(),
                  slaveId.get(),
                  offeredResources,
-                 std::move(accept),
-                 lambda::_1));
+                 accept_,
+                 authorizations,
+                 validated));
 }
 
 
@@ -4648,8 +4816,9 @@ void Master::_accept(
     const FrameworkID& frameworkId,
     const SlaveID& slaveId,
     const Resources& offeredResources,
-    scheduler::Call::Accept&& accept,
-    const Future<vector<Future<bool>>>& _authorizations)
+    const Owned<scheduler::Call::Accept>& accept,
+    const Future<vector<Future<bool>>>& _authorizations,
+    const Future<vector<vector<Option<Error>>>>& _validations)
 {
   Framework* framework = getFramework(frameworkId);
 
@@ -4678,7 +4847,7 @@ void Master::_accept(
       newTaskState = TASK_LOST;
     }
 
-    foreach (const Offer::Operation& operation, accept.operations()) {
+    foreach (const Offer::Operation& operation, accept->operations()) {
       if (operation.type() != Offer::Operation::LAUNCH &&
           operation.type() != Offer::Operation::LAUNCH_GROUP) {
         continue;
@@ -4779,7 +4948,15 @@ void Master::_accept(
   std::deque<Future<bool>> authorizations(
       _authorizations->begin(), _authorizations->end());
 
-  foreach (const Offer::Operation& operation, accept.operations()) {
+  // The results of the stateless validation of the tasks, in the order
+  // of the tasks in `accept.operations()`.
+  CHECK_READY(_validations);
+  std::deque<Option<Error>> validations;
+  foreach (const vector<Option<Error>>& batch, _validations.get()) {
+    validations.insert(validations.end(), batch.begin(), batch.end());
+  }
+
+  foreach (const Offer::Operation& operation, accept->operations()) {
     switch (operation.type()) {
       // The RESERVE operation allows a principal to reserve resources.
       case Offer::Operation::RESERVE: {
@@ -5268,6 +5445,10 @@ void Master::_accept(
           Future<bool> authorization = authorizations.front();
           authorizations.pop_front();
 
+          CHECK(!validations.empty());
+          Option<Error> stateless = validations.front();
+          validations.pop_front();
+
           // The task will not be in `pendingTasks` if it has been
           // killed in the interim. No need to send TASK_KILLED in
           // this case as it has already been sent. Note however that
@@ -5334,8 +5515,8 @@ void Master::_accept(
           Resources available =
             _offeredResources.nonShared() + offeredSharedResources;
 
-          Option<Error> error =
-            validation::task::validate(task, framework, slave, available);
+          Option<Error> error = validation::task::validate(
+              task, framework, slave, available, stateless);
 
           if (error.isSome()) {
             const StatusUpdate& update = protobuf::createStatusUpdate(
@@ -5513,11 +5694,17 @@ void Master::_accept(
         // NOTE: We check for the authorization errors first and never break the
         // loop to ensure that all authorization futures for this task group are
         // iterated through.
+        vector<Option<Error>> stateless;
+
         foreach (const TaskInfo& task, taskGroup.tasks()) {
           CHECK(!authorizations.empty());
           Future<bool> authorization = authorizations.front();
           authorizations.pop_front();
 
+          CHECK(!validations.empty());
+          stateless.push_back(validations.front());
+          validations.pop_front();
+
           CHECK(!authorization.isDiscarded());
 
           if (authorization.isFailed()) {
@@ -5540,7 +5727,12 @@ void Master::_accept(
           reason = TaskStatus::REASON_TASK_GROUP_UNAUTHORIZED;
         } else {
           error = validation::task::group::validate(
-              taskGroup, executor, framework, slave, _offeredResources);
+              taskGroup,
+              executor,
+              framework,
+              slave,
+              _offeredResources,
+              stateless);
 
           if (error.isSome()) {
             reason = TaskStatus::REASON_TASK_GROUP_INVALID;
@@ -5855,7 +6047,7 @@ void Master::_accept(
         frameworkId,
         slaveId,
         _offeredResources + resizedResources,
-        accept.filters());
+        accept->filters());
   }
 }
 
@@ -7033,51 +7225,110 @@ void Master::reregisterSlave(
     return;
   }
 
-  Option<Error> error =
-    validation::master::message::reregisterSlave(reregisterSlaveMessage);
-
-  if (error.isSome()) {
-    LOG(WARNING) << "Dropping re-registration of agent at " << from
-                 << " because it sent an invalid re-registration: "
-                 << error->message;
-
-    return;
-  }
-
-  LOG(INFO) << "Received reregister agent message from agent "
-            << slaveInfo.id() << " at " << from << " ("
-            << slaveInfo.hostname() << ")";
+  // Note that the principal may be empty if authentication is not
+  // required. Also it is passed along because it may be removed from
+  // `authenticated` while the validation or authorization is pending.
+  Option<Principal> principal = authenticated.contains(from)
+      ? Principal(authenticated.at(from))
+      : Option<Principal>::none();
 
   // TODO(bevers): Create a guard object calling `insert()` in its constructor
   // and `erase()` in its destructor, to avoid the manual bookkeeping.
   slaves.reregistering.insert(slaveInfo.id());
 
-  // Update all resources passed by the agent to `POST_RESERVATION_REFINEMENT`
-  // format. We do this as early as possible so that we only use a single
-  // format inside master, and downgrade again if necessary when they leave the
-  // master (e.g. when writing to the registry).
-  upgradeResources(&reregisterSlaveMessage);
+  // The message is validated off the master actor together with the
+  // other re-registrations which arrive in the meantime, since the
+  // validation and the resource upgrade are proportional to the number
+  // of tasks and executors running on the agent. This matters
+  // after a master failover, when all agents reregister at once.
+  if (slaves.validating.empty()) {
+    dispatch(self(), &Self::validateReregistrations);
+  }
+
+  slaves.validating.push_back(
+      {from, principal, std::move(reregisterSlaveMessage)});
+}
+
+
+void Master::validateReregistrations()
+{
+  vector<Slaves::Reregistration> reregistrations;
+  std::swap(reregistrations, slaves.validating);
+
+  for (size_t i = 0;
+       i < reregistrations.size();
+       i += AGENT_REREGISTRATION_BATCH_SIZE) {
+    Owned<vector<Slaves::Reregistration>> batch(
+        new vector<Slaves::Reregistration>(
+            std::make_move_iterator(reregistrations.begin() + i),
+            std::make_move_iterator(
+                reregistrations.begin() +
+                std::min(i + AGENT_REREGISTRATION_BATCH_SIZE,
+                         reregistrations.size()))));
+
+    // NOTE: The master does not access the messages of the batch
+    // until the validation has completed.
+    async([batch]() {
+      vector<Option<Error>> errors;
+      errors.reserve(batch->size());
+
+      foreach (Slaves::Reregistration& reregistration, *batch) {
+        errors.push_back(validation::master::message::reregisterSlave(
+            reregistration.message));
+
+        // Update all resources passed by the agent to
+        // `POST_RESERVATION_REFINEMENT` format. We do this as early as
+        // possible so that we only use a single format inside master,
+        // and downgrade again if necessary when they leave the master
+        // (e.g. when writing to the registry).
+        if (errors.back().isNone()) {
+          upgradeResources(&reregistration.message);
+        }
+      }
 
-  // Note that the principal may be empty if authentication is not
-  // required. Also it is passed along because it may be removed from
-  // `authenticated` while the authorization is pending.
-  Option<Principal> principal = authenticated.contains(from)
-      ? Principal(authenticated.at(from))
-      : Option<Principal>::none();
+      return errors;
+    })
+    .onAny(defer(self(), [=](const Future<vector<Option<Error>>>& errors) {
+      CHECK_READY(errors);
+      CHECK_EQ(batch->size(), errors->size());
 
-  // Calling the `onAny` continuation below separately so we can move
-  // `reregisterSlaveMessage` without it being evaluated before it's used
-  // by `authorizeSlave`.
-  Future<bool> authorization =
-    authorizeSlave(reregisterSlaveMessage.slave(), principal);
+      for (size_t j = 0; j < batch->size(); j++) {
+        Slaves::Reregistration& reregistration = batch->at(j);
 
-  authorization
-    .onAny(defer(self(),
-                 &Self::_reregisterSlave,
-                 from,
-                 std::move(reregisterSlaveMessage),
-                 principal,
-                 lambda::_1));
+        const UPID& from = reregistration.pid;
+        const SlaveInfo& slaveInfo = reregistration.message.slave();
+
+        CHECK(slaves.reregistering.contains(slaveInfo.id()));
+
+        if (errors->at(j).isSome()) {
+          LOG(WARNING) << "Dropping re-registration of agent at " << from
+                       << " because it sent an invalid re-registration: "
+                       << errors->at(j)->message;
+
+          slaves.reregistering.erase(slaveInfo.id());
+          continue;
+        }
+
+        LOG(INFO) << "Received reregister agent message from agent "
+                  << slaveInfo.id() << " at " << from << " ("
+                  << slaveInfo.hostname() << ")";
+
+        // Calling the `onAny` continuation below separately so we can
+        // move the message without it being evaluated before it's used
+        // by `authorizeSlave`.
+        Future<bool> authorization =
+          authorizeSlave(slaveInfo, reregistration.principal);
+
+        authorization
+          .onAny(defer(self(),
+                       &Self::_reregisterSlave,
+                       from,
+                       std::move(reregistration.message),
+                       reregistration.principal,
+                       lambda::_1));
+      }
+    }));
+  }
 }
 
 
@@ -7408,18 +7659,6 @@ void Master::__reregisterSlave(
   machineId.set_hostname(slaveInfo.hostname());
   machineId.set_ip(stringify(pid.address.ip));
 
-  // For easy lookup, first determine the set of FrameworkIDs on the
-  // reregistering agent that are partition-aware.
-  hashset<FrameworkID> partitionAwareFrameworks;
-
-  foreach (const FrameworkInfo& framework,
-           reregisterSlaveMessage.frameworks()) {
-    if (protobuf::frameworkHasCapability(
-            framework, FrameworkInfo::Capability::PARTITION_AWARE)) {
-      partitionAwareFrameworks.insert(framework.id());
-    }
-  }
-
   // All tasks except the ones from completed frameworks are re-added to the
   // master (those tasks were previously marked "unreachable", so they
   // should be removed from that collection).
@@ -9527,10 +9766,16 @@ void Master::offer(
   message.mutable_offers()->Reserve(offersEstimate);
   message.mutable_pids()->Reserve(offersEstimate);
 
-  // We keep track of the offer IDs so that we can log them.
+  // We keep track of the offer IDs so that we can log them and
+  // rescind the outstanding ones once the offer timeout elapses.
   vector<OfferID> offerIds;
   offerIds.reserve(offersEstimate);
 
+  // The parts of an offer which only depend on the agent are the same
+  // for every role the agent's resources are offered to, so we build
+  // them once per agent and copy them into each of its offers.
+  hashmap<SlaveID, Offer> prototypes;
+
   foreachkey (const string& role, resources) {
     foreachpair (const SlaveID& slaveId,
                  const Resources& offered,
@@ -9587,69 +9832,69 @@ void Master::offer(
       // separate offers, so that rescinding offers with revocable
       // resources does not affect offers with regular resources.
 
-      // TODO(bmahler): Set "https" if only "https" is supported.
-      mesos::URL url;
-      url.set_scheme("http");
-      url.mutable_address()->set_hostname(slave->info.hostname());
-      url.mutable_address()->set_ip(stringify(slave->pid.address.ip));
-      url.mutable_address()->set_port(slave->pid.address.port);
-      url.set_path("/" + slave->pid.id);
-
-      Offer* offer = new Offer();
-      offer->mutable_id()->MergeFrom(newOfferId());
-      offer->mutable_framework_id()->MergeFrom(framework->id());
-      offer->mutable_slave_id()->MergeFrom(slave->id);
-      offer->set_hostname(slave->info.hostname());
-      offer->mutable_url()->MergeFrom(url);
-      offer->mutable_resources()->MergeFrom(offered);
-      offer->mutable_attributes()->MergeFrom(slave->info.attributes());
-      offer->mutable_allocation_info()->set_role(role);
+      if (!prototypes.contains(slaveId)) {
+        Offer& prototype = prototypes[slaveId];
 
-      if (slave->info.has_domain()) {
-        offer->mutable_domain()->MergeFrom(slave->info.domain());
-      }
+        // TODO(bmahler): Set "https" if only "https" is supported.
+        mesos::URL* url = prototype.mutable_url();
+        url->set_scheme("http");
+        url->mutable_address()->set_hostname(slave->info.hostname());
+        url->mutable_address()->set_ip(stringify(slave->pid.address.ip));
+        url->mutable_address()->set_port(slave->pid.address.port);
+        url->set_path("/" + slave->pid.id);
+
+        prototype.mutable_framework_id()->CopyFrom(framework->id());
+        prototype.mutable_slave_id()->CopyFrom(slave->id);
+        prototype.set_hostname(slave->info.hostname());
+        prototype.mutable_attributes()->CopyFrom(slave->info.attributes());
 
-      // Add all framework's executors running on this slave.
-      if (slave->executors.contains(framework->id())) {
-        const hashmap<ExecutorID, ExecutorInfo>& executors =
-          slave->executors[framework->id()];
-        foreachkey (const ExecutorID& executorId, executors) {
-          offer->add_executor_ids()->MergeFrom(executorId);
+        if (slave->info.has_domain()) {
+          prototype.mutable_domain()->CopyFrom(slave->info.domain());
+        }
+
+        // Add all framework's executors running on this slave.
+        if (slave->executors.contains(framework->id())) {
+          const hashmap<ExecutorID, ExecutorInfo>& executors =
+            slave->executors[framework->id()];
+          foreachkey (const ExecutorID& executorId, executors) {
+            prototype.add_executor_ids()->CopyFrom(executorId);
+          }
         }
-      }
 
-      // If the slave in this offer is planned to be unavailable due to
-      // maintenance in the future, then set the Unavailability.
-      CHECK(machines.contains(slave->machineId));
-      if (machines[slave->machineId].info.has_unavailability()) {
-        offer->mutable_unavailability()->CopyFrom(
-            machines[slave->machineId].info.unavailability());
+        // If the slave in this offer is planned to be unavailable due to
+        // maintenance in the future, then set the Unavailability.
+        CHECK(machines.contains(slave->machineId));
+        if (machines[slave->machineId].info.has_unavailability()) {
+          prototype.mutable_unavailability()->CopyFrom(
+              machines[slave->machineId].info.unavailability());
+        }
       }
 
+      Offer* offer = new Offer(prototypes.at(slaveId));
+      offer->mutable_id()->CopyFrom(newOfferId());
+      offer->mutable_resources()->MergeFrom(offered);
+      offer->mutable_allocation_info()->set_role(role);
+
       offers[offer->id()] = offer;
 
       framework->addOffer(offer);
       slave->addOffer(offer);
 
-      if (flags.offer_timeout.isSome()) {
-        // Rescind the offer after the timeout elapses.
-        offerTimers[offer->id()] =
-          delay(flags.offer_timeout.get(),
-                self(),
-                &Self::offerTimeout,
-                offer->id());
-      }
+      offerIds.push_back(offer->id());
+
+      // Add the offer *AND* the corresponding slave's PID.
+      Offer* offer_ = message.add_offers();
+      offer_->CopyFrom(*offer);
+      message.add_pids(slave->pid);
 
       // TODO(jieyu): For now, we strip 'ephemeral_ports' resource from
       // offers so that frameworks do not see this resource. This is a
       // short term workaround. Revisit this once we resolve MESOS-1654.
-      Offer offer_ = *offer;
-
-      for (int i = 0; i < offer_.resources_size();) {
-        if (offer_.resources(i).name() == "ephemeral_ports") {
-          offer_.mutable_resources()->SwapElements(
-              i, offer_.resources_size() - 1);
-          offer_.mutable_resources()->RemoveLast();
+      for (int i = 0; i < offer_->resources_size();) {
+        if (offer_->resources(i).name() == "ephemeral_ports") {
+          offer_->mutable_resources()->SwapElements(
+              i, offer_->resources_size() - 1);
+          offer_->mutable_resources()->RemoveLast();
         } else {
           ++i;
         }
@@ -9665,28 +9910,22 @@ void Master::offer(
       // information doesn't provide any value to a pre-MULTI_ROLE
       // scheduler, we preserve the old `Offer` format for them.
       if (!framework->capabilities.multiRole) {
-        offer_.clear_allocation_info();
+        offer_->clear_allocation_info();
 
-        foreach (Resource& resource, *offer_.mutable_resources()) {
+        foreach (Resource& resource, *offer_->mutable_resources()) {
           resource.clear_allocation_info();
         }
       }
 
       if (!framework->capabilities.reservationRefinement) {
         convertResourceFormat(
-            offer_.mutable_resources(), PRE_RESERVATION_REFINEMENT);
+            offer_->mutable_resources(), PRE_RESERVATION_REFINEMENT);
       }
 
-      VLOG(2) << "Sending offer " << offer_.id()
+      VLOG(2) << "Sending offer " << offer_->id()
               << " containing resources " << offered
               << " on agent " << *slave
               << " to framework " << *framework;
-
-      offerIds.push_back(offer_.id());
-
-      // Add the offer *AND* the corresponding slave's PID.
-      *message.add_offers() = std::move(offer_);
-      message.add_pids(slave->pid);
     }
   }
 
@@ -9696,8 +9935,38 @@ void Master::offer(
 
   LOG(INFO) << "Sending offers " << offerIds << " to framework " << *framework;
 
+  if (flags.offer_timeout.isSome()) {
+    // Rescind the offers after the timeout elapses. A single timer is
+    // used for all the offers of this batch; the offers which have
+    // been accepted or declined by then are skipped.
+    delay(flags.offer_timeout.get(),
+          self(),
+          &Self::offersTimeout,
+          offerIds);
+  }
+
   framework->metrics.offers_sent += message.offers().size();
-  framework->send(message);
+
+  // Large batches of offers are split into several events for HTTP
+  // frameworks, so that the scheduler can start processing the first
+  // offers while the remaining ones are still being serialized.
+  if (framework->http.isNone() ||
+      message.offers().size() <= static_cast<int>(MAX_OFFERS_PER_EVENT)) {
+    framework->send(message);
+    return;
+  }
+
+  ResourceOffersMessage chunk;
+  for (int i = 0; i < message.offers_size(); i++) {
+    chunk.add_offers()->Swap(message.mutable_offers(i));
+    chunk.add_pids()->swap(*message.mutable_pids(i));
+
+    if (chunk.offers_size() == static_cast<int>(MAX_OFFERS_PER_EVENT) ||
+        i == message.offers_size() - 1) {
+      framework->send(chunk);
+      chunk.Clear();
+    }
+  }
 }
 
 
@@ -10116,7 +10385,7 @@ void Master::addFramework(
 
   if (framework->connected()) {
     if (framework->pid.isSome()) {
-      link(framework->pid.get());
+      linkFramework(framework->pid.get());
     } else {
       CHECK_SOME(framework->http);
 
@@ -10237,7 +10506,7 @@ Try<Nothing> Master::activateRecoveredFramework(
   // Update the framework's connection state.
   if (pid.isSome()) {
     framework->updateConnection(pid.get());
-    link(pid.get());
+    linkFramework(pid.get());
   } else {
     framework->updateConnection(http.get());
     http->closed()
@@ -10313,6 +10582,10 @@ void Master::failoverFramework(
     Option<string> principal = frameworks.principals[framework->pid.get()];
 
     frameworks.principals.erase(framework->pid.get());
+
+    synchronized (linkedFrameworks->mutex) {
+      linkedFrameworks->pids.erase(framework->pid.get());
+    }
   }
 
   framework->updateConnection(http);
@@ -10351,8 +10624,14 @@ void Master::failoverFramework(Framework* framework, const UPID& newPid)
     framework->send(message);
   }
 
+  if (oldPid.isSome() && oldPid.get() != newPid) {
+    synchronized (linkedFrameworks->mutex) {
+      linkedFrameworks->pids.erase(oldPid.get());
+    }
+  }
+
   framework->updateConnection(newPid);
-  link(newPid);
+  linkFramework(newPid);
 
   _failoverFramework(framework);
 
@@ -10528,7 +10807,7 @@ void Master::removeFramework(Framework* framework)
       << " was found on registered agent " << task->slave_id();
 
     // Move task from unreachable map to completed map.
-    framework->addCompletedTask(std::move(*task));
+    framework->addCompletedTask(*task);
     framework->unreachableTasks.erase(taskId);
   }
 
@@ -10552,6 +10831,11 @@ void Master::removeFramework(Framework* framework)
   // failoverFramework needs to be shared!
 
   // TODO(benh): unlink(framework->pid);
+  if (framework->pid.isSome()) {
+    synchronized (linkedFrameworks->mutex) {
+      linkedFrameworks->pids.erase(framework->pid.get());
+    }
+  }
 
   // For http frameworks, close the connection.
   if (framework->http.isSome()) {
@@ -10732,7 +11016,7 @@ void Master::addSlave(
                 << " of framework " << *framework
                 << " that ran on agent " << *slave;
 
-        framework->addCompletedTask(std::move(task));
+        framework->addCompletedTask(task);
       } else {
         // The framework might not be reregistered yet.
         //
@@ -11679,13 +11963,15 @@ void Master::_apply(
 }
 
 
-void Master::offerTimeout(const OfferID& offerId)
+void Master::offersTimeout(const vector<OfferID>& offerIds)
 {
-  Offer* offer = getOffer(offerId);
-  if (offer != nullptr) {
-    allocator->recoverResources(
-        offer->framework_id(), offer->slave_id(), offer->resources(), None());
-    removeOffer(offer, true);
+  foreach (const OfferID& offerId, offerIds) {
+    Offer* offer = getOffer(offerId);
+    if (offer != nullptr) {
+      allocator->recoverResources(
+          offer->framework_id(), offer->slave_id(), offer->resources(), None());
+      removeOffer(offer, true);
+    }
   }
 }
 
@@ -11718,13 +12004,6 @@ void Master::removeOffer(Offer* offer, bool rescind)
     framework->send(message);
   }
 
-  // Remove and cancel offer removal timers. Canceling the Timers is
-  // only done to avoid having too many active Timers in libprocess.
-  if (offerTimers.contains(offer->id())) {
-    Clock::cancel(offerTimers[offer->id()]);
-    offerTimers.erase(offer->id());
-  }
-
   // Delete it.
   LOG(INFO) << "Removing offer " << offer->id();
   offers.erase(offer->id());
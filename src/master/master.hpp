@@ -21,6 +21,7 @@
 
 #include <list>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -59,6 +60,7 @@
 #include <stout/foreach.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
+#include <stout/lambda.hpp>
 #include <stout/linkedhashmap.hpp>
 #include <stout/multihashmap.hpp>
 #include <stout/nothing.hpp>
@@ -500,6 +502,9 @@ protected:
 
   void _exited(Framework* framework);
 
+  // Links to the PID of a (v0) framework, see `linkedFrameworks`.
+  void linkFramework(const process::UPID& pid);
+
   // Invoked upon noticing a subscriber disconnection.
   void exited(const id::UUID& id);
 
@@ -540,6 +545,10 @@ protected:
       RegisterSlaveMessage&& registerSlaveMessage,
       const process::Future<bool>& admit);
 
+  // Validates the pending re-registrations off the master actor and
+  // continues with the authorization of the valid ones.
+  void validateReregistrations();
+
   void _reregisterSlave(
       const process::UPID& pid,
       ReregisterSlaveMessage&& incomingMessage,
@@ -918,8 +927,8 @@ protected:
       const process::UPID& acknowledgee,
       Framework* framework);
 
-  // Remove an offer after specified timeout
-  void offerTimeout(const OfferID& offerId);
+  // Remove the outstanding offers of a batch after specified timeout.
+  void offersTimeout(const std::vector<OfferID>& offerIds);
 
   // Remove an offer and optionally rescind the offer as well.
   void removeOffer(Offer* offer, bool rescind = false);
@@ -1018,9 +1027,11 @@ private:
       const FrameworkID& frameworkId,
       const SlaveID& slaveId,
       const Resources& offeredResources,
-      mesos::scheduler::Call::Accept&& accept,
+      const process::Owned<mesos::scheduler::Call::Accept>& accept,
+      const process::Future<
+          std::vector<process::Future<bool>>>& authorizations,
       const process::Future<
-          std::vector<process::Future<bool>>>& authorizations);
+          std::vector<std::vector<Option<Error>>>>& validations);
 
   void acceptInverseOffers(
       Framework* framework,
@@ -1088,6 +1099,10 @@ private:
       const hashset<SlaveID>& toRemoveGone,
       const process::Future<bool>& registrarResult);
 
+  // Returns the names of the roles exposed by the role endpoints,
+  // in a deterministic order.
+  std::set<std::string> knownRoles() const;
+
   std::vector<std::string> filterRoles(
       const process::Owned<ObjectApprovers>& approvers) const;
 
@@ -1306,10 +1321,24 @@ public:
   // This is because deciding whether an incoming request is read-only often
   // requires some inspection, e.g. distinguishing between "GET" and "POST"
   // requests to the same endpoint.
+  //
+  // The handler takes a copy of the state it exposes when it is
+  // constructed, which must happen on the master actor. The copy is
+  // shared and immutable, so the member functions can run on any
+  // thread, concurrently with each other and with the master.
   class ReadOnlyHandler
   {
   public:
-    explicit ReadOnlyHandler(const Master* _master) : master(_master) {}
+    typedef process::http::Response (ReadOnlyHandler::*Handler)(
+        const hashmap<std::string, std::string>&,
+        const process::Owned<ObjectApprovers>&) const;
+
+    // Copies the state exposed by all of the member functions.
+    explicit ReadOnlyHandler(const Master* master);
+
+    // Copies only the state exposed by the given member functions,
+    // which are then the only ones that may be called.
+    ReadOnlyHandler(const Master* master, const std::vector<Handler>& handlers);
 
     // /frameworks
     process::http::Response frameworks(
@@ -1342,7 +1371,9 @@ public:
         const process::Owned<ObjectApprovers>& approvers) const;
 
   private:
-    const Master* master;
+    struct State;
+
+    std::shared_ptr<const State> view;
   };
 
 private:
@@ -1352,7 +1383,6 @@ private:
   {
   public:
     explicit Http(Master* _master) : master(_master),
-                                     readonlyHandler(_master),
                                      quotaHandler(_master),
                                      weightsHandler(_master) {}
 
@@ -1708,8 +1738,15 @@ private:
         const Option<process::http::authentication::Principal>& principal,
         ContentType contentType) const;
 
+    // If `flush` is set, it is called with the tasks gathered so far
+    // whenever `STREAMED_STATE_TASKS_PER_RECORD` tasks have been
+    // gathered, and the tasks are dropped afterwards.
     mesos::master::Response::GetTasks _getTasks(
-        const process::Owned<ObjectApprovers>& approvers) const;
+        const process::Owned<ObjectApprovers>& approvers,
+        const mesos::master::Call::GetTasks& query,
+        const Option<lambda::function<
+            void(mesos::master::Response::GetTasks*)>>& flush =
+          None()) const;
 
     process::Future<process::http::Response> createVolumes(
         const mesos::master::Call& call,
@@ -1762,8 +1799,24 @@ private:
         const Option<process::http::authentication::Principal>& principal,
         ContentType contentType) const;
 
+    // If `flush` is set, the state is passed to it in parts instead
+    // of being returned, see `streamState()`.
     mesos::master::Response::GetState _getState(
-        const process::Owned<ObjectApprovers>& approvers) const;
+        const process::Owned<ObjectApprovers>& approvers,
+        const mesos::master::Call::GetState& query,
+        const Option<lambda::function<
+            void(mesos::master::Response::GetState*)>>& flush =
+          None()) const;
+
+    // Streams the state as RecordIO encoded `GET_STATE` responses.
+    // Each record contains a part of the state, so the state is never
+    // built as a single message; merging all the records yields the
+    // complete state. The encoded records are still buffered until
+    // the client reads them.
+    process::Future<process::http::Response> streamState(
+        const mesos::master::Call& call,
+        const Option<process::http::authentication::Principal>& principal,
+        ContentType messageContentType) const;
 
     process::Future<process::http::Response> subscribe(
         const mesos::master::Call& call,
@@ -1795,8 +1848,6 @@ private:
 
     Master* master;
 
-    ReadOnlyHandler readonlyHandler;
-
     // NOTE: The quota specific pieces of the Operator API are factored
     // out into this separate class.
     QuotaHandler quotaHandler;
@@ -1874,6 +1925,10 @@ private:
   mesos::master::contender::MasterContender* contender;
   mesos::master::detector::MasterDetector* detector;
 
+  // Caches the object approvers of the authorizer across requests, see
+  // `--object_approvers_cache_ttl`. If set, `authorizer` points to it.
+  const Option<process::Owned<Authorizer>> cachingAuthorizer;
+
   const Option<Authorizer*> authorizer;
 
   MasterInfo info_;
@@ -1921,6 +1976,17 @@ private:
     hashset<process::UPID> registering;
     hashset<SlaveID> reregistering;
 
+    // Re-registrations which are waiting to be validated off the
+    // master actor, see `Master::validateReregistrations()`.
+    struct Reregistration
+    {
+      process::UPID pid;
+      Option<process::http::authentication::Principal> principal;
+      ReregisterSlaveMessage message;
+    };
+
+    std::vector<Reregistration> validating;
+
     // Registered slaves are indexed by SlaveID and UPID. Note that
     // iteration is supported but is exposed as iteration over a
     // hashmap<SlaveID, Slave*> since it is tedious to convert
@@ -2138,7 +2204,6 @@ private:
   Subscribers subscribers;
 
   hashmap<OfferID, Offer*> offers;
-  hashmap<OfferID, process::Timer> offerTimers;
 
   hashmap<OfferID, InverseOffer*> inverseOffers;
   hashmap<OfferID, process::Timer> inverseOfferTimers;
@@ -2253,6 +2318,19 @@ private:
 
   Option<process::Time> electedTime; // Time when this master is elected.
 
+  // The PIDs of the (v0) frameworks which the master has linked to.
+  // The event classifier runs on the threads which enqueue the events,
+  // and uses them to tell the `ExitedEvent`s of frameworks from those
+  // of agents, see `Master::Master()`.
+  struct LinkedFrameworks
+  {
+    std::mutex mutex;
+    hashset<process::UPID> pids;
+  };
+
+  const std::shared_ptr<LinkedFrameworks> linkedFrameworks =
+    std::make_shared<LinkedFrameworks>();
+
   // Validates the framework including authorization.
   // Returns None if the framework is valid.
   // Returns Error if the framework is invalid.
@@ -2268,6 +2346,31 @@ inline std::ostream& operator<<(
     const Framework& framework);
 
 
+// A task which has reached a terminal state. Completed tasks are only
+// kept as history for the state endpoints, so they are stored
+// serialized (and optionally compressed) and only decoded when they
+// are queried. The agent ID and the state of the task are kept decoded
+// since they are needed to summarize all of the completed tasks.
+class CompletedTask
+{
+public:
+  CompletedTask(const Task& task, bool compress);
+
+  // Decodes the task.
+  Task get() const;
+
+  const SlaveID slaveId;
+  const TaskState state;
+
+private:
+  CompletedTask(const CompletedTask&) = delete;
+  CompletedTask& operator=(const CompletedTask&) = delete;
+
+  std::string data;
+  bool compressed;
+};
+
+
 // TODO(bmahler): Keeping the task and executor information in sync
 // across the Slave and Framework structs is error prone!
 struct Framework
@@ -2326,7 +2429,7 @@ struct Framework
   template <typename Message>
   void send(const Message& message);
 
-  void addCompletedTask(Task&& task);
+  void addCompletedTask(const Task& task);
 
   void addUnreachableTask(const Task& task);
 
@@ -2422,10 +2525,10 @@ struct Framework
 
   // Tasks launched by this framework that have reached a terminal
   // state and have had all their updates acknowledged. We only keep a
-  // fixed-size cache to avoid consuming too much memory. We use
-  // circular_buffer rather than BoundedHashMap because there
-  // can be multiple completed tasks with the same task ID.
-  circular_buffer<process::Owned<Task>> completedTasks;
+  // fixed-size cache of compact records to avoid consuming too much
+  // memory. We use circular_buffer rather than BoundedHashMap because
+  // there can be multiple completed tasks with the same task ID.
+  circular_buffer<process::Owned<CompletedTask>> completedTasks;
 
   // When an agent is marked unreachable, tasks running on it are stored
   // here. We only keep a fixed-size cache to avoid consuming too much memory.
@@ -2491,6 +2594,10 @@ struct Framework
   FrameworkMetrics metrics;
 
 private:
+  // Whether completed tasks are compressed, see
+  // `--compress_completed_tasks`.
+  const bool compressCompletedTasks;
+
   Framework(Master* const _master,
             const Flags& masterFlags,
             const FrameworkInfo& _info,
@@ -16,6 +16,7 @@
 
 #include "master/master.hpp"
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -46,6 +47,7 @@ using mesos::authorization::VIEW_FRAMEWORK;
 using mesos::authorization::VIEW_ROLE;
 using mesos::authorization::VIEW_TASK;
 
+using std::set;
 using std::vector;
 using std::string;
 
@@ -74,6 +76,247 @@ struct Full : Representation<T>
 };
 
 
+// An immutable copy of the parts of a `Framework` which are exposed by
+// the read-only endpoints.
+struct FrameworkView
+{
+  explicit FrameworkView(const Framework& framework);
+
+  FrameworkID id;
+  FrameworkInfo info;
+  Option<process::UPID> pid;
+  protobuf::framework::Capabilities capabilities;
+  bool active;
+  bool connected;
+  bool recovered;
+  process::Time registeredTime;
+  process::Time reregisteredTime;
+  process::Time unregisteredTime;
+  Resources totalUsedResources;
+  Resources totalOfferedResources;
+
+  vector<TaskInfo> pendingTasks;
+  vector<Owned<Task>> tasks;
+  vector<Owned<Task>> unreachableTasks;
+  vector<Owned<CompletedTask>> completedTasks;
+  vector<Offer> offers;
+  hashmap<SlaveID, hashmap<ExecutorID, ExecutorInfo>> executors;
+};
+
+
+FrameworkView::FrameworkView(const Framework& framework)
+  : id(framework.id()),
+    info(framework.info),
+    pid(framework.pid),
+    capabilities(framework.capabilities),
+    active(framework.active()),
+    connected(framework.connected()),
+    recovered(framework.recovered()),
+    registeredTime(framework.registeredTime),
+    reregisteredTime(framework.reregisteredTime),
+    unregisteredTime(framework.unregisteredTime),
+    totalUsedResources(framework.totalUsedResources),
+    totalOfferedResources(framework.totalOfferedResources),
+    executors(framework.executors)
+{
+  foreachvalue (const TaskInfo& taskInfo, framework.pendingTasks) {
+    pendingTasks.push_back(taskInfo);
+  }
+
+  foreachvalue (const Task* task, framework.tasks) {
+    tasks.push_back(Owned<Task>(new Task(*task)));
+  }
+
+  foreachvalue (const Owned<Task>& task, framework.unreachableTasks) {
+    unreachableTasks.push_back(Owned<Task>(new Task(*task)));
+  }
+
+  // Completed tasks are never modified by the master, so we share
+  // them instead of copying them. They are only decoded when the
+  // view is rendered.
+  foreach (const Owned<CompletedTask>& task, framework.completedTasks) {
+    completedTasks.push_back(task);
+  }
+
+  foreach (const Offer* offer, framework.offers) {
+    offers.push_back(*offer);
+  }
+}
+
+
+// An immutable copy of the parts of a `Slave` which are exposed by the
+// read-only endpoints.
+struct SlaveView
+{
+  explicit SlaveView(const Slave& slave);
+
+  SlaveID id;
+  SlaveInfo info;
+  process::UPID pid;
+  string version;
+  protobuf::slave::Capabilities capabilities;
+  process::Time registeredTime;
+  Option<process::Time> reregisteredTime;
+  bool active;
+  Resources totalResources;
+  Resources usedResources;
+  Resources offeredResources;
+};
+
+
+SlaveView::SlaveView(const Slave& slave)
+  : id(slave.id),
+    info(slave.info),
+    pid(slave.pid),
+    version(slave.version),
+    capabilities(slave.capabilities),
+    registeredTime(slave.registeredTime),
+    reregisteredTime(slave.reregisteredTime),
+    active(slave.active),
+    totalResources(slave.totalResources),
+    usedResources(Resources::sum(slave.usedResources)),
+    offeredResources(slave.offeredResources)
+{}
+
+
+// An immutable copy of the parts of a `Role` which are exposed by the
+// read-only endpoints.
+struct RoleView
+{
+  Resources allocatedResources;
+  vector<FrameworkID> frameworks;
+};
+
+
+// The view of the master state from which the read-only handlers
+// render their responses. It is taken on the master actor, but the
+// responses are rendered on other threads, concurrently with the
+// master processing further events.
+//
+// Copying the frameworks and their tasks is proportional to the size
+// of the cluster, so a view only contains the parts of the state that
+// are rendered by the handlers which use it.
+struct Master::ReadOnlyHandler::State
+{
+  enum Part
+  {
+    MASTER = 1 << 0, // Master info, flags and agent counts.
+    SLAVES = 1 << 1,
+    FRAMEWORKS = 1 << 2, // Including their tasks, offers and executors.
+    ROLES = 1 << 3,
+    ALL = MASTER | SLAVES | FRAMEWORKS | ROLES
+  };
+
+  State(const Master& master, int parts);
+
+  MasterInfo info;
+  process::UPID pid;
+  process::Time startTime;
+  Option<process::Time> electedTime;
+  Option<MasterInfo> leader;
+  Option<Flags> flags;
+
+  double activatedSlaves = 0;
+  double deactivatedSlaves = 0;
+  double unreachableSlaves = 0;
+
+  vector<SlaveView> slaves;
+  vector<SlaveInfo> recoveredSlaves;
+
+  vector<FrameworkView> frameworks;
+  vector<FrameworkView> completedFrameworks;
+
+  set<string> roleNames;
+  hashmap<string, double> weights;
+  hashmap<string, Quota> quotas;
+  hashmap<string, RoleView> roles;
+};
+
+
+Master::ReadOnlyHandler::State::State(const Master& master, int parts)
+  : info(master.info()),
+    pid(master.self()),
+    startTime(master.startTime),
+    electedTime(master.electedTime),
+    leader(master.leader)
+{
+  if (parts & MASTER) {
+    flags = master.flags;
+    activatedSlaves = master._const_slaves_active();
+    deactivatedSlaves = master._const_slaves_inactive();
+    unreachableSlaves = master._const_slaves_unreachable();
+  }
+
+  if (parts & SLAVES) {
+    slaves.reserve(master.slaves.registered.size());
+    foreachvalue (const Slave* slave, master.slaves.registered) {
+      slaves.emplace_back(*slave);
+    }
+
+    foreachvalue (const SlaveInfo& slaveInfo, master.slaves.recovered) {
+      recoveredSlaves.push_back(slaveInfo);
+    }
+  }
+
+  if (parts & FRAMEWORKS) {
+    frameworks.reserve(master.frameworks.registered.size());
+    foreachvalue (const Framework* framework, master.frameworks.registered) {
+      frameworks.emplace_back(*framework);
+    }
+
+    foreachvalue (const Owned<Framework>& framework,
+                  master.frameworks.completed) {
+      completedFrameworks.emplace_back(*framework);
+    }
+  }
+
+  if (parts & ROLES) {
+    roleNames = master.knownRoles();
+    weights = master.weights;
+    quotas = master.quotas;
+
+    foreachpair (const string& name, const Role* role, master.roles) {
+      RoleView& view = roles[name];
+      view.allocatedResources = role->allocatedResources();
+
+      foreachkey (const FrameworkID& frameworkId, role->frameworks) {
+        view.frameworks.push_back(frameworkId);
+      }
+    }
+  }
+}
+
+
+Master::ReadOnlyHandler::ReadOnlyHandler(const Master* master)
+  : view(new State(*master, State::ALL)) {}
+
+
+Master::ReadOnlyHandler::ReadOnlyHandler(
+    const Master* master,
+    const vector<Handler>& handlers)
+{
+  int parts = 0;
+
+  foreach (Handler handler, handlers) {
+    if (handler == &ReadOnlyHandler::frameworks ||
+        handler == &ReadOnlyHandler::tasks) {
+      parts |= State::FRAMEWORKS;
+    } else if (handler == &ReadOnlyHandler::roles) {
+      parts |= State::ROLES;
+    } else if (handler == &ReadOnlyHandler::slaves) {
+      parts |= State::SLAVES;
+    } else if (handler == &ReadOnlyHandler::state ||
+               handler == &ReadOnlyHandler::stateSummary) {
+      parts |= State::MASTER | State::SLAVES | State::FRAMEWORKS;
+    } else {
+      parts |= State::ALL;
+    }
+  }
+
+  view.reset(new State(*master, parts));
+}
+
+
 // Filtered representation of Full<Framework>.
 // Executors and Tasks are filtered based on whether the
 // user is authorized to view them.
@@ -83,24 +326,24 @@ struct Full : Representation<T>
 struct FullFrameworkWriter {
   FullFrameworkWriter(
       const process::Owned<ObjectApprovers>& approvers,
-      const Framework* framework);
+      const FrameworkView* framework);
 
   void operator()(JSON::ObjectWriter* writer) const;
 
   const process::Owned<ObjectApprovers>& approvers_;
-  const Framework* framework_;
+  const FrameworkView* framework_;
 };
 
 
 struct SlaveWriter
 {
   SlaveWriter(
-      const Slave& slave,
+      const SlaveView& slave,
       const process::Owned<ObjectApprovers>& approvers);
 
   void operator()(JSON::ObjectWriter* writer) const;
 
-  const Slave& slave_;
+  const SlaveView& slave_;
   const process::Owned<ObjectApprovers>& approvers_;
 };
 
@@ -108,26 +351,28 @@ struct SlaveWriter
 struct SlavesWriter
 {
   SlavesWriter(
-      const Master::Slaves& slaves,
+      const vector<SlaveView>& slaves,
+      const vector<SlaveInfo>& recoveredSlaves,
       const process::Owned<ObjectApprovers>& approvers,
       const IDAcceptor<SlaveID>& selectSlaveId);
 
   void operator()(JSON::ObjectWriter* writer) const;
 
-  void writeSlave(const Slave* slave, JSON::ObjectWriter* writer) const;
+  void writeSlave(const SlaveView& slave, JSON::ObjectWriter* writer) const;
 
-  const Master::Slaves& slaves_;
+  const vector<SlaveView>& slaves_;
+  const vector<SlaveInfo>& recoveredSlaves_;
   const process::Owned<ObjectApprovers>& approvers_;
   const IDAcceptor<SlaveID>& selectSlaveId_;
 };
 
 
-void json(JSON::ObjectWriter* writer, const Summary<Framework>& summary);
+void json(JSON::ObjectWriter* writer, const Summary<FrameworkView>& summary);
 
 
 FullFrameworkWriter::FullFrameworkWriter(
     const Owned<ObjectApprovers>& approvers,
-    const Framework* framework)
+    const FrameworkView* framework)
   : approvers_(approvers),
     framework_(framework)
 {}
@@ -135,7 +380,7 @@ FullFrameworkWriter::FullFrameworkWriter(
 
 void FullFrameworkWriter::operator()(JSON::ObjectWriter* writer) const
 {
-  json(writer, Summary<Framework>(*framework_));
+  json(writer, Summary<FrameworkView>(*framework_));
 
   // Add additional fields to those generated by the
   // `Summary<Framework>` overload.
@@ -173,7 +418,7 @@ void FullFrameworkWriter::operator()(JSON::ObjectWriter* writer) const
 
   // Model all of the tasks associated with a framework.
   writer->field("tasks", [this](JSON::ArrayWriter* writer) {
-    foreachvalue (const TaskInfo& taskInfo, framework_->pendingTasks) {
+    foreach (const TaskInfo& taskInfo, framework_->pendingTasks) {
       // Skip unauthorized tasks.
       if (!approvers_->approved<VIEW_TASK>(taskInfo, framework_->info)) {
         continue;
@@ -182,7 +427,7 @@ void FullFrameworkWriter::operator()(JSON::ObjectWriter* writer) const
       writer->element([this, &taskInfo](JSON::ObjectWriter* writer) {
         writer->field("id", taskInfo.task_id().value());
         writer->field("name", taskInfo.name());
-        writer->field("framework_id", framework_->id().value());
+        writer->field("framework_id", framework_->id.value());
 
         writer->field(
             "executor_id",
@@ -214,7 +459,7 @@ void FullFrameworkWriter::operator()(JSON::ObjectWriter* writer) const
       });
     }
 
-    foreachvalue (Task* task, framework_->tasks) {
+    foreach (const Owned<Task>& task, framework_->tasks) {
       // Skip unauthorized tasks.
       if (!approvers_->approved<VIEW_TASK>(*task, framework_->info)) {
         continue;
@@ -225,7 +470,7 @@ void FullFrameworkWriter::operator()(JSON::ObjectWriter* writer) const
   });
 
   writer->field("unreachable_tasks", [this](JSON::ArrayWriter* writer) {
-    foreachvalue (const Owned<Task>& task, framework_->unreachableTasks) {
+    foreach (const Owned<Task>& task, framework_->unreachableTasks) {
       // Skip unauthorized tasks.
       if (!approvers_->approved<VIEW_TASK>(*task, framework_->info)) {
         continue;
@@ -236,20 +481,23 @@ void FullFrameworkWriter::operator()(JSON::ObjectWriter* writer) const
   });
 
   writer->field("completed_tasks", [this](JSON::ArrayWriter* writer) {
-    foreach (const Owned<Task>& task, framework_->completedTasks) {
+    foreach (const Owned<CompletedTask>& completedTask,
+             framework_->completedTasks) {
+      const Task task = completedTask->get();
+
       // Skip unauthorized tasks.
-      if (!approvers_->approved<VIEW_TASK>(*task, framework_->info)) {
+      if (!approvers_->approved<VIEW_TASK>(task, framework_->info)) {
         continue;
       }
 
-      writer->element(*task);
+      writer->element(task);
     }
   });
 
   // Model all of the offers associated with a framework.
   writer->field("offers", [this](JSON::ArrayWriter* writer) {
-    foreach (Offer* offer, framework_->offers) {
-      writer->element(*offer);
+    foreach (const Offer& offer, framework_->offers) {
+      writer->element(offer);
     }
   });
 
@@ -284,7 +532,7 @@ void FullFrameworkWriter::operator()(JSON::ObjectWriter* writer) const
 
 
 SlaveWriter::SlaveWriter(
-    const Slave& slave,
+    const SlaveView& slave,
     const Owned<ObjectApprovers>& approvers)
   : slave_(slave), approvers_(approvers)
 {}
@@ -303,7 +551,7 @@ void SlaveWriter::operator()(JSON::ObjectWriter* writer) const
 
   const Resources& totalResources = slave_.totalResources;
   writer->field("resources", totalResources);
-  writer->field("used_resources", Resources::sum(slave_.usedResources));
+  writer->field("used_resources", slave_.usedResources);
   writer->field("offered_resources", slave_.offeredResources);
   writer->field(
       "reserved_resources",
@@ -327,18 +575,22 @@ void SlaveWriter::operator()(JSON::ObjectWriter* writer) const
 
 
 SlavesWriter::SlavesWriter(
-    const Master::Slaves& slaves,
+    const vector<SlaveView>& slaves,
+    const vector<SlaveInfo>& recoveredSlaves,
     const Owned<ObjectApprovers>& approvers,
     const IDAcceptor<SlaveID>& selectSlaveId)
-  : slaves_(slaves), approvers_(approvers), selectSlaveId_(selectSlaveId)
+  : slaves_(slaves),
+    recoveredSlaves_(recoveredSlaves),
+    approvers_(approvers),
+    selectSlaveId_(selectSlaveId)
 {}
 
 
 void SlavesWriter::operator()(JSON::ObjectWriter* writer) const
 {
   writer->field("slaves", [this](JSON::ArrayWriter* writer) {
-    foreachvalue (const Slave* slave, slaves_.registered) {
-      if (!selectSlaveId_.accept(slave->id)) {
+    foreach (const SlaveView& slave, slaves_) {
+      if (!selectSlaveId_.accept(slave.id)) {
         continue;
       }
 
@@ -349,7 +601,7 @@ void SlavesWriter::operator()(JSON::ObjectWriter* writer) const
   });
 
   writer->field("recovered_slaves", [this](JSON::ArrayWriter* writer) {
-    foreachvalue (const SlaveInfo& slaveInfo, slaves_.recovered) {
+    foreach (const SlaveInfo& slaveInfo, recoveredSlaves_) {
       if (!selectSlaveId_.accept(slaveInfo.id())) {
         continue;
       }
@@ -363,9 +615,9 @@ void SlavesWriter::operator()(JSON::ObjectWriter* writer) const
 
 
 void SlavesWriter::writeSlave(
-  const Slave* slave, JSON::ObjectWriter* writer) const
+  const SlaveView& slave, JSON::ObjectWriter* writer) const
 {
-  SlaveWriter(*slave, approvers_)(writer);
+  SlaveWriter(slave, approvers_)(writer);
 
   // Add the complete protobuf->JSON for all used, reserved,
   // and offered resources. The other endpoints summarize
@@ -374,7 +626,7 @@ void SlavesWriter::writeSlave(
   // information is necessary so that operators can use the
   // `/unreserve` and `/destroy-volumes` endpoints.
 
-  hashmap<string, Resources> reserved = slave->totalResources.reservations();
+  hashmap<string, Resources> reserved = slave.totalResources.reservations();
 
   writer->field(
       "reserved_resources_full",
@@ -396,7 +648,7 @@ void SlavesWriter::writeSlave(
         }
       });
 
-  Resources unreservedResources = slave->totalResources.unreserved();
+  Resources unreservedResources = slave.totalResources.unreserved();
 
   writer->field(
       "unreserved_resources_full",
@@ -409,7 +661,7 @@ void SlavesWriter::writeSlave(
         }
       });
 
-  Resources usedResources = Resources::sum(slave->usedResources);
+  const Resources& usedResources = slave.usedResources;
 
   writer->field(
       "used_resources_full",
@@ -422,7 +674,7 @@ void SlavesWriter::writeSlave(
         }
       });
 
-  const Resources& offeredResources = slave->offeredResources;
+  const Resources& offeredResources = slave.offeredResources;
 
   writer->field(
       "offered_resources_full",
@@ -437,11 +689,11 @@ void SlavesWriter::writeSlave(
 }
 
 
-void json(JSON::ObjectWriter* writer, const Summary<Framework>& summary)
+void json(JSON::ObjectWriter* writer, const Summary<FrameworkView>& summary)
 {
-  const Framework& framework = summary;
+  const FrameworkView& framework = summary;
 
-  writer->field("id", framework.id().value());
+  writer->field("id", framework.id.value());
   writer->field("name", framework.info.name());
 
   // Omit pid for http frameworks.
@@ -455,9 +707,9 @@ void json(JSON::ObjectWriter* writer, const Summary<Framework>& summary)
   writer->field("capabilities", framework.info.capabilities());
   writer->field("hostname", framework.info.hostname());
   writer->field("webui_url", framework.info.webui_url());
-  writer->field("active", framework.active());
-  writer->field("connected", framework.connected());
-  writer->field("recovered", framework.recovered());
+  writer->field("active", framework.active);
+  writer->field("connected", framework.connected);
+  writer->field("recovered", framework.recovered);
 }
 
 
@@ -468,29 +720,29 @@ void json(JSON::ObjectWriter* writer, const Summary<Framework>& summary)
 class SlaveFrameworkMapping
 {
 public:
-  SlaveFrameworkMapping(const hashmap<FrameworkID, Framework*>& frameworks)
+  SlaveFrameworkMapping(const vector<FrameworkView>& frameworks)
   {
-    foreachpair (const FrameworkID& frameworkId,
-                 const Framework* framework,
-                 frameworks) {
-      foreachvalue (const TaskInfo& taskInfo, framework->pendingTasks) {
+    foreach (const FrameworkView& framework, frameworks) {
+      const FrameworkID& frameworkId = framework.id;
+
+      foreach (const TaskInfo& taskInfo, framework.pendingTasks) {
         frameworksToSlaves[frameworkId].insert(taskInfo.slave_id());
         slavesToFrameworks[taskInfo.slave_id()].insert(frameworkId);
       }
 
-      foreachvalue (const Task* task, framework->tasks) {
+      foreach (const Owned<Task>& task, framework.tasks) {
         frameworksToSlaves[frameworkId].insert(task->slave_id());
         slavesToFrameworks[task->slave_id()].insert(frameworkId);
       }
 
-      foreachvalue (const Owned<Task>& task, framework->unreachableTasks) {
+      foreach (const Owned<Task>& task, framework.unreachableTasks) {
         frameworksToSlaves[frameworkId].insert(task->slave_id());
         slavesToFrameworks[task->slave_id()].insert(frameworkId);
       }
 
-      foreach (const Owned<Task>& task, framework->completedTasks) {
-        frameworksToSlaves[frameworkId].insert(task->slave_id());
-        slavesToFrameworks[task->slave_id()].insert(frameworkId);
+      foreach (const Owned<CompletedTask>& task, framework.completedTasks) {
+        frameworksToSlaves[frameworkId].insert(task->slaveId);
+        slavesToFrameworks[task->slaveId].insert(frameworkId);
       }
     }
   }
@@ -542,7 +794,12 @@ struct TaskStateSummary
   // Account for the state of the given task.
   void count(const Task& task)
   {
-    switch (task.state()) {
+    count(task.state());
+  }
+
+  void count(const TaskState& state)
+  {
+    switch (state) {
       case TASK_STAGING: { ++staging; break; }
       case TASK_STARTING: { ++starting; break; }
       case TASK_RUNNING: { ++running; break; }
@@ -589,29 +846,29 @@ const TaskStateSummary TaskStateSummary::EMPTY;
 class TaskStateSummaries
 {
 public:
-  TaskStateSummaries(const hashmap<FrameworkID, Framework*>& frameworks)
+  TaskStateSummaries(const vector<FrameworkView>& frameworks)
   {
-    foreachpair (const FrameworkID& frameworkId,
-                 const Framework* framework,
-                 frameworks) {
-      foreachvalue (const TaskInfo& taskInfo, framework->pendingTasks) {
+    foreach (const FrameworkView& framework, frameworks) {
+      const FrameworkID& frameworkId = framework.id;
+
+      foreach (const TaskInfo& taskInfo, framework.pendingTasks) {
         frameworkTaskSummaries[frameworkId].staging++;
         slaveTaskSummaries[taskInfo.slave_id()].staging++;
       }
 
-      foreachvalue (const Task* task, framework->tasks) {
+      foreach (const Owned<Task>& task, framework.tasks) {
         frameworkTaskSummaries[frameworkId].count(*task);
         slaveTaskSummaries[task->slave_id()].count(*task);
       }
 
-      foreachvalue (const Owned<Task>& task, framework->unreachableTasks) {
+      foreach (const Owned<Task>& task, framework.unreachableTasks) {
         frameworkTaskSummaries[frameworkId].count(*task);
         slaveTaskSummaries[task->slave_id()].count(*task);
       }
 
-      foreach (const Owned<Task>& task, framework->completedTasks) {
-        frameworkTaskSummaries[frameworkId].count(*task);
-        slaveTaskSummaries[task->slave_id()].count(*task);
+      foreach (const Owned<CompletedTask>& task, framework.completedTasks) {
+        frameworkTaskSummaries[frameworkId].count(task->state);
+        slaveTaskSummaries[task->slaveId].count(task->state);
       }
     }
   }
@@ -645,43 +902,41 @@ process::http::Response Master::ReadOnlyHandler::frameworks(
 
   // This lambda is consumed before the outer lambda
   // returns, hence capture by reference is fine here.
-  const Master* master = this->master;
-  auto frameworks = [master, &approvers, &selectFrameworkId](
+  const State* view = this->view.get();
+  auto frameworks = [view, &approvers, &selectFrameworkId](
       JSON::ObjectWriter* writer) {
     // Model all of the frameworks.
     writer->field(
         "frameworks",
-        [master, &approvers, &selectFrameworkId](
+        [view, &approvers, &selectFrameworkId](
             JSON::ArrayWriter* writer) {
-          foreachvalue (
-              Framework* framework, master->frameworks.registered) {
+          foreach (const FrameworkView& framework, view->frameworks) {
             // Skip unauthorized frameworks or frameworks
             // without a matching ID.
-            if (!selectFrameworkId.accept(framework->id()) ||
-                !approvers->approved<VIEW_FRAMEWORK>(framework->info)) {
+            if (!selectFrameworkId.accept(framework.id) ||
+                !approvers->approved<VIEW_FRAMEWORK>(framework.info)) {
               continue;
             }
 
-            writer->element(FullFrameworkWriter(approvers, framework));
+            writer->element(FullFrameworkWriter(approvers, &framework));
           }
         });
 
     // Model all of the completed frameworks.
     writer->field(
         "completed_frameworks",
-        [master, &approvers, &selectFrameworkId](
+        [view, &approvers, &selectFrameworkId](
             JSON::ArrayWriter* writer) {
-          foreachvalue (const Owned<Framework>& framework,
-                        master->frameworks.completed) {
+          foreach (const FrameworkView& framework,
+                   view->completedFrameworks) {
             // Skip unauthorized frameworks or frameworks
             // without a matching ID.
-            if (!selectFrameworkId.accept(framework->id()) ||
-                !approvers->approved<VIEW_FRAMEWORK>(framework->info)) {
+            if (!selectFrameworkId.accept(framework.id) ||
+                !approvers->approved<VIEW_FRAMEWORK>(framework.info)) {
               continue;
             }
 
-            writer->element(
-                FullFrameworkWriter(approvers, framework.get()));
+            writer->element(FullFrameworkWriter(approvers, &framework));
           }
         });
 
@@ -699,7 +954,7 @@ JSON::Object model(
     const string& name,
     Option<double> weight,
     Option<Quota> quota,
-    Option<Role*> _role)
+    const Option<RoleView>& role)
 {
   JSON::Object object;
   object.values["name"] = name;
@@ -714,18 +969,16 @@ JSON::Object model(
     object.values["quota"] = model(quota->info);
   }
 
-  if (_role.isNone()) {
+  if (role.isNone()) {
     object.values["resources"] = model(Resources());
     object.values["frameworks"] = JSON::Array();
   } else {
-    Role* role = _role.get();
-
-    object.values["resources"] = model(role->allocatedResources());
+    object.values["resources"] = model(role->allocatedResources);
 
     {
       JSON::Array array;
 
-      foreachkey (const FrameworkID& frameworkId, role->frameworks) {
+      foreach (const FrameworkID& frameworkId, role->frameworks) {
         array.values.push_back(frameworkId.value());
       }
 
@@ -742,26 +995,19 @@ process::http::Response Master::ReadOnlyHandler::roles(
     const process::Owned<ObjectApprovers>& approvers) const
 {
   JSON::Object object;
-  const vector<string> filteredRoles = master->filterRoles(approvers);
 
   {
     JSON::Array array;
 
-    foreach (const string& name, filteredRoles) {
-      Option<double> weight = None();
-      if (master->weights.contains(name)) {
-        weight = master->weights.at(name);
-      }
-
-      Option<Quota> quota = None();
-      if (master->quotas.contains(name)) {
-        quota = master->quotas.at(name);
+    foreach (const string& name, view->roleNames) {
+      // Only list roles the principal is authorized to see.
+      if (!approvers->approved<VIEW_ROLE>(name)) {
+        continue;
       }
 
-      Option<Role*> role = None();
-      if (master->roles.contains(name)) {
-        role = master->roles.at(name);
-      }
+      Option<double> weight = view->weights.get(name);
+      Option<Quota> quota = view->quotas.get(name);
+      Option<RoleView> role = view->roles.get(name);
 
       array.values.push_back(model(name, weight, quota, role));
     }
@@ -780,7 +1026,8 @@ process::http::Response Master::ReadOnlyHandler::slaves(
   IDAcceptor<SlaveID> selectSlaveId(query.get("slave_id"));
 
   return process::http::OK(
-      jsonify(SlavesWriter(master->slaves, approvers, selectSlaveId)),
+      jsonify(SlavesWriter(
+          view->slaves, view->recoveredSlaves, approvers, selectSlaveId)),
       query.get("jsonp"));
 }
 
@@ -789,8 +1036,8 @@ process::http::Response Master::ReadOnlyHandler::state(
     const hashmap<std::string, std::string>& query,
     const process::Owned<ObjectApprovers>& approvers) const
 {
-  const Master* master = this->master;
-  auto calculateState = [master, &approvers](JSON::ObjectWriter* writer) {
+  const State* view = this->view.get();
+  auto calculateState = [view, &approvers](JSON::ObjectWriter* writer) {
     writer->field("version", MESOS_VERSION);
 
     if (build::GIT_SHA.isSome()) {
@@ -808,52 +1055,52 @@ process::http::Response Master::ReadOnlyHandler::state(
     writer->field("build_date", build::DATE);
     writer->field("build_time", build::TIME);
     writer->field("build_user", build::USER);
-    writer->field("start_time", master->startTime.secs());
+    writer->field("start_time", view->startTime.secs());
 
-    if (master->electedTime.isSome()) {
-      writer->field("elected_time", master->electedTime->secs());
+    if (view->electedTime.isSome()) {
+      writer->field("elected_time", view->electedTime->secs());
     }
 
-    writer->field("id", master->info().id());
-    writer->field("pid", string(master->self()));
-    writer->field("hostname", master->info().hostname());
-    writer->field("capabilities", master->info().capabilities());
-    writer->field("activated_slaves", master->_const_slaves_active());
-    writer->field("deactivated_slaves", master->_const_slaves_inactive());
-    writer->field("unreachable_slaves", master->_const_slaves_unreachable());
+    writer->field("id", view->info.id());
+    writer->field("pid", string(view->pid));
+    writer->field("hostname", view->info.hostname());
+    writer->field("capabilities", view->info.capabilities());
+    writer->field("activated_slaves", view->activatedSlaves);
+    writer->field("deactivated_slaves", view->deactivatedSlaves);
+    writer->field("unreachable_slaves", view->unreachableSlaves);
 
-    if (master->info().has_domain()) {
-      writer->field("domain", master->info().domain());
+    if (view->info.has_domain()) {
+      writer->field("domain", view->info.domain());
     }
 
     // TODO(haosdent): Deprecated this in favor of `leader_info` below.
-    if (master->leader.isSome()) {
-      writer->field("leader", master->leader->pid());
+    if (view->leader.isSome()) {
+      writer->field("leader", view->leader->pid());
     }
 
-    if (master->leader.isSome()) {
-      writer->field("leader_info", [master](JSON::ObjectWriter* writer) {
-        json(writer, master->leader.get());
+    if (view->leader.isSome()) {
+      writer->field("leader_info", [view](JSON::ObjectWriter* writer) {
+        json(writer, view->leader.get());
       });
     }
 
     if (approvers->approved<VIEW_FLAGS>()) {
-      if (master->flags.cluster.isSome()) {
-        writer->field("cluster", master->flags.cluster.get());
+      if (view->flags->cluster.isSome()) {
+        writer->field("cluster", view->flags->cluster.get());
       }
 
-      if (master->flags.log_dir.isSome()) {
-        writer->field("log_dir", master->flags.log_dir.get());
+      if (view->flags->log_dir.isSome()) {
+        writer->field("log_dir", view->flags->log_dir.get());
       }
 
-      if (master->flags.external_log_file.isSome()) {
+      if (view->flags->external_log_file.isSome()) {
         writer->field("external_log_file",
-                      master->flags.external_log_file.get());
+                      view->flags->external_log_file.get());
       }
 
-      writer->field("flags", [master](JSON::ObjectWriter* writer) {
-          foreachvalue (const flags::Flag& flag, master->flags) {
-            Option<string> value = flag.stringify(master->flags);
+      writer->field("flags", [view](JSON::ObjectWriter* writer) {
+          foreachvalue (const flags::Flag& flag, view->flags.get()) {
+            Option<string> value = flag.stringify(view->flags.get());
             if (value.isSome()) {
               writer->field(flag.effective_name().value, value.get());
             }
@@ -864,18 +1111,17 @@ process::http::Response Master::ReadOnlyHandler::state(
     // Model all of the registered slaves.
     writer->field(
         "slaves",
-        [master, &approvers](JSON::ArrayWriter* writer) {
-          foreachvalue (Slave* slave, master->slaves.registered) {
-            writer->element(SlaveWriter(*slave, approvers));
+        [view, &approvers](JSON::ArrayWriter* writer) {
+          foreach (const SlaveView& slave, view->slaves) {
+            writer->element(SlaveWriter(slave, approvers));
           }
         });
 
     // Model all of the recovered slaves.
     writer->field(
         "recovered_slaves",
-        [master](JSON::ArrayWriter* writer) {
-          foreachvalue (
-              const SlaveInfo& slaveInfo, master->slaves.recovered) {
+        [view](JSON::ArrayWriter* writer) {
+          foreach (const SlaveInfo& slaveInfo, view->recoveredSlaves) {
             writer->element([&slaveInfo](JSON::ObjectWriter* writer) {
               json(writer, slaveInfo);
             });
@@ -885,32 +1131,29 @@ process::http::Response Master::ReadOnlyHandler::state(
     // Model all of the frameworks.
     writer->field(
         "frameworks",
-        [master, &approvers](JSON::ArrayWriter* writer) {
-          foreachvalue (
-              Framework* framework, master->frameworks.registered) {
+        [view, &approvers](JSON::ArrayWriter* writer) {
+          foreach (const FrameworkView& framework, view->frameworks) {
             // Skip unauthorized frameworks.
-            if (!approvers->approved<VIEW_FRAMEWORK>(framework->info)) {
+            if (!approvers->approved<VIEW_FRAMEWORK>(framework.info)) {
               continue;
             }
 
-            writer->element(FullFrameworkWriter(approvers, framework));
+            writer->element(FullFrameworkWriter(approvers, &framework));
           }
         });
 
     // Model all of the completed frameworks.
     writer->field(
         "completed_frameworks",
-        [master, &approvers](JSON::ArrayWriter* writer) {
-          foreachvalue (
-              const Owned<Framework>& framework,
-              master->frameworks.completed) {
+        [view, &approvers](JSON::ArrayWriter* writer) {
+          foreach (const FrameworkView& framework,
+                   view->completedFrameworks) {
             // Skip unauthorized frameworks.
-            if (!approvers->approved<VIEW_FRAMEWORK>(framework->info)) {
+            if (!approvers->approved<VIEW_FRAMEWORK>(framework.info)) {
               continue;
             }
 
-            writer->element(
-                FullFrameworkWriter(approvers, framework.get()));
+            writer->element(FullFrameworkWriter(approvers, &framework));
           }
         });
 
@@ -931,12 +1174,12 @@ process::http::Response Master::ReadOnlyHandler::stateSummary(
     const hashmap<std::string, std::string>& query,
     const process::Owned<ObjectApprovers>& approvers) const
 {
-  const Master* master = this->master;
-  auto stateSummary = [master, &approvers](JSON::ObjectWriter* writer) {
-    writer->field("hostname", master->info().hostname());
+  const State* view = this->view.get();
+  auto stateSummary = [view, &approvers](JSON::ObjectWriter* writer) {
+    writer->field("hostname", view->info.hostname());
 
-    if (master->flags.cluster.isSome()) {
-      writer->field("cluster", master->flags.cluster.get());
+    if (view->flags->cluster.isSome()) {
+      writer->field("cluster", view->flags->cluster.get());
     }
 
     // We use the tasks in the 'Frameworks' struct to compute summaries
@@ -948,32 +1191,30 @@ process::http::Response Master::ReadOnlyHandler::stateSummary(
     // recent completed / failed tasks.
 
     // Generate mappings from 'slave' to 'framework' and reverse.
-    SlaveFrameworkMapping slaveFrameworkMapping(
-        master->frameworks.registered);
+    SlaveFrameworkMapping slaveFrameworkMapping(view->frameworks);
 
     // Generate 'TaskState' summaries for all framework and slave ids.
-    TaskStateSummaries taskStateSummaries(
-        master->frameworks.registered);
+    TaskStateSummaries taskStateSummaries(view->frameworks);
 
     // Model all of the slaves.
     writer->field(
         "slaves",
-        [master,
+        [view,
          &slaveFrameworkMapping,
          &taskStateSummaries,
          &approvers](JSON::ArrayWriter* writer) {
-          foreachvalue (Slave* slave, master->slaves.registered) {
+          foreach (const SlaveView& slave, view->slaves) {
             writer->element(
                 [&slave,
                  &slaveFrameworkMapping,
                  &taskStateSummaries,
                  &approvers](JSON::ObjectWriter* writer) {
-                  SlaveWriter slaveWriter(*slave, approvers);
+                  SlaveWriter slaveWriter(slave, approvers);
                   slaveWriter(writer);
 
                   // Add the 'TaskState' summary for this slave.
                   const TaskStateSummary& summary =
-                      taskStateSummaries.slave(slave->id);
+                      taskStateSummaries.slave(slave.id);
 
                   // Certain per-agent status totals will always be zero
                   // (e.g., TASK_ERROR, TASK_UNREACHABLE). We report
@@ -997,7 +1238,7 @@ process::http::Response Master::ReadOnlyHandler::stateSummary(
                   // Add the ids of all the frameworks running on this
                   // slave.
                   const hashset<FrameworkID>& frameworks =
-                      slaveFrameworkMapping.frameworks(slave->id);
+                      slaveFrameworkMapping.frameworks(slave.id);
 
                   writer->field(
                       "framework_ids",
@@ -1015,24 +1256,24 @@ process::http::Response Master::ReadOnlyHandler::stateSummary(
     // Model all of the frameworks.
     writer->field(
         "frameworks",
-        [master,
+        [view,
          &slaveFrameworkMapping,
          &taskStateSummaries,
          &approvers](JSON::ArrayWriter* writer) {
-          foreachpair (const FrameworkID& frameworkId,
-                       Framework* framework,
-                       master->frameworks.registered) {
+          foreach (const FrameworkView& framework, view->frameworks) {
             // Skip unauthorized frameworks.
-            if (!approvers->approved<VIEW_FRAMEWORK>(framework->info)) {
+            if (!approvers->approved<VIEW_FRAMEWORK>(framework.info)) {
               continue;
             }
 
+            const FrameworkID& frameworkId = framework.id;
+
             writer->element(
                 [&frameworkId,
                  &framework,
                  &slaveFrameworkMapping,
                  &taskStateSummaries](JSON::ObjectWriter* writer) {
-                  json(writer, Summary<Framework>(*framework));
+                  json(writer, Summary<FrameworkView>(framework));
 
                   // Add the 'TaskState' summary for this framework.
                   const TaskStateSummary& summary =
@@ -1139,48 +1380,48 @@ process::http::Response Master::ReadOnlyHandler::tasks(
   IDAcceptor<TaskID> selectTaskId(taskId);
 
   // Construct framework list with both active and completed frameworks.
-  vector<const Framework*> frameworks;
-  foreachvalue (Framework* framework, master->frameworks.registered) {
+  vector<const FrameworkView*> frameworks;
+  foreach (const FrameworkView& framework, view->frameworks) {
     // Skip unauthorized frameworks or frameworks without matching
     // framework ID.
-    if (!selectFrameworkId.accept(framework->id()) ||
-        !approvers->approved<VIEW_FRAMEWORK>(framework->info)) {
+    if (!selectFrameworkId.accept(framework.id) ||
+        !approvers->approved<VIEW_FRAMEWORK>(framework.info)) {
       continue;
     }
 
-    frameworks.push_back(framework);
+    frameworks.push_back(&framework);
   }
 
-  foreachvalue (const Owned<Framework>& framework,
-                master->frameworks.completed) {
+  foreach (const FrameworkView& framework, view->completedFrameworks) {
     // Skip unauthorized frameworks or frameworks without matching
     // framework ID.
-    if (!selectFrameworkId.accept(framework->id()) ||
-        !approvers->approved<VIEW_FRAMEWORK>(framework->info)) {
+    if (!selectFrameworkId.accept(framework.id) ||
+        !approvers->approved<VIEW_FRAMEWORK>(framework.info)) {
      continue;
     }
 
-    frameworks.push_back(framework.get());
+    frameworks.push_back(&framework);
   }
 
   // Construct task list with both running,
   // completed and unreachable tasks.
   vector<const Task*> tasks;
-  foreach (const Framework* framework, frameworks) {
-    foreachvalue (Task* task, framework->tasks) {
-      CHECK_NOTNULL(task);
+
+  // Completed tasks are decoded here, so we need to keep them alive
+  // until the response is rendered.
+  vector<Owned<Task>> completedTasks;
+  foreach (const FrameworkView* framework, frameworks) {
+    foreach (const Owned<Task>& task, framework->tasks) {
       // Skip unauthorized tasks or tasks without matching task ID.
       if (!selectTaskId.accept(task->task_id()) ||
           !approvers->approved<VIEW_TASK>(*task, framework->info)) {
         continue;
       }
 
-      tasks.push_back(task);
+      tasks.push_back(task.get());
     }
 
-    foreachvalue (
-        const Owned<Task>& task,
-        framework->unreachableTasks) {
+    foreach (const Owned<Task>& task, framework->unreachableTasks) {
       // Skip unauthorized tasks or tasks without matching task ID.
       if (!selectTaskId.accept(task->task_id()) ||
           !approvers->approved<VIEW_TASK>(*task, framework->info)) {
@@ -1190,7 +1431,10 @@ process::http::Response Master::ReadOnlyHandler::tasks(
       tasks.push_back(task.get());
     }
 
-    foreach (const Owned<Task>& task, framework->completedTasks) {
+    foreach (const Owned<CompletedTask>& completedTask,
+             framework->completedTasks) {
+      Owned<Task> task(new Task(completedTask->get()));
+
       // Skip unauthorized tasks or tasks without matching task ID.
       if (!selectTaskId.accept(task->task_id()) ||
           !approvers->approved<VIEW_TASK>(*task, framework->info)) {
@@ -1198,6 +1442,7 @@ process::http::Response Master::ReadOnlyHandler::tasks(
       }
 
       tasks.push_back(task.get());
+      completedTasks.push_back(task);
     }
   }
 
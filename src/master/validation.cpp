@@ -60,6 +60,23 @@ namespace validation {
 namespace master {
 namespace call {
 
+// Validates that the field mask of a `GET_TASKS` or `GET_STATE` call
+// only names fields which exist in `descriptor`.
+static Option<Error> validateFields(
+    const RepeatedPtrField<string>& fields,
+    const google::protobuf::Descriptor* descriptor)
+{
+  foreach (const string& field, fields) {
+    if (descriptor->FindFieldByName(field) == nullptr) {
+      return Error(
+          "Unknown field '" + field + "' in '" + descriptor->full_name() + "'");
+    }
+  }
+
+  return None();
+}
+
+
 Option<Error> validate(const mesos::master::Call& call)
 {
   if (!call.IsInitialized()) {
@@ -110,8 +127,22 @@ Option<Error> validate(const mesos::master::Call& call)
       }
       return None();
 
-    case mesos::master::Call::GET_STATE:
-      return None();
+    case mesos::master::Call::GET_STATE: {
+      if (!call.has_get_state()) {
+        return None();
+      }
+
+      Option<Error> error = validateFields(
+          call.get_state().fields(),
+          mesos::master::Response::GetState::descriptor());
+
+      if (error.isSome()) {
+        return error;
+      }
+
+      return validateFields(
+          call.get_state().get_tasks().fields(), Task::descriptor());
+    }
 
     case mesos::master::Call::GET_AGENTS:
       return None();
@@ -126,7 +157,11 @@ Option<Error> validate(const mesos::master::Call& call)
       return None();
 
     case mesos::master::Call::GET_TASKS:
-      return None();
+      if (!call.has_get_tasks()) {
+        return None();
+      }
+
+      return validateFields(call.get_tasks().fields(), Task::descriptor());
 
     case mesos::master::Call::GET_ROLES:
       return None();
@@ -1375,10 +1410,12 @@ Option<Error> validateContainerInfo(const TaskInfo& task)
 
 
 // Validates task specific fields except its executor (if it exists).
+// `stateless` is the result of `validateStateless()` for the task.
 Option<Error> validateTask(
     const TaskInfo& task,
     Framework* framework,
-    Slave* slave)
+    Slave* slave,
+    const Option<Error>& stateless)
 {
   CHECK_NOTNULL(framework);
   CHECK_NOTNULL(slave);
@@ -1388,14 +1425,7 @@ Option<Error> validateTask(
   vector<lambda::function<Option<Error>()>> validators = {
     lambda::bind(internal::validateTaskID, task),
     lambda::bind(internal::validateUniqueTaskID, task, framework),
-    lambda::bind(internal::validateSlaveID, task, slave),
-    lambda::bind(internal::validateKillPolicy, task),
-    lambda::bind(internal::validateMaxCompletionTime, task),
-    lambda::bind(internal::validateCheck, task),
-    lambda::bind(internal::validateHealthCheck, task),
-    lambda::bind(internal::validateResources, task),
-    lambda::bind(internal::validateCommandInfo, task),
-    lambda::bind(internal::validateContainerInfo, task)
+    lambda::bind(internal::validateSlaveID, task, slave)
   };
 
   foreach (const lambda::function<Option<Error>()>& validator, validators) {
@@ -1405,7 +1435,7 @@ Option<Error> validateTask(
     }
   }
 
-  return None();
+  return stateless;
 }
 
 
@@ -1520,18 +1550,54 @@ Option<Error> validateExecutor(
 } // namespace internal {
 
 
+Option<Error> validateStateless(const TaskInfo& task)
+{
+  // NOTE: The order in which the following validate functions are
+  // executed does matter!
+  vector<lambda::function<Option<Error>()>> validators = {
+    lambda::bind(internal::validateKillPolicy, task),
+    lambda::bind(internal::validateMaxCompletionTime, task),
+    lambda::bind(internal::validateCheck, task),
+    lambda::bind(internal::validateHealthCheck, task),
+    lambda::bind(internal::validateResources, task),
+    lambda::bind(internal::validateCommandInfo, task),
+    lambda::bind(internal::validateContainerInfo, task)
+  };
+
+  foreach (const lambda::function<Option<Error>()>& validator, validators) {
+    Option<Error> error = validator();
+    if (error.isSome()) {
+      return error;
+    }
+  }
+
+  return None();
+}
+
+
 // Validate task and its executor (if it exists).
 Option<Error> validate(
     const TaskInfo& task,
     Framework* framework,
     Slave* slave,
     const Resources& offered)
+{
+  return validate(task, framework, slave, offered, validateStateless(task));
+}
+
+
+Option<Error> validate(
+    const TaskInfo& task,
+    Framework* framework,
+    Slave* slave,
+    const Resources& offered,
+    const Option<Error>& stateless)
 {
   CHECK_NOTNULL(framework);
   CHECK_NOTNULL(slave);
 
   vector<lambda::function<Option<Error>()>> validators = {
-    lambda::bind(internal::validateTask, task, framework, slave),
+    lambda::bind(internal::validateTask, task, framework, slave, stateless),
     lambda::bind(internal::validateExecutor, task, framework, slave, offered)
   };
 
@@ -1550,22 +1616,9 @@ namespace group {
 
 namespace internal {
 
-Option<Error> validateTask(
-    const TaskInfo& task,
-    Framework* framework,
-    Slave* slave)
+// Validates the `TaskGroup` specific fields of a task.
+Option<Error> validateTask(const TaskInfo& task)
 {
-  CHECK_NOTNULL(framework);
-  CHECK_NOTNULL(slave);
-
-  // Do the general validation first.
-  Option<Error> error = task::internal::validateTask(task, framework, slave);
-  if (error.isSome()) {
-    return error;
-  }
-
-  // Now do `TaskGroup` specific validation.
-
   if (!task.has_executor()) {
     return Error("'TaskInfo.executor' must be set");
   }
@@ -1725,18 +1778,55 @@ Option<Error> validateExecutor(
 } // namespace internal {
 
 
+Option<Error> validateStateless(const TaskInfo& task)
+{
+  // Do the general validation first.
+  Option<Error> error = task::validateStateless(task);
+  if (error.isSome()) {
+    return error;
+  }
+
+  // Now do `TaskGroup` specific validation.
+  return internal::validateTask(task);
+}
+
+
 Option<Error> validate(
     const TaskGroupInfo& taskGroup,
     const ExecutorInfo& executor,
     Framework* framework,
     Slave* slave,
     const Resources& offered)
+{
+  vector<Option<Error>> stateless;
+  stateless.reserve(taskGroup.tasks().size());
+
+  foreach (const TaskInfo& task, taskGroup.tasks()) {
+    stateless.push_back(validateStateless(task));
+  }
+
+  return validate(taskGroup, executor, framework, slave, offered, stateless);
+}
+
+
+Option<Error> validate(
+    const TaskGroupInfo& taskGroup,
+    const ExecutorInfo& executor,
+    Framework* framework,
+    Slave* slave,
+    const Resources& offered,
+    const vector<Option<Error>>& stateless)
 {
   CHECK_NOTNULL(framework);
   CHECK_NOTNULL(slave);
+  CHECK_EQ(taskGroup.tasks().size(), static_cast<int>(stateless.size()));
+
+  for (int i = 0; i < taskGroup.tasks().size(); i++) {
+    const TaskInfo& task = taskGroup.tasks(i);
+
+    Option<Error> error =
+      task::internal::validateTask(task, framework, slave, stateless[i]);
 
-  foreach (const TaskInfo& task, taskGroup.tasks()) {
-    Option<Error> error = internal::validateTask(task, framework, slave);
     if (error.isSome()) {
       return Error("Task '" + stringify(task.task_id()) + "' is invalid: " +
                    error->message);
@@ -183,6 +183,22 @@ Option<Error> validate(
     const Resources& offered);
 
 
+// Validates the fields of a task which do not depend on the state of
+// the master, so that this can be done off the master actor.
+Option<Error> validateStateless(const TaskInfo& task);
+
+
+// Same as the `validate()` above, except that the stateless part of
+// the validation is not done again: `stateless` is the result of
+// `validateStateless()` for the task.
+Option<Error> validate(
+    const TaskInfo& task,
+    Framework* framework,
+    Slave* slave,
+    const Resources& offered,
+    const Option<Error>& stateless);
+
+
 // Functions in this namespace are only exposed for testing.
 namespace internal {
 
@@ -223,6 +239,24 @@ Option<Error> validate(
     const Resources& offered);
 
 
+// Validates the fields of a task in a task group which do not depend
+// on the state of the master, so that this can be done off the master
+// actor.
+Option<Error> validateStateless(const TaskInfo& task);
+
+
+// Same as the `validate()` above, except that the stateless part of
+// the validation is not done again: `stateless` contains the results
+// of `validateStateless()` for the tasks of the task group, in order.
+Option<Error> validate(
+    const TaskGroupInfo& taskGroup,
+    const ExecutorInfo& executor,
+    Framework* framework,
+    Slave* slave,
+    const Resources& offered,
+    const std::vector<Option<Error>>& stateless);
+
+
 // Functions in this namespace are only exposed for testing.
 namespace internal {
 
@@ -1135,12 +1135,15 @@ StorageLocalResourceProviderProcess::reconcileOperationStatuses()
   const string resourceProviderDir = slave::paths::getResourceProviderPath(
       metaDir, slaveId, info.type(), info.name(), info.id());
 
+  // The operation status updates are group committed through a log,
+  // which is replayed by the `recover()` call below.
   statusUpdateManager.initialize(
       defer(self(), &Self::sendOperationStatusUpdate, lambda::_1),
       std::bind(
           &slave::paths::getOperationUpdatesPath,
           resourceProviderDir,
-          lambda::_1));
+          lambda::_1),
+      slave::paths::getOperationUpdatesLogPath(resourceProviderDir));
 
   Try<list<string>> operationPaths = slave::paths::getOperationPaths(
       slave::paths::getResourceProviderPath(
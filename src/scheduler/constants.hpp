@@ -17,6 +17,8 @@
 #ifndef __SCHEDULER_CONSTANTS_HPP__
 #define __SCHEDULER_CONSTANTS_HPP__
 
+#include <stddef.h>
+
 #include <stout/duration.hpp>
 
 namespace mesos {
@@ -27,6 +29,10 @@ namespace scheduler {
 // before connecting with the master.
 constexpr Duration DEFAULT_CONNECTION_DELAY_MAX = Milliseconds(500);
 
+// Default maximum number of calls the scheduler pipelines on the
+// non-subscribe connection before it queues further calls locally.
+constexpr size_t DEFAULT_MAX_PIPELINED_CALLS = 64;
+
 } // namespace scheduler {
 } // namespace v1 {
 } // namespace mesos {
@@ -21,6 +21,9 @@
 
 #include <mesos/mesos.hpp>
 
+#include <stout/error.hpp>
+#include <stout/option.hpp>
+
 #include "common/parse.hpp"
 
 #include "local/flags.hpp"
@@ -44,6 +47,20 @@ public:
         "initiating a (re-)connection attempt with the master.",
         DEFAULT_CONNECTION_DELAY_MAX);
 
+    add(&Flags::maxPipelinedCalls,
+        "max_pipelined_calls",
+        "The maximum number of non-subscribe calls that are sent to the\n"
+        "master without having received their responses. Further calls are\n"
+        "queued by the library and sent, in order, as responses arrive.",
+        DEFAULT_MAX_PIPELINED_CALLS,
+        [](size_t value) -> Option<Error> {
+          if (value == 0) {
+            return Error("Expected --max_pipelined_calls to be positive");
+          }
+
+          return None();
+        });
+
     add(&Flags::httpAuthenticatee,
         "http_authenticatee",
         "HTTP authenticatee implementation to use when authenticating against\n"
@@ -112,6 +129,7 @@ public:
   }
 
   Duration connectionDelayMax;
+  size_t maxPipelinedCalls;
   Option<Modules> modules;
   Option<std::string> modulesDir;
   std::string httpAuthenticatee;
@@ -29,6 +29,7 @@
 #include <arpa/inet.h>
 #endif // __WINDOWS__
 
+#include <deque>
 #include <iostream>
 #include <memory>
 #include <queue>
@@ -101,6 +102,7 @@ using namespace mesos::internal::master;
 
 using namespace process;
 
+using std::deque;
 using std::get;
 using std::ostream;
 using std::queue;
@@ -162,7 +164,8 @@ public:
       callbacks {connected, disconnected, received},
       credential(_credential),
       local(false),
-      flags(_flags)
+      flags(_flags),
+      pipelined(0)
   {
     GOOGLE_PROTOBUF_VERIFY_VERSION;
 
@@ -481,6 +484,17 @@ protected:
       subscribed->reader.close();
     }
 
+    // Fail the calls which are queued for the non-subscribe connection.
+    // Responses of calls which were already sent are ignored since they
+    // belong to the stale connection.
+    while (!queued.empty()) {
+      queued.front().promise->fail("Connection to master interrupted");
+      queued.pop_front();
+    }
+
+    queuedAcknowledgements.clear();
+    pipelined = 0;
+
     state = DISCONNECTED;
 
     connections = None();
@@ -609,7 +623,7 @@ protected:
       // Set the stream ID associated with this connection.
       request.headers["Mesos-Stream-Id"] = streamId->toString();
 
-      response = connections->nonSubscribe.send(request);
+      response = pipeline(call, request);
     }
 
     CHECK_SOME(connectionId);
@@ -734,9 +748,7 @@ protected:
     // Set the stream ID associated with this connection.
     request.headers["Mesos-Stream-Id"] = streamId->toString();
 
-    CHECK_SOME(connectionId);
-
-    return connections->nonSubscribe.send(request)
+    return pipeline(callMessage, request)
       .then(defer(self(),
                   &Self::__call,
                   callMessage,
@@ -781,6 +793,89 @@ protected:
     return result;
   }
 
+  // Sends a call on the non-subscribe connection. The connection
+  // pipelines requests and returns the responses in the order in which
+  // the requests were sent, so at most `flags.maxPipelinedCalls` are
+  // kept outstanding and any further calls are queued, in order, until
+  // a response arrives. This bounds the amount of work the scheduler
+  // can have outstanding at the master while preserving the order of
+  // all calls (and hence also the order of calls of the same type).
+  //
+  // An ACKNOWLEDGE call for a status update which is already queued is
+  // coalesced with the queued call, e.g., when a scheduler retries its
+  // acknowledgements while the master is slow to respond.
+  Future<process::http::Response> pipeline(
+      const Call& call,
+      const process::http::Request& request)
+  {
+    CHECK_SOME(connections);
+    CHECK_SOME(connectionId);
+
+    if (pipelined < flags.maxPipelinedCalls) {
+      pipelined++;
+
+      return connections->nonSubscribe.send(request)
+        .onAny(defer(self(), &Self::pipelineCompleted, connectionId.get()));
+    }
+
+    if (call.type() == Call::ACKNOWLEDGE) {
+      const string& uuid = call.acknowledge().uuid();
+
+      if (queuedAcknowledgements.contains(uuid)) {
+        VLOG(1) << "Coalescing " << call.type() << " call for status update "
+                << uuid << " with a queued call";
+
+        return queuedAcknowledgements.at(uuid);
+      }
+    }
+
+    QueuedCall queuedCall {
+        call,
+        request,
+        Owned<Promise<process::http::Response>>(
+            new Promise<process::http::Response>())};
+
+    Future<process::http::Response> future = queuedCall.promise->future();
+
+    if (call.type() == Call::ACKNOWLEDGE) {
+      queuedAcknowledgements.put(call.acknowledge().uuid(), future);
+    }
+
+    queued.push_back(std::move(queuedCall));
+
+    return future;
+  }
+
+  void pipelineCompleted(const id::UUID& _connectionId)
+  {
+    // Ignore responses from a stale connection, the pipeline has been
+    // reset when we disconnected from it.
+    if (connectionId != _connectionId) {
+      return;
+    }
+
+    CHECK_SOME(connections);
+    CHECK_GT(pipelined, 0u);
+
+    pipelined--;
+
+    while (pipelined < flags.maxPipelinedCalls && !queued.empty()) {
+      QueuedCall queuedCall = std::move(queued.front());
+      queued.pop_front();
+
+      if (queuedCall.call.type() == Call::ACKNOWLEDGE) {
+        queuedAcknowledgements.erase(queuedCall.call.acknowledge().uuid());
+      }
+
+      pipelined++;
+
+      queuedCall.promise->associate(
+          connections->nonSubscribe.send(queuedCall.request)
+            .onAny(defer(
+                self(), &Self::pipelineCompleted, connectionId.get())));
+    }
+  }
+
   void read()
   {
     subscribed->decoder->read()
@@ -866,6 +961,13 @@ private:
     lambda::function<void(const queue<Event>&)> received;
   };
 
+  struct QueuedCall
+  {
+    Call call;
+    process::http::Request request;
+    Owned<Promise<process::http::Response>> promise;
+  };
+
   struct SubscribedResponse
   {
     Pipe::Reader reader;
@@ -953,6 +1055,14 @@ private:
   Option<id::UUID> streamId;
   const Flags flags;
 
+  // Number of calls sent on the non-subscribe connection which have not
+  // received their responses yet, and the calls queued behind them.
+  size_t pipelined;
+  deque<QueuedCall> queued;
+
+  // The queued ACKNOWLEDGE calls, keyed by the status update UUID.
+  hashmap<string, Future<process::http::Response>> queuedAcknowledgements;
+
   Owned<mesos::http::authentication::Authenticatee> authenticatee;
 
   // Master detection future.
@@ -53,11 +53,19 @@ constexpr Duration DEFAULT_EXECUTOR_HEARTBEAT_INTERVAL = Minutes(30);
 
 constexpr Duration RECOVERY_TIMEOUT = Minutes(15);
 
+// Default number of threads used to read the checkpointed state
+// during agent recovery.
+constexpr size_t DEFAULT_RECOVERY_PARALLELISM = 8;
+
 // TODO(gkleiman): Move this to a different file once `TaskStatusUpdateManager`
 // uses `StatusUpdateManagerProcess`. See MESOS-8296.
 constexpr Duration STATUS_UPDATE_RETRY_INTERVAL_MIN = Seconds(10);
 constexpr Duration STATUS_UPDATE_RETRY_INTERVAL_MAX = Minutes(10);
 
+// Size above which the shared log of a status update manager running
+// in group commit mode is compacted into the per-stream files.
+constexpr Bytes STATUS_UPDATE_LOG_COMPACTION_THRESHOLD = Megabytes(4);
+
 // Default backoff interval used by the slave to wait before registration.
 constexpr Duration DEFAULT_REGISTRATION_BACKOFF_FACTOR = Seconds(1);
 
@@ -86,6 +94,9 @@ constexpr Duration DISK_WATCH_INTERVAL = Minutes(1);
 // Minimum free disk capacity enforced by the garbage collector.
 constexpr double GC_DISK_HEADROOM = 0.1;
 
+// Default number of paths removed in parallel by the garbage collector.
+constexpr size_t DEFAULT_GC_WORKERS = 1;
+
 // Maximum number of completed frameworks to store in memory.
 constexpr size_t MAX_COMPLETED_FRAMEWORKS = 50;
 
@@ -154,6 +165,11 @@ constexpr Duration DOCKER_INSPECT_TIMEOUT = Seconds(5);
 // in parallel to prevent hitting system's open file descriptor limit.
 constexpr size_t DOCKER_PS_MAX_INSPECT_CALLS = 100;
 
+// Maximum number of connections the Docker Engine API client opens to
+// the Docker daemon at once. Further requests wait for a connection to
+// become available.
+constexpr size_t DOCKER_ENGINE_MAX_CONNECTIONS = 32;
+
 // Default duration that docker containerizer will wait to check
 // docker version.
 // TODO(tnachen): Make this a flag.
@@ -189,6 +205,10 @@ constexpr Bytes DEFAULT_FETCHER_CACHE_SIZE = Gigabytes(2);
 // Default timeout for the fetcher to wait when a net download stalls.
 constexpr Duration DEFAULT_FETCHER_STALL_TIMEOUT = Minutes(1);
 
+// Time after which an idle fetcher worker is terminated. This is short
+// so that a burst of fetches does not leave idle workers behind.
+constexpr Duration FETCHER_WORKER_IDLE_TIMEOUT = Seconds(30);
+
 // If no pings received within this timeout, then the slave will
 // trigger a re-detection of the master to cause a re-registration.
 Duration DEFAULT_MASTER_PING_TIMEOUT();
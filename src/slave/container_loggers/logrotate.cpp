@@ -14,13 +14,20 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
 #include <unistd.h>
+#include <zlib.h>
 
+#include <stdio.h>
+
+#include <algorithm>
 #include <new>
 
 #include <functional>
 #include <string>
+#include <vector>
 
+#include <process/async.hpp>
 #include <process/defer.hpp>
 #include <process/dispatch.hpp>
 #include <process/id.hpp>
@@ -30,12 +37,24 @@
 #include <stout/bytes.hpp>
 #include <stout/error.hpp>
 #include <stout/exit.hpp>
+#include <stout/foreach.hpp>
+#include <stout/none.hpp>
 #include <stout/nothing.hpp>
+#include <stout/numify.hpp>
+#include <stout/option.hpp>
 #include <stout/path.hpp>
 #include <stout/stringify.hpp>
+#include <stout/strings.hpp>
 #include <stout/try.hpp>
 
+#include <stout/os/close.hpp>
+#include <stout/os/exists.hpp>
+#include <stout/os/lseek.hpp>
+#include <stout/os/open.hpp>
 #include <stout/os/pagesize.hpp>
+#include <stout/os/read.hpp>
+#include <stout/os/rename.hpp>
+#include <stout/os/rm.hpp>
 #include <stout/os/shell.hpp>
 #include <stout/os/su.hpp>
 #include <stout/os/write.hpp>
@@ -48,6 +67,134 @@
 using namespace process;
 using namespace mesos::internal::logger::rotate;
 
+using std::string;
+using std::vector;
+
+
+// The subset of 'logrotate' options which the logger implements itself,
+// without forking 'logrotate' on every rotation.
+struct RotateOptions
+{
+  // Number of rotated log files to keep, i.e. 'rotate <count>'.
+  // Like in 'logrotate', no rotated log files are kept by default.
+  size_t count = 0;
+
+  // Whether rotated log files are compressed with gzip.
+  bool compress = false;
+
+  // Whether compression is postponed to the next rotation, so that the
+  // most recently rotated log file stays uncompressed.
+  bool delaycompress = false;
+};
+
+
+// Parses the `--logrotate_options` into the options which the logger
+// implements itself. Returns `None` if there is any option which only
+// 'logrotate' implements, e.g. 'postrotate' scripts or 'copytruncate'.
+static Option<RotateOptions> parse(const Option<string>& options)
+{
+  RotateOptions result;
+
+  if (options.isNone()) {
+    return result;
+  }
+
+  foreach (const string& line, strings::tokenize(options.get(), "\n")) {
+    const vector<string> tokens = strings::tokenize(line, " \t\r");
+
+    if (tokens.empty() || strings::startsWith(tokens[0], "#")) {
+      continue;
+    }
+
+    const string& option = tokens[0];
+
+    if (option == "rotate" && tokens.size() == 2) {
+      Try<size_t> count = numify<size_t>(tokens[1]);
+      if (count.isError()) {
+        return None();
+      }
+
+      result.count = count.get();
+    } else if (option == "compress" && tokens.size() == 1) {
+      result.compress = true;
+    } else if (option == "nocompress" && tokens.size() == 1) {
+      result.compress = false;
+    } else if (option == "delaycompress" && tokens.size() == 1) {
+      result.delaycompress = true;
+    } else if (option == "nodelaycompress" && tokens.size() == 1) {
+      result.delaycompress = false;
+    } else if (option == "size") {
+      // The size is overridden by `--max_size` anyway.
+      continue;
+    } else if ((option == "missingok" ||
+                option == "nomissingok" ||
+                option == "ifempty" ||
+                option == "notifempty" ||
+                option == "nocopytruncate") &&
+               tokens.size() == 1) {
+      // These options make no difference for rotations triggered by the
+      // logger: the leading log file always exists and is never empty.
+      continue;
+    } else {
+      return None();
+    }
+  }
+
+  return result;
+}
+
+
+// Compresses the file at `path` into '<path>.gz' like 'gzip' does, and
+// removes the uncompressed file once it has been compressed.
+static Try<Nothing> compressFile(const string& path)
+{
+  Try<int> fd = os::open(path, O_RDONLY | O_CLOEXEC);
+  if (fd.isError()) {
+    return Error("Failed to open '" + path + "': " + fd.error());
+  }
+
+  const string target = path + ".gz";
+
+  gzFile file = gzopen(target.c_str(), "wb");
+  if (file == nullptr) {
+    os::close(fd.get());
+    return Error("Failed to open '" + target + "'");
+  }
+
+  char buffer[BUFSIZ];
+
+  while (true) {
+    ssize_t length = os::read(fd.get(), buffer, sizeof(buffer));
+    if (length < 0) {
+      ErrnoError error("Failed to read '" + path + "'");
+      gzclose(file);
+      os::close(fd.get());
+      os::rm(target);
+      return error;
+    }
+
+    if (length == 0) {
+      break;
+    }
+
+    if (gzwrite(file, buffer, static_cast<unsigned>(length)) != length) {
+      gzclose(file);
+      os::close(fd.get());
+      os::rm(target);
+      return Error("Failed to write '" + target + "'");
+    }
+  }
+
+  os::close(fd.get());
+
+  if (gzclose(file) != Z_OK) {
+    os::rm(target);
+    return Error("Failed to write '" + target + "'");
+  }
+
+  return os::rm(path);
+}
+
 
 class LogrotateLoggerProcess : public Process<LogrotateLoggerProcess>
 {
@@ -55,12 +202,20 @@ public:
   LogrotateLoggerProcess(const Flags& _flags)
     : ProcessBase(process::ID::generate("logrotate-logger")),
       flags(_flags),
+      options(parse(_flags.logrotate_options)),
       leading(None()),
-      bytesWritten(0)
+      bytesWritten(0),
+      compressing(Nothing())
   {
     // Prepare a buffer for reading from the `incoming` pipe.
     length = os::pagesize();
     buffer = new char[length];
+
+#ifdef __linux__
+    splicing = true;
+#else
+    splicing = false;
+#endif // __linux__
   }
 
   ~LogrotateLoggerProcess() override
@@ -85,6 +240,9 @@ public:
     // NOTE: We specify a size of `--max_size - length` because `logrotate`
     // has slightly different size semantics.  `logrotate` will rotate when the
     // max size is *exceeded*.  We rotate to keep files *under* the max size.
+    //
+    // NOTE: The configuration file is written even if the logger rotates
+    // the log files itself, as it documents how the files are rotated.
     const std::string config =
       "\"" + flags.log_filename.get() + "\" {\n" +
       flags.logrotate_options.getOrElse("") + "\n" +
@@ -98,7 +256,7 @@ public:
       return Failure("Failed to write configuration file: " + result.error());
     }
 
-    // NOTE: This is a prerequisuite for `io::read`.
+    // NOTE: This is a prerequisuite for `io::read` and `io::poll`.
     Try<Nothing> async = io::prepare_async(STDIN_FILENO);
     if (async.isError()) {
       return Failure("Failed to set async pipe: " + async.error());
@@ -107,65 +265,148 @@ public:
     // NOTE: This does not block.
     loop();
 
-    return promise.future();
+    // Wait for the compression of the last rotated log file, if any.
+    return promise.future()
+      .then(defer(self(), [this]() { return compressing; }));
   }
 
-  // Reads from stdin and writes to the leading log file.
+  // Moves data from stdin to the leading log file.
   void loop()
   {
-    io::read(STDIN_FILENO, buffer, length)
-      .then(defer(self(), [&](size_t readSize) -> Future<Nothing> {
+    // If the leading log file is not open, open it.
+    Try<Nothing> open = this->open();
+    if (open.isError()) {
+      promise.fail("Failed to write: " + open.error());
+      return;
+    }
+
+    // NOTE: We never move more data than fits into the leading log file,
+    // so that each log file is exactly `--max_size` before rotation.
+    transfer(flags.max_size.bytes() - bytesWritten)
+      .onFailed(defer(self(), [this](const string& failure) {
+        promise.fail(failure);
+      }))
+      .onReady(defer(self(), [this](size_t size) {
         // Check if EOF has been reached on the input stream.
         // This indicates that the container (whose logs are being
         // piped to this process) has exited.
-        if (readSize <= 0) {
+        if (size == 0) {
           promise.set(Nothing());
-          return Nothing();
+          return;
         }
 
-        // Do log rotation (if necessary) and write the bytes to the
-        // leading log file.
-        Try<Nothing> result = write(readSize);
-        if (result.isError()) {
-          promise.fail("Failed to write: " + result.error());
-          return Nothing();
+        bytesWritten += size;
+
+        // Rotate the log file once it has reached `--max_size`.
+        if (bytesWritten >= flags.max_size.bytes()) {
+          rotate()
+            .onAny(defer(self(), [this](const Future<Nothing>&) {
+              loop();
+            }));
+
+          return;
         }
 
         // Use `dispatch` to limit the size of the call stack.
         dispatch(self(), &LogrotateLoggerProcess::loop);
-
-        return Nothing();
       }));
   }
 
-  // Writes the buffer from stdin to the leading log file.
-  // When the number of written bytes exceeds `--max_size`, the leading
-  // log file is rotated.  When the number of log files exceed `--max_files`,
-  // the oldest log file is deleted.
-  Try<Nothing> write(size_t readSize)
+  // Opens the leading log file if it is not open yet.
+  Try<Nothing> open()
   {
-    // Rotate the log file if it will grow beyond the `--max_size`.
-    if (bytesWritten + readSize > flags.max_size.bytes()) {
-      rotate();
+    if (leading.isSome()) {
+      return Nothing();
     }
 
-    // If the leading log file is not open, open it.
-    // NOTE: We open the file in append-mode as `logrotate` may sometimes fail.
-    if (leading.isNone()) {
-      Try<int> open = os::open(
-          flags.log_filename.get(),
-          O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
-          S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
-
-      if (open.isError()) {
-        return Error(
-            "Failed to open '" + flags.log_filename.get() +
-            "': " + open.error());
-      }
+    // NOTE: We do not open the file in append-mode because `splice`
+    // does not support it. Instead we write from the end of the file,
+    // as `logrotate` may sometimes fail to move the leading log file.
+    Try<int> open = os::open(
+        flags.log_filename.get(),
+        O_WRONLY | O_CREAT | O_CLOEXEC,
+        S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    if (open.isError()) {
+      return Error(
+          "Failed to open '" + flags.log_filename.get() +
+          "': " + open.error());
+    }
+
+    Try<off_t> seek = os::lseek(open.get(), 0, SEEK_END);
+    if (seek.isError()) {
+      os::close(open.get());
+      return Error(
+          "Failed to seek '" + flags.log_filename.get() +
+          "': " + seek.error());
+    }
+
+    leading = open.get();
 
-      leading = open.get();
+    return Nothing();
+  }
+
+  // Moves at most `size` bytes from stdin to the leading log file and
+  // returns the number of bytes moved. Zero bytes are moved on EOF.
+  Future<size_t> transfer(size_t size)
+  {
+#ifdef __linux__
+    // On Linux, the data is moved from the pipe into the log file with
+    // `splice`, i.e., without copying it through a userspace buffer.
+    if (splicing) {
+      return io::poll(STDIN_FILENO, io::READ)
+        .then(defer(self(), [this, size]() -> Future<size_t> {
+          ssize_t spliced = ::splice(
+              STDIN_FILENO,
+              nullptr,
+              leading.get(),
+              nullptr,
+              size,
+              SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+          if (spliced >= 0) {
+            return static_cast<size_t>(spliced);
+          }
+
+          if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return transfer(size);
+          }
+
+          // Stdin is not a pipe or the file system does not support
+          // `splice`, so we fall back to reading and writing.
+          if (errno == EINVAL) {
+            splicing = false;
+            return transfer(size);
+          }
+
+          // On any other error (e.g., a full disk), we read and write
+          // the data, as we always drain stdin (see `write`).
+          std::cerr << ErrnoError("Failed to splice").message << std::endl;
+          return read(size);
+        }));
     }
+#endif // __linux__
 
+    return read(size);
+  }
+
+  // Reads at most `size` bytes from stdin and writes them to the
+  // leading log file.
+  Future<size_t> read(size_t size)
+  {
+    return io::read(STDIN_FILENO, buffer, std::min(size, length))
+      .then(defer(self(), [this](size_t readSize) {
+        if (readSize > 0) {
+          write(readSize);
+        }
+
+        return readSize;
+      }));
+  }
+
+  // Writes the buffer from stdin to the leading log file.
+  void write(size_t readSize)
+  {
     // Write from stdin to `leading`.
     // NOTE: We do not exit on error here since we are prioritizing
     // clearing the STDIN pipe (which would otherwise potentially block
@@ -176,45 +417,136 @@ public:
     if (result.isError()) {
       std::cerr << "Failed to write: " << result.error() << std::endl;
     }
-
-    bytesWritten += readSize;
-
-    return Nothing();
   }
 
-  // Calls `logrotate` on the leading log file and resets the `bytesWritten`.
-  void rotate()
+  // Rotates the leading log file and resets the `bytesWritten`.
+  // When the number of rotated log files exceeds the 'rotate' option,
+  // the oldest log file is deleted.
+  Future<Nothing> rotate()
   {
     if (leading.isSome()) {
       os::close(leading.get());
       leading = None();
     }
 
-    // Call `logrotate` to move around the files.
-    // NOTE: If `logrotate` fails for whatever reason, we will ignore
-    // the error and continue logging.  In case the leading log file
-    // is not renamed, we will continue appending to the existing
-    // leading log file.
-    os::shell(
-        flags.logrotate_path +
-        " --state \"" + flags.log_filename.get() + STATE_SUFFIX + "\" \"" +
-        flags.log_filename.get() + CONF_SUFFIX + "\"");
-
     // Reset the number of bytes written.
     bytesWritten = 0;
+
+    if (options.isNone()) {
+      // Call `logrotate` to move around the files.
+      // NOTE: If `logrotate` fails for whatever reason, we will ignore
+      // the error and continue logging.  In case the leading log file
+      // is not renamed, we will continue appending to the existing
+      // leading log file.
+      os::shell(
+          flags.logrotate_path +
+          " --state \"" + flags.log_filename.get() + STATE_SUFFIX + "\" \"" +
+          flags.log_filename.get() + CONF_SUFFIX + "\"");
+
+      return Nothing();
+    }
+
+    // NOTE: If the previously rotated log file is still being compressed,
+    // the rotation waits for the compression before moving the files.
+    // This stops reading from stdin, and hence applies backpressure to
+    // the container, when it logs faster than the files are compressed.
+    return compressing
+      .then(defer(self(), &LogrotateLoggerProcess::_rotate));
+  }
+
+  // Moves around the files like `logrotate` does: '<log>.<i>' is renamed
+  // to '<log>.<i+1>', the oldest file is deleted, and the leading log
+  // file is renamed to '<log>.1'.
+  // NOTE: Like with `logrotate`, errors are ignored and logging continues.
+  Future<Nothing> _rotate()
+  {
+    const string& log = flags.log_filename.get();
+    const size_t count = options->count;
+
+    // Like `logrotate`, a count of zero removes the leading log file.
+    if (count == 0) {
+      remove(log);
+      return Nothing();
+    }
+
+    remove(log + "." + stringify(count));
+    remove(log + "." + stringify(count) + ".gz");
+
+    for (size_t i = count - 1; i >= 1; i--) {
+      move(log + "." + stringify(i), log + "." + stringify(i + 1));
+      move(log + "." + stringify(i) + ".gz",
+           log + "." + stringify(i + 1) + ".gz");
+    }
+
+    move(log, log + "." + stringify(1));
+
+    if (options->compress) {
+      const size_t index = options->delaycompress ? 2 : 1;
+      const string path = log + "." + stringify(index);
+
+      if (index <= count && os::exists(path)) {
+        compressing = async([path]() {
+          Try<Nothing> compress = compressFile(path);
+          if (compress.isError()) {
+            std::cerr << "Failed to compress '" << path << "': "
+                      << compress.error() << std::endl;
+          }
+
+          return Nothing();
+        });
+      }
+    }
+
+    return Nothing();
   }
 
 private:
+  static void move(const string& from, const string& to)
+  {
+    if (!os::exists(from)) {
+      return;
+    }
+
+    Try<Nothing> rename = os::rename(from, to);
+    if (rename.isError()) {
+      std::cerr << "Failed to rename '" << from << "' to '" << to << "': "
+                << rename.error() << std::endl;
+    }
+  }
+
+  static void remove(const string& path)
+  {
+    if (!os::exists(path)) {
+      return;
+    }
+
+    Try<Nothing> rm = os::rm(path);
+    if (rm.isError()) {
+      std::cerr << "Failed to remove '" << path << "': "
+                << rm.error() << std::endl;
+    }
+  }
+
   Flags flags;
 
+  // The options if the logger rotates the log files itself, or `None`
+  // if it calls `logrotate` instead.
+  const Option<RotateOptions> options;
+
   // For reading from stdin.
   char* buffer;
   size_t length;
 
+  // Whether data is moved from stdin with `splice`.
+  bool splicing;
+
   // For writing and rotating the leading log file.
   Option<int> leading;
   size_t bytesWritten;
 
+  // The compression of the most recently rotated log file.
+  Future<Nothing> compressing;
+
   // Used to capture when log rotation has completed because the
   // underlying process/input has terminated.
   Promise<Nothing> promise;
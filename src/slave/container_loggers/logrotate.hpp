@@ -47,9 +47,12 @@ struct Flags : public virtual flags::FlagsBase
       "Usage: " + NAME + " [options]\n"
       "\n"
       "This command pipes from STDIN to the given leading log file.\n"
-      "When the leading log file reaches '--max_size', the command.\n"
-      "uses 'logrotate' to rotate the logs.  All 'logrotate' options\n"
-      "are supported.  See '--logrotate_options'.\n"
+      "When the leading log file reaches '--max_size', the command\n"
+      "rotates the logs.  All 'logrotate' options are supported.\n"
+      "If the options only consist of 'rotate', 'compress',\n"
+      "'delaycompress' and their negations, the command rotates and\n"
+      "compresses the logs itself.  Otherwise it uses 'logrotate'.\n"
+      "See '--logrotate_options'.\n"
       "\n");
 
     add(&Flags::max_size,
@@ -75,7 +78,10 @@ struct Flags : public virtual flags::FlagsBase
         "    <logrotate_options>\n"
         "    size <max_size>\n"
         "  }\n"
-        "NOTE: The 'size' option will be overridden by this command.");
+        "NOTE: The 'size' option will be overridden by this command.\n"
+        "NOTE: 'logrotate' is only called if there are options other than\n"
+        "'rotate <count>', '[no]compress', '[no]delaycompress',\n"
+        "'[no]missingok', 'ifempty', 'notifempty' and 'nocopytruncate'.");
 
     add(&Flags::log_filename,
         "log_filename",
@@ -94,7 +94,9 @@ public:
 
   Future<Nothing> remove(const ContainerID& containerId);
 
-  Future<Nothing> pruneImages(const vector<Image>& excludedImages);
+  Future<Nothing> pruneImages(
+      const vector<Image>& excludedImages,
+      const Option<double>& headroom);
 
 private:
   // Continuations.
@@ -259,10 +261,14 @@ Future<Nothing> ComposingContainerizer::remove(const ContainerID& containerId)
 
 
 Future<Nothing> ComposingContainerizer::pruneImages(
-    const vector<Image>& excludedImages)
+    const vector<Image>& excludedImages,
+    const Option<double>& headroom)
 {
   return dispatch(
-      process, &ComposingContainerizerProcess::pruneImages, excludedImages);
+      process,
+      &ComposingContainerizerProcess::pruneImages,
+      excludedImages,
+      headroom);
 }
 
 
@@ -674,12 +680,13 @@ Future<Nothing> ComposingContainerizerProcess::remove(
 
 
 Future<Nothing> ComposingContainerizerProcess::pruneImages(
-    const vector<Image>& excludedImages)
+    const vector<Image>& excludedImages,
+    const Option<double>& headroom)
 {
   vector<Future<Nothing>> futures;
 
   foreach (Containerizer* containerizer, containerizers_) {
-    futures.push_back(containerizer->pruneImages(excludedImages));
+    futures.push_back(containerizer->pruneImages(excludedImages, headroom));
   }
 
   return collect(futures)
@@ -88,7 +88,8 @@ public:
   process::Future<Nothing> remove(const ContainerID& containerId) override;
 
   process::Future<Nothing> pruneImages(
-      const std::vector<Image>& excludedImages) override;
+      const std::vector<Image>& excludedImages,
+      const Option<double>& headroom) override;
 
 private:
   ComposingContainerizerProcess* process;
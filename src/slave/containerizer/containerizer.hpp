@@ -170,9 +170,14 @@ public:
     return process::Failure("Unsupported");
   }
 
-  // Prune unused images from supported image stores.
+  // Prune unused images from supported image stores. If `headroom` is
+  // set, stores which support it only evict the least recently used
+  // images until their disk usage is back below the headroom, which
+  // is what the automatic image GC does. Otherwise all unused images
+  // which are not in `excludedImages` are pruned.
   virtual process::Future<Nothing> pruneImages(
-      const std::vector<Image>& excludedImages) = 0;
+      const std::vector<Image>& excludedImages,
+      const Option<double>& headroom) = 0;
 };
 
 } // namespace slave {
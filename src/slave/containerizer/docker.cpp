@@ -56,6 +56,10 @@
 
 #include "common/status_utils.hpp"
 
+#ifndef __WINDOWS__
+#include "docker/engine.hpp"
+#endif // __WINDOWS__
+
 #include "hook/manager.hpp"
 
 #ifdef __linux__
@@ -181,11 +185,27 @@ Try<DockerContainerizer*> DockerContainerizer::create(
     return Error("Failed to create container logger: " + logger.error());
   }
 
+  // Only the selected implementation is created, so that the docker
+  // CLI is not probed when the engine API is used.
+#ifdef __WINDOWS__
   Try<Owned<Docker>> create = Docker::create(
       flags.docker,
       flags.docker_socket,
       true,
       flags.docker_config);
+#else
+  Try<Owned<Docker>> create = flags.docker_engine_api
+    ? DockerEngine::create(
+          flags.docker,
+          flags.docker_socket,
+          true,
+          flags.docker_config)
+    : Docker::create(
+          flags.docker,
+          flags.docker_socket,
+          true,
+          flags.docker_config);
+#endif // __WINDOWS__
 
   if (create.isError()) {
     return Error("Failed to create docker: " + create.error());
@@ -254,6 +274,9 @@ DockerContainerizer::~DockerContainerizer()
   dockerFlags.sandbox_directory = directory;
   dockerFlags.mapped_directory = flags.sandbox_directory;
   dockerFlags.docker_socket = flags.docker_socket;
+#ifndef __WINDOWS__
+  dockerFlags.docker_engine_api = flags.docker_engine_api;
+#endif // __WINDOWS__
   dockerFlags.launcher_dir = flags.launcher_dir;
 
   if (taskEnvironment.isSome()) {
@@ -877,7 +900,8 @@ Future<hashset<ContainerID>> DockerContainerizer::containers()
 
 
 Future<Nothing> DockerContainerizer::pruneImages(
-    const vector<Image>& excludedImages)
+    const vector<Image>& excludedImages,
+    const Option<double>& headroom)
 {
   VLOG(1) << "DockerContainerizer does not support pruneImages";
   return Nothing();
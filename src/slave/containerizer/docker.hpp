@@ -114,7 +114,8 @@ public:
   process::Future<hashset<ContainerID>> containers() override;
 
   process::Future<Nothing> pruneImages(
-      const std::vector<Image>& excludedImages) override;
+      const std::vector<Image>& excludedImages,
+      const Option<double>& headroom) override;
 
 private:
   process::Owned<DockerContainerizerProcess> process;
@@ -19,8 +19,10 @@
 #include <process/async.hpp>
 #include <process/check.hpp>
 #include <process/collect.hpp>
+#include <process/delay.hpp>
 #include <process/dispatch.hpp>
 #include <process/id.hpp>
+#include <process/io.hpp>
 #include <process/owned.hpp>
 #include <process/subprocess.hpp>
 
@@ -28,6 +30,7 @@
 
 #include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
+#include <stout/json.hpp>
 #include <stout/net.hpp>
 #include <stout/path.hpp>
 #include <stout/strings.hpp>
@@ -47,6 +50,8 @@
 
 #include "common/status_utils.hpp"
 
+#include "slave/constants.hpp"
+
 #include "slave/containerizer/fetcher_process.hpp"
 
 using std::list;
@@ -65,6 +70,7 @@ using process::async;
 using process::Failure;
 using process::Future;
 using process::Owned;
+using process::Promise;
 using process::Subprocess;
 
 namespace mesos {
@@ -301,6 +307,14 @@ FetcherProcess::~FetcherProcess()
   foreachkey (const ContainerID& containerId, subprocessPids) {
     kill(containerId);
   }
+
+#ifndef __WINDOWS__
+  foreachvalue (const std::list<shared_ptr<Worker>>& pool, workers) {
+    foreach (const shared_ptr<Worker>& worker, pool) {
+      os::killtree(worker->subprocess.pid(), SIGKILL);
+    }
+  }
+#endif // __WINDOWS__
 }
 
 
@@ -538,6 +552,10 @@ Future<Nothing> FetcherProcess::__fetch(
   // the cache for and which ones we are bypassing the cache.
   FetcherInfo info;
 
+  // The entries downloaded by this fetch can be completed as soon as
+  // their items are fetched, see `FetcherProcess::fetched()`.
+  hashmap<int, shared_ptr<Cache::Entry>> downloading;
+
   foreachpair (const CommandInfo::URI& uri,
                const Option<shared_ptr<Cache::Entry>>& entry,
                entries) {
@@ -554,6 +572,8 @@ Future<Nothing> FetcherProcess::__fetch(
         // completion in FetcherProcess::fetch().
         item->set_action(FetcherInfo::Item::DOWNLOAD_AND_CACHE);
         item->set_cache_filename(entry.get()->filename);
+
+        downloading.put(info.items_size() - 1, entry.get());
       } else {
         CHECK_READY(entry.get()->completion());
         item->set_action(FetcherInfo::Item::RETRIEVE_FROM_CACHE);
@@ -578,10 +598,14 @@ Future<Nothing> FetcherProcess::__fetch(
   info.mutable_stall_timeout()
     ->set_nanoseconds(flags.fetcher_stall_timeout.ns());
 
+  downloads.put(containerId, downloading);
+
   return run(containerId, sandboxDirectory, user, info)
     .repair(defer(self(), [=](const Future<Nothing>& future) {
       ++metrics.task_fetches_failed;
 
+      downloads.erase(containerId);
+
       LOG(ERROR) << "Failed to run mesos-fetcher: " << future.failure();
 
       foreachvalue (const Option<shared_ptr<Cache::Entry>>& entry, entries) {
@@ -605,26 +629,15 @@ Future<Nothing> FetcherProcess::__fetch(
     .then(defer(self(), [=]() {
       ++metrics.task_fetches_succeeded;
 
+      downloads.erase(containerId);
+
       foreachvalue (const Option<shared_ptr<Cache::Entry>>& entry, entries) {
         if (entry.isSome()) {
           entry.get()->unreference();
 
           if (entry.get()->completion().isPending()) {
             // Successfully downloaded and cached!
-
-            Try<Nothing> adjust = cache.adjust(entry.get());
-            if (adjust.isSome()) {
-              entry.get()->complete();
-            } else {
-              LOG(WARNING) << "Failed to adjust the cache size for entry '"
-                           << entry.get()->key << "' with error: "
-                           << adjust.error();
-
-              // Successfully fetched, but not reusable from the
-              // cache, because we are deleting the entry now.
-              entry.get()->fail();
-              cache.remove(entry.get());
-            }
+            completeCacheEntry(entry.get());
           }
         }
       }
@@ -634,6 +647,44 @@ Future<Nothing> FetcherProcess::__fetch(
 }
 
 
+void FetcherProcess::completeCacheEntry(const shared_ptr<Cache::Entry>& entry)
+{
+  Try<Nothing> adjust = cache.adjust(entry);
+  if (adjust.isSome()) {
+    entry->complete();
+  } else {
+    LOG(WARNING) << "Failed to adjust the cache size for entry '"
+                 << entry->key << "' with error: " << adjust.error();
+
+    // Successfully fetched, but not reusable from the
+    // cache, because we are deleting the entry now.
+    entry->fail();
+    cache.remove(entry);
+  }
+}
+
+
+void FetcherProcess::fetched(const ContainerID& containerId, int index)
+{
+  if (!downloads.contains(containerId) ||
+      !downloads.at(containerId).contains(index)) {
+    return;
+  }
+
+  const shared_ptr<Cache::Entry> entry = downloads.at(containerId).at(index);
+  downloads.at(containerId).erase(index);
+
+  // Other containers fetching the same URI only need to wait for the
+  // cache file to be downloaded, not for this whole fetch to finish.
+  if (entry->completion().isPending()) {
+    VLOG(1) << "Downloaded '" << entry->key << "' into the cache for"
+            << " container " << containerId;
+
+    completeCacheEntry(entry);
+  }
+}
+
+
 static off_t delta(
     const Bytes& actualSize,
     const shared_ptr<FetcherProcess::Cache::Entry>& entry)
@@ -741,6 +792,53 @@ FetcherProcess::reserveCacheSpace(
 }
 
 
+// Returns the environment of the mesos-fetcher program for the given
+// `FetcherInfo`.
+static map<string, string> fetcherEnvironment(
+    const FetcherInfo& info,
+    const Flags& flags)
+{
+  // We pass arguments to the fetcher program by means of an
+  // environment variable.
+  // For assuring that we pass on variables that may be consumed by
+  // the mesos-fetcher, we whitelist them before masking out any
+  // unwanted agent->fetcher environment spillover.
+  // TODO(tillt): Consider using the `mesos::internal::logging::Flags`
+  // to determine the whitelist.
+  const hashset<string> whitelist = {
+    "MESOS_EXTERNAL_LOG_FILE",
+    "MESOS_INITIALIZE_DRIVER_LOGGING",
+    "MESOS_LOG_DIR",
+    "MESOS_LOGBUFSECS",
+    "MESOS_LOGGING_LEVEL",
+    "MESOS_QUIET"
+  };
+
+  map<string, string> environment;
+  foreachpair (const string& key, const string& value, os::environment()) {
+    if (whitelist.contains(strings::upper(key)) ||
+        (!startsWith(key, "LIBPROCESS_") && !startsWith(key, "MESOS_"))) {
+      environment.emplace(key, value);
+    }
+  }
+
+  environment["MESOS_FETCHER_INFO"] = stringify(JSON::protobuf(info));
+
+  if (flags.hadoop_home.isSome()) {
+    environment["HADOOP_HOME"] = flags.hadoop_home.get();
+  }
+
+  // TODO(jieyu): This is to make sure the libprocess of the fetcher
+  // can properly initialize and find the IP. Since we don't need to
+  // use the TCP socket for communication, it's OK to use a local
+  // address. Consider disable TCP socket in libprocess if libprocess
+  // supports that.
+  environment.emplace("LIBPROCESS_IP", "127.0.0.1");
+
+  return environment;
+}
+
+
 Future<Nothing> FetcherProcess::run(
     const ContainerID& containerId,
     const string& sandboxDirectory,
@@ -849,42 +947,21 @@ Future<Nothing> FetcherProcess::run(
   // Now the actual mesos-fetcher command.
   string command = realpath.get();
 
-  // We pass arguments to the fetcher program by means of an
-  // environment variable.
-  // For assuring that we pass on variables that may be consumed by
-  // the mesos-fetcher, we whitelist them before masking out any
-  // unwanted agent->fetcher environment spillover.
-  // TODO(tillt): Consider using the `mesos::internal::logging::Flags`
-  // to determine the whitelist.
-  const hashset<string> whitelist = {
-    "MESOS_EXTERNAL_LOG_FILE",
-    "MESOS_INITIALIZE_DRIVER_LOGGING",
-    "MESOS_LOG_DIR",
-    "MESOS_LOGBUFSECS",
-    "MESOS_LOGGING_LEVEL",
-    "MESOS_QUIET"
-  };
-
-  map<string, string> environment;
-  foreachpair (const string& key, const string& value, os::environment()) {
-    if (whitelist.contains(strings::upper(key)) ||
-        (!startsWith(key, "LIBPROCESS_") && !startsWith(key, "MESOS_"))) {
-      environment.emplace(key, value);
-    }
-  }
-
-  environment["MESOS_FETCHER_INFO"] = stringify(JSON::protobuf(info));
-
-  if (flags.hadoop_home.isSome()) {
-    environment["HADOOP_HOME"] = flags.hadoop_home.get();
-  }
-
-  // TODO(jieyu): This is to make sure the libprocess of the fetcher
-  // can properly initialize and find the IP. Since we don't need to
-  // use the TCP socket for communication, it's OK to use a local
-  // address. Consider disable TCP socket in libprocess if libprocess
-  // supports that.
-  environment.emplace("LIBPROCESS_IP", "127.0.0.1");
+#ifndef __WINDOWS__
+  // The worker opens the 'stdout' and 'stderr' files by itself.
+  os::close(out.get());
+  os::close(err.get());
+
+  Request request;
+  request.containerId = containerId;
+  request.user = user;
+  request.command = command;
+  request.info = info;
+  request.promise.reset(new Promise<Nothing>());
+
+  Future<Nothing> fetch = enqueue(request);
+#else
+  map<string, string> environment = fetcherEnvironment(info, flags);
 
   VLOG(1) << "Fetching URIs using command '" << command << "'";
 
@@ -905,7 +982,7 @@ Future<Nothing> FetcherProcess::run(
   // the subprocess.
   subprocessPids[containerId] = fetcherSubprocess->pid();
 
-  return fetcherSubprocess->status()
+  Future<Nothing> fetch = fetcherSubprocess->status()
     .then(defer(self(), [=](const Option<int>& status) -> Future<Nothing> {
       if (status.isNone()) {
         return Failure("No status available from mesos-fetcher");
@@ -919,6 +996,13 @@ Future<Nothing> FetcherProcess::run(
 
       return Nothing();
     }))
+    .onAny(defer(self(), [=](const Future<Nothing>&) {
+      // Clear the subprocess PID remembered from running mesos-fetcher.
+      subprocessPids.erase(containerId);
+    }));
+#endif // __WINDOWS__
+
+  return fetch
     .onFailed(defer(self(), [=](const string&) {
       // To aid debugging what went wrong when attempting to fetch, grab the
       // fetcher's local log output from the sandbox and log it here.
@@ -932,14 +1016,278 @@ Future<Nothing> FetcherProcess::run(
         LOG(ERROR) << "Fetcher log (stderr in sandbox) for container "
                    << containerId << " not readable: " << text.error();
       }
-    }))
-    .onAny(defer(self(), [=](const Future<Nothing>&) {
-      // Clear the subprocess PID remembered from running mesos-fetcher.
-      subprocessPids.erase(containerId);
     }));
 }
 
 
+#ifndef __WINDOWS__
+FetcherProcess::Worker::Worker(
+    const string& _user,
+    const Subprocess& _subprocess)
+  : user(_user),
+    subprocess(_subprocess),
+    decoder([](const string& data) -> Try<string> { return data; }),
+    fetches(0) {}
+
+
+Future<Nothing> FetcherProcess::enqueue(const Request& request)
+{
+  const string key = request.user.getOrElse("");
+
+  requests[key].push_back(request);
+
+  schedule(key);
+
+  return request.promise->future();
+}
+
+
+void FetcherProcess::schedule(const string& key)
+{
+  while (requests.contains(key) && !requests.at(key).empty()) {
+    shared_ptr<Worker> worker;
+
+    foreach (const shared_ptr<Worker>& candidate, workers[key]) {
+      if (candidate->request.isNone()) {
+        worker = candidate;
+        break;
+      }
+    }
+
+    if (worker.get() == nullptr) {
+      if (workers[key].size() >= flags.fetcher_max_workers_per_user) {
+        // The fetch is performed once a worker becomes idle.
+        return;
+      }
+
+      Try<shared_ptr<Worker>> launched = launch(requests.at(key).front());
+      if (launched.isError()) {
+        requests.at(key).front().promise->fail(
+            "Failed to execute mesos-fetcher: " + launched.error());
+
+        requests.at(key).pop_front();
+        continue;
+      }
+
+      worker = launched.get();
+      workers[key].push_back(worker);
+    }
+
+    Request request = requests.at(key).front();
+    requests.at(key).pop_front();
+
+    VLOG(1) << "Fetching URIs for container " << request.containerId
+            << " using the mesos-fetcher worker " << worker->subprocess.pid();
+
+    worker->request = request;
+
+    ::recordio::Encoder<string> encoder(
+        [](const string& data) { return data; });
+
+    const pid_t pid = worker->subprocess.pid();
+
+    process::io::write(
+        worker->subprocess.in().get(),
+        encoder.encode(stringify(JSON::protobuf(request.info))))
+      .onFailed([pid](const string& failure) {
+        LOG(ERROR) << "Failed to send the fetch to the mesos-fetcher worker "
+                   << pid << ": " << failure;
+
+        // The fetch fails once the worker has terminated.
+        os::killtree(pid, SIGKILL);
+      });
+  }
+
+  requests.erase(key);
+}
+
+
+Try<shared_ptr<FetcherProcess::Worker>> FetcherProcess::launch(
+    const Request& request)
+{
+  // The worker creates the cache directory of the user and drops its
+  // privileges based on the `FetcherInfo` it is launched with.
+  map<string, string> environment = fetcherEnvironment(request.info, flags);
+  environment["MESOS_FETCHER_WORKER"] = "true";
+
+  VLOG(1) << "Launching mesos-fetcher worker using command '"
+          << request.command << "'";
+
+  Try<Subprocess> subprocess = process::subprocess(
+      request.command,
+      Subprocess::PIPE(),
+      Subprocess::PIPE(),
+      Subprocess::FD(STDERR_FILENO),
+      environment);
+
+  if (subprocess.isError()) {
+    return Error(subprocess.error());
+  }
+
+  shared_ptr<Worker> worker(
+      new Worker(request.user.getOrElse(""), subprocess.get()));
+
+  read(worker);
+
+  return worker;
+}
+
+
+void FetcherProcess::read(const shared_ptr<Worker>& worker)
+{
+  process::io::read(
+      worker->subprocess.out().get(),
+      worker->buffer,
+      sizeof(worker->buffer))
+    .onAny(defer(self(), &Self::_read, worker, lambda::_1));
+}
+
+
+void FetcherProcess::_read(
+    const shared_ptr<Worker>& worker,
+    const Future<size_t>& length)
+{
+  if (!length.isReady() || length.get() == 0) {
+    if (length.isFailed()) {
+      LOG(ERROR) << "Failed to read from the mesos-fetcher worker "
+                 << worker->subprocess.pid() << ": " << length.failure();
+
+      os::killtree(worker->subprocess.pid(), SIGKILL);
+    }
+
+    worker->subprocess.status()
+      .onAny(defer(self(), &Self::exited, worker, lambda::_1));
+
+    return;
+  }
+
+  Try<std::deque<Try<string>>> records =
+    worker->decoder.decode(string(worker->buffer, length.get()));
+
+  bool valid = records.isSome();
+  if (valid) {
+    foreach (const Try<string>& record, records.get()) {
+      if (record.isError() || !handle(worker, record.get())) {
+        valid = false;
+        break;
+      }
+    }
+  }
+
+  if (!valid) {
+    LOG(ERROR) << "Received an invalid result from the mesos-fetcher worker "
+               << worker->subprocess.pid();
+
+    // The worker is removed once we see the end of its output.
+    os::killtree(worker->subprocess.pid(), SIGKILL);
+  }
+
+  read(worker);
+}
+
+
+bool FetcherProcess::handle(const shared_ptr<Worker>& worker, const string& data)
+{
+  Try<JSON::Object> object = JSON::parse<JSON::Object>(data);
+  if (object.isError() || worker->request.isNone()) {
+    return false;
+  }
+
+  Result<JSON::String> type = object->at<JSON::String>("type");
+  if (!type.isSome()) {
+    return false;
+  }
+
+  const Request request = worker->request.get();
+
+  if (type->value == "FETCHED") {
+    Result<JSON::Number> index = object->at<JSON::Number>("index");
+    if (!index.isSome()) {
+      return false;
+    }
+
+    fetched(request.containerId, index->as<int>());
+    return true;
+  }
+
+  if (type->value == "SUCCEEDED") {
+    request.promise->set(Nothing());
+  } else if (type->value == "FAILED") {
+    Result<JSON::String> message = object->at<JSON::String>("message");
+
+    request.promise->fail(
+        "Failed to fetch all URIs for container '" +
+        stringify(request.containerId) + "': " +
+        (message.isSome() ? message->value : "unknown error"));
+  } else {
+    return false;
+  }
+
+  worker->request = None();
+  worker->fetches++;
+
+  const string key = request.user.getOrElse("");
+
+  schedule(key);
+
+  if (worker->request.isNone()) {
+    delay(FETCHER_WORKER_IDLE_TIMEOUT,
+          self(),
+          &Self::retire,
+          worker,
+          worker->fetches);
+  }
+
+  return true;
+}
+
+
+void FetcherProcess::exited(
+    const shared_ptr<Worker>& worker,
+    const Future<Option<int>>& status)
+{
+  string reason = "terminated";
+  if (status.isReady() && status->isSome()) {
+    reason = WSTRINGIFY(status->get());
+  }
+
+  VLOG(1) << "The mesos-fetcher worker " << worker->subprocess.pid() << " "
+          << reason;
+
+  if (worker->request.isSome()) {
+    const Request& request = worker->request.get();
+
+    request.promise->fail(
+        "Failed to fetch all URIs for container '" +
+        stringify(request.containerId) + "': " + reason);
+  }
+
+  if (workers.contains(worker->user)) {
+    workers.at(worker->user).remove(worker);
+
+    if (workers.at(worker->user).empty()) {
+      workers.erase(worker->user);
+    }
+  }
+
+  // Fetches waiting for a worker of the user get a new one.
+  schedule(worker->user);
+}
+
+
+void FetcherProcess::retire(const shared_ptr<Worker>& worker, size_t fetches)
+{
+  if (worker->request.isNone() && worker->fetches == fetches) {
+    VLOG(1) << "Terminating the idle mesos-fetcher worker "
+            << worker->subprocess.pid();
+
+    // The worker is removed once we see the end of its output.
+    os::killtree(worker->subprocess.pid(), SIGKILL);
+  }
+}
+#endif // __WINDOWS__
+
+
 void FetcherProcess::kill(const ContainerID& containerId)
 {
   if (subprocessPids.contains(containerId)) {
@@ -949,6 +1297,34 @@ void FetcherProcess::kill(const ContainerID& containerId)
 
     subprocessPids.erase(containerId);
   }
+
+#ifndef __WINDOWS__
+  foreachvalue (std::deque<Request>& queue, requests) {
+    for (auto it = queue.begin(); it != queue.end();) {
+      if (it->containerId == containerId) {
+        it->promise->fail("The fetch was killed");
+        it = queue.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  foreachvalue (const std::list<shared_ptr<Worker>>& pool, workers) {
+    foreach (const shared_ptr<Worker>& worker, pool) {
+      if (worker->request.isSome() &&
+          worker->request->containerId == containerId) {
+        VLOG(1) << "Killing the mesos-fetcher worker "
+                << worker->subprocess.pid() << " fetching for container '"
+                << containerId << "'";
+
+        // The fetch fails once the worker has terminated. Other fetches
+        // of the user are performed by a new worker.
+        os::killtree(worker->subprocess.pid(), SIGKILL);
+      }
+    }
+  }
+#endif // __WINDOWS__
 }
 
 
@@ -1010,7 +1386,8 @@ shared_ptr<FetcherProcess::Cache::Entry> FetcherProcess::Cache::create(
       new Cache::Entry(key, cacheDirectory, filename));
 
   table.put(key, entry);
-  lruSortedEntries.push_back(entry);
+  lruPositions.put(
+      key, lruSortedEntries.insert(lruSortedEntries.end(), entry));
 
   VLOG(1) << "Created cache entry '" << key << "' with file: " << filename;
 
@@ -1044,8 +1421,8 @@ FetcherProcess::Cache::get(
     }
 
     // Refresh the cache entry by moving it to the back of lruSortedEntries.
-    lruSortedEntries.remove(entry.get());
-    lruSortedEntries.push_back(entry.get());
+    lruSortedEntries.splice(
+        lruSortedEntries.end(), lruSortedEntries, lruPositions.at(key));
   }
 
   return entry;
@@ -1118,7 +1495,8 @@ Try<Nothing> FetcherProcess::Cache::remove(
   CHECK(contains(entry));
 
   table.erase(entry->key);
-  lruSortedEntries.remove(entry);
+  lruSortedEntries.erase(lruPositions.at(entry->key));
+  lruPositions.erase(entry->key);
 
   // We may or may not have started downloading. The download may or may
   // not have been partial. In any case, clean up whatever is there.
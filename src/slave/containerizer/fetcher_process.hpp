@@ -17,6 +17,7 @@
 #ifndef __SLAVE_CONTAINERIZER_FETCHER_PROCESS_HPP__
 #define __SLAVE_CONTAINERIZER_FETCHER_PROCESS_HPP__
 
+#include <deque>
 #include <list>
 #include <memory>
 #include <string>
@@ -26,11 +27,13 @@
 
 #include <process/future.hpp>
 #include <process/process.hpp>
+#include <process/subprocess.hpp>
 
 #include <process/metrics/counter.hpp>
 #include <process/metrics/pull_gauge.hpp>
 
 #include <stout/hashmap.hpp>
+#include <stout/recordio.hpp>
 
 #include "slave/flags.hpp"
 
@@ -208,6 +211,11 @@ public:
 
     // Stores cache file entries sorted from LRU to MRU.
     std::list<std::shared_ptr<Entry>> lruSortedEntries;
+
+    // Maps keys to the positions of their entries in `lruSortedEntries`,
+    // so that entries can be refreshed and removed in constant time.
+    hashmap<std::string, std::list<std::shared_ptr<Entry>>::iterator>
+      lruPositions;
   };
 
   // Public and virtual for mock testing.
@@ -249,6 +257,75 @@ private:
       const Try<Bytes>& requestedSpace,
       const std::shared_ptr<Cache::Entry>& entry);
 
+  // Marks the entry, whose file has been downloaded into the cache, as
+  // complete, so that concurrent fetches waiting for it can proceed.
+  void completeCacheEntry(const std::shared_ptr<Cache::Entry>& entry);
+
+  // Called when the item with the given index of the `FetcherInfo` run
+  // for the container has been fetched.
+  void fetched(const ContainerID& containerId, int index);
+
+#ifndef __WINDOWS__
+  // A fetch to be performed by a worker, see below.
+  struct Request
+  {
+    ContainerID containerId;
+    Option<std::string> user;
+    std::string command;
+    mesos::fetcher::FetcherInfo info;
+    std::shared_ptr<process::Promise<Nothing>> promise;
+  };
+
+  // A long-lived mesos-fetcher program which performs the fetches of
+  // a single user one after the other. Workers save launching (and
+  // initializing) a mesos-fetcher for every container.
+  struct Worker
+  {
+    Worker(const std::string& _user, const process::Subprocess& _subprocess);
+
+    // The user the worker fetches for ("" if none).
+    const std::string user;
+
+    process::Subprocess subprocess;
+
+    // Decodes the results which the worker reports on its stdout.
+    ::recordio::Decoder<std::string> decoder;
+    char buffer[4096];
+
+    // The fetch in progress, if any.
+    Option<Request> request;
+
+    // Number of fetches performed so far, used to detect whether the
+    // worker has been idle since some point in time.
+    size_t fetches;
+  };
+
+  // Queues the fetch for one of the workers of the user.
+  process::Future<Nothing> enqueue(const Request& request);
+
+  // Hands the queued fetches of the user to idle workers, launching
+  // new workers up to `--fetcher_max_workers_per_user`.
+  void schedule(const std::string& user);
+
+  Try<std::shared_ptr<Worker>> launch(const Request& request);
+
+  void read(const std::shared_ptr<Worker>& worker);
+  void _read(
+      const std::shared_ptr<Worker>& worker,
+      const process::Future<size_t>& length);
+
+  // Handles a result reported by the worker. Returns false if the
+  // worker did not adhere to the protocol.
+  bool handle(const std::shared_ptr<Worker>& worker, const std::string& data);
+
+  void exited(
+      const std::shared_ptr<Worker>& worker,
+      const process::Future<Option<int>>& status);
+
+  // Terminates the worker if it has not performed any fetches since.
+  void retire(const std::shared_ptr<Worker>& worker, size_t fetches);
+#endif // __WINDOWS__
+
   struct Metrics
   {
     explicit Metrics(FetcherProcess *fetcher);
@@ -270,6 +347,16 @@ private:
   Cache cache;
 
   hashmap<ContainerID, pid_t> subprocessPids;
+
+  // The cache entries which the fetch of a container downloads, by the
+  // index of their item in the `FetcherInfo`.
+  hashmap<ContainerID, hashmap<int, std::shared_ptr<Cache::Entry>>> downloads;
+
+#ifndef __WINDOWS__
+  // Workers and queued fetches, by user ("" if none).
+  hashmap<std::string, std::list<std::shared_ptr<Worker>>> workers;
+  hashmap<std::string, std::deque<Request>> requests;
+#endif // __WINDOWS__
 };
 
 
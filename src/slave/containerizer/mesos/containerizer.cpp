@@ -714,10 +714,14 @@ Future<Nothing> MesosContainerizer::remove(const ContainerID& containerId)
 
 
 Future<Nothing> MesosContainerizer::pruneImages(
-    const vector<Image>& excludedImages)
+    const vector<Image>& excludedImages,
+    const Option<double>& headroom)
 {
   return dispatch(
-      process.get(), &MesosContainerizerProcess::pruneImages, excludedImages);
+      process.get(),
+      &MesosContainerizerProcess::pruneImages,
+      excludedImages,
+      headroom);
 }
 
 
@@ -3028,7 +3032,8 @@ Future<hashset<ContainerID>> MesosContainerizerProcess::containers()
 
 
 Future<Nothing> MesosContainerizerProcess::pruneImages(
-    const vector<Image>& excludedImages)
+    const vector<Image>& excludedImages,
+    const Option<double>& headroom)
 {
   vector<Image> _excludedImages;
   _excludedImages.reserve(containers_.size() + excludedImages.size());
@@ -3061,7 +3066,7 @@ Future<Nothing> MesosContainerizerProcess::pruneImages(
 
   // TODO(zhitao): use std::unique to deduplicate `_excludedImages`.
 
-  return provisioner->pruneImages(_excludedImages);
+  return provisioner->pruneImages(_excludedImages, headroom);
 }
 
 
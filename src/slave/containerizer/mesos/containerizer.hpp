@@ -121,7 +121,8 @@ public:
   process::Future<Nothing> remove(const ContainerID& containerId) override;
 
   process::Future<Nothing> pruneImages(
-      const std::vector<Image>& excludedImages) override;
+      const std::vector<Image>& excludedImages,
+      const Option<double>& headroom) override;
 
 private:
   explicit MesosContainerizer(
@@ -196,7 +197,8 @@ public:
   virtual process::Future<hashset<ContainerID>> containers();
 
   virtual process::Future<Nothing> pruneImages(
-      const std::vector<Image>& excludedImages);
+      const std::vector<Image>& excludedImages,
+      const Option<double>& headroom);
 
 private:
   enum State
@@ -14,11 +14,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -984,6 +986,7 @@ private:
         const http::Pipe::Writer& _writer,
         const ContentType& contentType)
       : writer(_writer),
+        type(contentType),
         encoder(lambda::bind(serialize, contentType, lambda::_1)) {}
 
     bool send(const agent::ProcessIO& message)
@@ -991,6 +994,23 @@ private:
       return writer.write(encoder.encode(message));
     }
 
+    // Sends a message which has already been encoded with `encode()`
+    // by a connection with the same content type.
+    bool send(const string& record)
+    {
+      return writer.write(record);
+    }
+
+    string encode(const agent::ProcessIO& message) const
+    {
+      return encoder.encode(message);
+    }
+
+    ContentType contentType() const
+    {
+      return type;
+    }
+
     bool close()
     {
       return writer.close();
@@ -1003,9 +1023,37 @@ private:
 
   private:
     http::Pipe::Writer writer;
+    ContentType type;
     ::recordio::Encoder<agent::ProcessIO> encoder;
   };
 
+  // The state of redirecting one of the container's output streams.
+  // The redirect owns (duplicates of) both file descriptors.
+  struct Redirect
+  {
+    Redirect(int _from, int _to, const agent::ProcessIO::Data::Type& _type)
+      : from(_from),
+        to(_to),
+        type(_type),
+        splice(true),
+        buffer(new char[process::io::BUFFERED_READ_SIZE]) {}
+
+    ~Redirect()
+    {
+      os::close(from);
+      os::close(to);
+    }
+
+    const int from;
+    const int to;
+    const agent::ProcessIO::Data::Type type;
+
+    // Whether the output can be moved with `splice`, see `transfer()`.
+    bool splice;
+
+    std::unique_ptr<char[]> buffer;
+  };
+
   // Sit in a heartbeat loop forever.
   void heartbeatLoop();
 
@@ -1038,6 +1086,17 @@ private:
       ContentType acceptType,
       Option<ContentType> messageAcceptType);
 
+  // Redirect the output from `from` to `to` and send it to all of our
+  // output connections, until EOF is reached on `from`.
+  Future<Nothing> redirect(
+      int from,
+      int to,
+      const agent::ProcessIO::Data::Type& type);
+
+  // Move the next chunk of output of the redirect and return its size,
+  // which is zero on EOF.
+  Future<size_t> transfer(const std::shared_ptr<Redirect>& redirect);
+
   // Asynchronously receive data as we read it from our
   // `stdoutFromFd` and `stderrFromFd` file descriptors.
   void outputHook(
@@ -1205,14 +1264,10 @@ Future<Nothing> IOSwitchboardServerProcess::run()
 
   startRedirect.future()
     .then(defer(self(), [this]() {
-      Future<Nothing> stdoutRedirect = process::io::redirect(
+      Future<Nothing> stdoutRedirect = redirect(
           stdoutFromFd,
           stdoutToFd,
-          process::io::BUFFERED_READ_SIZE,
-          {defer(self(),
-                 &Self::outputHook,
-                 lambda::_1,
-                 agent::ProcessIO::Data::STDOUT)});
+          agent::ProcessIO::Data::STDOUT);
 
       // NOTE: We don't need to redirect stderr if TTY is enabled. If
       // TTY is enabled for the container, stdout and stderr for the
@@ -1223,14 +1278,10 @@ Future<Nothing> IOSwitchboardServerProcess::run()
       if (tty) {
         stderrRedirect = Nothing();
       } else {
-        stderrRedirect = process::io::redirect(
+        stderrRedirect = redirect(
             stderrFromFd,
             stderrToFd,
-            process::io::BUFFERED_READ_SIZE,
-            {defer(self(),
-                   &Self::outputHook,
-                   lambda::_1,
-                   agent::ProcessIO::Data::STDERR)});
+            agent::ProcessIO::Data::STDERR);
       }
 
       // Set the future once our IO redirects finish. On failure,
@@ -1847,6 +1898,141 @@ Future<http::Response> IOSwitchboardServerProcess::attachContainerOutput(
 }
 
 
+Future<Nothing> IOSwitchboardServerProcess::redirect(
+    int from,
+    int to,
+    const agent::ProcessIO::Data::Type& type)
+{
+  // Duplicate the file descriptors so that we're in control of their
+  // lifetime, like `process::io::redirect()` does.
+  Try<int_fd> dupFrom = os::dup(from);
+  if (dupFrom.isError()) {
+    return Failure("Failed to duplicate 'from': " + dupFrom.error());
+  }
+
+  Try<int_fd> dupTo = os::dup(to);
+  if (dupTo.isError()) {
+    os::close(dupFrom.get());
+    return Failure("Failed to duplicate 'to': " + dupTo.error());
+  }
+
+  std::shared_ptr<Redirect> redirect(
+      new Redirect(dupFrom.get(), dupTo.get(), type));
+
+  const vector<int> fds = {redirect->from, redirect->to};
+
+  foreach (int fd, fds) {
+    Try<Nothing> cloexec = os::cloexec(fd);
+    if (cloexec.isError()) {
+      return Failure("Failed to set close-on-exec: " + cloexec.error());
+    }
+
+    Try<Nothing> async = process::io::prepare_async(fd);
+    if (async.isError()) {
+      return Failure("Failed to make asynchronous: " + async.error());
+    }
+  }
+
+#ifdef __linux__
+  // `splice` does not support writing to files opened in append mode,
+  // which is how the container loggers open the sandbox log files. We
+  // must not clear `O_APPEND` as the open file description is shared
+  // with other writers (e.g., a log rotation truncating the file), so
+  // we read and write the output of these files instead.
+  int flags = ::fcntl(redirect->to, F_GETFL);
+  if (flags == -1 || (flags & O_APPEND) != 0) {
+    redirect->splice = false;
+  }
+#endif // __linux__
+
+  return loop(
+      self(),
+      [=]() {
+        return transfer(redirect);
+      },
+      [](size_t length) -> ControlFlow<Nothing> {
+        if (length == 0) { // EOF.
+          return Break();
+        }
+
+        return Continue();
+      });
+}
+
+
+Future<size_t> IOSwitchboardServerProcess::transfer(
+    const std::shared_ptr<Redirect>& redirect)
+{
+#ifdef __linux__
+  // Without output connections, the output does not need to be framed
+  // into `ProcessIO` messages. In that case, we move it from `from` to
+  // `to` with `splice`, i.e., without copying it through userspace.
+  if (redirect->splice && outputConnections.empty()) {
+    return process::io::poll(redirect->from, process::io::READ)
+      .then(defer(self(), [=]() -> Future<size_t> {
+        // An output connection might have been attached meanwhile.
+        if (!outputConnections.empty()) {
+          return transfer(redirect);
+        }
+
+        ssize_t length = ::splice(
+            redirect->from,
+            nullptr,
+            redirect->to,
+            nullptr,
+            process::io::BUFFERED_READ_SIZE,
+            SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+        if (length >= 0) {
+          return static_cast<size_t>(length);
+        }
+
+        if (errno == EINTR) {
+          return transfer(redirect);
+        }
+
+        // As `from` is readable, `to` must be full (e.g., the pipe to
+        // the container logger), so wait until it is writable again.
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          return process::io::poll(redirect->to, process::io::WRITE)
+            .then(defer(self(), [=]() {
+              return transfer(redirect);
+            }));
+        }
+
+        // `splice` is not supported for these file descriptors, e.g.,
+        // for a pseudo terminal, so we fall back to reading and writing.
+        if (errno == EINVAL) {
+          redirect->splice = false;
+          return transfer(redirect);
+        }
+
+        return ErrnoFailure("Failed to splice");
+      }));
+  }
+#endif // __linux__
+
+  return process::io::read(
+      redirect->from,
+      redirect->buffer.get(),
+      process::io::BUFFERED_READ_SIZE)
+    .then(defer(self(), [=](size_t length) -> Future<size_t> {
+      if (length == 0) { // EOF.
+        return 0;
+      }
+
+      const string data(redirect->buffer.get(), length);
+
+      outputHook(data, redirect->type);
+
+      return process::io::write(redirect->to, data)
+        .then([length]() {
+          return length;
+        });
+    }));
+}
+
+
 void IOSwitchboardServerProcess::outputHook(
     const string& data,
     const agent::ProcessIO::Data::Type& type)
@@ -1869,8 +2055,19 @@ void IOSwitchboardServerProcess::outputHook(
   // the `HttpConnection::closed()` call above. We might do a few
   // unnecessary writes if we have a bunch of messages queued up,
   // but that shouldn't be a problem.
+  //
+  // NOTE: The message is only encoded once per content type rather
+  // than once per connection.
+  map<ContentType, string> records;
+
   foreach (HttpConnection& connection, outputConnections) {
-    connection.send(message);
+    const ContentType contentType = connection.contentType();
+
+    if (records.count(contentType) == 0) {
+      records[contentType] = connection.encode(message);
+    }
+
+    connection.send(records.at(contentType));
   }
 }
 #endif // __WINDOWS__
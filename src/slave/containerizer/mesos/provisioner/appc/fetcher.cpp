@@ -19,6 +19,8 @@
 
 #include "common/command_utils.hpp"
 
+#include "slave/containerizer/mesos/provisioner/archive.hpp"
+
 #include "slave/containerizer/mesos/provisioner/appc/fetcher.hpp"
 #include "slave/containerizer/mesos/provisioner/appc/paths.hpp"
 
@@ -216,7 +218,11 @@ Future<Nothing> Fetcher::fetch(const Image::Appc& appc, const Path& directory)
             appc.name() + "': " + mkdir.error());
       }
 
-      return command::untar(aciBundle, imagePath);
+      ImageArchive archive;
+      archive.source = aciBundle.string();
+      archive.directory = imagePath;
+
+      return extract({archive}, 1);
     })
     .then([=]() -> Future<Nothing> {
       // Remove the bundle file if everything goes well.
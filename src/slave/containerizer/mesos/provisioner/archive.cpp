@@ -0,0 +1,196 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __WINDOWS__
+#include <unistd.h>
+#endif // __WINDOWS__
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <archive_entry.h>
+
+#include <glog/logging.h>
+
+#include <process/async.hpp>
+#include <process/collect.hpp>
+#include <process/future.hpp>
+
+#include <stout/archiver.hpp>
+#include <stout/error.hpp>
+#include <stout/path.hpp>
+#include <stout/result.hpp>
+#include <stout/strings.hpp>
+
+#include <stout/os/realpath.hpp>
+
+#include "common/command_utils.hpp"
+
+#include "slave/containerizer/mesos/provisioner/archive.hpp"
+
+using process::Failure;
+using process::Future;
+
+using std::string;
+using std::vector;
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+// Refuses symbolic links whose target escapes the directory. Unlike
+// `tar`, which extracts such links, an image layer must not be able to
+// point into the host filesystem, e.g., through a link to '../../etc'.
+// An absolute target is resolved against the root filesystem of the
+// container, so only relative targets with up-level references can
+// escape.
+static Try<Nothing> filter(struct archive_entry* entry)
+{
+  if (archive_entry_filetype(entry) != AE_IFLNK) {
+    return Nothing();
+  }
+
+  const char* pathname = archive_entry_pathname_utf8(entry);
+  const char* target = archive_entry_symlink_utf8(entry);
+
+  if (pathname == nullptr || target == nullptr || target[0] == '/') {
+    return Nothing();
+  }
+
+  // The target is relative to the directory of the link.
+  Try<string> resolved =
+    path::normalize(string(pathname) + "/../" + target, '/');
+
+  if (resolved.isError() ||
+      resolved.get() == ".." ||
+      strings::startsWith(resolved.get(), "../")) {
+    return Error(
+        "Refusing to extract symbolic link '" + string(pathname) + "'"
+        " to '" + target + "' which escapes the destination");
+  }
+
+  return Nothing();
+}
+
+
+Try<Nothing> extract(const ImageArchive& archive)
+{
+  // Like `tar`, refuse entries which would be written outside of the
+  // directory, either through up-level references or through symbolic
+  // links extracted earlier, e.g., a layer with a link 'var/run' to a
+  // host directory followed by a file 'var/run/x'.
+  int flags =
+    ARCHIVE_EXTRACT_TIME |
+    ARCHIVE_EXTRACT_SECURE_NODOTDOT |
+    ARCHIVE_EXTRACT_SECURE_SYMLINKS;
+
+#ifndef __WINDOWS__
+  // Mirror the defaults of `tar`, which only preserves the ownership
+  // and the permissions (including the setuid and setgid bits) of the
+  // archived files for the super user.
+  if (::geteuid() == 0) {
+    flags |= ARCHIVE_EXTRACT_OWNER | ARCHIVE_EXTRACT_PERM;
+  }
+#endif // __WINDOWS__
+
+  // The entries are extracted to absolute paths under the directory, and
+  // libarchive refuses to extract through any symbolic link on the way,
+  // including those in the path of the directory itself.
+  Result<string> directory = os::realpath(archive.directory);
+  if (!directory.isSome()) {
+    return Error(
+        "Failed to resolve '" + archive.directory + "': " +
+        (directory.isError() ? directory.error() : "No such directory"));
+  }
+
+  return archiver::extract(archive.source, directory.get(), flags, &filter);
+}
+
+
+// Verifies the archive against its digest, if any.
+static Future<Nothing> verify(const ImageArchive& archive)
+{
+  if (archive.digest.isNone()) {
+    return Nothing();
+  }
+
+  const vector<string> digest = strings::split(archive.digest.get(), ":", 2);
+  if (digest.size() != 2 || digest[0] != "sha256") {
+    return Failure("Unsupported digest '" + archive.digest.get() + "'");
+  }
+
+  const string expected = digest[1];
+
+  return command::sha256(Path(archive.source))
+    .then([expected](const string& actual) -> Future<Nothing> {
+      if (actual != expected) {
+        return Failure(
+            "Digest mismatch, expected 'sha256:" + expected + "'"
+            " but got 'sha256:" + actual + "'");
+      }
+
+      return Nothing();
+    });
+}
+
+
+Future<Nothing> extract(const vector<ImageArchive>& archives, size_t parallelism)
+{
+  CHECK_GT(parallelism, 0u);
+
+  // Each lane extracts its share of the archives one after another.
+  const size_t lanes = std::min(parallelism, archives.size());
+
+  vector<Future<Nothing>> futures;
+  futures.reserve(lanes);
+
+  for (size_t lane = 0; lane < lanes; lane++) {
+    Future<Nothing> future = Nothing();
+
+    for (size_t i = lane; i < archives.size(); i += lanes) {
+      const ImageArchive archive = archives[i];
+
+      future = future.then([archive]() {
+        return verify(archive)
+          .then([archive]() {
+            return process::async([archive]() { return extract(archive); });
+          })
+          .then([archive](const Try<Nothing>& result) -> Future<Nothing> {
+            if (result.isError()) {
+              return Failure(result.error());
+            }
+
+            return Nothing();
+          })
+          .repair([archive](const Future<Nothing>& future) {
+            return Failure(
+                "Failed to extract '" + archive.source + "' to '" +
+                archive.directory + "': " + future.failure());
+          });
+      });
+    }
+
+    futures.push_back(future);
+  }
+
+  return process::collect(futures)
+    .then([]() { return Nothing(); });
+}
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
@@ -0,0 +1,68 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __MESOS_CONTAINERIZER_PROVISIONER_ARCHIVE_HPP__
+#define __MESOS_CONTAINERIZER_PROVISIONER_ARCHIVE_HPP__
+
+#include <string>
+#include <vector>
+
+#include <process/future.hpp>
+
+#include <stout/nothing.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+// An image archive (e.g., a Docker layer tarball) to be extracted.
+struct ImageArchive
+{
+  // Path to the (possibly compressed) tar archive.
+  std::string source;
+
+  // Existing directory to extract the archive into.
+  std::string directory;
+
+  // Digest of the raw archive in the form `sha256:<hex>`. If set, the
+  // archive is verified against it before it is extracted.
+  Option<std::string> digest;
+};
+
+
+// Extracts the archive in-process using libarchive, i.e., without
+// forking `tar`. Like `tar`, the ownership and permissions of the
+// archived files are only restored when running as root.
+//
+// NOTE: This blocks while the archive is extracted and does not verify
+// the digest, see below for an asynchronous version which does.
+Try<Nothing> extract(const ImageArchive& archive);
+
+
+// Extracts the archives asynchronously, each on a separate actor so
+// that the calling actor is not blocked. At most `parallelism`
+// archives are extracted at a time. Fails if any extraction fails.
+process::Future<Nothing> extract(
+    const std::vector<ImageArchive>& archives,
+    size_t parallelism);
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __MESOS_CONTAINERIZER_PROVISIONER_ARCHIVE_HPP__
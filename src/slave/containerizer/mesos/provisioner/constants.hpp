@@ -17,6 +17,8 @@
 #ifndef __MESOS_PROVISIONER_CONSTANTS_HPP__
 #define __MESOS_PROVISIONER_CONSTANTS_HPP__
 
+#include <stddef.h>
+
 namespace mesos {
 namespace internal {
 namespace slave {
@@ -27,6 +29,10 @@ constexpr char BIND_BACKEND[] = "bind";
 constexpr char COPY_BACKEND[] = "copy";
 constexpr char OVERLAY_BACKEND[] = "overlay";
 
+// Maximum number of image archives (e.g., layer tarballs of an image)
+// which are extracted in parallel.
+constexpr size_t ARCHIVE_EXTRACTION_PARALLELISM = 4;
+
 } // namespace slave {
 } // namespace internal {
 } // namespace mesos {
@@ -30,13 +30,14 @@
 #include <process/id.hpp>
 #include <process/process.hpp>
 
-#include "common/command_utils.hpp"
-
 #include "hdfs/hdfs.hpp"
 
 #include "uri/schemes/file.hpp"
 #include "uri/schemes/hdfs.hpp"
 
+#include "slave/containerizer/mesos/provisioner/archive.hpp"
+#include "slave/containerizer/mesos/provisioner/constants.hpp"
+
 #include "slave/containerizer/mesos/provisioner/docker/image_tar_puller.hpp"
 #include "slave/containerizer/mesos/provisioner/docker/paths.hpp"
 
@@ -86,11 +87,6 @@ private:
       const vector<string>& layerIds,
       const string& backend);
 
-  Future<Nothing> extractLayer(
-      const string& directory,
-      const string& layerId,
-      const string& backend);
-
   const string storeDir;
   const URI archivesUri;
 
@@ -193,7 +189,11 @@ Future<vector<string>> ImageTarPullerProcess::pull(
                 << "' from '" << source
                 << "' to '" << directory << "'";
 
-        return command::untar(Path(source), Path(directory))
+        ImageArchive archive;
+        archive.source = source;
+        archive.directory = directory;
+
+        return extract({archive}, 1)
           .then(defer(self(), &Self::_pull, reference, directory, backend));
       }));
   }
@@ -211,7 +211,11 @@ Future<vector<string>> ImageTarPullerProcess::pull(
           << "' from '" << tarPath
           << "' to '" << directory << "'";
 
-  return command::untar(Path(tarPath), Path(directory))
+  ImageArchive archive;
+  archive.source = tarPath;
+  archive.directory = directory;
+
+  return extract({archive}, 1)
     .then(defer(self(), &Self::_pull, reference, directory, backend));
 }
 
@@ -344,7 +348,8 @@ Future<Nothing> ImageTarPullerProcess::extractLayers(
     const vector<string>& layerIds,
     const string& backend)
 {
-  vector<Future<Nothing>> futures;
+  vector<ImageArchive> archives;
+
   foreach (const string& layerId, layerIds) {
     // Check if the layer is already in the store. If yes, skip the
     // unnecessary extracting.
@@ -355,41 +360,37 @@ Future<Nothing> ImageTarPullerProcess::extractLayers(
       continue;
     }
 
-    futures.push_back(extractLayer(directory, layerId, backend));
-  }
-
-  return collect(futures)
-    .then([]() { return Nothing(); });
-}
+    const string layerPath = path::join(directory, layerId);
+    const string tar = paths::getImageLayerTarPath(layerPath);
+    const string rootfs = paths::getImageLayerRootfsPath(layerPath, backend);
 
+    VLOG(1) << "Extracting layer tar ball '" << tar
+            << " to rootfs '" << rootfs << "'";
 
-Future<Nothing> ImageTarPullerProcess::extractLayer(
-    const string& directory,
-    const string& layerId,
-    const string& backend)
-{
-  const string layerPath = path::join(directory, layerId);
-  const string tar = paths::getImageLayerTarPath(layerPath);
-  const string rootfs = paths::getImageLayerRootfsPath(layerPath, backend);
+    Try<Nothing> mkdir = os::mkdir(rootfs);
+    if (mkdir.isError()) {
+      return Failure(
+          "Failed to create directory '" + rootfs + "'"
+          ": " + mkdir.error());
+    }
 
-  VLOG(1) << "Extracting layer tar ball '" << tar
-          << " to rootfs '" << rootfs << "'";
+    ImageArchive archive;
+    archive.source = tar;
+    archive.directory = rootfs;
 
-  Try<Nothing> mkdir = os::mkdir(rootfs);
-  if (mkdir.isError()) {
-    return Failure(
-        "Failed to create directory '" + rootfs + "'"
-        ": " + mkdir.error());
+    archives.push_back(archive);
   }
 
-  return command::untar(Path(tar), Path(rootfs))
-    .then([tar]() -> Future<Nothing> {
-      // Remove the tar after the extraction.
-      Try<Nothing> rm = os::rm(tar);
-      if (rm.isError()) {
-        return Failure(
-          "Failed to remove '" + tar + "' "
-          "after extraction: " + rm.error());
+  return extract(archives, ARCHIVE_EXTRACTION_PARALLELISM)
+    .then([archives]() -> Future<Nothing> {
+      // Remove the tars after the extraction.
+      foreach (const ImageArchive& archive, archives) {
+        Try<Nothing> rm = os::rm(archive.source);
+        if (rm.isError()) {
+          return Failure(
+            "Failed to remove '" + archive.source + "' "
+            "after extraction: " + rm.error());
+        }
       }
 
       return Nothing();
@@ -24,6 +24,7 @@
 #include <stout/os.hpp>
 #include <stout/protobuf.hpp>
 
+#include <process/clock.hpp>
 #include <process/defer.hpp>
 #include <process/dispatch.hpp>
 #include <process/owned.hpp>
@@ -41,6 +42,7 @@ namespace spec = docker::spec;
 using std::string;
 using std::vector;
 
+using process::Clock;
 using process::Failure;
 using process::Future;
 using process::Owned;
@@ -67,6 +69,8 @@ public:
       const spec::ImageReference& reference,
       bool cached);
 
+  Future<vector<Image>> images();
+
   Future<hashset<string>> prune(
       const vector<spec::ImageReference>& excludedImages);
 
@@ -135,6 +139,12 @@ Future<Option<Image>> MetadataManager::get(
 }
 
 
+Future<vector<Image>> MetadataManager::images()
+{
+  return dispatch(process.get(), &MetadataManagerProcess::images);
+}
+
+
 Future<hashset<string>> MetadataManager::prune(
     const vector<spec::ImageReference>& excludedImages)
 {
@@ -157,6 +167,8 @@ Future<Image> MetadataManagerProcess::put(
     dockerImage.add_layer_ids(layerId);
   }
 
+  dockerImage.set_last_used(Clock::now().secs());
+
   storedImages[imageReference] = dockerImage;
 
   Try<Nothing> status = persist();
@@ -187,10 +199,28 @@ Future<Option<Image>> MetadataManagerProcess::get(
     return None();
   }
 
+  // NOTE: The access time is only checkpointed with the next `put` or
+  // `prune` to keep cache hits cheap, so it might go back in time
+  // after an agent restart.
+  storedImages[imageReference].set_last_used(Clock::now().secs());
+
   return storedImages[imageReference];
 }
 
 
+Future<vector<Image>> MetadataManagerProcess::images()
+{
+  vector<Image> result;
+  result.reserve(storedImages.size());
+
+  foreachvalue (const Image& image, storedImages) {
+    result.push_back(image);
+  }
+
+  return result;
+}
+
+
 Future<hashset<string>> MetadataManagerProcess::prune(
     const vector<spec::ImageReference>& excludedImages)
 {
@@ -93,6 +93,11 @@ public:
       const ::docker::spec::ImageReference& reference,
       bool cached);
 
+  /**
+   * Retrieve all Images stored in memory.
+   */
+  process::Future<std::vector<Image>> images();
+
   /**
    * Prune images from the metadata manager by comparing
    * existing images with active images in use. This function will
@@ -106,6 +106,18 @@ string getImageArchiveTarPath(const string& discoveryDir, const string& name)
 }
 
 
+string getBlobsDir(const string& storeDir)
+{
+  return path::join(storeDir, "blobs");
+}
+
+
+string getBlobPath(const string& storeDir, const string& blobSum)
+{
+  return path::join(getBlobsDir(storeDir), blobSum);
+}
+
+
 string getStoredImagesPath(const string& storeDir)
 {
   return path::join(storeDir, "storedImages");
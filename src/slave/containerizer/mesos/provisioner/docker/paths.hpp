@@ -42,6 +42,8 @@ namespace paths {
  *           |-- rootfs
  *           |-- json(manifest)
  *           |-- VERSION
+ *    |--blobs
+ *       |--<blob_sum> (layer tarball shared by in-flight pulls)
  *    |--storedImages (file holding on cached images)
  *    |--gc (dir holding marked layers to be sweeped)
  */
@@ -92,6 +94,14 @@ std::string getImageArchiveTarPath(
     const std::string& name);
 
 
+std::string getBlobsDir(const std::string& storeDir);
+
+
+std::string getBlobPath(
+    const std::string& storeDir,
+    const std::string& blobSum);
+
+
 std::string getStoredImagesPath(const std::string& storeDir);
 
 
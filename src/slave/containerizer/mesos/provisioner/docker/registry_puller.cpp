@@ -23,15 +23,21 @@
 #include <process/dispatch.hpp>
 #include <process/http.hpp>
 
+#include <stout/hashmap.hpp>
+#include <stout/hashset.hpp>
+#include <stout/strings.hpp>
+
 #include <stout/os/exists.hpp>
 #include <stout/os/mkdir.hpp>
 #include <stout/os/rm.hpp>
+#include <stout/os/rmdir.hpp>
 #include <stout/os/write.hpp>
 
-#include "common/command_utils.hpp"
-
 #include "uri/schemes/docker.hpp"
 
+#include "slave/containerizer/mesos/provisioner/archive.hpp"
+#include "slave/containerizer/mesos/provisioner/constants.hpp"
+
 #include "slave/containerizer/mesos/provisioner/docker/paths.hpp"
 #include "slave/containerizer/mesos/provisioner/docker/registry_puller.hpp"
 
@@ -89,16 +95,19 @@ private:
     const spec::ImageReference& reference,
     const string& directory,
     const spec::v2::ImageManifest& manifest,
-    const hashset<string>& blobSums,
     const string& backend);
 
-  Future<hashset<string>> fetchBlobs(
+  Future<Nothing> fetchBlobs(
     const spec::ImageReference& reference,
-    const string& directory,
-    const spec::v2::ImageManifest& manifest,
-    const string& backend,
+    const hashset<string>& blobSums,
     const Option<Secret::Value>& config);
 
+  // Drops the references of a finished pull to the given blobs.
+  void releaseBlobs(const hashset<string>& blobSums);
+
+  // Removes a blob which is not referenced by any pull anymore.
+  void removeBlob(const string& blobSum);
+
   RegistryPullerProcess(const RegistryPullerProcess&) = delete;
   RegistryPullerProcess& operator=(const RegistryPullerProcess&) = delete;
 
@@ -110,6 +119,16 @@ private:
 
   Shared<uri::Fetcher> fetcher;
   SecretResolver* secretResolver;
+
+  // Blobs are fetched into a directory shared by all pulls, so that
+  // concurrent pulls of images with common layers (e.g., the same
+  // base image) fetch each blob only once. This maps a blob sum to
+  // its (possibly in-flight) fetch.
+  hashmap<string, Future<Nothing>> blobs;
+
+  // The number of in-flight pulls referencing each blob. A blob is
+  // removed once it is not referenced anymore.
+  hashmap<string, size_t> blobReferences;
 };
 
 
@@ -128,6 +147,18 @@ Try<Owned<Puller>> RegistryPuller::create(
   VLOG(1) << "Creating registry puller with docker registry '"
           << flags.docker_registry << "'";
 
+  // Remove the blobs left behind by the pulls which were in flight
+  // when the agent stopped.
+  const string blobsDir = paths::getBlobsDir(flags.docker_store_dir);
+  if (os::exists(blobsDir)) {
+    Try<Nothing> rmdir = os::rmdir(blobsDir);
+    if (rmdir.isError()) {
+      return Error(
+          "Failed to remove blobs directory '" + blobsDir + "': " +
+          rmdir.error());
+    }
+  }
+
   Owned<RegistryPullerProcess> process(
       new RegistryPullerProcess(
           flags.docker_store_dir,
@@ -320,14 +351,46 @@ Future<vector<string>> RegistryPullerProcess::__pull(
     return Failure("'fsLayers' and 'history' have different size in manifest");
   }
 
-  return fetchBlobs(reference, directory, manifest.get(), backend, config)
+  // Find all the blobs that need to be fetched.
+  //
+  // NOTE: There might exist duplicated blob sums in 'fsLayers'. We
+  // just need to fetch one of them.
+  hashset<string> blobSums;
+
+  for (int i = 0; i < manifest->fslayers_size(); i++) {
+    CHECK(manifest->history(i).has_v1());
+    const spec::v1::ImageManifest& v1 = manifest->history(i).v1();
+
+    // Check if the layer is in the store or not. If yes, skip the
+    // unnecessary fetching.
+    if (os::exists(
+        paths::getImageLayerRootfsPath(storeDir, v1.id(), backend))) {
+      continue;
+    }
+
+    const string& blobSum = manifest->fslayers(i).blobsum();
+
+    VLOG(1) << "Fetching blob '" << blobSum << "' for layer '"
+            << v1.id() << "' of image '" << reference << "'";
+
+    blobSums.insert(blobSum);
+  }
+
+  // Hold on to the blobs until the layers have been extracted.
+  foreach (const string& blobSum, blobSums) {
+    blobReferences[blobSum]++;
+  }
+
+  return fetchBlobs(reference, blobSums, config)
     .then(defer(self(),
                 &Self::___pull,
                 reference,
                 directory,
                 manifest.get(),
-                lambda::_1,
-                backend));
+                backend))
+    .onAny(defer(self(), [=](const Future<vector<string>>&) {
+      releaseBlobs(blobSums);
+    }));
 }
 
 
@@ -335,7 +398,6 @@ Future<vector<string>> RegistryPullerProcess::___pull(
     const spec::ImageReference& reference,
     const string& directory,
     const spec::v2::ImageManifest& manifest,
-    const hashset<string>& blobSums,
     const string& backend)
 {
   // Docker reads the layer ids from the disk:
@@ -358,7 +420,7 @@ Future<vector<string>> RegistryPullerProcess::___pull(
   // sure ids are unique.
   hashset<string> uniqueIds;
   vector<string> layerIds;
-  vector<Future<Nothing>> futures;
+  vector<ImageArchive> archives;
 
   // The order of `fslayers` should be [child, parent, ...].
   //
@@ -387,7 +449,7 @@ Future<vector<string>> RegistryPullerProcess::___pull(
     }
 
     const string layerPath = path::join(directory, v1.id());
-    const string tar = path::join(directory, blobSum);
+    const string tar = paths::getBlobPath(storeDir, blobSum);
     const string rootfs = paths::getImageLayerRootfsPath(layerPath, backend);
     const string json = paths::getImageLayerManifestPath(layerPath);
 
@@ -409,64 +471,49 @@ Future<vector<string>> RegistryPullerProcess::___pull(
           v1.id() + "': " + write.error());
     }
 
-    futures.push_back(command::untar(Path(tar), Path(rootfs)));
-  }
+    ImageArchive archive;
+    archive.source = tar;
+    archive.directory = rootfs;
 
-  return collect(futures)
-    .then([=]() -> Future<vector<string>> {
-      // Remove the tarballs after the extraction.
-      foreach (const string& blobSum, blobSums) {
-        const string tar = path::join(directory, blobSum);
-
-        Try<Nothing> rm = os::rm(tar);
-        if (rm.isError()) {
-          return Failure(
-              "Failed to remove '" + tar + "' "
-              "after extraction: " + rm.error());
-        }
-      }
+    // The blob is verified against its digest while it is extracted.
+    if (strings::startsWith(blobSum, "sha256:")) {
+      archive.digest = blobSum;
+    }
 
-      return layerIds;
-    });
+    archives.push_back(archive);
+  }
+
+  return extract(archives, ARCHIVE_EXTRACTION_PARALLELISM)
+    .then([layerIds]() { return layerIds; });
 }
 
 
-Future<hashset<string>> RegistryPullerProcess::fetchBlobs(
+Future<Nothing> RegistryPullerProcess::fetchBlobs(
     const spec::ImageReference& reference,
-    const string& directory,
-    const spec::v2::ImageManifest& manifest,
-    const string& backend,
+    const hashset<string>& blobSums,
     const Option<Secret::Value>& config)
 {
-  // First, find all the blobs that need to be fetched.
-  //
-  // NOTE: There might exist duplicated blob sums in 'fsLayers'. We
-  // just need to fetch one of them.
-  hashset<string> blobSums;
+  const string blobsDir = paths::getBlobsDir(storeDir);
 
-  for (int i = 0; i < manifest.fslayers_size(); i++) {
-    CHECK(manifest.history(i).has_v1());
-    const spec::v1::ImageManifest& v1 = manifest.history(i).v1();
-
-    // Check if the layer is in the store or not. If yes, skip the
-    // unnecessary fetching.
-    if (os::exists(
-        paths::getImageLayerRootfsPath(storeDir, v1.id(), backend))) {
-      continue;
-    }
-
-    const string& blobSum = manifest.fslayers(i).blobsum();
-
-    VLOG(1) << "Fetching blob '" << blobSum << "' for layer '"
-            << v1.id() << "' of image '" << reference << "'";
-
-    blobSums.insert(blobSum);
+  Try<Nothing> mkdir = os::mkdir(blobsDir);
+  if (mkdir.isError()) {
+    return Failure(
+        "Failed to create blobs directory '" + blobsDir + "': " +
+        mkdir.error());
   }
 
-  // Now, actually fetch the blobs.
   vector<Future<Nothing>> futures;
 
   foreach (const string& blobSum, blobSums) {
+    // Join the fetch of the blob if another pull is fetching it.
+    if (blobs.contains(blobSum)) {
+      VLOG(1) << "Blob '" << blobSum << "' of image '" << reference
+              << "' is already being fetched";
+
+      futures.push_back(blobs.at(blobSum));
+      continue;
+    }
+
     URI blobUri;
 
     if (reference.has_registry()) {
@@ -506,14 +553,71 @@ Future<hashset<string>> RegistryPullerProcess::fetchBlobs(
           port);
     }
 
-    futures.push_back(fetcher->fetch(
+    Future<Nothing> fetch = fetcher->fetch(
         blobUri,
-        directory,
-        config.isSome() ? config->data() : Option<string>()));
+        blobsDir,
+        config.isSome() ? config->data() : Option<string>());
+
+    // Forget about a failed fetch so that the next pull retries it.
+    fetch.onAny(defer(self(), [=](const Future<Nothing>& future) {
+      if (!future.isReady() &&
+          blobs.contains(blobSum) &&
+          blobs.at(blobSum) == future) {
+        blobs.erase(blobSum);
+      }
+    }));
+
+    blobs[blobSum] = fetch;
+    futures.push_back(fetch);
   }
 
   return collect(futures)
-    .then([blobSums]() -> hashset<string> { return blobSums; });
+    .then([]() { return Nothing(); });
+}
+
+
+void RegistryPullerProcess::releaseBlobs(const hashset<string>& blobSums)
+{
+  foreach (const string& blobSum, blobSums) {
+    CHECK(blobReferences.contains(blobSum));
+
+    if (--blobReferences[blobSum] > 0) {
+      continue;
+    }
+
+    blobReferences.erase(blobSum);
+
+    // If the blob is still being fetched, e.g., because the pull
+    // failed fetching another blob, only remove it once the fetch
+    // finished so that it cannot race with a later fetch of the blob.
+    if (blobs.contains(blobSum)) {
+      blobs.at(blobSum)
+        .onAny(defer(self(), [=](const Future<Nothing>&) {
+          removeBlob(blobSum);
+        }));
+    } else {
+      removeBlob(blobSum);
+    }
+  }
+}
+
+
+void RegistryPullerProcess::removeBlob(const string& blobSum)
+{
+  // The blob might have been referenced by a new pull meanwhile.
+  if (blobReferences.contains(blobSum)) {
+    return;
+  }
+
+  blobs.erase(blobSum);
+
+  const string blob = paths::getBlobPath(storeDir, blobSum);
+  if (os::exists(blob)) {
+    Try<Nothing> rm = os::rm(blob);
+    if (rm.isError()) {
+      LOG(WARNING) << "Failed to remove blob '" << blob << "': " << rm.error();
+    }
+  }
 }
 
 } // namespace docker {
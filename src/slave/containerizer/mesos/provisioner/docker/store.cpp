@@ -14,6 +14,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -23,11 +24,15 @@
 
 #include <mesos/secret/resolver.hpp>
 
+#include <stout/bytes.hpp>
+#include <stout/fs.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
 #include <stout/json.hpp>
 #include <stout/os.hpp>
+#include <stout/path.hpp>
 
+#include <process/async.hpp>
 #include <process/collect.hpp>
 #include <process/defer.hpp>
 #include <process/dispatch.hpp>
@@ -37,6 +42,8 @@
 #include <process/metrics/metrics.hpp>
 #include <process/metrics/timer.hpp>
 
+#include "common/disk_usage.hpp"
+
 #include "slave/containerizer/mesos/provisioner/constants.hpp"
 #include "slave/containerizer/mesos/provisioner/utils.hpp"
 
@@ -94,7 +101,8 @@ public:
 
   Future<Nothing> prune(
       const std::vector<mesos::Image>& excludeImages,
-      const hashset<string>& activeLayerPaths);
+      const hashset<string>& activeLayerPaths,
+      const Option<double>& headroom);
 
 private:
   struct Metrics
@@ -253,10 +261,15 @@ Future<ImageInfo> Store::get(
 
 Future<Nothing> Store::prune(
     const vector<mesos::Image>& excludedImages,
-    const hashset<string>& activeLayerPaths)
+    const hashset<string>& activeLayerPaths,
+    const Option<double>& headroom)
 {
   return dispatch(
-      process.get(), &StoreProcess::prune, excludedImages, activeLayerPaths);
+      process.get(),
+      &StoreProcess::prune,
+      excludedImages,
+      activeLayerPaths,
+      headroom);
 }
 
 
@@ -509,9 +522,109 @@ Future<Nothing> StoreProcess::moveLayer(
 }
 
 
+// Selects the cached images to retain so that the disk usage of the
+// store drops below the threshold given by the image disk headroom.
+// Images are evicted in least recently used order, and only the
+// layers which are not referenced by retained images or by active
+// containers are accounted as reclaimed.
+static Try<vector<spec::ImageReference>> selectRetainedImages(
+    const string& storeDir,
+    double headroom,
+    vector<Image> images,
+    const vector<spec::ImageReference>& excludedImages,
+    const hashset<string>& activeLayerIds)
+{
+  Try<Bytes> size = fs::size(storeDir);
+  if (size.isError()) {
+    return Error("Failed to get the disk size: " + size.error());
+  }
+
+  Try<Bytes> used = fs::used(storeDir);
+  if (used.isError()) {
+    return Error("Failed to get the disk usage: " + used.error());
+  }
+
+  const Bytes threshold(
+      static_cast<uint64_t>(size->bytes() * (1.0 - headroom)));
+
+  // Leave out the excluded images from the eviction, and count the
+  // references to each layer from the other cached images.
+  hashset<string> excludedNames;
+  foreach (const spec::ImageReference& reference, excludedImages) {
+    excludedNames.insert(stringify(reference));
+  }
+
+  hashset<string> pinnedLayerIds = activeLayerIds;
+  hashmap<string, size_t> layerReferences;
+
+  foreach (const Image& image, images) {
+    const bool excluded = excludedNames.contains(stringify(image.reference()));
+
+    foreach (const string& layerId, image.layer_ids()) {
+      if (excluded) {
+        pinnedLayerIds.insert(layerId);
+      } else {
+        layerReferences[layerId]++;
+      }
+    }
+  }
+
+  std::sort(
+      images.begin(),
+      images.end(),
+      [](const Image& left, const Image& right) {
+        return left.last_used() < right.last_used();
+      });
+
+  vector<spec::ImageReference> retained = excludedImages;
+  Bytes reclaimed;
+
+  foreach (const Image& image, images) {
+    const string name = stringify(image.reference());
+
+    if (excludedNames.contains(name)) {
+      continue;
+    }
+
+    if (used.get() < threshold + reclaimed) {
+      retained.push_back(image.reference());
+      continue;
+    }
+
+    VLOG(1) << "Evicting least recently used image '" << name << "'";
+
+    foreach (const string& layerId, image.layer_ids()) {
+      CHECK(layerReferences.contains(layerId));
+
+      if (--layerReferences[layerId] > 0 || pinnedLayerIds.contains(layerId)) {
+        continue;
+      }
+
+      // Mark the layer as reclaimed so that duplicated layers of an
+      // image are only accounted once.
+      pinnedLayerIds.insert(layerId);
+
+      Try<Bytes> usage =
+        diskUsage(paths::getImageLayerPath(storeDir, layerId));
+
+      if (usage.isError()) {
+        LOG(WARNING) << "Failed to get the disk usage of layer '" << layerId
+                     << "': " << usage.error();
+        continue;
+      }
+
+      reclaimed += usage.get();
+    }
+  }
+
+  return retained;
+}
+
+
 Future<Nothing> StoreProcess::prune(
     const vector<mesos::Image>& excludedImages,
-    const hashset<string>& activeLayerPaths)
+    const hashset<string>& activeLayerPaths,
+    const Option<double>& headroom)
 {
   // All existing pulling should have finished.
   if (!pulling.empty()) {
@@ -534,8 +647,44 @@ Future<Nothing> StoreProcess::prune(
     imageReferences.push_back(reference.get());
   }
 
-  return metadataManager->prune(imageReferences)
+  // Without a headroom (e.g., an explicit prune through the operator
+  // API), all images which are not excluded are removed from the store.
+  if (headroom.isNone()) {
+    return metadataManager->prune(imageReferences)
       .then(defer(self(), &Self::_prune, activeLayerPaths, lambda::_1));
+  }
+
+  // Otherwise only evict the least recently used images until the
+  // disk usage is back below the headroom, so that the images which
+  // are likely to be used again do not need to be pulled again.
+  hashset<string> activeLayerIds;
+
+  foreach (const string& rootfsPath, activeLayerPaths) {
+    activeLayerIds.insert(Path(Path(rootfsPath).dirname()).basename());
+  }
+
+  const string storeDir = flags.docker_store_dir;
+
+  return metadataManager->images()
+    .then([=](const vector<Image>& images) {
+      // Measuring the layers walks the store, so do it asynchronously.
+      return process::async([=]() {
+        return selectRetainedImages(
+            storeDir, headroom.get(), images, imageReferences, activeLayerIds);
+      });
+    })
+    .then(defer(self(), [=](
+        const Try<vector<spec::ImageReference>>& retainedImages)
+        -> Future<hashset<string>> {
+      if (retainedImages.isError()) {
+        return Failure(
+            "Failed to select the images to retain: " +
+            retainedImages.error());
+      }
+
+      return metadataManager->prune(retainedImages.get());
+    }))
+    .then(defer(self(), &Self::_prune, activeLayerPaths, lambda::_1));
 }
 
 
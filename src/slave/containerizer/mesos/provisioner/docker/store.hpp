@@ -61,7 +61,8 @@ public:
 
   process::Future<Nothing> prune(
       const std::vector<mesos::Image>& excludeImages,
-      const hashset<std::string>& activeLayerPaths) override;
+      const hashset<std::string>& activeLayerPaths,
+      const Option<double>& headroom) override;
 
 private:
   explicit Store(process::Owned<StoreProcess> process);
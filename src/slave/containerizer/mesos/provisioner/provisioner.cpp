@@ -354,12 +354,14 @@ Future<bool> Provisioner::destroy(const ContainerID& containerId) const
 
 
 Future<Nothing> Provisioner::pruneImages(
-    const vector<Image>& excludedImages) const
+    const vector<Image>& excludedImages,
+    const Option<double>& headroom) const
 {
   return dispatch(
       CHECK_NOTNULL(process.get()),
       &ProvisionerProcess::pruneImages,
-      excludedImages);
+      excludedImages,
+      headroom);
 }
 
 
@@ -731,12 +733,13 @@ Future<bool> ProvisionerProcess::__destroy(const ContainerID& containerId)
 
 
 Future<Nothing> ProvisionerProcess::pruneImages(
-    const vector<Image>& excludedImages)
+    const vector<Image>& excludedImages,
+    const Option<double>& headroom)
 {
   // `destroy` and `provision` can happen concurrently, but `pruneImages`
   // is exclusive.
   return rwLock.write_lock()
-    .then(defer(self(), [this, excludedImages]() -> Future<Nothing> {
+    .then(defer(self(), [=]() -> Future<Nothing> {
       hashset<string> activeLayerPaths;
 
       foreachpair (
@@ -771,7 +774,7 @@ Future<Nothing> ProvisionerProcess::pruneImages(
           }
         }
 
-        futures.push_back(store->prune(images, activeLayerPaths));
+        futures.push_back(store->prune(images, activeLayerPaths, headroom));
       }
 
       return collect(futures)
@@ -106,8 +106,11 @@ public:
   // Prune images in different stores. Image references in excludedImages
   // will be passed to stores and retained in a best effort fashion.
   // All layer paths used by active containers will not be pruned.
+  // If `headroom` is set, stores only prune until their disk usage is
+  // back below it.
   virtual process::Future<Nothing> pruneImages(
-      const std::vector<Image>& excludedImages) const;
+      const std::vector<Image>& excludedImages,
+      const Option<double>& headroom) const;
 
 protected:
   Provisioner() {} // For creating mock object.
@@ -140,7 +143,8 @@ public:
   process::Future<bool> destroy(const ContainerID& containerId);
 
   process::Future<Nothing> pruneImages(
-      const std::vector<Image>& excludedImages);
+      const std::vector<Image>& excludedImages,
+      const Option<double>& headroom);
 
 private:
   process::Future<ProvisionInfo> _provision(
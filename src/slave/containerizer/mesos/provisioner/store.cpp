@@ -91,7 +91,8 @@ Try<hashmap<Image::Type, Owned<Store>>> Store::create(
 
 process::Future<Nothing> Store::prune(
     const vector<Image>& excludeImages,
-    const hashset<string>& activeLayerPaths)
+    const hashset<string>& activeLayerPaths,
+    const Option<double>& headroom)
 {
   return Nothing();
 }
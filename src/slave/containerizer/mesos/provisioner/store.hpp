@@ -102,9 +102,13 @@ public:
   // should also be retained. Because in certain store (e.g, docker store)
   // the cache is not source of truth, and we need to not only keep the
   // excluded images, but also maintain the cache.
+  //
+  // If `headroom` is set, a store may stop pruning once its disk usage
+  // is back below the headroom instead of pruning all unused images.
   virtual process::Future<Nothing> prune(
       const std::vector<Image>& excludedImages,
-      const hashset<std::string>& activeLayerPaths);
+      const hashset<std::string>& activeLayerPaths,
+      const Option<double>& headroom);
 };
 
 } // namespace slave {
@@ -254,6 +254,22 @@ mesos::internal::slave::Flags::Flags()
       "    each other when occupying a shared space (i.e. disk contention).",
       path::join(os::temp(), "mesos", "fetch"));
 
+  add(&Flags::fetcher_max_workers_per_user,
+      "fetcher_max_workers_per_user",
+      "Maximum number of fetcher processes the agent runs at once for the\n"
+      "fetches of a single user. Further fetches of the user wait until one\n"
+      "of the running fetches finishes. Defaults to the number of CPUs of\n"
+      "the agent.",
+      static_cast<size_t>(os::cpus().isSome() ? os::cpus().get() : 1),
+      [](const size_t& value) -> Option<Error> {
+        if (value == 0) {
+          return Error(
+              "Expected `--fetcher_max_workers_per_user` to be positive");
+        }
+
+        return None();
+      });
+
   add(&Flags::fetcher_stall_timeout,
       "fetcher_stall_timeout",
       "Amount of time for the fetcher to wait before considering a download\n"
@@ -482,6 +498,29 @@ mesos::internal::slave::Flags::Flags()
       "be a value between 0.0 and 1.0",
       GC_DISK_HEADROOM);
 
+  add(&Flags::gc_workers,
+      "gc_workers",
+      "Maximum number of paths (e.g., executor sandboxes) that are removed\n"
+      "in parallel by the garbage collector. Paths which are due for removal\n"
+      "are removed in the order of their scheduled removal time.",
+      DEFAULT_GC_WORKERS,
+      [](const size_t& value) -> Option<Error> {
+        if (value == 0) {
+          return Error("Expected `--gc_workers` to be positive");
+        }
+
+        return None();
+      });
+
+  add(&Flags::gc_max_bytes_per_second,
+      "gc_max_bytes_per_second",
+      "Maximum rate (e.g., 100MB) at which the garbage collector workers\n"
+      "together reclaim disk space. The disk usage of a path is measured\n"
+      "before it is removed, and its removal is delayed until the space\n"
+      "reclaimed by the previous removals would have taken at this rate.\n"
+      "This bounds the disk I/O caused by garbage collection. If not set,\n"
+      "removals are not throttled and their disk usage is not measured.");
+
   add(&Flags::gc_non_executor_container_sandboxes,
       "gc_non_executor_container_sandboxes",
       "Determines whether nested container sandboxes created via the\n"
@@ -530,6 +569,20 @@ mesos::internal::slave::Flags::Flags()
       "successfully reconnect to the framework.",
       RECOVERY_TIMEOUT);
 
+  add(&Flags::recovery_parallelism,
+      "recovery_parallelism",
+      "Maximum number of threads used to read the checkpointed state of\n"
+      "frameworks and executors when the agent recovers. Agents with many\n"
+      "frameworks or executors recover faster with more threads.",
+      DEFAULT_RECOVERY_PARALLELISM,
+      [](const size_t& value) -> Option<Error> {
+        if (value == 0) {
+          return Error("Expected `--recovery_parallelism` to be positive");
+        }
+
+        return None();
+      });
+
   add(&Flags::reconfiguration_policy,
       "reconfiguration_policy",
       "This flag controls which agent configuration changes are considered\n"
@@ -908,6 +961,17 @@ mesos::internal::slave::Flags::Flags()
       "  }\n"
       "}");
 
+#ifndef __WINDOWS__
+  add(&Flags::docker_engine_api,
+      "docker_engine_api",
+      "Whether the docker containerizer and executor talk to the Docker\n"
+      "Engine API over `--docker_socket` to inspect, list, stop, kill and\n"
+      "remove containers, instead of running the docker CLI for each of\n"
+      "these operations. Containers are still run and images pulled with\n"
+      "the docker CLI.",
+      false);
+#endif // __WINDOWS__
+
   add(&Flags::sandbox_directory,
       "sandbox_directory",
       "The absolute path for the directory in the container where the\n"
@@ -65,6 +65,7 @@ public:
   Option<std::string> attributes;
   Bytes fetcher_cache_size;
   std::string fetcher_cache_dir;
+  size_t fetcher_max_workers_per_user;
   Duration fetcher_stall_timeout;
   std::string work_dir;
   std::string runtime_dir;
@@ -91,6 +92,8 @@ public:
 #endif // USE_SSL_SOCKET
   Duration gc_delay;
   double gc_disk_headroom;
+  size_t gc_workers;
+  Option<Bytes> gc_max_bytes_per_second;
   bool gc_non_executor_container_sandboxes;
   Duration disk_watch_interval;
 
@@ -99,6 +102,7 @@ public:
   std::string reconfiguration_policy;
   std::string recover;
   Duration recovery_timeout;
+  size_t recovery_parallelism;
   bool strict;
   Duration register_retry_interval_min;
 #ifdef __linux__
@@ -140,6 +144,9 @@ public:
   bool docker_kill_orphans;
   std::string docker_socket;
   Option<JSON::Object> docker_config;
+#ifndef __WINDOWS__
+  bool docker_engine_api;
+#endif // __WINDOWS__
 
 #ifdef ENABLE_PORT_MAPPING_ISOLATOR
   uint16_t ephemeral_ports_per_container;
@@ -16,6 +16,7 @@
 
 #include "slave/gc.hpp"
 
+#include <algorithm>
 #include <list>
 
 #include <process/check.hpp>
@@ -28,9 +29,12 @@
 #include <stout/adaptor.hpp>
 #include <stout/foreach.hpp>
 #include <stout/lambda.hpp>
+#include <stout/stringify.hpp>
 
 #include <stout/os/rmdir.hpp>
 
+#include "common/disk_usage.hpp"
+
 #include "logging/logging.hpp"
 
 #ifdef __linux__
@@ -53,6 +57,78 @@ namespace mesos {
 namespace internal {
 namespace slave {
 
+// The window over which the reclaim rate metric is computed.
+static const Duration RECLAIM_RATE_WINDOW = Minutes(1);
+
+
+// Removes `path`, unmounting any persistent volumes left mounted
+// under it first. Returns `None` if the path does not exist.
+static Result<Nothing> removePath(const string& path, const string& workDir)
+{
+#ifdef __linux__
+  // Clear any possible persistent volume mount points in `path`. See
+  // MESOS-8830.
+  Try<fs::MountInfoTable> mountTable = fs::MountInfoTable::read();
+  if (mountTable.isError()) {
+    LOG(ERROR) << "Skipping deletion of '" << path << "' because of failure "
+                  "on read MountInfoTable for agent process: "
+               << mountTable.error();
+
+    return Error(mountTable.error());
+  }
+
+  foreach (const fs::MountInfoTable::Entry& entry,
+           adaptor::reverse(mountTable->entries)) {
+    // Ignore mounts whose targets are not under `workDir`.
+    if (!strings::startsWith(
+            path::join(entry.target, ""),
+            path::join(workDir, ""))) {
+      continue;
+    }
+
+    // TODO(zhitao): Validate that both `path` and `workDir` are real
+    // paths.
+    if (strings::startsWith(
+            path::join(entry.target, ""), path::join(path, ""))) {
+      LOG(WARNING)
+          << "Unmounting dangling mount point '" << entry.target
+          << "' of persistent volume '" << entry.root
+          << "' inside garbage collected path '" << path << "'";
+
+      Try<Nothing> unmount = fs::unmount(entry.target);
+      if (unmount.isError()) {
+        LOG(WARNING) << "Skipping deletion of '"
+                     << path << "' because unmount failed on '"
+                     << entry.target << "': " << unmount.error();
+
+        return Error(unmount.error());
+      }
+    }
+  }
+#endif // __linux__
+
+  // Run the removal operation with 'continueOnError = true'.
+  // It's possible for tasks and isolators to lay down files
+  // that are not deletable by GC. In the face of such errors
+  // GC needs to free up disk space wherever it can because the
+  // disk space has already been re-offered to frameworks.
+  LOG(INFO) << "Deleting " << path;
+  Try<Nothing> rmdir = os::rmdir(path, true, true, true);
+
+  if (rmdir.isError()) {
+    // TODO(zhitao): Change return value type of `rmdir` to
+    // `Try<Nothing, ErrnoError>` and check error type instead.
+    if (rmdir.error() == ErrnoError(ENOENT).message) {
+      return None();
+    }
+
+    return Error(rmdir.error());
+  }
+
+  return Nothing();
+}
+
+
 GarbageCollectorProcess::Metrics::Metrics(GarbageCollectorProcess *gc)
   : path_removals_succeeded("gc/path_removals_succeeded"),
     path_removals_failed("gc/path_removals_failed"),
@@ -61,11 +137,17 @@ GarbageCollectorProcess::Metrics::Metrics(GarbageCollectorProcess *gc)
       // basically has to be tracked as a member variable, which means we
       // can safely do concurrent reads while the map is being updated.
       return static_cast<double>(gc->paths.size());
-    })
+    }),
+    path_removals_active("gc/path_removals_active"),
+    bytes_reclaimed("gc/bytes_reclaimed"),
+    bytes_reclaimed_per_second("gc/bytes_reclaimed_per_second")
 {
   process::metrics::add(path_removals_succeeded);
   process::metrics::add(path_removals_failed);
   process::metrics::add(path_removals_pending);
+  process::metrics::add(path_removals_active);
+  process::metrics::add(bytes_reclaimed);
+  process::metrics::add(bytes_reclaimed_per_second);
 }
 
 
@@ -73,6 +155,9 @@ GarbageCollectorProcess::Metrics::~Metrics()
 {
   process::metrics::remove(path_removals_succeeded);
   process::metrics::remove(path_removals_failed);
+  process::metrics::remove(path_removals_active);
+  process::metrics::remove(bytes_reclaimed);
+  process::metrics::remove(bytes_reclaimed_per_second);
 
   // Wait for the metric to be removed to protect against asynchronous
   // evaluation referencing a deleted object.
@@ -80,6 +165,25 @@ GarbageCollectorProcess::Metrics::~Metrics()
 }
 
 
+GarbageCollectorProcess::GarbageCollectorProcess(
+    const string& _workDir,
+    size_t _workers,
+    const Option<Bytes>& _maxBytesPerSecond)
+  : ProcessBase(process::ID::generate("agent-garbage-collector")),
+    metrics(this),
+    workDir(_workDir),
+    maxBytesPerSecond(_maxBytesPerSecond),
+    nextRemoval(Clock::now())
+{
+  CHECK_GT(_workers, 0u);
+
+  for (size_t i = 0; i < _workers; i++) {
+    workers.push_back(Owned<Executor>(new Executor()));
+    idle.push_back(i);
+  }
+}
+
+
 GarbageCollectorProcess::~GarbageCollectorProcess()
 {
   foreachvalue (const Owned<PathInfo>& info, paths) {
@@ -181,125 +285,20 @@ void GarbageCollectorProcess::reset()
 void GarbageCollectorProcess::remove(const Timeout& removalTime)
 {
   if (paths.count(removalTime) > 0) {
-    list<Owned<PathInfo>> infos;
-
-    foreach (const Owned<PathInfo> info, paths.get(removalTime)) {
+    foreach (const Owned<PathInfo>& info, paths.get(removalTime)) {
       if (info->removing) {
         VLOG(1) << "Skipping deletion of '" << info-> path
                 << "'  as it is already in progress";
         continue;
       }
 
-      infos.push_back(info);
+      queue.put(removalTime, info);
 
       // Set `removing` to signify that the path is being cleaned up.
       info->removing = true;
     }
 
-    Counter _succeeded = metrics.path_removals_succeeded;
-    Counter _failed = metrics.path_removals_failed;
-    const string _workDir = workDir;
-
-    auto rmdirs =
-      [_succeeded, _failed, _workDir, infos]() mutable -> Future<Nothing> {
-      // Make mutable copies of the counters to work around MESOS-7907.
-      Counter succeeded = _succeeded;
-      Counter failed = _failed;
-
-#ifdef __linux__
-      // Clear any possible persistent volume mount points in `infos`. See
-      // MESOS-8830.
-      Try<fs::MountInfoTable> mountTable = fs::MountInfoTable::read();
-      if (mountTable.isError()) {
-        LOG(ERROR) << "Skipping any path deletion because of failure on read "
-                      "MountInfoTable for agent process: "
-                   << mountTable.error();
-
-        foreach (const Owned<PathInfo>& info, infos) {
-          info->promise.fail(mountTable.error());
-          ++failed;
-        }
-
-        return Failure(mountTable.error());
-      }
-
-      foreach (const fs::MountInfoTable::Entry& entry,
-               adaptor::reverse(mountTable->entries)) {
-        // Ignore mounts whose targets are not under `workDir`.
-        if (!strings::startsWith(
-                path::join(entry.target, ""),
-                path::join(_workDir, ""))) {
-                continue;
-        }
-
-        for (auto it = infos.begin(); it != infos.end(); ) {
-          const Owned<PathInfo>& info = *it;
-          // TODO(zhitao): Validate that both `info->path` and `workDir` are
-          // real paths.
-          if (strings::startsWith(
-                path::join(entry.target, ""), path::join(info->path, ""))) {
-            LOG(WARNING)
-                << "Unmounting dangling mount point '" << entry.target
-                << "' of persistent volume '" << entry.root
-                << "' inside garbage collected path '" << info->path << "'";
-
-            Try<Nothing> unmount = fs::unmount(entry.target);
-            if (unmount.isError()) {
-              LOG(WARNING) << "Skipping deletion of '"
-                           << info->path << "' because unmount failed on '"
-                           << entry.target << "': " << unmount.error();
-
-              info->promise.fail(unmount.error());
-              ++failed;
-              it = infos.erase(it);
-              continue;
-            } else {
-              break;
-            }
-          }
-
-          it++;
-        }
-      }
-#endif // __linux__
-
-      foreach (const Owned<PathInfo>& info, infos) {
-        // Run the removal operation with 'continueOnError = true'.
-        // It's possible for tasks and isolators to lay down files
-        // that are not deletable by GC. In the face of such errors
-        // GC needs to free up disk space wherever it can because the
-        // disk space has already been re-offered to frameworks.
-        LOG(INFO) << "Deleting " << info->path;
-        Try<Nothing> rmdir = os::rmdir(info->path, true, true, true);
-
-        if (rmdir.isError()) {
-          // TODO(zhitao): Change return value type of `rmdir` to
-          // `Try<Nothing, ErrnoError>` and check error type instead.
-          if (rmdir.error() == ErrnoError(ENOENT).message) {
-            LOG(INFO) << "Skipped '" << info->path << "' which does not exist";
-          } else {
-            LOG(WARNING) << "Failed to delete '" << info->path << "': "
-                         << rmdir.error();
-            info->promise.fail(rmdir.error());
-
-            ++failed;
-          }
-        } else {
-          LOG(INFO) << "Deleted '" << info->path << "'";
-          info->promise.set(rmdir.get());
-
-          ++succeeded;
-        }
-      }
-
-      return Nothing();
-    };
-
-    // NOTE: All `rmdirs` calls are dispatched to one executor so that:
-    //   1. They do not block other dispatches (MESOS-6549).
-    //   2. They do not occupy all worker threads (MESOS-7964).
-    executor.execute(rmdirs)
-      .onAny(defer(self(), &Self::_remove, lambda::_1, infos));
+    removeQueued();
   } else {
     // This occurs when either:
     //   1. The path(s) has already been removed (e.g. by prune()).
@@ -311,16 +310,161 @@ void GarbageCollectorProcess::remove(const Timeout& removalTime)
 }
 
 
-void GarbageCollectorProcess::_remove(const Future<Nothing>& result,
-                                      const list<Owned<PathInfo>> infos)
+void GarbageCollectorProcess::removeQueued()
 {
-  // Remove path records from `paths` and `timeouts` data structures.
-  foreach (const Owned<PathInfo>& info, infos) {
-    CHECK(paths.remove(timeouts[info->path], info));
-    CHECK_EQ(timeouts.erase(info->path), 1u);
+  while (!queue.empty() && !idle.empty()) {
+    // The queue is ordered by removal time, so the paths which have
+    // been waiting the longest are removed first.
+    auto it = queue.begin();
+    const Owned<PathInfo> info = it->second;
+    queue.erase(it);
+
+    const size_t worker = idle.back();
+    idle.pop_back();
+
+    ++metrics.path_removals_active;
+
+    // The disk usage of the path is only needed to throttle removals,
+    // so it is not measured unless the reclaim rate is limited.
+    if (maxBytesPerSecond.isNone()) {
+      removeWith(worker, info, None());
+      continue;
+    }
+
+    const string path = info->path;
+
+    // Entries which cannot be measured are throttled as if they were
+    // empty rather than not removed at all.
+    workers[worker]->execute([path]() {
+      Try<Bytes> usage = diskUsage(path);
+      if (usage.isError()) {
+        LOG(WARNING) << "Failed to get the disk usage of '" << path << "': "
+                     << usage.error();
+        return Bytes(0);
+      }
+
+      return usage.get();
+    })
+    .onAny(defer(self(), &Self::throttle, lambda::_1, worker, info));
+  }
+}
+
+
+void GarbageCollectorProcess::throttle(
+    const Future<Bytes>& usage,
+    size_t worker,
+    const Owned<PathInfo>& info)
+{
+  CHECK_SOME(maxBytesPerSecond);
+
+  if (!usage.isReady() || maxBytesPerSecond->bytes() == 0) {
+    removeWith(worker, info, None());
+    return;
+  }
+
+  // All workers draw from the same budget, which refills at the maximum
+  // rate: a removal may only start once the space reclaimed by all the
+  // removals admitted before it would have taken at that rate.
+  const Time now = Clock::now();
+  const Time start = std::max(now, nextRemoval);
+
+  nextRemoval = start + Seconds(1) *
+    (static_cast<double>(usage->bytes()) / maxBytesPerSecond->bytes());
+
+  if (start > now) {
+    VLOG(1) << "Throttling the removal of '" << info->path << "' ("
+            << usage.get() << ") for " << (start - now);
+
+    delay(start - now, self(), &Self::removeWith, worker, info, usage.get());
+    return;
   }
 
+  removeWith(worker, info, usage.get());
+}
+
+
+void GarbageCollectorProcess::removeWith(
+    size_t worker,
+    const Owned<PathInfo>& info,
+    const Option<Bytes>& usage)
+{
+  const string path = info->path;
+  const string _workDir = workDir;
+
+  workers[worker]->execute([path, _workDir]() {
+    return removePath(path, _workDir);
+  })
+  .onAny(defer(self(), &Self::_remove, lambda::_1, worker, info, usage));
+}
+
+
+void GarbageCollectorProcess::_remove(
+    const Future<Result<Nothing>>& result,
+    size_t worker,
+    const Owned<PathInfo>& info,
+    const Option<Bytes>& usage)
+{
+  --metrics.path_removals_active;
+
+  if (!result.isReady()) {
+    const string message =
+      result.isFailed() ? result.failure() : "Removal discarded";
+
+    LOG(WARNING) << "Failed to delete '" << info->path << "': " << message;
+    info->promise.fail(message);
+    ++metrics.path_removals_failed;
+  } else if (result->isError()) {
+    LOG(WARNING) << "Failed to delete '" << info->path << "': "
+                 << result->error();
+    info->promise.fail(result->error());
+    ++metrics.path_removals_failed;
+  } else if (result->isNone()) {
+    LOG(INFO) << "Skipped '" << info->path << "' which does not exist";
+  } else {
+    LOG(INFO) << "Deleted '" << info->path << "'"
+              << (usage.isSome() ? " (" + stringify(usage.get()) + ")" : "");
+
+    info->promise.set(Nothing());
+    ++metrics.path_removals_succeeded;
+
+    if (usage.isSome()) {
+      metrics.bytes_reclaimed += usage->bytes();
+      reclaimed.push_back(std::make_pair(Clock::now(), usage.get()));
+
+      updateReclaimRate();
+
+      // Make sure the rate drops back once the removals stop.
+      delay(RECLAIM_RATE_WINDOW, self(), &Self::updateReclaimRate);
+    }
+  }
+
+  // Remove path records from `paths` and `timeouts` data structures.
+  CHECK(paths.remove(timeouts[info->path], info));
+  CHECK_EQ(timeouts.erase(info->path), 1u);
+
   reset();
+
+  idle.push_back(worker);
+  removeQueued();
+}
+
+
+void GarbageCollectorProcess::updateReclaimRate()
+{
+  const Time now = Clock::now();
+
+  while (!reclaimed.empty() &&
+         now - reclaimed.front().first >= RECLAIM_RATE_WINDOW) {
+    reclaimed.pop_front();
+  }
+
+  Bytes total;
+  foreach (const auto& removal, reclaimed) {
+    total += removal.second;
+  }
+
+  metrics.bytes_reclaimed_per_second =
+    static_cast<int64_t>(total.bytes() / RECLAIM_RATE_WINDOW.secs());
 }
 
 
@@ -336,9 +480,12 @@ void GarbageCollectorProcess::prune(const Duration& d)
 }
 
 
-GarbageCollector::GarbageCollector(const string& workDir)
+GarbageCollector::GarbageCollector(
+    const string& workDir,
+    size_t workers,
+    const Option<Bytes>& maxBytesPerSecond)
 {
-  process = new GarbageCollectorProcess(workDir);
+  process = new GarbageCollectorProcess(workDir, workers, maxBytesPerSecond);
   spawn(process);
 }
 
@@ -22,8 +22,10 @@
 
 #include <process/future.hpp>
 
+#include <stout/bytes.hpp>
 #include <stout/duration.hpp>
 #include <stout/nothing.hpp>
+#include <stout/option.hpp>
 
 namespace mesos {
 namespace internal {
@@ -42,7 +44,13 @@ class GarbageCollectorProcess;
 class GarbageCollector
 {
 public:
-  explicit GarbageCollector(const std::string& workDir);
+  // Up to `workers` paths are removed in parallel. If
+  // `maxBytesPerSecond` is set, removals are throttled so that all
+  // workers together reclaim disk space at no more than that rate.
+  explicit GarbageCollector(
+      const std::string& workDir,
+      size_t workers = 1,
+      const Option<Bytes>& maxBytesPerSecond = None());
   virtual ~GarbageCollector();
 
   // Schedules the specified path for removal after the specified
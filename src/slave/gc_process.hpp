@@ -17,24 +17,32 @@
 #ifndef __SLAVE_GC_PROCESS_HPP__
 #define __SLAVE_GC_PROCESS_HPP__
 
+#include <deque>
 #include <list>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <process/executor.hpp>
 #include <process/future.hpp>
 #include <process/id.hpp>
 #include <process/owned.hpp>
 #include <process/process.hpp>
+#include <process/time.hpp>
 #include <process/timeout.hpp>
 #include <process/timer.hpp>
 
 #include <process/metrics/counter.hpp>
 #include <process/metrics/pull_gauge.hpp>
+#include <process/metrics/push_gauge.hpp>
 
+#include <stout/bytes.hpp>
 #include <stout/duration.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/multimap.hpp>
 #include <stout/nothing.hpp>
+#include <stout/option.hpp>
+#include <stout/result.hpp>
 #include <stout/try.hpp>
 
 namespace mesos {
@@ -45,10 +53,14 @@ class GarbageCollectorProcess :
     public process::Process<GarbageCollectorProcess>
 {
 public:
-  explicit GarbageCollectorProcess(const std::string& _workDir)
-    : ProcessBase(process::ID::generate("agent-garbage-collector")),
-      metrics(this),
-      workDir(_workDir) {}
+  // Paths are removed by up to `workers` actors in parallel. If
+  // `_maxBytesPerSecond` is set, the disk usage of each path is measured
+  // before its removal, and removals are delayed so that all workers
+  // together reclaim disk space at no more than that rate.
+  GarbageCollectorProcess(
+      const std::string& _workDir,
+      size_t workers = 1,
+      const Option<Bytes>& _maxBytesPerSecond = None());
 
   ~GarbageCollectorProcess() override;
 
@@ -63,6 +75,7 @@ public:
 private:
   void reset();
 
+  // Queues the paths scheduled for `removalTime` for removal.
   void remove(const process::Timeout& removalTime);
 
   struct PathInfo
@@ -83,10 +96,33 @@ private:
     bool removing = false;
   };
 
-  // Callback for `remove` for bookkeeping after path removal.
+  // Hands queued paths to idle workers, oldest removal time first.
+  void removeQueued();
+
+  // Admits the removal of a path with the given disk usage once the
+  // rate limit shared by all workers allows it.
+  void throttle(
+      const process::Future<Bytes>& usage,
+      size_t worker,
+      const process::Owned<PathInfo>& info);
+
+  // Removes the path on the given worker. `usage` is the disk space
+  // which the removal reclaims, if it was measured.
+  void removeWith(
+      size_t worker,
+      const process::Owned<PathInfo>& info,
+      const Option<Bytes>& usage);
+
+  // Callback for the removal of a path by a worker for bookkeeping.
+  // The result is `None` if the path did not exist.
   void _remove(
-      const process::Future<Nothing>& result,
-      const std::list<process::Owned<PathInfo>> infos);
+      const process::Future<Result<Nothing>>& result,
+      size_t worker,
+      const process::Owned<PathInfo>& info,
+      const Option<Bytes>& usage);
+
+  // Updates the reclaim rate metric from the recent removals.
+  void updateReclaimRate();
 
   struct Metrics
   {
@@ -96,9 +132,17 @@ private:
     process::metrics::Counter path_removals_succeeded;
     process::metrics::Counter path_removals_failed;
     process::metrics::PullGauge path_removals_pending;
+    process::metrics::PushGauge path_removals_active;
+    process::metrics::Counter bytes_reclaimed;
+    process::metrics::PushGauge bytes_reclaimed_per_second;
   } metrics;
 
   const std::string workDir;
+  const Option<Bytes> maxBytesPerSecond;
+
+  // The earliest time at which the next removal may start without
+  // exceeding `maxBytesPerSecond`.
+  process::Time nextRemoval;
 
   // Store all the timeouts and corresponding paths to delete.
   // NOTE: We are using Multimap here instead of Multihashmap, because
@@ -111,8 +155,17 @@ private:
 
   process::Timer timer;
 
-  // For executing path removals in a separate actor.
-  process::Executor executor;
+  // Paths which are due for removal but wait for a worker.
+  Multimap<process::Timeout, process::Owned<PathInfo>> queue;
+
+  // Path removals are executed by a bounded pool of separate actors so
+  // that they do not block other dispatches (MESOS-6549) and do not
+  // occupy all worker threads (MESOS-7964).
+  std::vector<process::Owned<process::Executor>> workers;
+  std::vector<size_t> idle;
+
+  // Disk space reclaimed by recent removals, used for the reclaim rate.
+  std::deque<std::pair<process::Time, Bytes>> reclaimed;
 };
 
 } // namespace slave {
@@ -553,7 +553,8 @@ Future<Response> Http::_api(
 
   if (streamingMediaType(mediaTypes.accept) &&
       call.type() != mesos::agent::Call::ATTACH_CONTAINER_OUTPUT &&
-      call.type() != mesos::agent::Call::LAUNCH_NESTED_CONTAINER_SESSION) {
+      call.type() != mesos::agent::Call::LAUNCH_NESTED_CONTAINER_SESSION &&
+      call.type() != mesos::agent::Call::GET_STATE) {
     return NotAcceptable("Streaming response is not supported for " +
         stringify(call.type()) + " call");
   }
@@ -589,6 +590,11 @@ Future<Response> Http::_api(
       return readFile(call, mediaTypes.accept, principal);
 
     case mesos::agent::Call::GET_STATE:
+      if (streamingMediaType(mediaTypes.accept)) {
+        CHECK_SOME(mediaTypes.messageAccept);
+        return streamState(call, mediaTypes.messageAccept.get(), principal);
+      }
+
       return getState(call, mediaTypes.accept, principal);
 
     case mesos::agent::Call::GET_CONTAINERS:
@@ -1921,6 +1927,64 @@ mesos::agent::Response::GetState Http::_getState(
 }
 
 
+Future<Response> Http::streamState(
+    const mesos::agent::Call& call,
+    ContentType messageAcceptType,
+    const Option<Principal>& principal) const
+{
+  CHECK_EQ(mesos::agent::Call::GET_STATE, call.type());
+
+  LOG(INFO) << "Processing GET_STATE call";
+
+  return ObjectApprovers::create(
+      slave->authorizer,
+      principal,
+      {VIEW_FRAMEWORK, VIEW_TASK, VIEW_EXECUTOR})
+    .then(defer(
+        slave->self(),
+        [=](const Owned<ObjectApprovers>& approvers) -> Response {
+          Pipe pipe;
+          OK ok;
+
+          ok.headers["Content-Type"] = APPLICATION_RECORDIO;
+          ok.headers[MESSAGE_CONTENT_TYPE] = stringify(messageAcceptType);
+          ok.type = Response::PIPE;
+          ok.reader = pipe.reader();
+
+          StreamingHttpConnection<v1::agent::Response> http(
+              pipe.writer(), messageAcceptType);
+
+          // Each part of the state is sent as a separate `GET_STATE`
+          // response as soon as it has been computed. All parts are
+          // sent in a single turn of the agent actor to form a
+          // consistent state. The pipe has no backpressure, so all the
+          // encoded records are buffered until the client reads them.
+          auto send = [&http](mesos::agent::Response::GetState* getState) {
+            mesos::agent::Response response;
+            response.set_type(mesos::agent::Response::GET_STATE);
+            response.mutable_get_state()->Swap(getState);
+
+            http.send(response);
+          };
+
+          mesos::agent::Response::GetState getState;
+
+          *getState.mutable_get_tasks() = _getTasks(approvers);
+          send(&getState);
+
+          *getState.mutable_get_executors() = _getExecutors(approvers);
+          send(&getState);
+
+          *getState.mutable_get_frameworks() = _getFrameworks(approvers);
+          send(&getState);
+
+          http.close();
+
+          return ok;
+        }));
+}
+
+
 string Http::STATISTICS_HELP()
 {
   return HELP(
@@ -2360,7 +2424,7 @@ Future<Response> Http::pruneImages(
             return Forbidden();
           }
 
-          return slave->containerizer->pruneImages(excludedImages)
+          return slave->containerizer->pruneImages(excludedImages, None())
             .then([]() -> Response { return OK(); });
         }));
 }
@@ -213,6 +213,13 @@ private:
       ContentType acceptType,
       const Option<process::http::authentication::Principal>& principal) const;
 
+  // Streams the state as RecordIO encoded `GET_STATE` responses, each
+  // of which contains a part of the state.
+  process::Future<process::http::Response> streamState(
+      const mesos::agent::Call& call,
+      ContentType messageAcceptType,
+      const Option<process::http::authentication::Principal>& principal) const;
+
   mesos::agent::Response::GetState _getState(
       const process::Owned<ObjectApprovers>& approvers) const;
 
@@ -466,7 +466,8 @@ int main(int argc, char** argv)
 #endif // __linux__
 
   Fetcher* fetcher = new Fetcher(flags);
-  GarbageCollector* gc = new GarbageCollector(flags.work_dir);
+  GarbageCollector* gc = new GarbageCollector(
+      flags.work_dir, flags.gc_workers, flags.gc_max_bytes_per_second);
 
   // Initialize SecretResolver.
   Try<SecretResolver*> secretResolver =
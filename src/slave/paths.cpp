@@ -68,6 +68,7 @@ const char RESOURCES_INFO_FILE[] = "resources.info";
 const char RESOURCES_TARGET_FILE[] = "resources.target";
 const char RESOURCE_PROVIDER_STATE_FILE[] = "resource_provider.state";
 const char OPERATION_UPDATES_FILE[] = "operation.updates";
+const char OPERATION_UPDATES_LOG_FILE[] = "operation.updates.log";
 
 
 const char CONTAINERS_DIR[] = "containers";
@@ -601,6 +602,13 @@ string getOperationUpdatesPath(
 }
 
 
+string getOperationUpdatesLogPath(
+    const string& rootDir)
+{
+  return path::join(rootDir, OPERATION_UPDATES_LOG_FILE);
+}
+
+
 string getResourcesInfoPath(
     const string& rootDir)
 {
@@ -81,6 +81,7 @@ namespace paths {
 //   |           |           |-- latest (symlink)
 //   |           |           |-- <resource_provider_id>
 //   |           |               |-- resource_provider.state
+//   |           |               |-- operation.updates.log
 //   |           |               |-- operations
 //   |           |                   |-- <operation_uuid>
 //   |           |                       |-- operation.updates
@@ -373,6 +374,10 @@ std::string getOperationUpdatesPath(
     const id::UUID& operationUuid);
 
 
+std::string getOperationUpdatesLogPath(
+    const std::string& rootDir);
+
+
 std::string getResourcesInfoPath(
     const std::string& rootDir);
 
@@ -910,7 +910,7 @@ void Slave::initialize()
 #endif  // __WINDOWS__
 
   // Do recovery.
-  async(&state::recover, metaDir, flags.strict)
+  async(&state::recover, metaDir, flags.strict, flags.recovery_parallelism)
     .then(defer(self(), &Slave::recover, lambda::_1))
     .then(defer(self(), &Slave::_recover))
     .onAny(defer(self(), &Slave::__recover, lambda::_1));
@@ -6983,7 +6983,8 @@ void Slave::_checkImageDiskUsage(const Future<double>& usage)
           flags.image_gc_config->excluded_images().begin(),
           flags.image_gc_config->excluded_images().end());
 
-      containerizer->pruneImages(excludedImages);
+      containerizer->pruneImages(
+          excludedImages, flags.image_gc_config->image_disk_headroom());
     }
   }
 
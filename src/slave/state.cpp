@@ -16,13 +16,18 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include <process/pid.hpp>
 
 #include <stout/check.hpp>
 #include <stout/error.hpp>
 #include <stout/foreach.hpp>
+#include <stout/lambda.hpp>
 #include <stout/none.hpp>
 #include <stout/nothing.hpp>
 #include <stout/numify.hpp>
@@ -59,9 +64,57 @@ namespace state {
 using std::list;
 using std::max;
 using std::string;
+using std::vector;
 
 
-Try<State> recover(const string& rootDir, bool strict)
+namespace {
+
+// Invokes 'f' for every index in '[0, count)' using up to
+// 'parallelism' threads (including the calling thread) and returns
+// the results ordered by index. Each index is handed out exactly once,
+// so 'f' only needs to be safe to call concurrently for distinct
+// indices.
+template <typename T>
+vector<T> parallel(
+    size_t count,
+    size_t parallelism,
+    const lambda::function<T(size_t)>& f)
+{
+  vector<Option<T>> results(count);
+  std::atomic<size_t> next(0);
+
+  auto worker = [&]() {
+    for (size_t i = next++; i < count; i = next++) {
+      results[i] = f(i);
+    }
+  };
+
+  vector<std::thread> threads;
+  for (size_t i = 1; i < std::min(parallelism, count); i++) {
+    threads.emplace_back(worker);
+  }
+
+  worker();
+
+  foreach (std::thread& thread, threads) {
+    thread.join();
+  }
+
+  vector<T> values;
+  values.reserve(count);
+
+  foreach (Option<T>& result, results) {
+    CHECK_SOME(result);
+    values.push_back(std::move(result.get()));
+  }
+
+  return values;
+}
+
+} // namespace {
+
+
+Try<State> recover(const string& rootDir, bool strict, size_t parallelism)
 {
   LOG(INFO) << "Recovering state from '" << rootDir << "'";
 
@@ -123,8 +176,8 @@ Try<State> recover(const string& rootDir, bool strict)
   SlaveID slaveId;
   slaveId.set_value(Path(directory.get()).basename());
 
-  Try<SlaveState> slave =
-    SlaveState::recover(rootDir, slaveId, strict, state.rebooted);
+  Try<SlaveState> slave = SlaveState::recover(
+      rootDir, slaveId, strict, state.rebooted, parallelism);
 
   if (slave.isError()) {
     return Error(slave.error());
@@ -140,7 +193,8 @@ Try<SlaveState> SlaveState::recover(
     const string& rootDir,
     const SlaveID& slaveId,
     bool strict,
-    bool rebooted)
+    bool rebooted,
+    size_t parallelism)
 {
   SlaveState state;
   state.id = slaveId;
@@ -185,21 +239,45 @@ Try<SlaveState> SlaveState::recover(
                  ": " + frameworks.error());
   }
 
-  // Recover each of the frameworks.
+  vector<FrameworkID> frameworkIds;
   foreach (const string& path, frameworks.get()) {
     FrameworkID frameworkId;
     frameworkId.set_value(Path(path).basename());
-
-    Try<FrameworkState> framework =
-      FrameworkState::recover(rootDir, slaveId, frameworkId, strict, rebooted);
+    frameworkIds.push_back(frameworkId);
+  }
+
+  // If there are enough frameworks to keep all threads busy we recover
+  // the frameworks concurrently, otherwise we recover the frameworks
+  // one after another and the executors of each framework concurrently.
+  // We never do both, to bound the number of threads by 'parallelism'.
+  const bool parallelFrameworks = frameworkIds.size() >= parallelism;
+
+  vector<Try<FrameworkState>> recovered = parallel<Try<FrameworkState>>(
+      frameworkIds.size(),
+      parallelFrameworks ? parallelism : 1,
+      [&](size_t i) {
+        return FrameworkState::recover(
+            rootDir,
+            slaveId,
+            frameworkIds[i],
+            strict,
+            rebooted,
+            parallelFrameworks ? 1 : parallelism);
+      });
+
+  // Collect the frameworks in directory order so that, as with a
+  // sequential recovery, the first error encountered is reported.
+  for (size_t i = 0; i < frameworkIds.size(); i++) {
+    const FrameworkID& frameworkId = frameworkIds[i];
+    Try<FrameworkState>& framework = recovered[i];
 
     if (framework.isError()) {
       return Error("Failed to recover framework " + frameworkId.value() +
                    ": " + framework.error());
     }
 
-    state.frameworks[frameworkId] = framework.get();
     state.errors += framework->errors;
+    state.frameworks[frameworkId] = std::move(framework.get());
   }
 
   return state;
@@ -211,7 +289,8 @@ Try<FrameworkState> FrameworkState::recover(
     const SlaveID& slaveId,
     const FrameworkID& frameworkId,
     bool strict,
-    bool rebooted)
+    bool rebooted,
+    size_t parallelism)
 {
   FrameworkState state;
   state.id = frameworkId;
@@ -294,21 +373,33 @@ Try<FrameworkState> FrameworkState::recover(
         ": " + executors.error());
   }
 
-  // Recover the executors.
+  vector<ExecutorID> executorIds;
   foreach (const string& path, executors.get()) {
     ExecutorID executorId;
     executorId.set_value(Path(path).basename());
+    executorIds.push_back(executorId);
+  }
 
-    Try<ExecutorState> executor = ExecutorState::recover(
-        rootDir, slaveId, frameworkId, executorId, strict, rebooted);
+  // Recover the executors.
+  vector<Try<ExecutorState>> recovered = parallel<Try<ExecutorState>>(
+      executorIds.size(),
+      parallelism,
+      [&](size_t i) {
+        return ExecutorState::recover(
+            rootDir, slaveId, frameworkId, executorIds[i], strict, rebooted);
+      });
+
+  for (size_t i = 0; i < executorIds.size(); i++) {
+    const ExecutorID& executorId = executorIds[i];
+    Try<ExecutorState>& executor = recovered[i];
 
     if (executor.isError()) {
       return Error("Failed to recover executor '" + executorId.value() +
                    "': " + executor.error());
     }
 
-    state.executors[executorId] = executor.get();
     state.errors += executor->errors;
+    state.executors[executorId] = std::move(executor.get());
   }
 
   return state;
@@ -339,7 +430,8 @@ Try<ExecutorState> ExecutorState::recover(
                  "': " + runs.error());
   }
 
-  // Recover the runs.
+  // Find the latest run first, so that we know which of the runs
+  // need to be recovered in full.
   foreach (const string& path, runs.get()) {
     if (Path(path).basename() == paths::LATEST_SYMLINK) {
       const Result<string>& latest = os::realpath(path);
@@ -356,10 +448,29 @@ Try<ExecutorState> ExecutorState::recover(
       ContainerID containerId;
       containerId.set_value(Path(latest.get()).basename());
       state.latest = containerId;
-    } else {
+    }
+  }
+
+  // Recover the runs.
+  foreach (const string& path, runs.get()) {
+    if (Path(path).basename() != paths::LATEST_SYMLINK) {
       ContainerID containerId;
       containerId.set_value(Path(path).basename());
 
+      // The agent only garbage collects completed runs which are not
+      // the latest run of the executor, hence there is no need to read
+      // their checkpointed tasks here. Agents with a long history of
+      // executor runs would otherwise spend most of their recovery
+      // parsing tasks which are never looked at. See
+      // `RunState::recoverCompleted` for why this is safe.
+      if (state.latest.isSome() &&
+          state.latest.get() != containerId &&
+          os::exists(paths::getExecutorSentinelPath(
+              rootDir, slaveId, frameworkId, executorId, containerId))) {
+        state.runs[containerId] = RunState::recoverCompleted(containerId);
+        continue;
+      }
+
       Try<RunState> run = RunState::recover(
           rootDir,
           slaveId,
@@ -594,6 +705,16 @@ Try<RunState> RunState::recover(
 }
 
 
+RunState RunState::recoverCompleted(const ContainerID& containerId)
+{
+  RunState state;
+  state.id = containerId;
+  state.completed = true;
+
+  return state;
+}
+
+
 Try<TaskState> TaskState::recover(
     const string& rootDir,
     const SlaveID& slaveId,
@@ -71,7 +71,15 @@ struct TaskState;
 // while increasing the 'errors' count. Note that 'errors' on a struct
 // includes the 'errors' encountered recursively. In other words,
 // 'State.errors' is the sum total of all recovery errors.
-Try<State> recover(const std::string& rootDir, bool strict);
+//
+// Frameworks (or, if there are fewer frameworks than 'parallelism',
+// the executors of each framework) are recovered concurrently on up
+// to 'parallelism' threads. The calling thread takes part in the
+// recovery, hence a 'parallelism' of 1 recovers sequentially.
+Try<State> recover(
+    const std::string& rootDir,
+    bool strict,
+    size_t parallelism = 1);
 
 
 // Reads the protobuf message(s) from the given path.
@@ -282,6 +290,21 @@ struct RunState
       bool strict,
       bool rebooted);
 
+  // Recovers a completed run which is not the latest run of its
+  // executor. The agent only garbage collects such runs, so only the
+  // run's id is recovered and its checkpointed tasks are not read.
+  //
+  // NOTE: Skipping the tasks is safe even though they then bypass the
+  // checks applied to the tasks of other runs:
+  //   * A corrupt task checkpoint of such a run does not fail a strict
+  //     recovery. The agent never reads it and only removes the run's
+  //     directory, which does not depend on the checkpoint's contents.
+  //   * The tasks do not get their `Resource.AllocationInfo` injected.
+  //     The agent only re-checkpoints the tasks of the latest run with
+  //     the injected info, and never reports the tasks of these runs to
+  //     the master, so the info would be dropped anyway.
+  static RunState recoverCompleted(const ContainerID& containerId);
+
   Option<ContainerID> id;
   hashmap<TaskID, TaskState> tasks;
   Option<pid_t> forkedPid;
@@ -327,7 +350,8 @@ struct FrameworkState
       const SlaveID& slaveId,
       const FrameworkID& frameworkId,
       bool strict,
-      bool rebooted);
+      bool rebooted,
+      size_t parallelism = 1);
 
   FrameworkID id;
   Option<FrameworkInfo> info;
@@ -363,7 +387,8 @@ struct SlaveState
       const std::string& rootDir,
       const SlaveID& slaveId,
       bool strict,
-      bool rebooted);
+      bool rebooted,
+      size_t parallelism = 1);
 
   SlaveID id;
   Option<SlaveInfo> info;
@@ -55,7 +55,8 @@ OperationStatusUpdateManager::~OperationStatusUpdateManager()
 
 void OperationStatusUpdateManager::initialize(
     const function<void(const UpdateOperationStatusMessage&)>& forward,
-    const function<const std::string(const id::UUID&)>& getPath)
+    const function<const std::string(const id::UUID&)>& getPath,
+    const Option<std::string>& logPath)
 {
   dispatch(
       process.get(),
@@ -64,7 +65,8 @@ void OperationStatusUpdateManager::initialize(
           UpdateOperationStatusRecord,
           UpdateOperationStatusMessage>::initialize,
       forward,
-      getPath);
+      getPath,
+      logPath);
 }
 
 
@@ -18,6 +18,7 @@
 #define __STATUS_UPDATE_MANAGER_OPERATION_HPP__
 
 #include <list>
+#include <string>
 
 #include <mesos/mesos.hpp>
 
@@ -27,6 +28,7 @@
 
 #include <stout/hashmap.hpp>
 #include <stout/lambda.hpp>
+#include <stout/option.hpp>
 #include <stout/uuid.hpp>
 
 #include "messages/messages.hpp"
@@ -61,10 +63,16 @@ public:
   //              recipient.
   //   `getPath`: called in order to generate the path of a status update stream
   //              file, given the operation's `operation_uuid`.
+  //
+  // If `logPath` is set, checkpointed updates and acknowledgements are group
+  // committed through a log at that path instead of being synced one by one,
+  // see `StatusUpdateManagerProcess`. `recover()` must then be called before
+  // any update is sent.
   void initialize(
       const lambda::function<
           void(const UpdateOperationStatusMessage&)>& forward,
-      const lambda::function<const std::string(const id::UUID&)>& getPath);
+      const lambda::function<const std::string(const id::UUID&)>& getPath,
+      const Option<std::string>& logPath = None());
 
   // Checkpoints the update if necessary and reliably sends the update.
   //
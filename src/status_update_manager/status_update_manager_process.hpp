@@ -21,16 +21,19 @@
 #include <queue>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <mesos/mesos.hpp>
 #include <mesos/type_utils.hpp>
 
 #include <process/delay.hpp>
+#include <process/dispatch.hpp>
 #include <process/future.hpp>
 #include <process/owned.hpp>
 #include <process/protobuf.hpp>
 #include <process/timeout.hpp>
 
+#include <stout/bytes.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
 #include <stout/duration.hpp>
@@ -44,10 +47,14 @@
 #include <stout/utils.hpp>
 #include <stout/uuid.hpp>
 
+#include <stout/os/fsync.hpp>
 #include <stout/os/ftruncate.hpp>
+#include <stout/os/lseek.hpp>
 
 #include "common/protobuf_utils.hpp"
 
+#include "messages/messages.hpp"
+
 #include "slave/constants.hpp"
 
 namespace mesos {
@@ -73,6 +80,17 @@ namespace internal {
 // This process does NOT garbage collect any checkpointed state. The users of it
 // are responsible for the garbage collection of the status updates files.
 //
+// By default every checkpointed record is written synchronously to the file of
+// its stream. If a log path is passed to `initialize()`, the process runs in
+// group commit mode instead: records are written to the stream files without
+// syncing and appended to a write-ahead log shared by all streams. All records
+// handled before the process gets to process its next `commit()` event form a
+// batch which is made durable by a single `fsync` of the log; the futures
+// returned for them are only satisfied, and the updates only forwarded, after
+// that. Once the log grows beyond `STATUS_UPDATE_LOG_COMPACTION_THRESHOLD`, the
+// stream files are synced and the log is emptied. Upon `recover()` the log is
+// replayed into the stream files before the streams are recovered.
+//
 // TODO(gkleiman): make `TaskStatusUpdateManager` use this actor (MESOS-8296).
 template <typename IDType, typename CheckpointType, typename UpdateType>
 class StatusUpdateManagerProcess
@@ -132,12 +150,16 @@ public:
   // needs to be forwarded.
   // `_getPath` is called in order to generate the path of a status update
   // stream checkpoint file, given an `IDType`.
+  // `_logPath`, if set, enables group commit mode using a log at that path.
+  // In this mode `recover()` has to be called before any update is handled.
   void initialize(
       const lambda::function<void(const UpdateType&)>& _forwardCallback,
-      const lambda::function<const std::string(const IDType&)>& _getPath)
+      const lambda::function<const std::string(const IDType&)>& _getPath,
+      const Option<std::string>& _logPath = None())
   {
     forwardCallback = _forwardCallback;
     getPath = _getPath;
+    logPath = _logPath;
   }
 
   // Forwards the status update on the specified update stream.
@@ -218,6 +240,12 @@ public:
       return Nothing();
     }
 
+    // In group commit mode the update is forwarded by `commit()` once it is
+    // durable.
+    if (stream->checkpointed() && log.get() != nullptr) {
+      return addToBatch(streamId);
+    }
+
     // Forward the status update if this is at the front of the queue.
     // Subsequent status updates will be sent in `acknowledgement()`.
     if (!paused && stream->pending.size() == 1) {
@@ -284,18 +312,27 @@ public:
     }
 
     bool terminated = stream->terminated;
+    bool batched = stream->checkpointed() && log.get() != nullptr;
+
     if (terminated) {
       if (next.isSome()) {
         LOG(WARNING) << "Acknowledged a terminal " << statusUpdateType
                      << " but updates are still pending";
       }
       cleanupStatusUpdateStream(streamId);
-    } else if (!paused && next.isSome()) {
+    } else if (!paused && next.isSome() && !batched) {
       // Forward the next queued status update.
       stream->timeout =
         forward(stream, next.get(), slave::STATUS_UPDATE_RETRY_INTERVAL_MIN);
     }
 
+    // In group commit mode the next status update is forwarded by `commit()`
+    // once the acknowledgement is durable.
+    if (batched) {
+      return addToBatch(streamId)
+        .then([terminated]() { return !terminated; });
+    }
+
     return !terminated;
   }
 
@@ -313,6 +350,22 @@ public:
   {
     LOG(INFO) << "Recovering " << statusUpdateType << " manager";
 
+    // Bring the stream files up to date with the records in the log before
+    // recovering the streams from them.
+    if (logPath.isSome() && log.get() == nullptr) {
+      Try<Nothing> replay = CheckpointLog::replay(logPath.get());
+      if (replay.isError()) {
+        return process::Failure(
+            "Failed to replay " + statusUpdateType + " log '" +
+            logPath.get() + "': " + replay.error());
+      }
+
+      Try<Nothing> open = openLog();
+      if (open.isError()) {
+        return process::Failure(open.error());
+      }
+    }
+
     State state;
     foreach (const IDType& streamId, streamIds) {
       Result<typename StatusUpdateStream::State> result =
@@ -385,7 +438,15 @@ public:
     LOG(INFO) << "Resuming " << statusUpdateType << " manager";
     paused = false;
 
-    foreachvalue (process::Owned<StatusUpdateStream>& stream, streams) {
+    foreachpair (const IDType& streamId,
+                 process::Owned<StatusUpdateStream>& stream,
+                 streams) {
+      // Updates of streams with records pending a group commit are
+      // forwarded by `commit()`.
+      if (batch.contains(streamId)) {
+        continue;
+      }
+
       const Result<UpdateType>& next = stream->next();
 
       if (next.isSome()) {
@@ -401,10 +462,130 @@ public:
 
 private:
   // Forward declarations.
+  class CheckpointLog;
   class StatusUpdateStream;
 
   // Helper methods.
 
+  // Opens the group commit log, appending to it if it already exists.
+  Try<Nothing> openLog()
+  {
+    CHECK_SOME(logPath);
+
+    Try<process::Owned<CheckpointLog>> open =
+      CheckpointLog::open(logPath.get());
+
+    if (open.isError()) {
+      return Error(
+          "Failed to open " + statusUpdateType + " log '" + logPath.get() +
+          "': " + open.error());
+    }
+
+    log = open.get();
+
+    return Nothing();
+  }
+
+  // Adds the stream to the current group commit batch, starting a new batch
+  // if necessary, and returns a future which is satisfied once the batch is
+  // durable.
+  process::Future<Nothing> addToBatch(const IDType& streamId)
+  {
+    if (batchCommitted.get() == nullptr) {
+      batchCommitted.reset(new process::Promise<Nothing>());
+
+      // All events already queued for this process are handled before this
+      // dispatch, so that their records make it into the same batch.
+      process::dispatch(this->self(), &StatusUpdateManagerProcess::commit);
+    }
+
+    batch.insert(streamId);
+
+    return batchCommitted->future();
+  }
+
+  // Syncs the log, which makes all records of the current batch durable, and
+  // forwards the status updates that were held back until then.
+  void commit()
+  {
+    CHECK_NOTNULL(log.get());
+    CHECK_NOTNULL(batchCommitted.get());
+
+    process::Owned<process::Promise<Nothing>> committed = batchCommitted;
+    batchCommitted.reset();
+
+    hashset<IDType> streamIds;
+    std::swap(streamIds, batch);
+
+    VLOG(1) << "Committing " << statusUpdateType << " records of "
+            << streamIds.size() << " streams";
+
+    Try<Nothing> sync = log->sync();
+    if (sync.isError()) {
+      const std::string message =
+        "Failed to sync " + statusUpdateType + " log '" + logPath.get() +
+        "': " + sync.error();
+
+      LOG(ERROR) << message;
+
+      // We don't know which of the records made it to disk, so the
+      // affected streams cannot be used anymore.
+      foreach (const IDType& streamId, streamIds) {
+        if (streams.contains(streamId)) {
+          streams[streamId]->fail(message);
+        }
+      }
+
+      committed->fail(message);
+      return;
+    }
+
+    committed->set(Nothing());
+
+    foreach (const IDType& streamId, streamIds) {
+      if (paused || !streams.contains(streamId)) {
+        continue;
+      }
+
+      StatusUpdateStream* stream = streams[streamId].get();
+
+      // Skip the stream if an update is already awaiting acknowledgement.
+      if (stream->timeout.isSome()) {
+        continue;
+      }
+
+      const Result<UpdateType>& next = stream->next();
+      if (next.isSome()) {
+        stream->timeout = forward(
+            stream, next.get(), slave::STATUS_UPDATE_RETRY_INTERVAL_MIN);
+      }
+    }
+
+    if (log->size() >= slave::STATUS_UPDATE_LOG_COMPACTION_THRESHOLD) {
+      Try<Nothing> compact = compactLog();
+      if (compact.isError()) {
+        // The log keeps growing until the next compaction succeeds.
+        LOG(WARNING) << "Failed to compact " << statusUpdateType << " log '"
+                     << logPath.get() << "': " << compact.error();
+      }
+    }
+  }
+
+  // Syncs all stream files and empties the log.
+  Try<Nothing> compactLog()
+  {
+    CHECK_NOTNULL(log.get());
+
+    foreachvalue (process::Owned<StatusUpdateStream>& stream, streams) {
+      Try<Nothing> sync = stream->sync();
+      if (sync.isError()) {
+        return Error(sync.error());
+      }
+    }
+
+    return log->reset();
+  }
+
   // Creates a new status update stream, adding it to `streams`.
   Try<Nothing> createStatusUpdateStream(
       const IDType& streamId,
@@ -414,12 +595,20 @@ private:
     VLOG(1) << "Creating " << statusUpdateType << " stream "
             << stringify(streamId) << " checkpoint=" << stringify(checkpoint);
 
+    if (checkpoint && logPath.isSome() && log.get() == nullptr) {
+      Try<Nothing> open = openLog();
+      if (open.isError()) {
+        return Error(open.error());
+      }
+    }
+
     Try<process::Owned<StatusUpdateStream>> stream =
       StatusUpdateStream::create(
           statusUpdateType,
           streamId,
           frameworkId,
-          checkpoint ? Option<std::string>(getPath(streamId)) : None());
+          checkpoint ? Option<std::string>(getPath(streamId)) : None(),
+          log.get());
 
     if (stream.isError()) {
       return Error(stream.error());
@@ -447,7 +636,11 @@ private:
         process::Owned<StatusUpdateStream>,
         typename StatusUpdateStream::State>> result =
           StatusUpdateStream::recover(
-              statusUpdateType, streamId, getPath(streamId), strict);
+              statusUpdateType,
+              streamId,
+              getPath(streamId),
+              strict,
+              log.get());
 
     if (result.isError()) {
       return Error(result.error());
@@ -576,10 +769,260 @@ private:
   lambda::function<void(UpdateType)> forwardCallback;
   lambda::function<const std::string(const IDType&)> getPath;
 
+  // Group commit state. NOTE: `log` is declared before `streams` since the
+  // streams hand their file descriptors over to it upon destruction.
+  Option<std::string> logPath;
+  process::Owned<CheckpointLog> log;
+  process::Owned<process::Promise<Nothing>> batchCommitted;
+  hashset<IDType> batch; // Streams with records in the current batch.
+
   hashmap<IDType, process::Owned<StatusUpdateStream>> streams;
   hashmap<FrameworkID, hashset<IDType>> frameworkStreams;
   bool paused;
 
+  // Write-ahead log shared by the streams in group commit mode. Records are
+  // appended without syncing, `sync()` makes all of them durable at once.
+  class CheckpointLog
+  {
+  public:
+    static Try<process::Owned<CheckpointLog>> open(const std::string& path)
+    {
+      const std::string& dirName = Path(path).dirname();
+      Try<Nothing> directory = os::mkdir(dirName);
+      if (directory.isError()) {
+        return Error(
+            "Failed to create '" + dirName + "': " + directory.error());
+      }
+
+      Try<int_fd> fd = os::open(
+          path,
+#ifdef __WINDOWS__
+          O_BINARY |
+#endif // __WINDOWS__
+          O_CREAT | O_WRONLY | O_APPEND | O_CLOEXEC,
+          S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+      if (fd.isError()) {
+        return Error("Failed to open '" + path + "': " + fd.error());
+      }
+
+      Try<off_t> size = os::lseek(fd.get(), 0, SEEK_END);
+      if (size.isError()) {
+        os::close(fd.get());
+        return Error("Failed to lseek '" + path + "': " + size.error());
+      }
+
+      return process::Owned<CheckpointLog>(
+          new CheckpointLog(fd.get(), Bytes(size.get())));
+    }
+
+    // Writes all records of the log at `path` to their stream files, syncs
+    // the stream files and empties the log. Records of stream files which
+    // do not exist anymore, e.g., because they have been garbage collected,
+    // are skipped.
+    static Try<Nothing> replay(const std::string& path)
+    {
+      if (!os::exists(path)) {
+        return Nothing();
+      }
+
+      Try<int_fd> fd = os::open(
+          path,
+#ifdef __WINDOWS__
+          O_BINARY |
+#endif // __WINDOWS__
+          O_RDWR | O_CLOEXEC);
+
+      if (fd.isError()) {
+        return Error("Failed to open '" + path + "': " + fd.error());
+      }
+
+      hashmap<std::string, int_fd> files;
+      Option<Error> error;
+
+      while (error.isNone()) {
+        // A partial record at the end of the log belongs to a batch which
+        // was never committed, so it can be ignored.
+        Result<StatusUpdateLogRecord> entry =
+          ::protobuf::read<StatusUpdateLogRecord>(fd.get(), true, true);
+
+        if (entry.isError()) {
+          error = Error("Failed to read '" + path + "': " + entry.error());
+          break;
+        }
+
+        if (entry.isNone()) {
+          break;
+        }
+
+        if (!files.contains(entry->path())) {
+          if (!os::exists(entry->path())) {
+            continue;
+          }
+
+          Try<int_fd> file = os::open(
+              entry->path(),
+#ifdef __WINDOWS__
+              O_BINARY |
+#endif // __WINDOWS__
+              O_WRONLY | O_CLOEXEC);
+
+          if (file.isError()) {
+            error = Error(
+                "Failed to open '" + entry->path() + "': " + file.error());
+            break;
+          }
+
+          files[entry->path()] = file.get();
+        }
+
+        CheckpointType record;
+        if (!record.ParseFromString(entry->record())) {
+          error = Error(
+              "Failed to parse record for '" + entry->path() + "'");
+          break;
+        }
+
+        const int_fd file = files.at(entry->path());
+
+        Try<off_t> seek = os::lseek(file, entry->offset(), SEEK_SET);
+        if (seek.isError()) {
+          error = Error(
+              "Failed to lseek '" + entry->path() + "': " + seek.error());
+          break;
+        }
+
+        Try<Nothing> write = ::protobuf::write(file, record);
+        if (write.isError()) {
+          error = Error(
+              "Failed to write to '" + entry->path() + "': " + write.error());
+          break;
+        }
+      }
+
+      foreachpair (const std::string& filePath, int_fd file, files) {
+        Try<Nothing> sync = os::fsync(file);
+        if (sync.isError() && error.isNone()) {
+          error = Error(
+              "Failed to sync '" + filePath + "': " + sync.error());
+        }
+
+        os::close(file);
+      }
+
+      if (error.isNone()) {
+        Try<Nothing> truncated = os::ftruncate(fd.get(), 0);
+        if (truncated.isError()) {
+          error = Error(
+              "Failed to truncate '" + path + "': " + truncated.error());
+        }
+      }
+
+      if (error.isNone()) {
+        Try<Nothing> sync = os::fsync(fd.get());
+        if (sync.isError()) {
+          error = Error("Failed to sync '" + path + "': " + sync.error());
+        }
+      }
+
+      os::close(fd.get());
+
+      if (error.isSome()) {
+        return error.get();
+      }
+
+      return Nothing();
+    }
+
+    ~CheckpointLog()
+    {
+      // The records of the retired stream files are in the log, so there is
+      // no need to sync them here.
+      foreach (int_fd file, retired) {
+        os::close(file);
+      }
+
+      os::close(fd);
+    }
+
+    // Appends a record which has been written to the stream file at
+    // `streamPath` starting at `offset`.
+    Try<Nothing> append(
+        const std::string& streamPath,
+        off_t offset,
+        const CheckpointType& record)
+    {
+      StatusUpdateLogRecord entry;
+      entry.set_path(streamPath);
+      entry.set_offset(offset);
+
+      if (!record.SerializeToString(entry.mutable_record())) {
+        return Error("Failed to serialize record");
+      }
+
+      Try<Nothing> write = ::protobuf::write(fd, entry);
+      if (write.isError()) {
+        return Error(write.error());
+      }
+
+      // `protobuf::write` prefixes the message with its size.
+      size_ += Bytes(sizeof(uint32_t) + entry.ByteSize());
+
+      return Nothing();
+    }
+
+    Try<Nothing> sync()
+    {
+      return os::fsync(fd);
+    }
+
+    // Takes over the file descriptor of a closed stream which has not been
+    // synced since the last `reset()`.
+    void retire(int_fd file)
+    {
+      retired.push_back(file);
+    }
+
+    // Empties the log. The files of all open streams must have been synced
+    // before, the retired ones are synced here.
+    Try<Nothing> reset()
+    {
+      while (!retired.empty()) {
+        Try<Nothing> sync = os::fsync(retired.back());
+        if (sync.isError()) {
+          return Error("Failed to sync stream file: " + sync.error());
+        }
+
+        os::close(retired.back());
+        retired.pop_back();
+      }
+
+      Try<Nothing> truncated = os::ftruncate(fd, 0);
+      if (truncated.isError()) {
+        return Error("Failed to truncate: " + truncated.error());
+      }
+
+      Try<Nothing> sync = os::fsync(fd);
+      if (sync.isError()) {
+        return Error("Failed to sync: " + sync.error());
+      }
+
+      size_ = Bytes(0);
+
+      return Nothing();
+    }
+
+    Bytes size() const { return size_; }
+
+  private:
+    CheckpointLog(int_fd _fd, const Bytes& _size)
+      : fd(_fd), size_(_size) {}
+
+    const int_fd fd;
+    Bytes size_;
+    std::vector<int_fd> retired;
+  };
+
   // Handles the status updates and acknowledgements, checkpointing them if
   // necessary. It also holds the information about received, acknowledged and
   // pending status updates.
@@ -599,6 +1042,14 @@ private:
     ~StatusUpdateStream()
     {
       if (fd.isSome()) {
+        // In group commit mode the stream file must be synced before the
+        // log is emptied, so the log takes care of closing it.
+        if (dirty) {
+          CHECK_NOTNULL(log);
+          log->retire(fd.get());
+          return;
+        }
+
         Try<Nothing> close = os::close(fd.get());
 
         if (close.isError()) {
@@ -614,7 +1065,8 @@ private:
         const std::string& statusUpdateType,
         const IDType& streamId,
         const Option<FrameworkID>& frameworkId,
-        const Option<std::string>& path)
+        const Option<std::string>& path,
+        CheckpointLog* log)
     {
       Option<int_fd> fd;
 
@@ -631,10 +1083,11 @@ private:
               "Failed to create '" + dirName + "': " + directory.error());
         }
 
-        // Open the updates file.
+        // Open the updates file. In group commit mode the records are made
+        // durable by the log, so the file is not opened with `O_SYNC`.
         Try<int_fd> result = os::open(
             path.get(),
-            O_CREAT | O_SYNC | O_WRONLY | O_CLOEXEC,
+            O_CREAT | (log == nullptr ? O_SYNC : 0) | O_WRONLY | O_CLOEXEC,
             S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
 
         if (result.isError()) {
@@ -646,7 +1099,7 @@ private:
       }
 
       process::Owned<StatusUpdateStream> stream(
-          new StatusUpdateStream(statusUpdateType, streamId, path, fd));
+          new StatusUpdateStream(statusUpdateType, streamId, path, fd, log));
 
       stream->frameworkId = frameworkId;
 
@@ -658,7 +1111,8 @@ private:
         const std::string& statusUpdateType,
         const IDType& streamId,
         const std::string& path,
-        bool strict)
+        bool strict,
+        CheckpointLog* log)
     {
       if (os::exists(Path(path).dirname()) && !os::exists(path)) {
         // This could happen if the process died before it checkpointed any
@@ -672,14 +1126,14 @@ private:
 #ifdef __WINDOWS__
           O_BINARY |
 #endif // __WINDOWS__
-          O_SYNC | O_RDWR | O_CLOEXEC);
+          (log == nullptr ? O_SYNC : 0) | O_RDWR | O_CLOEXEC);
 
       if (fd.isError()) {
         return Error("Failed to open '" + path + "': " + fd.error());
       }
 
-      process::Owned<StatusUpdateStream> stream(
-          new StatusUpdateStream(statusUpdateType, streamId, path, fd.get()));
+      process::Owned<StatusUpdateStream> stream(new StatusUpdateStream(
+          statusUpdateType, streamId, path, fd.get(), log));
 
       VLOG(1) << "Replaying " << statusUpdateType << " stream "
               << stringify(streamId);
@@ -891,6 +1345,33 @@ private:
     // Returns `true` if the stream is checkpointed, `false` otherwise.
     bool checkpointed() { return path.isSome(); }
 
+    // Syncs the stream file if it has been written to in group commit mode
+    // since the last sync.
+    Try<Nothing> sync()
+    {
+      if (!dirty) {
+        return Nothing();
+      }
+
+      CHECK_SOME(fd);
+
+      Try<Nothing> result = os::fsync(fd.get());
+      if (result.isError()) {
+        return Error(
+            "Failed to sync file '" + path.get() + "': " + result.error());
+      }
+
+      dirty = false;
+
+      return Nothing();
+    }
+
+    // Marks the stream as failed with a non-retryable error.
+    void fail(const std::string& message)
+    {
+      error = message;
+    }
+
     const IDType streamId;
 
     bool terminated;
@@ -903,12 +1384,15 @@ private:
         const std::string& _statusUpdateType,
         const IDType& _streamId,
         const Option<std::string>& _path,
-        Option<int_fd> _fd)
+        Option<int_fd> _fd,
+        CheckpointLog* _log)
       : streamId(_streamId),
         terminated(false),
         statusUpdateType(_statusUpdateType),
         path(_path),
-        fd(_fd) {}
+        fd(_fd),
+        log(_log),
+        dirty(false) {}
 
     // Handles the status update and writes it to disk, if necessary.
     //
@@ -943,12 +1427,34 @@ private:
             break;
         }
 
+        Option<off_t> offset;
+        if (log != nullptr) {
+          Try<off_t> position = os::lseek(fd.get(), 0, SEEK_CUR);
+          if (position.isError()) {
+            error =
+              "Failed to lseek file '" + path.get() + "': " + position.error();
+            return Error(error.get());
+          }
+
+          offset = position.get();
+        }
+
         Try<Nothing> write = ::protobuf::write(fd.get(), record);
         if (write.isError()) {
           error =
             "Failed to write to file '" + path.get() + "': " + write.error();
           return Error(error.get());
         }
+
+        if (log != nullptr) {
+          dirty = true;
+
+          Try<Nothing> append = log->append(path.get(), offset.get(), record);
+          if (append.isError()) {
+            error = "Failed to append to log: " + append.error();
+            return Error(error.get());
+          }
+        }
       }
 
       // Now actually handle the update.
@@ -999,6 +1505,9 @@ private:
     const Option<std::string> path; // File path of the update stream.
     const Option<int_fd> fd; // File descriptor to the update stream.
 
+    CheckpointLog* log; // Shared log in group commit mode, otherwise `nullptr`.
+    bool dirty; // Written to since the stream file was last synced.
+
     hashset<id::UUID> received;
     hashset<id::UUID> acknowledged;
 
@@ -684,6 +684,93 @@ TEST_P(MasterAPITest, GetState)
   driver.join();
 }
 
+// This test verifies that the state can be streamed as RecordIO
+// encoded `GET_STATE` responses which add up to the complete state.
+TEST_P(MasterAPITest, GetStateStreaming)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get());
+  ASSERT_SOME(slave);
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  EXPECT_CALL(sched, registered(&driver, _, _));
+
+  Future<vector<Offer>> offers;
+  EXPECT_CALL(sched, resourceOffers(&driver, _))
+    .WillOnce(FutureArg<1>(&offers))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  driver.start();
+
+  AWAIT_READY(offers);
+  ASSERT_FALSE(offers->empty());
+
+  ContentType contentType = GetParam();
+
+  v1::master::Call v1Call;
+  v1Call.set_type(v1::master::Call::GET_STATE);
+
+  http::Headers headers = createBasicAuthHeaders(DEFAULT_CREDENTIAL);
+  headers["Accept"] = APPLICATION_RECORDIO;
+  headers[MESSAGE_ACCEPT] = stringify(contentType);
+
+  Future<http::Response> response = http::streaming::post(
+      master.get()->pid,
+      "api/v1",
+      headers,
+      serialize(contentType, v1Call),
+      stringify(contentType));
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, response);
+  AWAIT_EXPECT_RESPONSE_HEADER_EQ(
+      APPLICATION_RECORDIO, "Content-Type", response);
+  AWAIT_EXPECT_RESPONSE_HEADER_EQ(
+      stringify(contentType), MESSAGE_CONTENT_TYPE, response);
+
+  ASSERT_EQ(http::Response::PIPE, response->type);
+  ASSERT_SOME(response->reader);
+
+  Reader<v1::master::Response> reader(
+      Decoder<v1::master::Response>(lambda::bind(
+          deserialize<v1::master::Response>, contentType, lambda::_1)),
+      response->reader.get());
+
+  // Merge all the records into a single state.
+  v1::master::Response::GetState getState;
+  size_t records = 0;
+
+  while (true) {
+    Future<Result<v1::master::Response>> record = reader.read();
+    AWAIT_READY(record);
+
+    if (record->isNone()) {
+      break;
+    }
+
+    ASSERT_SOME(record.get());
+    ASSERT_EQ(v1::master::Response::GET_STATE, record->get().type());
+
+    getState.MergeFrom(record->get().get_state());
+    records++;
+  }
+
+  EXPECT_LT(1u, records);
+
+  ASSERT_EQ(1, getState.get_frameworks().frameworks_size());
+  ASSERT_EQ(1, getState.get_agents().agents_size());
+  ASSERT_TRUE(getState.get_tasks().tasks().empty());
+  ASSERT_TRUE(getState.get_executors().executors().empty());
+
+  driver.stop();
+  driver.join();
+}
+
 
 TEST_P(MasterAPITest, GetTasksNoRunningTask)
 {
@@ -839,6 +926,172 @@ TEST_P(MasterAPITest, GetTasks)
 }
 
 
+// This test verifies that the GetTasks v1 API call applies the
+// filters, the pagination and the field mask of the call.
+TEST_P(MasterAPITest, GetTasksFiltered)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  MockExecutor exec(DEFAULT_EXECUTOR_ID);
+  TestContainerizer containerizer(&exec);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+
+  slave::Flags slaveFlags = CreateSlaveFlags();
+  slaveFlags.resources = "cpus:2;mem:1024";
+
+  Try<Owned<cluster::Slave>> slave =
+    StartSlave(detector.get(), &containerizer, slaveFlags);
+  ASSERT_SOME(slave);
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  Future<FrameworkID> frameworkId;
+  EXPECT_CALL(sched, registered(&driver, _, _))
+    .WillOnce(FutureArg<1>(&frameworkId));
+
+  Future<vector<Offer>> offers;
+  EXPECT_CALL(sched, resourceOffers(&driver, _))
+    .WillOnce(FutureArg<1>(&offers))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  driver.start();
+
+  AWAIT_READY(frameworkId);
+  AWAIT_READY(offers);
+  ASSERT_FALSE(offers->empty());
+
+  vector<TaskInfo> tasks;
+  for (int i = 1; i <= 2; i++) {
+    TaskInfo task;
+    task.set_name("test");
+    task.mutable_task_id()->set_value(stringify(i));
+    task.mutable_slave_id()->MergeFrom(offers.get()[0].slave_id());
+    task.mutable_resources()->MergeFrom(
+        Resources::parse("cpus:1;mem:512").get());
+    task.mutable_executor()->MergeFrom(DEFAULT_EXECUTOR_INFO);
+
+    tasks.push_back(task);
+  }
+
+  EXPECT_CALL(exec, registered(_, _, _, _));
+
+  EXPECT_CALL(exec, launchTask(_, _))
+    .WillRepeatedly(SendStatusUpdateFromTask(TASK_RUNNING));
+
+  Future<TaskStatus> status1;
+  Future<TaskStatus> status2;
+  EXPECT_CALL(sched, statusUpdate(&driver, _))
+    .WillOnce(FutureArg<1>(&status1))
+    .WillOnce(FutureArg<1>(&status2));
+
+  driver.launchTasks(offers.get()[0].id(), tasks);
+
+  AWAIT_READY(status1);
+  EXPECT_EQ(TASK_RUNNING, status1->state());
+
+  AWAIT_READY(status2);
+  EXPECT_EQ(TASK_RUNNING, status2->state());
+
+  ContentType contentType = GetParam();
+
+  auto getTasks = [&](const v1::master::Call::GetTasks& query) {
+    v1::master::Call v1Call;
+    v1Call.set_type(v1::master::Call::GET_TASKS);
+    v1Call.mutable_get_tasks()->CopyFrom(query);
+
+    return post(master.get()->pid, v1Call, contentType);
+  };
+
+  // Pages of a single task each return different tasks.
+  {
+    v1::master::Call::GetTasks query;
+    query.set_limit(1);
+
+    Future<v1::master::Response> page1 = getTasks(query);
+
+    query.set_offset(1);
+
+    Future<v1::master::Response> page2 = getTasks(query);
+
+    query.set_offset(2);
+
+    Future<v1::master::Response> page3 = getTasks(query);
+
+    AWAIT_READY(page1);
+    AWAIT_READY(page2);
+    AWAIT_READY(page3);
+
+    ASSERT_EQ(1, page1->get_tasks().tasks().size());
+    ASSERT_EQ(1, page2->get_tasks().tasks().size());
+    EXPECT_NE(
+        page1->get_tasks().tasks(0).task_id().value(),
+        page2->get_tasks().tasks(0).task_id().value());
+
+    EXPECT_TRUE(page3->get_tasks().tasks().empty());
+  }
+
+  // The field mask only keeps the requested and the required fields.
+  {
+    v1::master::Call::GetTasks query;
+    query.add_fields("statuses");
+
+    Future<v1::master::Response> v1Response = getTasks(query);
+
+    AWAIT_READY(v1Response);
+    ASSERT_TRUE(v1Response->IsInitialized());
+    ASSERT_EQ(2, v1Response->get_tasks().tasks().size());
+
+    foreach (const mesos::v1::Task& task, v1Response->get_tasks().tasks()) {
+      EXPECT_EQ("test", task.name());
+      EXPECT_EQ(v1::TASK_RUNNING, task.state());
+      EXPECT_FALSE(task.statuses().empty());
+      EXPECT_TRUE(task.resources().empty());
+      EXPECT_FALSE(task.has_executor_id());
+    }
+  }
+
+  // Filters by framework, agent and role.
+  {
+    v1::master::Call::GetTasks query;
+    query.add_framework_ids()->CopyFrom(evolve(frameworkId.get()));
+    query.add_agent_ids()->CopyFrom(evolve(offers.get()[0].slave_id()));
+    query.add_roles(DEFAULT_FRAMEWORK_INFO.roles(0));
+
+    Future<v1::master::Response> v1Response = getTasks(query);
+
+    AWAIT_READY(v1Response);
+    EXPECT_EQ(2, v1Response->get_tasks().tasks().size());
+
+    query.add_framework_ids()->set_value("unknown");
+    query.clear_roles();
+    query.add_roles("unknown");
+
+    v1Response = getTasks(query);
+
+    AWAIT_READY(v1Response);
+    EXPECT_TRUE(v1Response->get_tasks().tasks().empty());
+  }
+
+  // Unknown fields in the field mask are rejected.
+  {
+    v1::master::Call::GetTasks query;
+    query.add_fields("unknown");
+
+    AWAIT_FAILED(getTasks(query));
+  }
+
+  EXPECT_CALL(exec, shutdown(_))
+    .Times(AtMost(1));
+
+  driver.stop();
+  driver.join();
+}
+
+
 TEST_P(MasterAPITest, GetLoggingLevel)
 {
   Try<Owned<cluster::Master>> master = this->StartMaster();
@@ -3108,8 +3361,13 @@ TEST_P(MasterAPITest, EventAuthorizationDelayed)
 
   ContentType contentType = GetParam();
 
+  // This test expects the authorizer to be called for every event, so
+  // the master must not reuse object approvers.
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.object_approvers_cache_ttl = Seconds(0);
+
   MockAuthorizer authorizer;
-  Try<Owned<cluster::Master>> master = StartMaster(&authorizer);
+  Try<Owned<cluster::Master>> master = StartMaster(&authorizer, masterFlags);
   ASSERT_SOME(master);
 
   auto scheduler = std::make_shared<v1::MockHTTPScheduler>();
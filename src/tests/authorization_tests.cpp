@@ -15,6 +15,7 @@
 // limitations under the License.
 
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -24,8 +25,12 @@
 
 #include <mesos/module/authorizer.hpp>
 
+#include <stout/duration.hpp>
+#include <stout/stopwatch.hpp>
+#include <stout/stringify.hpp>
 #include <stout/try.hpp>
 
+#include "authorizer/caching_authorizer.hpp"
 #include "authorizer/local/authorizer.hpp"
 
 #include "tests/mesos.hpp"
@@ -37,7 +42,14 @@ namespace mesos {
 namespace internal {
 namespace tests {
 
+using std::cout;
+using std::endl;
 using std::string;
+using std::vector;
+
+using testing::_;
+using testing::Return;
+using testing::WithParamInterface;
 
 
 template <typename T>
@@ -7051,6 +7063,194 @@ TYPED_TEST(AuthorizationTest, LogAccess)
   }
 }
 
+
+// This tests that the first ACL which matches a request decides it,
+// regardless of whether the ACLs match the request by value or match
+// any subject or object.
+TYPED_TEST(AuthorizationTest, FirstMatchingACLDecides)
+{
+  ACLs acls;
+  acls.set_permissive(false);
+
+  {
+    // Nobody can view the tasks of user "root".
+    mesos::ACL::ViewTask* acl = acls.add_view_tasks();
+    acl->mutable_principals()->set_type(mesos::ACL::Entity::NONE);
+    acl->mutable_users()->add_values("root");
+  }
+
+  {
+    // Principal "foo" can view the tasks of users "root" and "bar".
+    mesos::ACL::ViewTask* acl = acls.add_view_tasks();
+    acl->mutable_principals()->add_values("foo");
+    acl->mutable_users()->add_values("root");
+    acl->mutable_users()->add_values("bar");
+  }
+
+  {
+    // Principal "baz" cannot view the tasks of any user.
+    mesos::ACL::ViewTask* acl = acls.add_view_tasks();
+    acl->mutable_principals()->add_values("baz");
+    acl->mutable_users()->set_type(mesos::ACL::Entity::NONE);
+  }
+
+  {
+    // Anybody can view the tasks of any user.
+    mesos::ACL::ViewTask* acl = acls.add_view_tasks();
+    acl->mutable_principals()->set_type(mesos::ACL::Entity::ANY);
+    acl->mutable_users()->set_type(mesos::ACL::Entity::ANY);
+  }
+
+  Try<Authorizer*> create = TypeParam::create(parameterize(acls));
+  ASSERT_SOME(create);
+  Owned<Authorizer> authorizer(create.get());
+
+  auto viewTask = [](const string& principal, const string& user) {
+    authorization::Request request;
+    request.set_action(authorization::VIEW_TASK);
+    request.mutable_subject()->set_value(principal);
+    request.mutable_object()->mutable_framework_info()->set_user(user);
+    request.mutable_object()->mutable_task()->set_user(user);
+    return request;
+  };
+
+  AWAIT_EXPECT_FALSE(authorizer->authorized(viewTask("foo", "root")));
+  AWAIT_EXPECT_TRUE(authorizer->authorized(viewTask("foo", "bar")));
+  AWAIT_EXPECT_TRUE(authorizer->authorized(viewTask("foo", "qux")));
+  AWAIT_EXPECT_FALSE(authorizer->authorized(viewTask("baz", "bar")));
+  AWAIT_EXPECT_TRUE(authorizer->authorized(viewTask("qux", "bar")));
+}
+
+
+// Tests that the caching authorizer reuses the object approvers of the
+// underlying authorizer per subject and action until they expire.
+TEST(CachingAuthorizerTest, ReuseObjectApprovers)
+{
+  Clock::pause();
+
+  MockAuthorizer authorizer;
+
+  // The approvers for VIEW_TASK are created twice since the first one
+  // expires, the approver for VIEW_FRAMEWORK once.
+  EXPECT_CALL(authorizer, getObjectApprover(_, _))
+    .Times(3)
+    .WillRepeatedly(Return(Owned<ObjectApprover>(
+        new AcceptingObjectApprover())));
+
+  CachingAuthorizer cachingAuthorizer(&authorizer, Seconds(10), 10);
+
+  authorization::Subject subject;
+  subject.set_value("foo");
+
+  Future<Owned<ObjectApprover>> approver1 =
+    cachingAuthorizer.getObjectApprover(subject, authorization::VIEW_TASK);
+
+  Future<Owned<ObjectApprover>> approver2 =
+    cachingAuthorizer.getObjectApprover(subject, authorization::VIEW_TASK);
+
+  Future<Owned<ObjectApprover>> approver3 =
+    cachingAuthorizer.getObjectApprover(
+        subject, authorization::VIEW_FRAMEWORK);
+
+  AWAIT_READY(approver1);
+  AWAIT_READY(approver2);
+  AWAIT_READY(approver3);
+
+  EXPECT_EQ(approver1->get(), approver2->get());
+
+  Clock::advance(Seconds(10));
+
+  Future<Owned<ObjectApprover>> approver4 =
+    cachingAuthorizer.getObjectApprover(subject, authorization::VIEW_TASK);
+
+  AWAIT_READY(approver4);
+
+  Clock::resume();
+}
+
+
+class LocalAuthorizer_BENCHMARK_Test
+  : public MesosTest,
+    public WithParamInterface<size_t> {};
+
+
+// The value is the number of ACLs.
+INSTANTIATE_TEST_CASE_P(
+    ACLCount,
+    LocalAuthorizer_BENCHMARK_Test,
+    ::testing::Values(10U, 1000U, 10000U));
+
+
+// This test measures the time to approve viewing tasks when there are
+// many ACLs, each of which allows a different principal to view the
+// tasks of a different user. The last ACL allows an operator to view
+// all tasks, which is the worst case for a linear scan of the ACLs.
+TEST_P(LocalAuthorizer_BENCHMARK_Test, ViewTasks)
+{
+  const size_t aclCount = GetParam();
+  const size_t taskCount = 100000;
+
+  ACLs acls;
+  acls.set_permissive(false);
+
+  for (size_t i = 0; i < aclCount; i++) {
+    mesos::ACL::ViewTask* acl = acls.add_view_tasks();
+    acl->mutable_principals()->add_values("principal" + stringify(i));
+    acl->mutable_users()->add_values("user" + stringify(i));
+  }
+
+  mesos::ACL::ViewTask* acl = acls.add_view_tasks();
+  acl->mutable_principals()->add_values("operator");
+  acl->mutable_users()->set_type(mesos::ACL::Entity::ANY);
+
+  Try<Authorizer*> create = LocalAuthorizer::create(acls);
+  ASSERT_SOME(create);
+  Owned<Authorizer> authorizer(create.get());
+
+  FrameworkInfo frameworkInfo;
+  frameworkInfo.set_user("user");
+
+  vector<Task> tasks(taskCount);
+  for (size_t i = 0; i < taskCount; i++) {
+    tasks[i].set_user("user" + stringify(i % aclCount));
+  }
+
+  const string principals[] = {"principal" + stringify(aclCount / 2),
+                               "operator"};
+
+  foreach (const string& principal, principals) {
+    authorization::Subject subject;
+    subject.set_value(principal);
+
+    Future<Owned<ObjectApprover>> approver =
+      authorizer->getObjectApprover(subject, authorization::VIEW_TASK);
+
+    AWAIT_READY(approver);
+
+    size_t approved = 0;
+
+    Stopwatch watch;
+    watch.start();
+
+    foreach (const Task& task, tasks) {
+      Try<bool> result =
+        approver.get()->approved(ObjectApprover::Object(task, frameworkInfo));
+
+      ASSERT_SOME(result);
+
+      if (result.get()) {
+        approved++;
+      }
+    }
+
+    watch.stop();
+
+    cout << "Approved " << approved << " out of " << taskCount
+         << " tasks for principal '" << principal << "' with "
+         << aclCount + 1 << " ACLs in " << watch.elapsed() << endl;
+  }
+}
+
 } // namespace tests {
 } // namespace internal {
 } // namespace mesos {
@@ -14,6 +14,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#ifndef __WINDOWS__
+#include <sys/resource.h>
+#endif // __WINDOWS__
+
+#include <atomic>
+#include <iostream>
 #include <memory>
 #include <string>
 #include <utility>
@@ -22,18 +28,33 @@
 #include <mesos/v1/mesos.hpp>
 
 #include <process/clock.hpp>
+#include <process/collect.hpp>
+#include <process/defer.hpp>
+#include <process/http.hpp>
+#include <process/id.hpp>
+#include <process/io.hpp>
 #include <process/owned.hpp>
+#include <process/process.hpp>
+#include <process/socket.hpp>
+#include <process/subprocess.hpp>
 
+#include <stout/duration.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/foreach.hpp>
+#include <stout/lambda.hpp>
 #include <stout/nothing.hpp>
+#include <stout/numify.hpp>
 #include <stout/path.hpp>
+#include <stout/stopwatch.hpp>
+#include <stout/strings.hpp>
 #include <stout/try.hpp>
 
 #include <stout/os/getcwd.hpp>
 
 #include "checks/checker.hpp"
+#include "checks/checker_process.hpp"
 
+#include "common/status_utils.hpp"
 #include "common/validation.hpp"
 
 #include "slave/containerizer/fetcher.hpp"
@@ -43,6 +64,8 @@
 #include "tests/mesos.hpp"
 #include "tests/utils.hpp"
 
+using mesos::internal::checks::CheckerProcess;
+
 using mesos::internal::common::validation::validateCheckInfo;
 using mesos::internal::common::validation::validateCheckStatusInfo;
 
@@ -55,13 +78,27 @@ using mesos::v1::scheduler::Call;
 using mesos::v1::scheduler::Event;
 using mesos::v1::scheduler::Mesos;
 
+using process::Failure;
 using process::Future;
 using process::Owned;
+using process::Process;
+using process::Promise;
+using process::Subprocess;
 
+using process::network::inet::Socket;
+
+using process::network::internal::SocketImpl;
+
+using std::cout;
+using std::endl;
 using std::pair;
+using std::shared_ptr;
 using std::string;
+using std::tuple;
 using std::vector;
 
+using testing::WithParamInterface;
+
 namespace mesos {
 namespace internal {
 namespace tests {
@@ -3046,6 +3083,547 @@ TEST_F(CheckTest, CheckStatusInfoValidation)
   }
 }
 
+
+#ifndef __WINDOWS__
+// Accepts connections on a loopback socket and hands each of them to
+// the given function. By default, the HTTP requests of the checks are
+// responded to with `200 OK`.
+class CheckTargetProcess : public Process<CheckTargetProcess>
+{
+public:
+  explicit CheckTargetProcess(
+      const Socket& _socket,
+      const lambda::function<void(const Socket&)>& _connected = serve)
+    : ProcessBase(process::ID::generate("check-target")),
+      socket(_socket),
+      connected(_connected) {}
+
+  static void serve(const Socket& socket)
+  {
+    // TCP checks close the connection without sending a request.
+    process::http::serve(
+        socket,
+        [](const process::http::Request&) -> Future<process::http::Response> {
+          return process::http::OK();
+        });
+  }
+
+protected:
+  void initialize() override
+  {
+    accept();
+  }
+
+  void finalize() override
+  {
+    accepting.discard();
+  }
+
+private:
+  void accept()
+  {
+    accepting = socket.accept()
+      .onAny(defer(self(), [this](const Future<Socket>& socket) {
+        if (!socket.isReady()) {
+          return;
+        }
+
+        connected(socket.get());
+
+        accept();
+      }));
+  }
+
+  Socket socket;
+  const lambda::function<void(const Socket&)> connected;
+  Future<Socket> accepting;
+};
+
+
+// Tests that the HTTP and TCP checks, which are performed in-process on
+// POSIX systems, have the same outcome as the command-based checks they
+// replace, i.e., as running `curl` and `mesos-tcp-connect`.
+class CheckerTest : public TemporaryDirectoryTest
+{
+protected:
+  void TearDown() override
+  {
+    if (checker.get() != nullptr) {
+      terminate(checker.get());
+      wait(checker.get());
+      checker.reset();
+    }
+
+    if (target.get() != nullptr) {
+      terminate(target.get());
+      wait(target.get());
+      target.reset();
+    }
+
+    TemporaryDirectoryTest::TearDown();
+  }
+
+  // Starts a target which hands the accepted connections to the given
+  // function.
+  void listen(
+      const lambda::function<void(const Socket&)>& connected =
+        CheckTargetProcess::serve)
+  {
+    Try<Socket> socket = Socket::create(SocketImpl::Kind::POLL);
+    ASSERT_SOME(socket);
+
+    Try<process::network::inet::Address> address =
+      socket->bind(process::network::inet4::Address::LOOPBACK_ANY());
+    ASSERT_SOME(address);
+    ASSERT_SOME(socket->listen(16));
+
+    port = address->port;
+
+    target.reset(new CheckTargetProcess(socket.get(), connected));
+    spawn(target.get());
+  }
+
+  // Binds a socket without listening on it, so that connections to its
+  // port are refused.
+  void refuse()
+  {
+    Try<Socket> socket = Socket::create(SocketImpl::Kind::POLL);
+    ASSERT_SOME(socket);
+
+    Try<process::network::inet::Address> address =
+      socket->bind(process::network::inet4::Address::LOOPBACK_ANY());
+    ASSERT_SOME(address);
+
+    port = address->port;
+    refusing = socket.get();
+  }
+
+  CheckInfo httpCheckInfo(const string& path, int timeout = 15)
+  {
+    CheckInfo checkInfo;
+    checkInfo.set_type(CheckInfo::HTTP);
+    checkInfo.mutable_http()->set_port(port.get());
+    checkInfo.mutable_http()->set_path(path);
+    checkInfo.set_delay_seconds(0);
+    checkInfo.set_interval_seconds(1000);
+    checkInfo.set_timeout_seconds(timeout);
+
+    return checkInfo;
+  }
+
+  CheckInfo tcpCheckInfo()
+  {
+    CheckInfo checkInfo;
+    checkInfo.set_type(CheckInfo::TCP);
+    checkInfo.mutable_tcp()->set_port(port.get());
+    checkInfo.set_delay_seconds(0);
+    checkInfo.set_interval_seconds(1000);
+    checkInfo.set_timeout_seconds(15);
+
+    return checkInfo;
+  }
+
+  // Starts a checker and returns the result of its first check.
+  Future<Try<CheckStatusInfo>> check(const CheckInfo& checkInfo)
+  {
+    shared_ptr<Promise<Try<CheckStatusInfo>>> promise(
+        new Promise<Try<CheckStatusInfo>>());
+
+    TaskID taskId;
+    taskId.set_value("task");
+
+    checker.reset(new CheckerProcess(
+        checkInfo,
+        getLauncherDir(),
+        [promise](const Try<CheckStatusInfo>& result) {
+          promise->set(result);
+        },
+        taskId,
+        CheckInfo::Type_Name(checkInfo.type()) + " check",
+        checks::runtime::Plain{vector<string>(), None()},
+        None()));
+
+    spawn(checker.get());
+
+    return promise->future();
+  }
+
+  // Runs `curl` with the arguments of the command-based HTTP check and
+  // returns the reported status code, or an error if `curl` fails.
+  Future<Try<int>> curl(const string& path)
+  {
+    const string url = "http://127.0.0.1:" + stringify(port.get()) + path;
+
+    Try<Subprocess> s = process::subprocess(
+        "curl",
+        {"curl", "-s", "-S", "-L", "-k", "-w", "%{http_code}",
+         "-o", os::DEV_NULL, "-g", url},
+        Subprocess::PATH(os::DEV_NULL),
+        Subprocess::PIPE(),
+        Subprocess::PATH(os::DEV_NULL));
+
+    if (s.isError()) {
+      return Failure("Failed to launch curl: " + s.error());
+    }
+
+    return await(s->status(), process::io::read(s->out().get()))
+      .then([](const tuple<Future<Option<int>>, Future<string>>& t)
+          -> Future<Try<int>> {
+        const Future<Option<int>>& status = std::get<0>(t);
+        if (!status.isReady() || status->isNone()) {
+          return Failure("Failed to reap curl");
+        }
+
+        if (status->get() != 0) {
+          return Try<int>(Error("curl " + WSTRINGIFY(status->get())));
+        }
+
+        const Future<string>& output = std::get<1>(t);
+        if (!output.isReady()) {
+          return Failure("Failed to read the output of curl");
+        }
+
+        return numify<int>(strings::trim(output.get()));
+      });
+  }
+
+  // Runs `mesos-tcp-connect` like the command-based TCP check and
+  // returns whether it succeeded.
+  Future<bool> tcpConnect()
+  {
+    const string command = path::join(getLauncherDir(), "mesos-tcp-connect");
+
+    Try<Subprocess> s = process::subprocess(
+        command,
+        {command, "--ip=127.0.0.1", "--port=" + stringify(port.get())},
+        Subprocess::PATH(os::DEV_NULL),
+        Subprocess::PATH(os::DEV_NULL),
+        Subprocess::PATH(os::DEV_NULL));
+
+    if (s.isError()) {
+      return Failure("Failed to launch mesos-tcp-connect: " + s.error());
+    }
+
+    return s->status()
+      .then([](const Option<int>& status) -> Future<bool> {
+        if (status.isNone()) {
+          return Failure("Failed to reap mesos-tcp-connect");
+        }
+
+        return status.get() == 0;
+      });
+  }
+
+  Option<uint16_t> port;
+  Option<Socket> refusing;
+  Owned<CheckTargetProcess> target;
+  Owned<CheckerProcess> checker;
+};
+
+
+// Tests that an HTTP check, which falls back to `curl` on a 3xx
+// response, follows the redirect like the command-based check.
+TEST_F(CheckerTest, HTTPCheckRedirect)
+{
+  listen([](const Socket& socket) {
+    process::http::serve(
+        socket,
+        [](const process::http::Request& request)
+            -> Future<process::http::Response> {
+          if (request.url.path == "/redirect") {
+            return process::http::TemporaryRedirect("/ok");
+          }
+
+          return process::http::OK();
+        });
+  });
+
+  Future<Try<int>> command = curl("/redirect");
+  AWAIT_READY(command);
+  ASSERT_SOME_EQ(200, command.get());
+
+  Future<Try<CheckStatusInfo>> result = check(httpCheckInfo("/redirect"));
+  AWAIT_READY(result);
+  ASSERT_SOME(result.get());
+
+  EXPECT_EQ(
+      static_cast<uint32_t>(command->get()),
+      result->get().http().status_code());
+}
+
+
+// Tests that an HTTP check reports a 3xx response which cannot be
+// followed with the same status code as the command-based check.
+TEST_F(CheckerTest, HTTPCheckRedirectWithoutLocation)
+{
+  listen([](const Socket& socket) {
+    process::http::serve(
+        socket,
+        [](const process::http::Request&) -> Future<process::http::Response> {
+          return process::http::Response(
+              process::http::Status::TEMPORARY_REDIRECT);
+        });
+  });
+
+  Future<Try<int>> command = curl("/");
+  AWAIT_READY(command);
+  ASSERT_SOME_EQ(307, command.get());
+
+  Future<Try<CheckStatusInfo>> result = check(httpCheckInfo("/"));
+  AWAIT_READY(result);
+  ASSERT_SOME(result.get());
+
+  EXPECT_EQ(
+      static_cast<uint32_t>(command->get()),
+      result->get().http().status_code());
+}
+
+
+// Tests that an HTTP check fails on a response which is not HTTP, like
+// the command-based check.
+TEST_F(CheckerTest, HTTPCheckMalformedResponse)
+{
+  listen([](Socket socket) {
+    shared_ptr<char> data(new char[4096], std::default_delete<char[]>());
+
+    socket.recv(data.get(), 4096)
+      .then([socket, data](size_t) mutable {
+        return socket.send("garbage\r\n\r\n");
+      });
+  });
+
+  Future<Try<int>> command = curl("/");
+  AWAIT_READY(command);
+  EXPECT_ERROR(command.get());
+
+  Future<Try<CheckStatusInfo>> result = check(httpCheckInfo("/"));
+  AWAIT_READY(result);
+  EXPECT_ERROR(result.get());
+}
+
+
+// Tests that an HTTP check fails once it times out if the target never
+// responds, like the command-based check, which kills `curl` then.
+TEST_F(CheckerTest, HTTPCheckTimeout)
+{
+  // Keep the connections open without responding to them.
+  shared_ptr<vector<Socket>> connections(new vector<Socket>());
+
+  listen([connections](const Socket& socket) {
+    connections->push_back(socket);
+  });
+
+  Future<Try<CheckStatusInfo>> result = check(httpCheckInfo("/", 1));
+  AWAIT_READY(result);
+  ASSERT_ERROR(result.get());
+
+  EXPECT_TRUE(strings::contains(result->error(), "timed out"))
+    << result->error();
+}
+
+
+// Tests that an HTTP check fails if the connection is refused, like the
+// command-based check.
+TEST_F(CheckerTest, HTTPCheckConnectionRefused)
+{
+  refuse();
+
+  Future<Try<int>> command = curl("/");
+  AWAIT_READY(command);
+  EXPECT_ERROR(command.get());
+
+  Future<Try<CheckStatusInfo>> result = check(httpCheckInfo("/"));
+  AWAIT_READY(result);
+  EXPECT_ERROR(result.get());
+}
+
+
+// Tests that a TCP check succeeds if the connection is accepted, like
+// the command-based check.
+TEST_F(CheckerTest, TCPCheck)
+{
+  listen();
+
+  Future<bool> command = tcpConnect();
+  AWAIT_EXPECT_TRUE(command);
+
+  Future<Try<CheckStatusInfo>> result = check(tcpCheckInfo());
+  AWAIT_READY(result);
+  ASSERT_SOME(result.get());
+
+  EXPECT_EQ(command.get(), result->get().tcp().succeeded());
+}
+
+
+// Tests that a TCP check does not succeed if the connection is refused,
+// like the command-based check.
+TEST_F(CheckerTest, TCPCheckConnectionRefused)
+{
+  refuse();
+
+  Future<bool> command = tcpConnect();
+  AWAIT_EXPECT_FALSE(command);
+
+  Future<Try<CheckStatusInfo>> result = check(tcpCheckInfo());
+  AWAIT_READY(result);
+  ASSERT_SOME(result.get());
+
+  EXPECT_EQ(command.get(), result->get().tcp().succeeded());
+}
+
+
+class Checker_BENCHMARK_Test
+  : public TemporaryDirectoryTest,
+    public WithParamInterface<size_t>
+{
+protected:
+  void SetUp() override
+  {
+    TemporaryDirectoryTest::SetUp();
+
+    Try<Socket> socket = Socket::create(SocketImpl::Kind::POLL);
+    ASSERT_SOME(socket);
+
+    Try<process::network::inet::Address> address =
+      socket->bind(process::network::inet4::Address::LOOPBACK_ANY());
+    ASSERT_SOME(address);
+    ASSERT_SOME(socket->listen(1024));
+
+    port = address->port;
+
+    target.reset(new CheckTargetProcess(socket.get()));
+    spawn(target.get());
+  }
+
+  void TearDown() override
+  {
+    terminate(target.get());
+    wait(target.get());
+    target.reset();
+
+    TemporaryDirectoryTest::TearDown();
+  }
+
+  // Runs the given number of checkers back to back for a fixed amount
+  // of time and prints how many checks were performed per second and
+  // per second of CPU time, including the CPU time of reaped helper
+  // processes, e.g., `curl`.
+  void benchmark(const CheckInfo& checkInfo, size_t checkerCount)
+  {
+    const Duration duration = Seconds(5);
+
+    std::atomic<size_t> performed(0);
+    std::atomic<size_t> failed(0);
+
+    vector<Owned<CheckerProcess>> checkers;
+    for (size_t i = 0; i < checkerCount; i++) {
+      TaskID taskId;
+      taskId.set_value("task" + stringify(i));
+
+      checkers.emplace_back(new CheckerProcess(
+          checkInfo,
+          getLauncherDir(),
+          [&performed, &failed](const Try<CheckStatusInfo>& result) {
+            if (result.isError()) {
+              failed++;
+            } else {
+              performed++;
+            }
+          },
+          taskId,
+          CheckInfo::Type_Name(checkInfo.type()) + " check",
+          checks::runtime::Plain{vector<string>(), None()},
+          None()));
+    }
+
+    const double cpuBefore = cpuTime();
+
+    Stopwatch watch;
+    watch.start();
+
+    foreach (const Owned<CheckerProcess>& checker, checkers) {
+      spawn(checker.get());
+    }
+
+    os::sleep(duration);
+
+    const size_t checks = performed.load();
+
+    watch.stop();
+
+    const double cpu = cpuTime() - cpuBefore;
+
+    foreach (const Owned<CheckerProcess>& checker, checkers) {
+      terminate(checker.get());
+      wait(checker.get());
+    }
+
+    cout << checkerCount << " " << CheckInfo::Type_Name(checkInfo.type())
+         << " checkers performed " << checks << " checks in "
+         << watch.elapsed() << " (" << checks / watch.elapsed().secs()
+         << " checks/sec, " << checks / cpu << " checks/CPU-sec)" << endl;
+
+    EXPECT_EQ(0u, failed.load());
+  }
+
+  Option<uint16_t> port;
+  Owned<CheckTargetProcess> target;
+
+private:
+  static double cpuTime(int who)
+  {
+    struct rusage usage;
+    CHECK_EQ(0, ::getrusage(who, &usage));
+
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+           usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+  }
+
+  static double cpuTime()
+  {
+    return cpuTime(RUSAGE_SELF) + cpuTime(RUSAGE_CHILDREN);
+  }
+};
+
+
+// The value is the number of concurrently running checkers.
+INSTANTIATE_TEST_CASE_P(
+    CheckerCount,
+    Checker_BENCHMARK_Test,
+    ::testing::Values(1U, 10U, 100U));
+
+
+// This benchmark measures the throughput of HTTP checks which are
+// performed back to back against a local HTTP server.
+TEST_P(Checker_BENCHMARK_Test, HTTPCheck)
+{
+  CheckInfo checkInfo;
+  checkInfo.set_type(CheckInfo::HTTP);
+  checkInfo.mutable_http()->set_port(port.get());
+  checkInfo.mutable_http()->set_path("/");
+  checkInfo.set_delay_seconds(0);
+  checkInfo.set_interval_seconds(0);
+  checkInfo.set_timeout_seconds(5);
+
+  benchmark(checkInfo, GetParam());
+}
+
+
+// This benchmark measures the throughput of TCP checks which are
+// performed back to back against a local TCP listener.
+TEST_P(Checker_BENCHMARK_Test, TCPCheck)
+{
+  CheckInfo checkInfo;
+  checkInfo.set_type(CheckInfo::TCP);
+  checkInfo.mutable_tcp()->set_port(port.get());
+  checkInfo.set_delay_seconds(0);
+  checkInfo.set_interval_seconds(0);
+  checkInfo.set_timeout_seconds(5);
+
+  benchmark(checkInfo, GetParam());
+}
+#endif // __WINDOWS__
+
 } // namespace tests {
 } // namespace internal {
 } // namespace mesos {
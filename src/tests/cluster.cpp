@@ -424,7 +424,8 @@ Try<process::Owned<Slave>> Slave::create(
 
   // If the garbage collector is not provided, create a default one.
   if (gc.isNone()) {
-    slave->gc.reset(new slave::GarbageCollector(flags.work_dir));
+    slave->gc.reset(new slave::GarbageCollector(
+        flags.work_dir, flags.gc_workers, flags.gc_max_bytes_per_second));
   }
 
   // If the containerizer is not provided, create a default one.
@@ -226,6 +226,22 @@ TEST_F_TEMP_DISABLED_ON_WINDOWS(TarTest, GZIPChangeDirectory)
 class ShasumTest : public TemporaryDirectoryTest {};
 
 
+TEST_F_TEMP_DISABLED_ON_WINDOWS(ShasumTest, SHA256SimpleFile)
+{
+  const Path testFile(path::join(os::getcwd(), "test"));
+
+  Try<Nothing> write = os::write(testFile, "hello world");
+  ASSERT_SOME(write);
+
+  Future<string> sha256 = command::sha256(testFile);
+  AWAIT_ASSERT_READY(sha256);
+
+  ASSERT_EQ(
+      sha256.get(),
+      "b94d27b9934d3e08a52e52d7da7dabfac484efe37a5380ee9088f7ace2efcde9");
+}
+
+
 TEST_F_TEMP_DISABLED_ON_WINDOWS(ShasumTest, SHA512SimpleFile)
 {
   const Path testFile(path::join(os::getcwd(), "test"));
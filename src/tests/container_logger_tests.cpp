@@ -14,8 +14,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <array>
 #include <list>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -24,14 +27,20 @@
 #include <mesos/slave/containerizer.hpp>
 
 #include <process/clock.hpp>
+#include <process/collect.hpp>
 #include <process/future.hpp>
 #include <process/gtest.hpp>
+#include <process/io.hpp>
+#include <process/loop.hpp>
 #include <process/owned.hpp>
+#include <process/subprocess.hpp>
 
 #include <stout/bytes.hpp>
 #include <stout/gtest.hpp>
+#include <stout/gzip.hpp>
 #include <stout/os.hpp>
 #include <stout/path.hpp>
+#include <stout/stopwatch.hpp>
 #include <stout/strings.hpp>
 #include <stout/try.hpp>
 
@@ -50,6 +59,8 @@
 #include "slave/paths.hpp"
 #include "slave/slave.hpp"
 
+#include "slave/container_loggers/logrotate.hpp"
+
 #include "slave/containerizer/docker.hpp"
 #include "slave/containerizer/fetcher.hpp"
 
@@ -85,13 +96,19 @@ using mesos::master::detector::MasterDetector;
 using mesos::slave::ContainerLogger;
 using mesos::slave::Isolator;
 
+using std::cout;
+using std::endl;
 using std::list;
+using std::shared_ptr;
 using std::string;
+using std::tuple;
 using std::vector;
 
 using testing::_;
 using testing::AtMost;
+using testing::Combine;
 using testing::Return;
+using testing::Values;
 using testing::WithParamInterface;
 
 namespace mesos {
@@ -779,6 +796,177 @@ TEST_P(UserContainerLoggerTest,
   EXPECT_LE(2040u, stdoutSize->bytes() / Bytes::KILOBYTES);
   EXPECT_GE(2048u, stdoutSize->bytes() / Bytes::KILOBYTES);
 }
+
+
+// Launches the `mesos-logrotate-logger` binary, which reads the logs
+// from the file descriptor `in` and takes ownership of it.
+static Try<Subprocess> launchLogger(
+    const string& log,
+    const Bytes& maxSize,
+    const string& options,
+    int_fd in)
+{
+  return subprocess(
+      path::join(getLauncherDir(), logger::rotate::NAME),
+      {logger::rotate::NAME,
+       "--log_filename=" + log,
+       "--max_size=" + stringify(maxSize.bytes()) + "B",
+       "--logrotate_options=" + options},
+      Subprocess::FD(in, Subprocess::IO::OWNED),
+      Subprocess::FD(STDOUT_FILENO),
+      Subprocess::FD(STDERR_FILENO));
+}
+
+
+class LogrotateLoggerTest : public TemporaryDirectoryTest {};
+
+
+// Tests that the logger rotates and compresses the log files itself,
+// without calling `logrotate`, if it implements all of the options.
+TEST_F(LogrotateLoggerTest, LOGROTATE_RotateAndCompress)
+{
+  const string log = path::join(sandbox.get(), "stdout");
+  const Bytes maxSize(os::pagesize());
+
+  Try<std::array<int_fd, 2>> pipes = os::pipe();
+  ASSERT_SOME(pipes);
+
+  Try<Subprocess> logger = launchLogger(
+      log, maxSize, "rotate 3\ncompress\ndelaycompress", pipes->at(0));
+
+  ASSERT_SOME(logger);
+
+  // Log four and a half log files worth of data.
+  const string data(maxSize.bytes(), 'x');
+  for (int i = 0; i < 4; i++) {
+    ASSERT_SOME(os::write(pipes->at(1), data));
+  }
+
+  ASSERT_SOME(os::write(pipes->at(1), data.substr(0, data.size() / 2)));
+  ASSERT_SOME(os::close(pipes->at(1)));
+
+  AWAIT_EXPECT_WEXITSTATUS_EQ(EXIT_SUCCESS, logger->status());
+
+  // The leading log file should be half full.
+  EXPECT_SOME_EQ(Bytes(maxSize.bytes() / 2), os::stat::size(log));
+
+  // Due to 'delaycompress', the most recently rotated log file should
+  // not be compressed.
+  EXPECT_SOME_EQ(maxSize, os::stat::size(log + ".1"));
+  EXPECT_FALSE(os::exists(log + ".1.gz"));
+
+  // The older log files should be compressed.
+  for (int i = 2; i <= 3; i++) {
+    const string path = log + "." + stringify(i);
+    EXPECT_FALSE(os::exists(path));
+
+    Try<string> compressed = os::read(path + ".gz");
+    ASSERT_SOME(compressed);
+    EXPECT_SOME_EQ(data, gzip::decompress(compressed.get()));
+  }
+
+  // Only three rotated log files should be kept.
+  EXPECT_FALSE(os::exists(log + ".4"));
+  EXPECT_FALSE(os::exists(log + ".4.gz"));
+
+  // The configuration file is still written, but `logrotate` is not
+  // called, so there is no state file.
+  EXPECT_TRUE(os::exists(log + logger::rotate::CONF_SUFFIX));
+  EXPECT_FALSE(os::exists(log + logger::rotate::STATE_SUFFIX));
+}
+
+
+// This benchmark measures the sustained throughput of the logger per
+// container. It is parameterized by the number of containers, each
+// with their own logger, and whether rotated log files are compressed.
+class LogrotateLogger_BENCHMARK_Test
+  : public TemporaryDirectoryTest,
+    public WithParamInterface<tuple<size_t, bool>> {};
+
+
+INSTANTIATE_TEST_CASE_P(
+    ContainersAndCompression,
+    LogrotateLogger_BENCHMARK_Test,
+    Combine(Values(1U, 4U, 16U), Values(false, true)));
+
+
+TEST_P(LogrotateLogger_BENCHMARK_Test, LOGROTATE_Throughput)
+{
+  size_t containers;
+  bool compress;
+
+  std::tie(containers, compress) = GetParam();
+
+  const Bytes size = Megabytes(256);
+  const string chunk(Kilobytes(64).bytes(), 'x');
+
+  const string options = compress ? "rotate 4\ncompress" : "rotate 4";
+
+  vector<int_fd> pipes;
+  vector<Subprocess> loggers;
+
+  for (size_t i = 0; i < containers; i++) {
+    const string directory = path::join(sandbox.get(), stringify(i));
+    ASSERT_SOME(os::mkdir(directory));
+
+    Try<std::array<int_fd, 2>> pipe = os::pipe();
+    ASSERT_SOME(pipe);
+
+    Try<Subprocess> logger = launchLogger(
+        path::join(directory, "stdout"), Megabytes(10), options, pipe->at(0));
+
+    ASSERT_SOME(logger);
+    ASSERT_SOME(io::prepare_async(pipe->at(1)));
+
+    pipes.push_back(pipe->at(1));
+    loggers.push_back(logger.get());
+  }
+
+  Stopwatch watch;
+  watch.start();
+
+  vector<Future<Option<int>>> statuses;
+
+  for (size_t i = 0; i < containers; i++) {
+    const int_fd pipe = pipes[i];
+    const Future<Option<int>> status = loggers[i].status();
+
+    shared_ptr<size_t> remaining(
+        new size_t(size.bytes() / chunk.size()));
+
+    statuses.push_back(process::loop(
+        [=]() {
+          return io::write(pipe, chunk);
+        },
+        [=](const Nothing&) -> ControlFlow<Nothing> {
+          if (--(*remaining) == 0) {
+            return Break();
+          }
+
+          return Continue();
+        })
+      .then([=]() {
+        os::close(pipe);
+        return status;
+      }));
+  }
+
+  AWAIT_READY_FOR(collect(statuses), Minutes(10));
+
+  watch.stop();
+
+  foreach (const Future<Option<int>>& status, statuses) {
+    AWAIT_EXPECT_WEXITSTATUS_EQ(EXIT_SUCCESS, status);
+  }
+
+  const double throughput =
+    (size.bytes() / Bytes::MEGABYTES) / watch.elapsed().secs();
+
+  cout << "Logged " << size << " through each of " << containers
+       << (compress ? " compressing" : "") << " loggers in "
+       << watch.elapsed() << " (" << throughput << " MB/s per container)"
+       << endl;
+}
 #endif // __WINDOWS__
 
 } // namespace tests {
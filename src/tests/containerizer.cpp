@@ -281,7 +281,9 @@ public:
     return containers_.keys();
   }
 
-  Future<Nothing> pruneImages(const vector<Image>& excludedImages)
+  Future<Nothing> pruneImages(
+      const vector<Image>& excludedImages,
+      const Option<double>& headroom)
   {
     return Nothing();
   }
@@ -411,7 +413,7 @@ void TestContainerizer::setup()
   EXPECT_CALL(*this, kill(_, _))
     .WillRepeatedly(Invoke(this, &TestContainerizer::_kill));
 
-  EXPECT_CALL(*this, pruneImages(_))
+  EXPECT_CALL(*this, pruneImages(_, _))
     .WillRepeatedly(Invoke(this, &TestContainerizer::_pruneImages));
 }
 
@@ -548,12 +550,14 @@ Future<hashset<ContainerID>> TestContainerizer::containers()
 
 
 Future<Nothing> TestContainerizer::_pruneImages(
-    const vector<Image>& excludedImages)
+    const vector<Image>& excludedImages,
+    const Option<double>& headroom)
 {
   return process::dispatch(
       process.get(),
       &TestContainerizerProcess::pruneImages,
-      excludedImages);
+      excludedImages,
+      headroom);
 }
 
 } // namespace tests {
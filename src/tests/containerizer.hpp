@@ -123,9 +123,10 @@ public:
       kill,
       process::Future<bool>(const ContainerID&, int));
 
-  MOCK_METHOD1(
+  MOCK_METHOD2(
       pruneImages,
-      process::Future<Nothing>(const std::vector<Image>&));
+      process::Future<Nothing>(
+          const std::vector<Image>&, const Option<double>&));
 
   // Additional destroy method for testing because we won't know the
   // ContainerID created for each container.
@@ -173,7 +174,8 @@ private:
       int status);
 
   process::Future<Nothing> _pruneImages(
-      const std::vector<Image>& excludedImages);
+      const std::vector<Image>& excludedImages,
+      const Option<double>& headroom);
 
   process::Owned<TestContainerizerProcess> process;
 };
@@ -21,9 +21,14 @@
 
 #include <gtest/gtest.h>
 
+#include <process/dispatch.hpp>
 #include <process/future.hpp>
 #include <process/gtest.hpp>
+#include <process/http.hpp>
+#include <process/id.hpp>
+#include <process/network.hpp>
 #include <process/owned.hpp>
+#include <process/process.hpp>
 #include <process/subprocess.hpp>
 
 #include <stout/duration.hpp>
@@ -34,6 +39,10 @@
 
 #include "docker/docker.hpp"
 
+#ifndef __WINDOWS__
+#include "docker/engine.hpp"
+#endif // __WINDOWS__
+
 #include "mesos/resources.hpp"
 
 #include "tests/environment.hpp"
@@ -44,6 +53,10 @@
 
 using namespace process;
 
+#ifndef __WINDOWS__
+namespace unix = process::network::unix;
+#endif // __WINDOWS__
+
 using std::list;
 using std::string;
 using std::vector;
@@ -1096,6 +1109,204 @@ TEST_F(DockerTest, ROOT_DOCKER_ConflictingVolumeDrivers)
   ASSERT_ERROR(runOptions);
 }
 
+
+#ifndef __WINDOWS__
+// A fake Docker daemon which serves a single container named 'foo'
+// over a UNIX socket, to test the Docker Engine API client.
+class FakeDockerDaemonProcess : public Process<FakeDockerDaemonProcess>
+{
+public:
+  explicit FakeDockerDaemonProcess(const unix::Socket& _socket)
+    : ProcessBase(process::ID::generate("fake-docker-daemon")),
+      socket(_socket),
+      started(false) {}
+
+  // Starts the container and notifies the event subscribers.
+  void start()
+  {
+    started = true;
+
+    foreach (http::Pipe::Writer writer, writers) {
+      writer.write("{\"status\":\"start\",\"id\":\"123\"}\n");
+    }
+  }
+
+  // Returns the requests received so far, e.g., "POST /containers/foo/stop".
+  vector<string> requests()
+  {
+    return received;
+  }
+
+protected:
+  void initialize() override
+  {
+    accept();
+  }
+
+  void finalize() override
+  {
+    accepting.discard();
+
+    foreach (http::Pipe::Writer writer, writers) {
+      writer.close();
+    }
+  }
+
+private:
+  void accept()
+  {
+    accepting = socket.accept()
+      .onAny(defer(self(), [this](const Future<unix::Socket>& socket) {
+        if (!socket.isReady()) {
+          return;
+        }
+
+        http::serve(socket.get(), defer(self(), &Self::handle, lambda::_1));
+
+        accept();
+      }));
+  }
+
+  Future<http::Response> handle(const http::Request& request)
+  {
+    received.push_back(request.method + " " + request.url.path);
+
+    if (request.url.path == "/version") {
+      return http::OK("{\"Version\": \"18.09.1\"}");
+    }
+
+    if (request.url.path == "/events") {
+      http::Pipe pipe;
+      writers.push_back(pipe.writer());
+
+      http::OK response;
+      response.type = http::Response::PIPE;
+      response.reader = pipe.reader();
+      return response;
+    }
+
+    if (request.url.path == "/containers/foo/json") {
+      return http::OK(
+          "{\"Id\": \"123\", \"Name\": \"/foo\","
+          " \"State\": {\"Pid\": " + string(started ? "42" : "0") + ","
+          " \"StartedAt\": \"" +
+          (started ? "2018-01-01T00:00:00Z" : "0001-01-01T00:00:00Z") + "\"},"
+          " \"NetworkSettings\": {\"IPAddress\": \"\"}}");
+    }
+
+    if (request.url.path == "/containers/json") {
+      return http::OK("[{\"Id\": \"123\", \"Names\": [\"/foo\"]}]");
+    }
+
+    if (request.url.path == "/containers/foo/stop") {
+      started = false;
+      return http::Response(http::Status::NO_CONTENT);
+    }
+
+    if (request.method == "DELETE" && request.url.path == "/containers/foo") {
+      return http::Response(http::Status::NO_CONTENT);
+    }
+
+    return http::NotFound("{\"message\": \"No such container\"}");
+  }
+
+  unix::Socket socket;
+  Future<unix::Socket> accepting;
+  bool started;
+  vector<http::Pipe::Writer> writers;
+  vector<string> received;
+};
+
+
+class DockerEngineTest : public TemporaryDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    TemporaryDirectoryTest::SetUp();
+
+    socketPath = path::join(sandbox.get(), "docker.sock");
+
+    Try<unix::Socket> socket = unix::Socket::create();
+    ASSERT_SOME(socket);
+
+    Try<unix::Address> address = unix::Address::create(socketPath);
+    ASSERT_SOME(address);
+
+    ASSERT_SOME(socket->bind(address.get()));
+    ASSERT_SOME(socket->listen(64));
+
+    daemon.reset(new FakeDockerDaemonProcess(socket.get()));
+    spawn(daemon.get());
+  }
+
+  void TearDown() override
+  {
+    terminate(daemon.get());
+    wait(daemon.get());
+    daemon.reset();
+
+    TemporaryDirectoryTest::TearDown();
+  }
+
+  string socketPath;
+  Owned<FakeDockerDaemonProcess> daemon;
+};
+
+
+// This test verifies that the Docker Engine API client waits for a
+// container to start through the event stream of the daemon rather
+// than by polling it.
+TEST_F(DockerEngineTest, InspectWaitsForStartEvent)
+{
+  Try<Owned<Docker>> docker = DockerEngine::create("docker", socketPath, false);
+  ASSERT_SOME(docker);
+
+  AWAIT_EXPECT_EQ(Version(18, 9, 1), docker.get()->version());
+
+  Future<Docker::Container> container = docker.get()->inspect("foo");
+  AWAIT_READY(container);
+  EXPECT_FALSE(container->started);
+  EXPECT_NONE(container->pid);
+
+  // Use a retry interval which is too long for the test to pass by
+  // polling the container.
+  container = docker.get()->inspect("foo", Days(1));
+
+  // Wait for the client to subscribe to the events before starting
+  // the container, to make sure the start is delivered as an event.
+  Future<vector<string>> requests;
+  do {
+    requests = dispatch(daemon.get(), &FakeDockerDaemonProcess::requests);
+    AWAIT_READY(requests);
+  } while (std::count(
+               requests->begin(),
+               requests->end(),
+               "GET /containers/foo/json") < 2);
+
+  EXPECT_TRUE(container.isPending());
+
+  dispatch(daemon.get(), &FakeDockerDaemonProcess::start);
+
+  AWAIT_READY(container);
+  EXPECT_TRUE(container->started);
+  EXPECT_SOME_EQ(42, container->pid);
+
+  Future<vector<Docker::Container>> containers = docker.get()->ps(true);
+  AWAIT_READY(containers);
+  ASSERT_EQ(1u, containers->size());
+  EXPECT_EQ("123", containers->front().id);
+
+  AWAIT_READY(docker.get()->stop("foo", Seconds(0), true));
+
+  requests = dispatch(daemon.get(), &FakeDockerDaemonProcess::requests);
+  AWAIT_READY(requests);
+  EXPECT_EQ("DELETE /containers/foo", requests->back());
+
+  AWAIT_FAILED(docker.get()->kill("bar", SIGKILL));
+}
+#endif // __WINDOWS__
+
 } // namespace tests {
 } // namespace internal {
 } // namespace mesos {
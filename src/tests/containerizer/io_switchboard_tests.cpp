@@ -14,6 +14,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
+
 #include <map>
 #include <string>
 #include <tuple>
@@ -264,6 +266,102 @@ TEST_F(IOSwitchboardServerTest, RedirectLog)
 }
 
 
+// Tests that the output is appended to log files which are opened in
+// append mode, like the container loggers open the sandbox log files.
+TEST_F(IOSwitchboardServerTest, RedirectLogAppend)
+{
+  Try<int> nullFd = os::open(os::DEV_NULL, O_RDWR);
+  ASSERT_SOME(nullFd);
+
+  Try<std::array<int_fd, 2>> stdoutPipe_ = os::pipe();
+  ASSERT_SOME(stdoutPipe_);
+
+  const std::array<int_fd, 2>& stdoutPipe = stdoutPipe_.get();
+
+  Try<std::array<int_fd, 2>> stderrPipe_ = os::pipe();
+  ASSERT_SOME(stderrPipe_);
+
+  const std::array<int_fd, 2>& stderrPipe = stderrPipe_.get();
+
+  const string existing = "Output of a previous run.\n";
+
+  string stdoutPath = path::join(sandbox.get(), "stdout");
+  ASSERT_SOME(os::write(stdoutPath, existing));
+
+  Try<int> stdoutFd = os::open(
+      stdoutPath,
+      O_WRONLY | O_CREAT | O_APPEND,
+      S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+  ASSERT_SOME(stdoutFd);
+
+  string stderrPath = path::join(sandbox.get(), "stderr");
+  ASSERT_SOME(os::write(stderrPath, existing));
+
+  Try<int> stderrFd = os::open(
+      stderrPath,
+      O_WRONLY | O_CREAT | O_APPEND,
+      S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+  ASSERT_SOME(stderrFd);
+
+  string socketPath = path::join(sandbox.get(), "mesos-io-switchboard");
+
+  Try<Owned<IOSwitchboardServer>> server = IOSwitchboardServer::create(
+      false,
+      nullFd.get(),
+      stdoutPipe[0],
+      stdoutFd.get(),
+      stderrPipe[0],
+      stderrFd.get(),
+      socketPath);
+
+  ASSERT_SOME(server);
+
+  Future<Nothing> runServer = server.get()->run();
+
+  string data =
+    "Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do "
+    "eiusmod tempor incididunt ut labore et dolore magna aliqua.\n";
+
+  while (Bytes(data.size()) < Megabytes(1)) {
+    data.append(data);
+  }
+
+  Try<Nothing> write = os::write(stdoutPipe[1], data);
+  ASSERT_SOME(write);
+
+  write = os::write(stderrPipe[1], data);
+  ASSERT_SOME(write);
+
+  os::close(stdoutPipe[1]);
+  os::close(stderrPipe[1]);
+
+  AWAIT_ASSERT_READY(runServer);
+
+  // The open file descriptions of the log files are shared with other
+  // writers, so the switchboard must not clear their `O_APPEND` flag.
+  EXPECT_NE(0, ::fcntl(stdoutFd.get(), F_GETFL) & O_APPEND);
+  EXPECT_NE(0, ::fcntl(stderrFd.get(), F_GETFL) & O_APPEND);
+
+  os::close(nullFd.get());
+  os::close(stdoutPipe[0]);
+  os::close(stderrPipe[0]);
+  os::close(stdoutFd.get());
+  os::close(stderrFd.get());
+
+  Try<string> read = os::read(stdoutPath);
+  ASSERT_SOME(read);
+
+  EXPECT_EQ(existing + data, read.get());
+
+  read = os::read(stderrPath);
+  ASSERT_SOME(read);
+
+  EXPECT_EQ(existing + data, read.get());
+}
+
+
 TEST_F(IOSwitchboardServerTest, AttachOutput)
 {
   Try<int> nullFd = os::open(os::DEV_NULL, O_RDWR);
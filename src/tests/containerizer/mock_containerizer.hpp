@@ -83,10 +83,10 @@ public:
       containers,
       process::Future<hashset<ContainerID>>());
 
-  MOCK_METHOD1(
+  MOCK_METHOD2(
       pruneImages,
       process::Future<Nothing>(
-          const std::vector<Image>&));
+          const std::vector<Image>&, const Option<double>&));
 };
 
 } // namespace tests {
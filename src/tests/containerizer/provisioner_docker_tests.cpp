@@ -14,15 +14,29 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <archive.h>
+#include <archive_entry.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
 #include <gmock/gmock.h>
 
+#include <stout/bytes.hpp>
 #include <stout/duration.hpp>
 #include <stout/gtest.hpp>
 #include <stout/json.hpp>
+#include <stout/option.hpp>
 #include <stout/os.hpp>
 #include <stout/path.hpp>
+#include <stout/stopwatch.hpp>
 #include <stout/stringify.hpp>
 
+#include <process/clock.hpp>
+#include <process/collect.hpp>
 #include <process/future.hpp>
 #include <process/gmock.hpp>
 #include <process/owned.hpp>
@@ -33,6 +47,9 @@
 #include "linux/fs.hpp"
 #endif // __linux__
 
+#include "common/command_utils.hpp"
+
+#include "slave/containerizer/mesos/provisioner/archive.hpp"
 #include "slave/containerizer/mesos/provisioner/constants.hpp"
 #include "slave/containerizer/mesos/provisioner/paths.hpp"
 
@@ -55,9 +72,15 @@ namespace paths = mesos::internal::slave::docker::paths;
 namespace slave = mesos::internal::slave;
 namespace spec = ::docker::spec;
 
+using std::cout;
+using std::endl;
+using std::make_tuple;
 using std::string;
+using std::tie;
+using std::tuple;
 using std::vector;
 
+using process::Clock;
 using process::Future;
 using process::Owned;
 using process::PID;
@@ -69,6 +92,7 @@ using mesos::internal::slave::AUFS_BACKEND;
 using mesos::internal::slave::Containerizer;
 using mesos::internal::slave::COPY_BACKEND;
 using mesos::internal::slave::Fetcher;
+using mesos::internal::slave::ImageArchive;
 using mesos::internal::slave::MesosContainerizer;
 using mesos::internal::slave::OVERLAY_BACKEND;
 using mesos::internal::slave::Provisioner;
@@ -80,6 +104,7 @@ using mesos::slave::ContainerTermination;
 using slave::ImageInfo;
 using slave::Slave;
 
+using slave::docker::MetadataManager;
 using slave::docker::Puller;
 using slave::docker::RegistryPuller;
 using slave::docker::Store;
@@ -245,6 +270,68 @@ TEST_F(ProvisionerDockerLocalStoreTest, MetadataManagerInitialization)
   verifyLocalDockerImage(flags, imageInfo->layers);
 }
 
+// This test verifies that the metadata manager tracks when each image
+// was last used, which the store uses to evict the least recently
+// used images first.
+TEST_F(ProvisionerDockerLocalStoreTest, MetadataManagerLastUsed)
+{
+  slave::Flags flags;
+  flags.docker_store_dir = path::join(os::getcwd(), "store");
+
+  ASSERT_SOME(os::mkdir(flags.docker_store_dir));
+
+  Try<Owned<MetadataManager>> metadataManager =
+    MetadataManager::create(flags);
+  ASSERT_SOME(metadataManager);
+
+  Try<spec::ImageReference> abc = spec::parseImageReference("abc");
+  ASSERT_SOME(abc);
+
+  Try<spec::ImageReference> xyz = spec::parseImageReference("xyz");
+  ASSERT_SOME(xyz);
+
+  Clock::pause();
+
+  AWAIT_READY(metadataManager.get()->put(abc.get(), {"123"}));
+
+  Clock::advance(Seconds(10));
+
+  AWAIT_READY(metadataManager.get()->put(xyz.get(), {"456"}));
+
+  Clock::advance(Seconds(10));
+
+  // A cache hit refreshes the access time of the image.
+  Future<Option<slave::docker::Image>> image =
+    metadataManager.get()->get(abc.get(), true);
+
+  AWAIT_READY(image);
+  ASSERT_SOME(image.get());
+
+  Future<vector<slave::docker::Image>> images =
+    metadataManager.get()->images();
+
+  AWAIT_READY(images);
+  ASSERT_EQ(2u, images->size());
+
+  Option<double> abcLastUsed;
+  Option<double> xyzLastUsed;
+
+  foreach (const slave::docker::Image& image, images.get()) {
+    if (image.reference().repository() == abc->repository()) {
+      abcLastUsed = image.last_used();
+    } else {
+      xyzLastUsed = image.last_used();
+    }
+  }
+
+  ASSERT_SOME(abcLastUsed);
+  ASSERT_SOME(xyzLastUsed);
+  EXPECT_DOUBLE_EQ(10.0, abcLastUsed.get() - xyzLastUsed.get());
+
+  Clock::resume();
+}
+
+
 // This is a regression test for MESOS-8871.
 // This test the ability of the metadata manger to ignore the empty images
 // file when it recover images.
@@ -396,6 +483,249 @@ TEST_F(ProvisionerDockerLocalStoreTest, PullingSameImageSimutanuously)
 }
 
 
+class ProvisionerArchiveTest : public TemporaryDirectoryTest
+{
+protected:
+  struct Entry
+  {
+    string path;
+
+    // If set, the entry is a symbolic link to this target, otherwise it
+    // is a regular file with `content`.
+    Option<string> symlink;
+    string content;
+  };
+
+  // Writes a tar archive with the given entries, in order. Unlike
+  // `os::tar()`, this allows crafting layers which a well behaved image
+  // builder would not produce.
+  static Try<Nothing> writeTar(const string& path, const vector<Entry>& entries)
+  {
+    std::unique_ptr<struct archive, int (*)(struct archive*)> writer(
+        archive_write_new(), archive_write_free);
+
+    archive_write_set_format_pax_restricted(writer.get());
+
+    if (archive_write_open_filename(writer.get(), path.c_str()) !=
+        ARCHIVE_OK) {
+      return Error(archive_error_string(writer.get()));
+    }
+
+    foreach (const Entry& entry, entries) {
+      std::unique_ptr<struct archive_entry, void (*)(struct archive_entry*)>
+        header(archive_entry_new(), archive_entry_free);
+
+      archive_entry_set_pathname(header.get(), entry.path.c_str());
+
+      if (entry.symlink.isSome()) {
+        archive_entry_set_filetype(header.get(), AE_IFLNK);
+        archive_entry_set_perm(header.get(), 0777);
+        archive_entry_set_symlink(header.get(), entry.symlink->c_str());
+      } else {
+        archive_entry_set_filetype(header.get(), AE_IFREG);
+        archive_entry_set_perm(header.get(), 0644);
+        archive_entry_set_size(header.get(), entry.content.size());
+      }
+
+      if (archive_write_header(writer.get(), header.get()) != ARCHIVE_OK) {
+        return Error(archive_error_string(writer.get()));
+      }
+
+      if (!entry.content.empty() &&
+          archive_write_data(
+              writer.get(),
+              entry.content.data(),
+              entry.content.size()) < 0) {
+        return Error(archive_error_string(writer.get()));
+      }
+    }
+
+    if (archive_write_close(writer.get()) != ARCHIVE_OK) {
+      return Error(archive_error_string(writer.get()));
+    }
+
+    return Nothing();
+  }
+};
+
+
+// This test verifies that an archive is extracted in-process and that
+// the archive is not extracted if it does not match its digest.
+TEST_F(ProvisionerArchiveTest, ExtractVerifiesDigest)
+{
+  const string cwd = os::getcwd();
+
+  ASSERT_SOME(os::mkdir(path::join(cwd, "layer")));
+  ASSERT_SOME(os::write(path::join(cwd, "layer", "file"), "content"));
+
+  ASSERT_SOME(os::chdir(path::join(cwd, "layer")));
+  ASSERT_SOME(os::tar(".", "../layer.tar.gz"));
+  ASSERT_SOME(os::chdir(cwd));
+
+  const string tar = path::join(cwd, "layer.tar.gz");
+
+  Future<string> sha256 = command::sha256(Path(tar));
+  AWAIT_READY(sha256);
+
+  ImageArchive archive;
+  archive.source = tar;
+  archive.directory = path::join(cwd, "rootfs1");
+  archive.digest = "sha256:" + sha256.get();
+
+  ASSERT_SOME(os::mkdir(archive.directory));
+  AWAIT_READY(slave::extract({archive}, 1));
+
+  EXPECT_SOME_EQ("content", os::read(path::join(archive.directory, "file")));
+
+  archive.directory = path::join(cwd, "rootfs2");
+  archive.digest = "sha256:" + string(64, '0');
+
+  ASSERT_SOME(os::mkdir(archive.directory));
+  AWAIT_FAILED(slave::extract({archive}, 1));
+
+  EXPECT_FALSE(os::exists(path::join(archive.directory, "file")));
+}
+
+
+// This test verifies that layers cannot write outside of the directory
+// they are extracted to through symbolic links, while links to absolute
+// paths inside the image, like 'var/run' to '/run', are still extracted.
+TEST_F(ProvisionerArchiveTest, ExtractRefusesSymlinkEscapes)
+{
+  const string cwd = os::getcwd();
+  const string host = path::join(cwd, "host");
+
+  ASSERT_SOME(os::mkdir(host));
+
+  // A link to a host directory followed by a file under the link.
+  ASSERT_SOME(writeTar(
+      path::join(cwd, "absolute.tar"),
+      {{"var/run", host, ""},
+       {"var/run/x", None(), "escaped"}}));
+
+  // A relative link which points outside of the directory.
+  ASSERT_SOME(writeTar(
+      path::join(cwd, "relative.tar"),
+      {{"var/escape", string("../../host"), ""}}));
+
+  ASSERT_SOME(writeTar(
+      path::join(cwd, "benign.tar"),
+      {{"var/run", string("/run"), ""},
+       {"usr/lib/libc", string("../../lib/libc"), ""},
+       {"etc/hostname", None(), "localhost"}}));
+
+  foreach (const string& name, vector<string>({"absolute", "relative"})) {
+    ImageArchive archive;
+    archive.source = path::join(cwd, name + ".tar");
+    archive.directory = path::join(cwd, name);
+
+    ASSERT_SOME(os::mkdir(archive.directory));
+    AWAIT_FAILED(slave::extract({archive}, 1));
+  }
+
+  EXPECT_FALSE(os::exists(path::join(host, "x")));
+
+  ImageArchive archive;
+  archive.source = path::join(cwd, "benign.tar");
+  archive.directory = path::join(cwd, "benign");
+
+  ASSERT_SOME(os::mkdir(archive.directory));
+  AWAIT_READY(slave::extract({archive}, 1));
+
+  EXPECT_TRUE(os::stat::islink(path::join(archive.directory, "var", "run")));
+  EXPECT_TRUE(
+      os::stat::islink(path::join(archive.directory, "usr", "lib", "libc")));
+
+  EXPECT_SOME_EQ(
+      "localhost",
+      os::read(path::join(archive.directory, "etc", "hostname")));
+}
+
+
+class ProvisionerArchive_BENCHMARK_Test
+  : public TemporaryDirectoryTest,
+    public WithParamInterface<tuple<size_t, size_t>> {};
+
+
+// The parameters are the number of layers of the synthetic image and
+// the number of files per layer.
+INSTANTIATE_TEST_CASE_P(
+    LayersAndFiles,
+    ProvisionerArchive_BENCHMARK_Test,
+    ::testing::Values(
+        make_tuple(10U, 1000U),
+        make_tuple(20U, 5000U),
+        make_tuple(50U, 1000U)));
+
+
+// This benchmark compares the extraction of the layers of an image by
+// forking `tar` per layer with the in-process extraction.
+TEST_P(ProvisionerArchive_BENCHMARK_Test, ExtractLayers)
+{
+  size_t layerCount;
+  size_t fileCount;
+
+  tie(layerCount, fileCount) = GetParam();
+
+  const string cwd = os::getcwd();
+  const string data(Kilobytes(4).bytes(), 'x');
+
+  vector<string> tars;
+
+  for (size_t i = 0; i < layerCount; i++) {
+    const string layer = path::join(cwd, "layer" + stringify(i));
+    ASSERT_SOME(os::mkdir(layer));
+
+    for (size_t j = 0; j < fileCount; j++) {
+      ASSERT_SOME(os::write(path::join(layer, "file" + stringify(j)), data));
+    }
+
+    ASSERT_SOME(os::chdir(layer));
+    ASSERT_SOME(os::tar(".", layer + ".tar.gz"));
+    ASSERT_SOME(os::chdir(cwd));
+    ASSERT_SOME(os::rmdir(layer));
+
+    tars.push_back(layer + ".tar.gz");
+  }
+
+  vector<Future<Nothing>> futures;
+  vector<ImageArchive> archives;
+
+  for (size_t i = 0; i < layerCount; i++) {
+    const string untarred = path::join(cwd, "untarred" + stringify(i));
+    const string extracted = path::join(cwd, "extracted" + stringify(i));
+
+    ASSERT_SOME(os::mkdir(untarred));
+    ASSERT_SOME(os::mkdir(extracted));
+
+    futures.push_back(command::untar(Path(tars[i]), Path(untarred)));
+
+    ImageArchive archive;
+    archive.source = tars[i];
+    archive.directory = extracted;
+
+    archives.push_back(archive);
+  }
+
+  Stopwatch watch;
+  watch.start();
+
+  AWAIT_READY_FOR(process::collect(futures), Minutes(10));
+
+  cout << "Extracted " << layerCount << " layers of " << fileCount
+       << " files using 'tar' in " << watch.elapsed() << endl;
+
+  watch.start();
+
+  AWAIT_READY_FOR(
+      slave::extract(archives, slave::ARCHIVE_EXTRACTION_PARALLELISM),
+      Minutes(10));
+
+  cout << "Extracted " << layerCount << " layers of " << fileCount
+       << " files in-process in " << watch.elapsed() << endl;
+}
+
+
 #ifdef __linux__
 class ProvisionerDockerTest
   : public MesosTest,
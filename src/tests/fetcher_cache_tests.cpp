@@ -43,6 +43,7 @@
 #include <stout/option.hpp>
 #include <stout/os.hpp>
 #include <stout/path.hpp>
+#include <stout/stopwatch.hpp>
 #include <stout/try.hpp>
 
 #include "master/flags.hpp"
@@ -99,6 +100,7 @@ using testing::Eq;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
 using testing::Return;
+using testing::WithParamInterface;
 
 namespace mesos {
 namespace internal {
@@ -1745,6 +1747,140 @@ TEST_F(FetcherCacheTest, RemoveLRUCacheEntries)
   EXPECT_TRUE(cmd2Found);
 }
 
+
+
+class FetcherCacheEntries_BENCHMARK_Test
+  : public TemporaryDirectoryTest,
+    public WithParamInterface<size_t> {};
+
+
+// The value is the number of entries in the cache.
+INSTANTIATE_TEST_CASE_P(
+    EntryCount,
+    FetcherCacheEntries_BENCHMARK_Test,
+    ::testing::Values(1000U, 10000U, 100000U));
+
+
+// This benchmark measures how long it takes to look up (and thereby
+// refresh) every entry of a cache with many entries, and to remove all
+// entries again.
+TEST_P(FetcherCacheEntries_BENCHMARK_Test, RefreshAndRemove)
+{
+  const size_t entryCount = GetParam();
+
+  FetcherProcess::Cache cache(Bytes(0));
+
+  vector<string> uris;
+  for (size_t i = 0; i < entryCount; i++) {
+    CommandInfo::URI uri;
+    uri.set_value("http://example.com/artifact" + stringify(i) + ".tgz");
+    uri.set_cache(true);
+
+    cache.create(sandbox.get(), None(), uri);
+    uris.push_back(uri.value());
+  }
+
+  Stopwatch watch;
+  watch.start();
+
+  // Refresh the entries from LRU to MRU, which leaves them in the
+  // same order afterwards.
+  foreach (const string& uri, uris) {
+    ASSERT_SOME(cache.get(None(), uri));
+  }
+
+  watch.stop();
+
+  cout << "Refreshed " << entryCount << " cache entries in "
+       << watch.elapsed() << endl;
+
+  watch.start();
+
+  foreach (const string& uri, uris) {
+    Option<std::shared_ptr<FetcherProcess::Cache::Entry>> entry =
+      cache.get(None(), uri);
+
+    ASSERT_SOME(entry);
+    ASSERT_SOME(cache.remove(entry.get()));
+  }
+
+  watch.stop();
+
+  cout << "Looked up and removed " << entryCount << " cache entries in "
+       << watch.elapsed() << endl;
+
+  EXPECT_EQ(0u, cache.size());
+}
+
+
+class FetcherCacheFetches_BENCHMARK_Test
+  : public MesosTest,
+    public WithParamInterface<size_t> {};
+
+
+// The value is the number of containers fetching at once.
+INSTANTIATE_TEST_CASE_P(
+    ContainerCount,
+    FetcherCacheFetches_BENCHMARK_Test,
+    ::testing::Values(10U, 100U, 1000U));
+
+
+// This benchmark measures how long it takes to fetch the same cached
+// artifact and a distinct uncached artifact into the sandboxes of many
+// containers at once. All of these fetches share a single download of
+// the cached artifact and are performed by long-lived fetcher workers.
+TEST_P(FetcherCacheFetches_BENCHMARK_Test, Concurrent)
+{
+  const size_t containerCount = GetParam();
+
+  const string assetsDirectory = path::join(sandbox.get(), "assets");
+  ASSERT_SOME(os::mkdir(assetsDirectory));
+
+  const string sharedAsset = path::join(assetsDirectory, "shared");
+  ASSERT_SOME(os::write(sharedAsset, string(Megabytes(1).bytes(), 'x')));
+
+  slave::Flags flags = CreateSlaveFlags();
+  flags.fetcher_cache_dir = path::join(sandbox.get(), "cache");
+
+  Fetcher fetcher(flags);
+
+  vector<Future<Nothing>> fetches;
+
+  Stopwatch watch;
+  watch.start();
+
+  for (size_t i = 0; i < containerCount; i++) {
+    const string asset = path::join(assetsDirectory, "own" + stringify(i));
+    ASSERT_SOME(os::write(asset, "data"));
+
+    const string directory =
+      path::join(sandbox.get(), "sandbox" + stringify(i));
+    ASSERT_SOME(os::mkdir(directory));
+
+    CommandInfo commandInfo;
+
+    CommandInfo::URI* uri = commandInfo.add_uris();
+    uri->set_value(sharedAsset);
+    uri->set_cache(true);
+
+    uri = commandInfo.add_uris();
+    uri->set_value(asset);
+
+    ContainerID containerId;
+    containerId.set_value("container" + stringify(i));
+
+    fetches.push_back(
+        fetcher.fetch(containerId, commandInfo, directory, None()));
+  }
+
+  AWAIT_READY_FOR(process::collect(fetches), Minutes(5));
+
+  watch.stop();
+
+  cout << "Fetched into " << containerCount << " sandboxes in "
+       << watch.elapsed() << endl;
+}
+
 } // namespace tests {
 } // namespace internal {
 } // namespace mesos {
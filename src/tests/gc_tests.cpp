@@ -40,6 +40,7 @@
 #include <process/process.hpp>
 #include <process/timeout.hpp>
 
+#include <stout/bytes.hpp>
 #include <stout/duration.hpp>
 #include <stout/gtest.hpp>
 #include <stout/nothing.hpp>
@@ -288,6 +289,78 @@ TEST_F(GarbageCollectorTest, Prune)
 }
 
 
+// This test verifies that the reclaim rate limit is shared by all the
+// workers, and that a removal waits for the limit before it starts.
+TEST_F(GarbageCollectorTest, ParallelRateLimited)
+{
+  GarbageCollector gc("work_dir", 2, Kilobytes(1));
+
+  // Make some temporary files to gc, large enough to occupy disk
+  // blocks on any file system.
+  const string& file1 = "file1";
+  const string& file2 = "file2";
+  const string& file3 = "file3";
+
+  const string data(Kilobytes(64).bytes(), 'x');
+
+  ASSERT_SOME(os::write(file1, data));
+  ASSERT_SOME(os::write(file2, data));
+  ASSERT_SOME(os::write(file3, data));
+
+  Clock::pause();
+
+  Future<Nothing> schedule1 = gc.schedule(Seconds(10), file1);
+  Future<Nothing> schedule2 = gc.schedule(Seconds(10), file2);
+  Future<Nothing> schedule3 = gc.schedule(Seconds(10), file3);
+
+  // Advance the clock to trigger the GC of all files. Only one of them
+  // is removed although two workers are idle, because the removal of
+  // the next file has to wait until the space reclaimed by the first
+  // one would have taken at the maximum rate.
+  Clock::advance(Seconds(10));
+  Clock::settle();
+
+  EXPECT_EQ(
+      2u,
+      (schedule1.isPending() ? 1u : 0u) +
+      (schedule2.isPending() ? 1u : 0u) +
+      (schedule3.isPending() ? 1u : 0u));
+
+  JSON::Object metrics = Metrics();
+
+  ASSERT_EQ(1u, metrics.values.count("gc/bytes_reclaimed"));
+  ASSERT_EQ(1u, metrics.values.count("gc/path_removals_active"));
+
+  EXPECT_SOME_EQ(
+      1u,
+      metrics.at<JSON::Number>("gc/path_removals_succeeded"));
+  // Both workers hold a file whose removal waits for the rate limit.
+  EXPECT_SOME_EQ(
+      2u,
+      metrics.at<JSON::Number>("gc/path_removals_active"));
+
+  Result<JSON::Number> reclaimed =
+    metrics.at<JSON::Number>("gc/bytes_reclaimed");
+
+  ASSERT_SOME(reclaimed);
+  EXPECT_LT(0u, reclaimed->as<uint64_t>());
+
+  // The remaining files are removed once the rate limit allows it.
+  Clock::advance(Minutes(5));
+  Clock::settle();
+
+  AWAIT_READY(schedule1);
+  AWAIT_READY(schedule2);
+  AWAIT_READY(schedule3);
+
+  EXPECT_FALSE(os::exists(file1));
+  EXPECT_FALSE(os::exists(file2));
+  EXPECT_FALSE(os::exists(file3));
+
+  Clock::resume();
+}
+
+
 class GarbageCollectorIntegrationTest : public MesosTest {};
 
 
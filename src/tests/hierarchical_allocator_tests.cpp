@@ -54,6 +54,7 @@
 #include "tests/resources_utils.hpp"
 #include "tests/utils.hpp"
 
+using mesos::internal::master::FULL_ALLOCATION_INTERVAL;
 using mesos::internal::master::MIN_CPUS;
 using mesos::internal::master::MIN_MEM;
 
@@ -2058,6 +2059,176 @@ TEST_F(HierarchicalAllocatorTest, RecoverResources)
 }
 
 
+// This test ensures that resources refused on one agent are offered
+// again once the refuse filter expires, when the periodic allocation
+// only considers the agents which changed since the last allocation.
+TEST_F(HierarchicalAllocatorTest, OfferFilterExpiresOnChangedAgent)
+{
+  Clock::pause();
+
+  const string ROLE{"role"};
+
+  initialize();
+
+  // All batch allocations below happen before the next allocation
+  // which considers all agents.
+  ASSERT_LT(flags.allocation_interval * 3, FULL_ALLOCATION_INTERVAL);
+
+  FrameworkInfo framework = createFrameworkInfo({ROLE});
+  allocator->addFramework(framework.id(), framework, {}, true, {});
+
+  SlaveInfo agent1 = createSlaveInfo("cpus:1;mem:512;disk:0");
+  allocator->addSlave(
+      agent1.id(),
+      agent1,
+      AGENT_CAPABILITIES(),
+      None(),
+      agent1.resources(),
+      {});
+
+  Allocation expected = Allocation(
+      framework.id(),
+      {{ROLE, {{agent1.id(), agent1.resources()}}}});
+
+  Future<Allocation> allocation = allocations.get();
+  AWAIT_EXPECT_EQ(expected, allocation);
+
+  const Resources allocated1 = allocation->resources.at(ROLE).at(agent1.id());
+
+  SlaveInfo agent2 = createSlaveInfo("cpus:1;mem:512;disk:0");
+  allocator->addSlave(
+      agent2.id(),
+      agent2,
+      AGENT_CAPABILITIES(),
+      None(),
+      agent2.resources(),
+      {});
+
+  expected = Allocation(
+      framework.id(),
+      {{ROLE, {{agent2.id(), agent2.resources()}}}});
+
+  allocation = allocations.get();
+  AWAIT_EXPECT_EQ(expected, allocation);
+
+  // `framework` declines the resources on `agent1` with a filter
+  // which outlasts the next batch allocation, and keeps `agent2`.
+  Duration filterTimeout = flags.allocation_interval * 2;
+
+  Filters offerFilter;
+  offerFilter.set_refuse_seconds(filterTimeout.secs());
+
+  allocator->recoverResources(
+      framework.id(),
+      agent1.id(),
+      allocated1,
+      offerFilter);
+
+  // Ensure the offer filter timeout is set before advancing the clock.
+  Clock::settle();
+
+  // The next batch allocation only considers `agent1`, whose
+  // resources are filtered.
+  Clock::advance(flags.allocation_interval);
+  Clock::settle();
+
+  allocation = allocations.get();
+  EXPECT_TRUE(allocation.isPending());
+
+  // The offer filter expires, which makes the next batch allocation
+  // consider `agent1` again.
+  Clock::advance(flags.allocation_interval);
+  Clock::settle();
+
+  expected = Allocation(
+      framework.id(),
+      {{ROLE, {{agent1.id(), agent1.resources()}}}});
+
+  AWAIT_EXPECT_EQ(expected, allocation);
+}
+
+
+// This test ensures that resources recovered on an agent which did
+// not change since the last allocation are offered again by the next
+// periodic allocation.
+TEST_F(HierarchicalAllocatorTest, RecoverResourcesOnUnchangedAgent)
+{
+  Clock::pause();
+
+  const string ROLE{"role"};
+
+  initialize();
+
+  // All batch allocations below happen before the next allocation
+  // which considers all agents.
+  ASSERT_LT(flags.allocation_interval * 3, FULL_ALLOCATION_INTERVAL);
+
+  FrameworkInfo framework = createFrameworkInfo({ROLE});
+  allocator->addFramework(framework.id(), framework, {}, true, {});
+
+  SlaveInfo agent1 = createSlaveInfo("cpus:1;mem:512;disk:0");
+  allocator->addSlave(
+      agent1.id(),
+      agent1,
+      AGENT_CAPABILITIES(),
+      None(),
+      agent1.resources(),
+      {});
+
+  Allocation expected = Allocation(
+      framework.id(),
+      {{ROLE, {{agent1.id(), agent1.resources()}}}});
+
+  Future<Allocation> allocation = allocations.get();
+  AWAIT_EXPECT_EQ(expected, allocation);
+
+  SlaveInfo agent2 = createSlaveInfo("cpus:1;mem:512;disk:0");
+  allocator->addSlave(
+      agent2.id(),
+      agent2,
+      AGENT_CAPABILITIES(),
+      None(),
+      agent2.resources(),
+      {});
+
+  expected = Allocation(
+      framework.id(),
+      {{ROLE, {{agent2.id(), agent2.resources()}}}});
+
+  allocation = allocations.get();
+  AWAIT_EXPECT_EQ(expected, allocation);
+
+  const Resources allocated2 = allocation->resources.at(ROLE).at(agent2.id());
+
+  // Nothing changes on either agent, so the batch allocations
+  // do not offer anything.
+  Clock::advance(flags.allocation_interval);
+  Clock::settle();
+
+  Clock::advance(flags.allocation_interval);
+  Clock::settle();
+
+  allocation = allocations.get();
+  EXPECT_TRUE(allocation.isPending());
+
+  // `framework` declines the resources on `agent2` without a filter.
+  allocator->recoverResources(
+      framework.id(),
+      agent2.id(),
+      allocated2,
+      None());
+
+  Clock::advance(flags.allocation_interval);
+  Clock::settle();
+
+  expected = Allocation(
+      framework.id(),
+      {{ROLE, {{agent2.id(), agent2.resources()}}}});
+
+  AWAIT_EXPECT_EQ(expected, allocation);
+}
+
+
 // Checks that resource provider resources can be added to an agent
 // and that the added used resources are correctly taken into account
 // when computing fair share.
@@ -6575,6 +6746,279 @@ TEST_P(HierarchicalAllocator_BENCHMARK_Test, AddAndUpdateSlave)
 }
 
 
+// This benchmark measures how long the allocator takes to handle the
+// `recoverResources()` calls made when all tasks in the cluster
+// terminate at once, e.g., when the frameworks are torn down.
+TEST_P(HierarchicalAllocator_BENCHMARK_Test, RecoverResources)
+{
+  size_t slaveCount = std::get<0>(GetParam());
+  size_t frameworkCount = std::get<1>(GetParam());
+
+  // Number of tasks running on each agent.
+  const size_t taskCount = 16;
+
+  cout << "Using " << slaveCount << " agents"
+       << " and " << frameworkCount << " frameworks" << endl;
+
+  Clock::pause();
+
+  auto offerCallback = [](
+      const FrameworkID& frameworkId,
+      const hashmap<string, hashmap<SlaveID, Resources>>& resources) {};
+
+  initialize(master::Flags(), offerCallback);
+
+  vector<FrameworkInfo> frameworks;
+  frameworks.reserve(frameworkCount);
+
+  for (size_t i = 0; i < frameworkCount; i++) {
+    frameworks.push_back(createFrameworkInfo({"*"}));
+    allocator->addFramework(frameworks[i].id(), frameworks[i], {}, true, {});
+  }
+
+  const Resources agentResources =
+    Resources::parse("cpus:24;mem:4096;disk:4096").get();
+
+  const Resources task =
+    allocatedResources(Resources::parse("cpus:1;mem:128").get(), "*");
+
+  Resources allocation;
+  for (size_t i = 0; i < taskCount; i++) {
+    allocation += task;
+  }
+
+  vector<SlaveInfo> slaves;
+  slaves.reserve(slaveCount);
+
+  // Each agent runs the tasks of a single framework. We round-robin
+  // through the frameworks when adding the agents.
+  for (size_t i = 0; i < slaveCount; i++) {
+    slaves.push_back(createSlaveInfo(agentResources));
+
+    hashmap<FrameworkID, Resources> used = {
+      {frameworks[i % frameworkCount].id(), allocation}
+    };
+
+    allocator->addSlave(
+        slaves[i].id(),
+        slaves[i],
+        AGENT_CAPABILITIES(),
+        None(),
+        slaves[i].resources(),
+        used);
+  }
+
+  // Wait for all the `addSlave` operations to be processed.
+  Clock::settle();
+
+  Stopwatch watch;
+  watch.start();
+
+  for (size_t i = 0; i < slaveCount; i++) {
+    for (size_t j = 0; j < taskCount; j++) {
+      allocator->recoverResources(
+          frameworks[i % frameworkCount].id(),
+          slaves[i].id(),
+          task,
+          None());
+    }
+  }
+
+  // Wait for all the `recoverResources` operations to be processed.
+  Clock::settle();
+
+  watch.stop();
+
+  cout << "Recovered the resources of " << slaveCount * taskCount
+       << " tasks in " << watch.elapsed() << endl;
+
+  Clock::resume();
+}
+
+
+// This benchmark measures the cost of the periodic allocation cycle
+// depending on the number of agents whose allocation has changed
+// since the last cycle. In each round, the resources offered on a
+// fraction of the agents are declined, and the allocation cycle is
+// expected to take time proportional to that fraction.
+TEST_P(HierarchicalAllocator_BENCHMARK_Test, PeriodicAllocation)
+{
+  size_t slaveCount = std::get<0>(GetParam());
+  size_t frameworkCount = std::get<1>(GetParam());
+
+  // Pause the clock because we want to manually drive the allocations.
+  Clock::pause();
+
+  struct OfferedResources
+  {
+    FrameworkID   frameworkId;
+    SlaveID       slaveId;
+    Resources     resources;
+  };
+
+  vector<OfferedResources> offers;
+
+  auto offerCallback = [&offers](
+      const FrameworkID& frameworkId,
+      const hashmap<string, hashmap<SlaveID, Resources>>& resources_)
+  {
+    foreachkey (const string& role, resources_) {
+      foreachpair (const SlaveID& slaveId,
+                   const Resources& resources,
+                   resources_.at(role)) {
+        offers.push_back(OfferedResources{frameworkId, slaveId, resources});
+      }
+    }
+  };
+
+  cout << "Using " << slaveCount << " agents and "
+       << frameworkCount << " frameworks" << endl;
+
+  initialize(master::Flags(), offerCallback);
+
+  for (size_t i = 0; i < frameworkCount; i++) {
+    FrameworkInfo framework = createFrameworkInfo({"*"});
+    allocator->addFramework(framework.id(), framework, {}, true, {});
+  }
+
+  const Resources agentResources =
+    Resources::parse("cpus:24;mem:4096;disk:4096").get();
+
+  for (size_t i = 0; i < slaveCount; i++) {
+    SlaveInfo slave = createSlaveInfo(agentResources);
+
+    allocator->addSlave(
+        slave.id(),
+        slave,
+        AGENT_CAPABILITIES(),
+        None(),
+        slave.resources(),
+        {});
+  }
+
+  // Wait for all the resources to be offered.
+  Clock::settle();
+
+  // Percentages of the outstanding offers declined in each round.
+  foreach (size_t percentage, vector<size_t>({0, 1, 10, 50, 100})) {
+    size_t declined = offers.size() * percentage / 100;
+
+    foreach (const OfferedResources& offer,
+             vector<OfferedResources>(offers.begin(),
+                                      offers.begin() + declined)) {
+      allocator->recoverResources(
+          offer.frameworkId, offer.slaveId, offer.resources, None());
+    }
+
+    offers.erase(offers.begin(), offers.begin() + declined);
+
+    // Wait for the declined offers.
+    Clock::settle();
+
+    size_t offerCount = offers.size();
+
+    Stopwatch watch;
+    watch.start();
+
+    // Advance the clock and trigger a periodic allocation cycle.
+    Clock::advance(flags.allocation_interval);
+    Clock::settle();
+
+    watch.stop();
+
+    cout << "allocate() took " << watch.elapsed()
+         << " to make " << offers.size() - offerCount << " offers"
+         << " after " << percentage << "% of the offers were declined"
+         << endl;
+  }
+
+  Clock::resume();
+}
+
+
+// This benchmark measures an allocation over all agents in a cluster
+// with agents of different shapes, some of them with GPUs, where most
+// of the agents are fully allocated. None of the frameworks is
+// capable of receiving GPU resources.
+TEST_P(HierarchicalAllocator_BENCHMARK_Test, HeterogeneousAgents)
+{
+  size_t slaveCount = std::get<0>(GetParam());
+  size_t frameworkCount = std::get<1>(GetParam());
+
+  // Pause the clock because we want to manually drive the allocations.
+  Clock::pause();
+
+  size_t offerCount = 0;
+
+  auto offerCallback = [&offerCount](
+      const FrameworkID& frameworkId,
+      const hashmap<string, hashmap<SlaveID, Resources>>& resources) {
+    foreachvalue (const auto& offers, resources) {
+      offerCount += offers.size();
+    }
+  };
+
+  cout << "Using " << slaveCount << " agents and "
+       << frameworkCount << " frameworks" << endl;
+
+  initialize(master::Flags(), offerCallback);
+
+  vector<FrameworkInfo> frameworks;
+  frameworks.reserve(frameworkCount);
+
+  for (size_t i = 0; i < frameworkCount; i++) {
+    frameworks.push_back(createFrameworkInfo({"*"}));
+    allocator->addFramework(frameworks[i].id(), frameworks[i], {}, true, {});
+  }
+
+  const vector<Resources> shapes = {
+    Resources::parse("cpus:8;mem:16384;disk:65536").get(),
+    Resources::parse("cpus:16;mem:65536;disk:131072").get(),
+    Resources::parse("cpus:32;mem:131072;disk:262144").get(),
+    Resources::parse("cpus:64;mem:262144;disk:1048576;gpus:4").get(),
+  };
+
+  for (size_t i = 0; i < slaveCount; i++) {
+    SlaveInfo slave = createSlaveInfo(shapes[i % shapes.size()]);
+
+    // All but every tenth agent of each shape are fully allocated.
+    hashmap<FrameworkID, Resources> used;
+    if ((i / shapes.size()) % 10 != 0) {
+      used[frameworks[i % frameworkCount].id()] =
+        allocatedResources(slave.resources(), "*");
+    }
+
+    allocator->addSlave(
+        slave.id(),
+        slave,
+        AGENT_CAPABILITIES(),
+        None(),
+        slave.resources(),
+        used);
+  }
+
+  // Wait for all the `addSlave` operations to be processed.
+  Clock::settle();
+
+  offerCount = 0;
+
+  Stopwatch watch;
+  watch.start();
+
+  // Reviving offers triggers an allocation over all agents.
+  allocator->reviveOffers(frameworks[0].id(), {});
+
+  Clock::settle();
+
+  watch.stop();
+
+  cout << "allocate() took " << watch.elapsed()
+       << " to make " << offerCount << " offers" << endl;
+
+  Clock::resume();
+}
+
+
 // This benchmark simulates a number of frameworks that have a fixed amount of
 // work to do. Once they have reached their targets, they start declining all
 // subsequent offers.
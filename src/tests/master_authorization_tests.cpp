@@ -426,7 +426,7 @@ TEST_F(MasterAuthorizationTest, KillTask)
   EXPECT_EQ(TaskStatus::REASON_TASK_KILLED_DURING_LAUNCH, status->reason());
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   // Now complete authorization.
   promise.set(true);
@@ -551,7 +551,7 @@ TEST_F(MasterAuthorizationTest, KillPendingTaskInTaskGroup)
             task1Status->reason());
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   // Now complete authorizations for task1 and task2.
   promise1.set(true);
@@ -647,7 +647,7 @@ TEST_F(MasterAuthorizationTest, SlaveRemovedLost)
     .WillOnce(FutureArg<1>(&status));
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   // Now complete authorization.
   promise.set(true);
@@ -752,7 +752,7 @@ TEST_F(MasterAuthorizationTest, SlaveRemovedDropped)
     .WillOnce(FutureArg<1>(&status));
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   // Now complete authorization.
   promise.set(true);
@@ -847,7 +847,7 @@ TEST_F(MasterAuthorizationTest, FrameworkRemoved)
   AWAIT_READY(removeFramework);
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   // Now complete authorization.
   promise.set(true);
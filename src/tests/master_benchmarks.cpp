@@ -15,6 +15,7 @@
 // limitations under the License.
 
 #include <atomic>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <string>
@@ -24,6 +25,8 @@
 #include <mesos/resources.hpp>
 #include <mesos/version.hpp>
 
+#include <mesos/v1/scheduler.hpp>
+
 #include <process/async.hpp>
 #include <process/clock.hpp>
 #include <process/collect.hpp>
@@ -34,10 +37,16 @@
 #include <process/protobuf.hpp>
 #include <process/statistics.hpp>
 
+#include <stout/bytes.hpp>
 #include <stout/duration.hpp>
+#include <stout/lambda.hpp>
+#include <stout/os.hpp>
+#include <stout/recordio.hpp>
 #include <stout/stopwatch.hpp>
 
+#include "common/http.hpp"
 #include "common/protobuf_utils.hpp"
+#include "common/recordio.hpp"
 
 #include "tests/mesos.hpp"
 
@@ -285,11 +294,14 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Values(
         make_tuple(2000, 5, 10, 5, 10),
         make_tuple(2000, 5, 20, 0, 0),
-        make_tuple(20000, 1, 5, 0, 0)));
+        make_tuple(20000, 1, 5, 0, 0),
+        make_tuple(50000, 1, 20, 0, 0)));
 
 
 // This test measures the time from all agents start to reregister to
-// to when all have received `SlaveReregisteredMessage`.
+// to when all have received `SlaveReregisteredMessage`. The largest
+// case (50k agents running 1M tasks) is expected to complete within
+// two minutes.
 TEST_P(MasterFailover_BENCHMARK_Test, AgentReregistrationDelay)
 {
   size_t agentCount;
@@ -395,6 +407,34 @@ TEST_P(MasterStateQuery_BENCHMARK_Test, GetState)
   master::Flags masterFlags = CreateMasterFlags();
   masterFlags.authenticate_agents = false;
 
+  // Authorize the principal to view the state through ACLs, so that the
+  // object approvers of the principal are used (and reused across the
+  // requests) as in a production setup.
+  {
+    mesos::ACL::ViewFramework* acl =
+      masterFlags.acls->add_view_frameworks();
+    acl->mutable_principals()->add_values(DEFAULT_CREDENTIAL.principal());
+    acl->mutable_users()->set_type(mesos::ACL::Entity::ANY);
+  }
+
+  {
+    mesos::ACL::ViewTask* acl = masterFlags.acls->add_view_tasks();
+    acl->mutable_principals()->add_values(DEFAULT_CREDENTIAL.principal());
+    acl->mutable_users()->set_type(mesos::ACL::Entity::ANY);
+  }
+
+  {
+    mesos::ACL::ViewExecutor* acl = masterFlags.acls->add_view_executors();
+    acl->mutable_principals()->add_values(DEFAULT_CREDENTIAL.principal());
+    acl->mutable_users()->set_type(mesos::ACL::Entity::ANY);
+  }
+
+  {
+    mesos::ACL::ViewRole* acl = masterFlags.acls->add_view_roles();
+    acl->mutable_principals()->add_values(DEFAULT_CREDENTIAL.principal());
+    acl->mutable_roles()->set_type(mesos::ACL::Entity::ANY);
+  }
+
   Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
   ASSERT_SOME(master);
 
@@ -434,22 +474,29 @@ TEST_P(MasterStateQuery_BENCHMARK_Test, GetState)
   Clock::resume();
 
   Stopwatch watch;
-  watch.start();
 
   // We first measure v0 "state" endpoint performance as the baseline.
-  Future<http::Response> v0Response = http::get(
-      master.get()->pid,
-      "state",
-      None(),
-      createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+  // The second request reuses the object approvers cached by the first.
+  const string v0Requests[] = {"first", "second"};
 
-  v0Response.await();
+  foreach (const string& v0Request, v0Requests) {
+    watch.start();
 
-  watch.stop();
+    Future<http::Response> v0Response = http::get(
+        master.get()->pid,
+        "state",
+        None(),
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL));
 
-  ASSERT_EQ(v0Response->status, http::OK().status);
+    v0Response.await();
+
+    watch.stop();
+
+    ASSERT_EQ(v0Response->status, http::OK().status);
 
-  cout << "v0 '/state' response took " << watch.elapsed() << endl;
+    cout << "v0 '/state' response (" << v0Request << " request) took "
+         << watch.elapsed() << endl;
+  }
 
   // Helper function to post a request to '/api/v1' master endpoint
   // and return the response.
@@ -500,6 +547,493 @@ TEST_P(MasterStateQuery_BENCHMARK_Test, GetState)
 }
 
 
+// This test measures the size of and the latency of the responses to
+// filtered `master::call::GetTasks` v1 api calls, compared to
+// unfiltered calls. The master state is set up from artificial agents
+// as in the test above.
+TEST_P(MasterStateQuery_BENCHMARK_Test, GetTasksFiltered)
+{
+  size_t agentCount;
+  size_t frameworksPerAgent;
+  size_t tasksPerFramework;
+  size_t completedFrameworksPerAgent;
+  size_t tasksPerCompletedFramework;
+
+  tie(agentCount,
+    frameworksPerAgent,
+    tasksPerFramework,
+    completedFrameworksPerAgent,
+    tasksPerCompletedFramework) = GetParam();
+
+  // Disable authentication to avoid the overhead, since we don't care about
+  // it in this test.
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.authenticate_agents = false;
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  vector<Owned<TestSlave>> slaves;
+
+  for (size_t i = 0; i < agentCount; i++) {
+    SlaveID slaveId;
+    slaveId.set_value("agent" + stringify(i));
+
+    slaves.push_back(Owned<TestSlave>(new TestSlave(
+        master.get()->pid,
+        slaveId,
+        frameworksPerAgent,
+        tasksPerFramework,
+        completedFrameworksPerAgent,
+        tasksPerCompletedFramework)));
+  }
+
+  cout << "Test setup: "
+       << agentCount << " agents with a total of "
+       << frameworksPerAgent * tasksPerFramework * agentCount
+       << " running tasks and "
+       << completedFrameworksPerAgent * tasksPerCompletedFramework * agentCount
+       << " completed tasks" << endl;
+
+  vector<Future<Nothing>> reregistered;
+
+  foreach (const Owned<TestSlave>& slave, slaves) {
+    reregistered.push_back(slave->reregister());
+  }
+
+  // Wait all agents to finish reregistration.
+  await(reregistered).await();
+
+  Clock::pause();
+  Clock::settle();
+  Clock::resume();
+
+  // The queries to measure, named for the output.
+  vector<tuple<string, v1::master::Call::GetTasks>> queries;
+
+  queries.push_back(make_tuple("unfiltered", v1::master::Call::GetTasks()));
+
+  {
+    v1::master::Call::GetTasks query;
+    query.add_framework_ids()->set_value("framework0");
+    queries.push_back(make_tuple("one framework", query));
+  }
+
+  {
+    v1::master::Call::GetTasks query;
+    query.add_agent_ids()->set_value("agent0");
+    queries.push_back(make_tuple("one agent", query));
+  }
+
+  {
+    v1::master::Call::GetTasks query;
+    query.set_offset(agentCount);
+    query.set_limit(100);
+    queries.push_back(make_tuple("100 tasks page", query));
+  }
+
+  {
+    v1::master::Call::GetTasks query;
+    query.add_fields("state");
+    queries.push_back(make_tuple("required fields", query));
+  }
+
+  const ContentType contentTypes[] =
+    { ContentType::PROTOBUF, ContentType::JSON };
+
+  for (ContentType contentType : contentTypes) {
+    foreach (const auto& query, queries) {
+      v1::master::Call v1Call;
+      v1Call.set_type(v1::master::Call::GET_TASKS);
+      *v1Call.mutable_get_tasks() = std::get<1>(query);
+
+      http::Headers headers = createBasicAuthHeaders(DEFAULT_CREDENTIAL);
+      headers["Accept"] = stringify(contentType);
+
+      Stopwatch watch;
+      watch.start();
+
+      Future<http::Response> response = http::post(
+          master.get()->pid,
+          "api/v1",
+          headers,
+          serialize(contentType, v1Call),
+          stringify(contentType));
+
+      response.await();
+
+      watch.stop();
+
+      ASSERT_EQ(response->status, http::OK().status);
+
+      cout << "v1 'master::call::GetTasks' (" << std::get<0>(query) << ") "
+           << contentType << " response of " << Bytes(response->body.size())
+           << " took " << watch.elapsed() << endl;
+    }
+  }
+}
+
+
+class MasterCompletedTasks_BENCHMARK_Test
+  : public MesosTest,
+    public WithParamInterface<tuple<size_t, size_t, size_t, bool>> {};
+
+
+// The value tuples are defined as:
+// - agentCount
+// - frameworksPerAgent
+// - tasksPerFramework (per agent)
+// - compress_completed_tasks
+INSTANTIATE_TEST_CASE_P(
+    AgentFrameworkTaskCountCompression,
+    MasterCompletedTasks_BENCHMARK_Test,
+    ::testing::Values(
+        make_tuple(1000, 5, 20, false),
+        make_tuple(1000, 5, 20, true),
+        make_tuple(5000, 5, 20, false),
+        make_tuple(5000, 5, 20, true)));
+
+
+// This test measures the memory used by the master to keep the history
+// of completed frameworks and tasks, and the latency of the v0 '/state'
+// endpoint which has to decode that history. The frameworks recovered
+// from artificial agents are torn down, which moves all of their tasks
+// into the completed tasks of the completed frameworks.
+//
+// NOTE: The memory is measured as the growth of the resident set size
+// of the test process, which includes the master, the artificial
+// agents and memory which was freed but not returned to the system.
+// The numbers are therefore only meaningful relative to each other.
+TEST_P(MasterCompletedTasks_BENCHMARK_Test, Memory)
+{
+  size_t agentCount;
+  size_t frameworksPerAgent;
+  size_t tasksPerFramework;
+  bool compress;
+
+  tie(agentCount, frameworksPerAgent, tasksPerFramework, compress) =
+    GetParam();
+
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.authenticate_agents = false;
+  masterFlags.compress_completed_tasks = compress;
+
+  // Keep all of the tasks of the torn down frameworks.
+  masterFlags.max_completed_frameworks = frameworksPerAgent;
+  masterFlags.max_completed_tasks_per_framework =
+    agentCount * tasksPerFramework;
+
+  auto rss = []() -> Bytes {
+    Result<os::Process> process = os::process(::getpid());
+    CHECK_SOME(process);
+    CHECK_SOME(process->rss);
+    return process->rss.get();
+  };
+
+  const Bytes initial = rss();
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  vector<Owned<TestSlave>> slaves;
+
+  for (size_t i = 0; i < agentCount; i++) {
+    SlaveID slaveId;
+    slaveId.set_value("agent" + stringify(i));
+
+    slaves.push_back(Owned<TestSlave>(new TestSlave(
+        master.get()->pid,
+        slaveId,
+        frameworksPerAgent,
+        tasksPerFramework,
+        0,
+        0)));
+  }
+
+  cout << "Test setup: "
+       << agentCount << " agents with a total of "
+       << frameworksPerAgent * tasksPerFramework * agentCount
+       << " tasks in " << frameworksPerAgent << " frameworks, "
+       << (compress ? "compressed" : "uncompressed") << endl;
+
+  vector<Future<Nothing>> reregistered;
+
+  foreach (const Owned<TestSlave>& slave, slaves) {
+    reregistered.push_back(slave->reregister());
+  }
+
+  await(reregistered).await();
+
+  const Bytes running = rss();
+
+  // Tear down all of the frameworks. The framework IDs are generated
+  // by the artificial agents in the same way for every agent.
+  for (size_t i = 0; i < frameworksPerAgent; i++) {
+    Future<http::Response> response = http::post(
+        master.get()->pid,
+        "teardown",
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL),
+        "frameworkId=framework" + stringify(i));
+
+    response.await();
+
+    ASSERT_EQ(response->status, http::OK().status);
+  }
+
+  Clock::pause();
+  Clock::settle();
+  Clock::resume();
+
+  const Bytes completed = rss();
+
+  cout << "Master RSS grew by " << running - initial
+       << " with running tasks and by " << completed - initial
+       << " with completed tasks" << endl;
+
+  Stopwatch watch;
+  watch.start();
+
+  Future<http::Response> response = http::get(
+      master.get()->pid,
+      "state",
+      None(),
+      createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+  response.await();
+
+  watch.stop();
+
+  ASSERT_EQ(response->status, http::OK().status);
+
+  cout << "v0 '/state' response took " << watch.elapsed()
+       << " for " << Bytes(response->body.size()) << endl;
+}
+
+
+class MasterOffers_BENCHMARK_Test
+  : public MesosTest,
+    public WithParamInterface<size_t> {};
+
+
+INSTANTIATE_TEST_CASE_P(
+    AgentCount,
+    MasterOffers_BENCHMARK_Test,
+    ::testing::Values(1000U, 10000U, 40000U));
+
+
+// This test measures the throughput of offers sent by the master to an
+// HTTP scheduler. The scheduler subscribes after all artificial agents
+// have reregistered, so that the resources of every agent are offered
+// to it in a single allocation.
+TEST_P(MasterOffers_BENCHMARK_Test, OfferThroughput)
+{
+  const size_t agentCount = GetParam();
+
+  // Disable authentication to avoid the overhead, since we don't care about
+  // it in this test.
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.authenticate_agents = false;
+  masterFlags.authenticate_http_frameworks = false;
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  vector<Owned<TestSlave>> slaves;
+
+  for (size_t i = 0; i < agentCount; i++) {
+    SlaveID slaveId;
+    slaveId.set_value("agent" + stringify(i));
+
+    slaves.push_back(Owned<TestSlave>(new TestSlave(
+        master.get()->pid,
+        slaveId,
+        0,
+        0,
+        0,
+        0)));
+  }
+
+  cout << "Test setup: " << agentCount << " agents" << endl;
+
+  vector<Future<Nothing>> reregistered;
+
+  foreach (const Owned<TestSlave>& slave, slaves) {
+    reregistered.push_back(slave->reregister());
+  }
+
+  // Wait all agents to finish reregistration.
+  await(reregistered).await();
+
+  Clock::pause();
+  Clock::settle();
+  Clock::resume();
+
+  v1::scheduler::Call subscribe;
+  subscribe.set_type(v1::scheduler::Call::SUBSCRIBE);
+  subscribe.mutable_subscribe()->mutable_framework_info()->CopyFrom(
+      v1::DEFAULT_FRAMEWORK_INFO);
+
+  http::Headers headers;
+  headers["Accept"] = APPLICATION_PROTOBUF;
+
+  // Measure the time from the subscription to when the scheduler has
+  // received the offers for all agents.
+  Stopwatch watch;
+  watch.start();
+
+  Future<http::Response> subscribed = http::streaming::post(
+      master.get()->pid,
+      "api/v1/scheduler",
+      headers,
+      subscribe.SerializeAsString(),
+      APPLICATION_PROTOBUF);
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, subscribed);
+  ASSERT_EQ(http::Response::PIPE, subscribed->type);
+  ASSERT_SOME(subscribed->reader);
+
+  recordio::Reader<v1::scheduler::Event> events(
+      ::recordio::Decoder<v1::scheduler::Event>(
+          lambda::bind(
+              deserialize<v1::scheduler::Event>,
+              ContentType::PROTOBUF,
+              lambda::_1)),
+      subscribed->reader.get());
+
+  size_t offerCount = 0;
+  size_t offerEvents = 0;
+
+  while (offerCount < agentCount) {
+    Future<Result<v1::scheduler::Event>> event = events.read();
+    AWAIT_READY_FOR(event, Minutes(5));
+    ASSERT_SOME(event.get());
+
+    if (event->get().type() == v1::scheduler::Event::OFFERS) {
+      offerCount += event->get().offers().offers_size();
+      offerEvents++;
+    }
+  }
+
+  watch.stop();
+
+  cout << "Received " << offerCount << " offers in " << offerEvents
+       << " events in " << watch.elapsed() << " ("
+       << offerCount / watch.elapsed().secs() << " offers/sec)" << endl;
+}
+
+
+class MasterAccept_BENCHMARK_Test
+  : public MesosTest,
+    public WithParamInterface<tuple<size_t, bool>> {};
+
+
+// The value tuples are defined as:
+// - taskCount
+// - whether the tasks are launched as a task group
+INSTANTIATE_TEST_CASE_P(
+    TaskCountTaskGroup,
+    MasterAccept_BENCHMARK_Test,
+    ::testing::Values(
+        make_tuple(100U, false),
+        make_tuple(100U, true),
+        make_tuple(1000U, false),
+        make_tuple(1000U, true),
+        make_tuple(5000U, false),
+        make_tuple(5000U, true)));
+
+
+// This test measures the time it takes the master to process an
+// `ACCEPT` call launching a large number of tasks on an artificial
+// agent, i.e. to authorize and validate the tasks and to send them to
+// the agent.
+TEST_P(MasterAccept_BENCHMARK_Test, LaunchTasks)
+{
+  size_t taskCount;
+  bool taskGroup;
+
+  tie(taskCount, taskGroup) = GetParam();
+
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.authenticate_agents = false;
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  SlaveID slaveId;
+  slaveId.set_value("agent");
+
+  TestSlave slave(master.get()->pid, slaveId, 0, 0, 0, 0);
+
+  AWAIT_READY(slave.reregister());
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  EXPECT_CALL(sched, registered(&driver, _, _));
+
+  Future<vector<Offer>> offers;
+  EXPECT_CALL(sched, resourceOffers(&driver, _))
+    .WillOnce(FutureArg<1>(&offers))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  EXPECT_CALL(sched, statusUpdate(&driver, _))
+    .WillRepeatedly(Return());
+
+  driver.start();
+
+  AWAIT_READY(offers);
+  ASSERT_FALSE(offers->empty());
+
+  const Offer& offer = offers->front();
+
+  // Using a static local variable to avoid the cost of re-parsing.
+  static const Resources resources = Resources::parse("cpus:0.001;mem:1").get();
+
+  vector<TaskInfo> tasks;
+  for (size_t i = 0; i < taskCount; i++) {
+    tasks.push_back(createTask(offer.slave_id(), resources, "sleep 1000"));
+  }
+
+  Offer::Operation operation;
+  if (taskGroup) {
+    ExecutorInfo executor = createExecutorInfo(
+        "default",
+        None(),
+        "cpus:0.1;mem:32",
+        ExecutorInfo::DEFAULT,
+        offer.framework_id());
+
+    foreach (TaskInfo& task, tasks) {
+      task.mutable_executor()->CopyFrom(executor);
+    }
+
+    operation = LAUNCH_GROUP(executor, createTaskGroupInfo(tasks));
+  } else {
+    operation = LAUNCH(tasks);
+  }
+
+  // Measure the time until the master has processed the `ACCEPT` call.
+  Stopwatch watch;
+  watch.start();
+
+  driver.acceptOffers({offer.id()}, {operation});
+
+  Clock::pause();
+  Clock::settle();
+  Clock::resume();
+
+  watch.stop();
+
+  cout << "Processed ACCEPT call launching " << taskCount << " tasks"
+       << (taskGroup ? " in a task group" : "")
+       << " in " << watch.elapsed() << endl;
+
+  driver.stop();
+  driver.join();
+}
+
+
 class MasterActorResponsiveness_BENCHMARK_Test
   : public MesosTest,
     public WithParamInterface<tuple<
@@ -519,11 +1053,6 @@ INSTANTIATE_TEST_CASE_P(
 // is taken as a load indicator. We set up a lot of master state from artificial
 // agents and send multiple '/state' queries while constantly probing '/health'.
 // As the baseline only '/health' is queried.
-//
-// NOTE: This test can dead lock if the number of libprocess worker threads is
-// insufficient. We observed deadlocks when
-// `(numClients >= LIBPROCESS_NUM_WORKER_THREADS - 3)`. Once MESOS-9400 is
-// fixed, we can add an assertion here.
 TEST_P(MasterActorResponsiveness_BENCHMARK_Test, WithV0StateLoad)
 {
   size_t agentCount;
@@ -713,6 +1242,323 @@ TEST_P(MasterActorResponsiveness_BENCHMARK_Test, WithV0StateLoad)
 }
 
 
+// This test measures the latency of scheduler calls while the master
+// serves '/state' requests. A v1 HTTP scheduler subscribes to a master
+// with a lot of artificial agent state and then sends `RECONCILE`
+// calls, first on their own as the baseline and then while several
+// clients are querying '/state' in the background, and finally while
+// agents are reregistering. The scheduler calls are processed on the
+// master actor, so their latency shows how much rendering the state
+// responses or reregistering the agents holds up the master.
+TEST_P(MasterActorResponsiveness_BENCHMARK_Test, SchedulerCallsWithV0StateLoad)
+{
+  size_t agentCount;
+  size_t frameworksPerAgent;
+  size_t tasksPerFramework;
+  size_t completedFrameworksPerAgent;
+  size_t tasksPerCompletedFramework;
+  size_t numRequests;
+  size_t numClients;
+
+  tie(agentCount,
+    frameworksPerAgent,
+    tasksPerFramework,
+    completedFrameworksPerAgent,
+    tasksPerCompletedFramework,
+    numRequests,
+    numClients) = GetParam();
+
+  const string schedulerEndpoint = "api/v1/scheduler";
+  const string stateEndpoint = "state";
+
+  // Disable authentication to avoid the overhead, since we don't care about
+  // it in this test.
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.authenticate_agents = false;
+  masterFlags.authenticate_http_frameworks = false;
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  vector<Owned<TestSlave>> slaves;
+
+  for (size_t i = 0; i < agentCount; i++) {
+    SlaveID slaveId;
+    slaveId.set_value("agent" + stringify(i));
+
+    slaves.push_back(Owned<TestSlave>(new TestSlave(
+        master.get()->pid,
+        slaveId,
+        frameworksPerAgent,
+        tasksPerFramework,
+        completedFrameworksPerAgent,
+        tasksPerCompletedFramework)));
+  }
+
+  cout << "Test setup: " << agentCount << " agents with a total of "
+       << frameworksPerAgent * tasksPerFramework * agentCount
+       << " running tasks and "
+       << completedFrameworksPerAgent * tasksPerCompletedFramework * agentCount
+       << " completed tasks" << endl;
+
+  vector<Future<Nothing>> reregistered;
+
+  foreach (const Owned<TestSlave>& slave, slaves) {
+    reregistered.push_back(slave->reregister());
+  }
+
+  // Wait all agents to finish reregistration.
+  await(reregistered).await();
+
+  // Subscribe an HTTP scheduler. The subscription stays open for the
+  // rest of the test, since the framework is disconnected once the
+  // stream is closed.
+  v1::scheduler::Call subscribe;
+  subscribe.set_type(v1::scheduler::Call::SUBSCRIBE);
+  subscribe.mutable_subscribe()->mutable_framework_info()->CopyFrom(
+      v1::DEFAULT_FRAMEWORK_INFO);
+
+  http::Headers subscribeHeaders;
+  subscribeHeaders["Accept"] = APPLICATION_PROTOBUF;
+
+  Future<http::Response> subscribed = http::streaming::post(
+      master.get()->pid,
+      schedulerEndpoint,
+      subscribeHeaders,
+      subscribe.SerializeAsString(),
+      APPLICATION_PROTOBUF);
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, subscribed);
+  ASSERT_EQ(http::Response::PIPE, subscribed->type);
+  ASSERT_SOME(subscribed->reader);
+  ASSERT_TRUE(subscribed->headers.contains("Mesos-Stream-Id"));
+
+  const string streamId = subscribed->headers.at("Mesos-Stream-Id");
+
+  recordio::Reader<v1::scheduler::Event> events(
+      ::recordio::Decoder<v1::scheduler::Event>(
+          lambda::bind(
+              deserialize<v1::scheduler::Event>,
+              ContentType::PROTOBUF,
+              lambda::_1)),
+      subscribed->reader.get());
+
+  Future<Result<v1::scheduler::Event>> event = events.read();
+  AWAIT_READY(event);
+  ASSERT_SOME(event.get());
+  ASSERT_EQ(v1::scheduler::Event::SUBSCRIBED, event->get().type());
+
+  const v1::FrameworkID frameworkId =
+    event->get().subscribed().framework_id();
+
+  Clock::pause();
+  Clock::settle();
+  Clock::resume();
+
+  // A helper sending a single scheduler call and measuring the time it
+  // takes for the master to accept it.
+  v1::scheduler::Call reconcile;
+  reconcile.set_type(v1::scheduler::Call::RECONCILE);
+  reconcile.mutable_framework_id()->CopyFrom(frameworkId);
+  reconcile.mutable_reconcile();
+
+  http::Headers callHeaders;
+  callHeaders["Accept"] = APPLICATION_PROTOBUF;
+  callHeaders["Mesos-Stream-Id"] = streamId;
+
+  const string body = reconcile.SerializeAsString();
+
+  auto singleCall = [=]() -> Future<Duration> {
+    shared_ptr<Stopwatch> watch(new Stopwatch);
+    watch->start();
+
+    Future<http::Response> response = http::post(
+        master.get()->pid,
+        schedulerEndpoint,
+        callHeaders,
+        body,
+        APPLICATION_PROTOBUF);
+
+    return response.then([watch](const http::Response& r) -> Future<Duration> {
+      watch->stop();
+      EXPECT_EQ(r.status, http::Accepted().status);
+      return watch->elapsed();
+    });
+  };
+
+  // A helper sending a single '/state' request and measuring the time
+  // it takes to receive a response.
+  auto singleRequest = [master, stateEndpoint]() -> Future<Duration> {
+    shared_ptr<Stopwatch> watch(new Stopwatch);
+    watch->start();
+
+    Future<http::Response> response = http::get(
+        master.get()->pid,
+        stateEndpoint,
+        None(),
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+    return response.then([watch](const http::Response& r) -> Future<Duration> {
+      watch->stop();
+      EXPECT_EQ(r.status, http::OK().status);
+      return watch->elapsed();
+    });
+  };
+
+  // Synchronizes completion of all lambdas sending requests.
+  atomic_bool stop = { false };
+
+  // A helper invoking `send` `numRequests` times. An early exit is
+  // possible if `stop` is set. Note that this lambda sets `stop` once
+  // `numRequests` requests have been sent. The intention is to
+  // synchronize completion across all running lambdas.
+  auto repeatRequests = [&stop](
+      const std::function<Future<Duration>()>& send,
+      size_t numRequests) -> vector<Duration> {
+    vector<Duration> durations;
+
+    size_t remaining = numRequests;
+    auto f = loop(
+        None(),
+        [=]() {
+          return send();
+        },
+        [&remaining, &durations, &stop](
+            const Duration& d) -> ControlFlow<Nothing> {
+          durations.push_back(d);
+
+          if (--remaining <= 0) {
+            stop.store(true);
+          }
+
+          if (stop.load()) {
+            return Break();
+          } else {
+            return Continue();
+          }
+        });
+
+    f.await();
+    EXPECT_TRUE(f.isReady());
+
+    return durations;
+  };
+
+  auto printStats = [](const vector<Duration>& durations) {
+    Option<Statistics<Duration>> s =
+      Statistics<Duration>::from(durations.cbegin(), durations.cend());
+    EXPECT_SOME(s);
+
+    cout << "[" << s->min << ", " << s->p25 << ", " << s->p50 << ", "
+         << s->p75 << ", " << s->p90 << ", " << s->max << "]"
+         << " from " << s->count << " measurements" << endl;
+  };
+
+  const std::function<Future<Duration>()> sendCall = singleCall;
+  const std::function<Future<Duration>()> sendRequest = singleRequest;
+
+  // First measure the response time for the scheduler calls only as
+  // the baseline.
+  cout << "Baseline: launching " << numRequests
+       << " 'RECONCILE' scheduler calls" << endl;
+
+  Future<vector<Duration>> callsFinished = async(
+      repeatRequests, sendCall, numRequests);
+  callsFinished.await();
+  CHECK_READY(callsFinished);
+
+  cout << "Results [min, p25, p50, p75, p90, max]: " << endl
+       << "  'RECONCILE' -> ";
+  printStats(callsFinished.get());
+
+  Clock::pause();
+  Clock::settle();
+  Clock::resume();
+
+  // Now measure the response times when scheduler calls and requests
+  // for `stateEndpoint` are sent in parallel. Stop when `numRequests`
+  // scheduler calls have been sent.
+  stop.store(false);
+
+  cout << "Benchmark: launching "
+       << numRequests << " 'RECONCILE' scheduler calls"
+       << " with up to " << numClients << " * " << numRequests
+       << " '/" << stateEndpoint << "'" << " requests in background" << endl;
+
+  vector<Future<vector<Duration>>> stateFinished;
+  while (numClients-- > 0) {
+    stateFinished.push_back(async(
+        repeatRequests, sendRequest, numeric_limits<size_t>::max()));
+  }
+
+  callsFinished = async(repeatRequests, sendCall, numRequests);
+
+  Future<vector<vector<Duration>>> collected = collect(stateFinished);
+  collected.await();
+  CHECK_READY(collected);
+
+  callsFinished.await();
+  CHECK_READY(callsFinished);
+
+  // Aggregate response times for all `/state` clients.
+  vector<Duration> aggregatedState;
+  foreach (const vector<Duration>& v, collected.get()) {
+    aggregatedState.insert(aggregatedState.end(), v.cbegin(), v.cend());
+  }
+
+  cout << "Results [min, p25, p50, p75, p90, max]: " << endl
+       << "  'RECONCILE' -> ";
+  printStats(callsFinished.get());
+
+  cout << "  '/" << stateEndpoint << "' -> ";
+  printStats(aggregatedState);
+
+  Clock::pause();
+  Clock::settle();
+  Clock::resume();
+
+  // Finally measure the response times of the scheduler calls while
+  // as many agents again reregister with the master in the background,
+  // as after a master failover.
+  vector<Owned<TestSlave>> reregisteringSlaves;
+
+  for (size_t i = 0; i < agentCount; i++) {
+    SlaveID slaveId;
+    slaveId.set_value("reregistering-agent" + stringify(i));
+
+    reregisteringSlaves.push_back(Owned<TestSlave>(new TestSlave(
+        master.get()->pid,
+        slaveId,
+        frameworksPerAgent,
+        tasksPerFramework,
+        completedFrameworksPerAgent,
+        tasksPerCompletedFramework)));
+  }
+
+  stop.store(false);
+
+  cout << "Benchmark: launching " << numRequests
+       << " 'RECONCILE' scheduler calls while " << agentCount
+       << " agents reregister in background" << endl;
+
+  reregistered.clear();
+
+  foreach (const Owned<TestSlave>& slave, reregisteringSlaves) {
+    reregistered.push_back(slave->reregister());
+  }
+
+  callsFinished = async(repeatRequests, sendCall, numRequests);
+  callsFinished.await();
+  CHECK_READY(callsFinished);
+
+  await(reregistered).await();
+
+  cout << "Results [min, p25, p50, p75, p90, max]: " << endl
+       << "  'RECONCILE' -> ";
+  printStats(callsFinished.get());
+}
+
+
 class MasterMetricsQuery_BENCHMARK_Test
   : public MesosTest,
     public WithParamInterface<tuple<
@@ -227,6 +227,10 @@ void MasterLoadTest::prepareCluster(Authorizer* authorizer)
   // Start a master.
   authorizer_.reset(new BlockingAuthorizer(authorizer));
   master::Flags masterFlags = CreateMasterFlags();
+
+  // These tests count the calls into the authorizer, so the master
+  // must not reuse object approvers across requests.
+  masterFlags.object_approvers_cache_ttl = Seconds(0);
   Try<Owned<cluster::Master>> master = StartMaster(
       authorizer_.get(), masterFlags);
 
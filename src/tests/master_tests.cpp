@@ -1737,7 +1737,7 @@ TEST_F(MasterTest, LaunchAcrossSlavesLost)
   combinedOffers.push_back(offers2.get()[0].id());
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   driver.launchTasks(combinedOffers, {task});
 
@@ -1846,7 +1846,7 @@ TEST_F(MasterTest, LaunchAcrossSlavesDropped)
   combinedOffers.push_back(offers2.get()[0].id());
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   driver.launchTasks(combinedOffers, {task});
 
@@ -1938,7 +1938,7 @@ TEST_F(MasterTest, LaunchDuplicateOfferLost)
     .WillOnce(FutureArg<1>(&status));
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   driver.launchTasks(combinedOffers, {task});
 
@@ -2030,7 +2030,7 @@ TEST_F(MasterTest, LaunchDuplicateOfferDropped)
     .WillOnce(FutureArg<1>(&status));
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   driver.launchTasks(combinedOffers, {task});
 
@@ -2219,7 +2219,7 @@ TEST_F(MasterTest, LaunchDifferentRoleLost)
   combinedOffers.push_back(offers3.get()[0].id());
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   driver.launchTasks(combinedOffers, {task2});
 
@@ -4588,7 +4588,7 @@ TEST_F(MasterTest, OfferTimeout)
     .WillOnce(FutureSatisfy(&offerRescinded));
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   driver.start();
 
@@ -4889,7 +4889,7 @@ TEST_F(MasterTest, ReleaseResourcesForTerminalTaskWithPendingUpdates)
   AWAIT_READY(___statusUpdate2);
 
   Future<Nothing> recoverResources = FUTURE_DISPATCH(
-      _, &MesosAllocatorProcess::recoverResources);
+      _, &MesosAllocatorProcess::recoverResourcesBatch);
 
   // Advance the clock so that the task status update manager resends
   // TASK_RUNNING update with 'latest_state' as TASK_FINISHED.
@@ -6041,6 +6041,97 @@ TEST_F(MasterTest, SlaveActiveEndpoint)
 }
 
 
+// This test verifies that the master handles the exit of an agent
+// after the messages the agent sent before it exited, i.e., only the
+// exits of framework PIDs are served ahead of other events. The agent
+// queues a reregistration and a resource update followed by its exit
+// while the master actor is busy; the master must apply the update
+// before it deactivates the agent.
+TEST_F(MasterTest, AgentExitAfterReregistration)
+{
+  Clock::pause();
+
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  slave::Flags slaveFlags = CreateSlaveFlags();
+
+  Future<SlaveRegisteredMessage> slaveRegisteredMessage =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), _, _);
+
+  // The agent sends a single `UpdateSlaveMessage` after registration.
+  Future<UpdateSlaveMessage> updateSlaveMessage =
+    FUTURE_PROTOBUF(UpdateSlaveMessage(), _, _);
+
+  StandaloneMasterDetector detector(master.get()->pid);
+  Try<Owned<cluster::Slave>> slave = StartSlave(&detector, slaveFlags);
+  ASSERT_SOME(slave);
+
+  Clock::advance(slaveFlags.registration_backoff_factor);
+
+  AWAIT_READY(slaveRegisteredMessage);
+  AWAIT_READY(updateSlaveMessage);
+
+  Clock::settle();
+
+  // Make the agent reregister and hold back the reregistration, so
+  // that we can deliver it while the master actor is busy.
+  Future<ReregisterSlaveMessage> reregisterSlaveMessage =
+    DROP_PROTOBUF(ReregisterSlaveMessage(), _, _);
+
+  detector.appoint(master.get()->pid);
+
+  Clock::advance(slaveFlags.authentication_backoff_factor);
+  Clock::advance(slaveFlags.registration_backoff_factor);
+
+  AWAIT_READY(reregisterSlaveMessage);
+
+  Clock::settle();
+
+  // Block the master actor until all the events below are queued.
+  Promise<Nothing> blocked;
+  Promise<Nothing> unblock;
+
+  process::dispatch(master.get()->pid, [&blocked, &unblock]() {
+    blocked.set(Nothing());
+    unblock.future().await();
+  });
+
+  AWAIT_READY(blocked.future());
+
+  Future<Nothing> updateSlave =
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::updateSlave);
+
+  Future<Nothing> deactivateSlave =
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::deactivateSlave);
+
+  // The filters are invoked when the master dispatches to the
+  // allocator, so this records whether the update was applied by the
+  // time the master handles the exit.
+  Future<bool> updatedBeforeExit = deactivateSlave
+    .then([updateSlave](const Nothing&) {
+      return updateSlave.isReady();
+    });
+
+  Resource revocable = Resources::parse("cpus", "1", "*").get();
+  revocable.mutable_revocable();
+
+  UpdateSlaveMessage update;
+  update.mutable_slave_id()->CopyFrom(slaveRegisteredMessage->slave_id());
+  update.set_update_oversubscribed_resources(true);
+  update.mutable_oversubscribed_resources()->Add()->CopyFrom(revocable);
+
+  process::post(
+      slave.get()->pid, master.get()->pid, reregisterSlaveMessage.get());
+  process::post(slave.get()->pid, master.get()->pid, update);
+  process::inject::exited(slave.get()->pid, master.get()->pid);
+
+  unblock.set(Nothing());
+
+  AWAIT_EXPECT_TRUE(updatedBeforeExit);
+}
+
+
 // This test verifies that service info for tasks is exposed over the
 // master's state endpoint.
 TEST_F(MasterTest, TaskDiscoveryInfo)
@@ -6968,6 +7059,122 @@ TEST_F(MasterTest, MaxCompletedTasksPerFrameworkFlag)
 }
 
 
+// Tests that completed tasks which are stored compressed by the master
+// are decoded when the state endpoints are queried.
+TEST_F(MasterTest, CompressCompletedTasks)
+{
+  Clock::pause();
+
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.compress_completed_tasks = true;
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  MockExecutor exec(DEFAULT_EXECUTOR_ID);
+  TestContainerizer containerizer(&exec);
+  EXPECT_CALL(exec, registered(_, _, _, _));
+
+  Future<SlaveRegisteredMessage> slaveRegisteredMessage =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), _, _);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  slave::Flags agentFlags = CreateSlaveFlags();
+  Try<Owned<cluster::Slave>> slave =
+    StartSlave(detector.get(), &containerizer, agentFlags);
+  ASSERT_SOME(slave);
+
+  Clock::advance(agentFlags.registration_backoff_factor);
+  AWAIT_READY(slaveRegisteredMessage);
+
+  MockScheduler sched;
+  MesosSchedulerDriver schedDriver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  EXPECT_CALL(sched, registered(_, _, _));
+
+  Future<vector<Offer>> offers;
+  EXPECT_CALL(sched, resourceOffers(_, _))
+    .WillOnce(FutureArg<1>(&offers))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  schedDriver.start();
+
+  Clock::advance(masterFlags.allocation_interval);
+
+  AWAIT_READY(offers);
+  ASSERT_FALSE(offers->empty());
+
+  TaskInfo task = createTask(offers->front(), "", DEFAULT_EXECUTOR_ID);
+
+  EXPECT_CALL(exec, launchTask(_, _))
+    .WillOnce(SendStatusUpdateFromTask(TASK_FINISHED));
+
+  Future<TaskStatus> statusFinished;
+  EXPECT_CALL(sched, statusUpdate(_, _))
+    .WillOnce(FutureArg<1>(&statusFinished));
+
+  schedDriver.launchTasks(offers->front().id(), {task});
+
+  AWAIT_READY(statusFinished);
+  EXPECT_EQ(TASK_FINISHED, statusFinished->state());
+
+  EXPECT_CALL(exec, shutdown(_))
+    .Times(AtMost(1));
+
+  schedDriver.stop();
+  schedDriver.join();
+
+  {
+    Future<Response> response = process::http::get(
+        master.get()->pid,
+        "state",
+        None(),
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+
+    Try<JSON::Object> state = JSON::parse<JSON::Object>(response->body);
+    ASSERT_SOME(state);
+
+    Result<JSON::Array> completedTasks = state->find<JSON::Array>(
+        "completed_frameworks[0].completed_tasks");
+
+    ASSERT_SOME(completedTasks);
+    ASSERT_EQ(1u, completedTasks->values.size());
+
+    JSON::Object completedTask =
+      completedTasks->values[0].as<JSON::Object>();
+
+    EXPECT_EQ(
+        task.task_id().value(),
+        completedTask.values["id"].as<JSON::String>().value);
+
+    EXPECT_EQ(
+        "TASK_FINISHED",
+        completedTask.values["state"].as<JSON::String>().value);
+  }
+
+  {
+    Future<Response> response = process::http::get(
+        master.get()->pid,
+        "tasks",
+        None(),
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+
+    Try<JSON::Object> tasks = JSON::parse<JSON::Object>(response->body);
+    ASSERT_SOME(tasks);
+
+    Result<JSON::String> taskId = tasks->find<JSON::String>("tasks[0].id");
+
+    ASSERT_SOME(taskId);
+    EXPECT_EQ(task.task_id().value(), taskId->value);
+  }
+}
+
+
 // Test GET requests on various endpoints without authentication and
 // with bad credentials.
 // Note that we have similar checks for the maintenance, roles, quota, teardown,
@@ -7337,7 +7544,7 @@ TEST_F(MasterTest, DISABLED_RecoverResourcesOrphanedTask)
   Clock::settle();
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   // Advance the clock for the task status update manager to retry with the
   // latest state of the task.
@@ -15,12 +15,15 @@
 // limitations under the License.
 
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include <mesos/v1/mesos.hpp>
 
 #include <process/clock.hpp>
+#include <process/collect.hpp>
 #include <process/future.hpp>
 #include <process/gmock.hpp>
 #include <process/owned.hpp>
@@ -29,6 +32,7 @@
 #include <stout/os.hpp>
 #include <stout/path.hpp>
 #include <stout/protobuf.hpp>
+#include <stout/stopwatch.hpp>
 #include <stout/uuid.hpp>
 
 #include <stout/os/ftruncate.hpp>
@@ -49,7 +53,15 @@ using process::Future;
 using process::Owned;
 using process::Promise;
 
+using std::cout;
+using std::endl;
 using std::string;
+using std::tie;
+using std::tuple;
+using std::vector;
+
+using testing::Return;
+using testing::WithParamInterface;
 
 namespace mesos {
 namespace internal {
@@ -114,7 +126,7 @@ protected:
     return statusUpdate;
   }
 
-  void resetStatusUpdateManager()
+  void resetStatusUpdateManager(const Option<string>& logPath = None())
   {
     statusUpdateManager.reset(new OperationStatusUpdateManager());
 
@@ -124,7 +136,7 @@ protected:
       };
 
     statusUpdateManager->initialize(
-        forward, OperationStatusUpdateManagerTest::getPath);
+        forward, OperationStatusUpdateManagerTest::getPath, logPath);
   }
 
   static const string getPath(const id::UUID& operationUuid)
@@ -906,6 +918,140 @@ TEST_F(OperationStatusUpdateManagerTest, UpdateLatestWhenResending)
   AWAIT_EXPECT_EQ(expectedStatusUpdate, forwardedStatusUpdate3);
 }
 
+
+// This test verifies that in group commit mode a status update is recovered
+// from the log if its write to the stream file was lost.
+TEST_F(OperationStatusUpdateManagerTest, GroupCommitRecoverFromLog)
+{
+  const string logPath = path::join(os::getcwd(), "log");
+
+  resetStatusUpdateManager(logPath);
+  AWAIT_READY(statusUpdateManager->recover({}, true));
+
+  Future<UpdateOperationStatusMessage> forwardedStatusUpdate1;
+  Future<UpdateOperationStatusMessage> forwardedStatusUpdate2;
+  EXPECT_CALL(statusUpdateProcessor, update(_))
+    .WillOnce(FutureArg<0>(&forwardedStatusUpdate1))
+    .WillOnce(FutureArg<0>(&forwardedStatusUpdate2));
+
+  const id::UUID operationUuid = id::UUID::random();
+  const id::UUID statusUuid = id::UUID::random();
+
+  UpdateOperationStatusMessage statusUpdate =
+    createUpdateOperationStatusMessage(
+        statusUuid, operationUuid, OperationState::OPERATION_FINISHED);
+
+  // Send a checkpointed operation status update.
+  AWAIT_ASSERT_READY(statusUpdateManager->update(statusUpdate, true));
+
+  UpdateOperationStatusMessage expectedStatusUpdate(statusUpdate);
+  expectedStatusUpdate.mutable_latest_status()->CopyFrom(statusUpdate.status());
+
+  // Verify that the status update is forwarded once committed.
+  AWAIT_EXPECT_EQ(expectedStatusUpdate, forwardedStatusUpdate1);
+
+  resetStatusUpdateManager(logPath);
+
+  // Simulate the loss of the unsynced write to the stream file.
+  Try<int_fd> fd = os::open(getPath(operationUuid), O_RDWR | O_CLOEXEC);
+  ASSERT_SOME(fd);
+  ASSERT_SOME(os::ftruncate(fd.get(), 0));
+  ASSERT_SOME(os::close(fd.get()));
+
+  // Recover the stream, this replays the log into the stream file.
+  Future<OperationStatusUpdateManagerState> state =
+    statusUpdateManager->recover({operationUuid}, true);
+
+  AWAIT_READY(state);
+
+  EXPECT_EQ(0u, state->errors);
+  ASSERT_TRUE(state->streams.contains(operationUuid));
+  ASSERT_SOME(state->streams.at(operationUuid));
+  ASSERT_EQ(1u, state->streams.at(operationUuid)->updates.size());
+  EXPECT_EQ(statusUpdate, state->streams.at(operationUuid)->updates.front());
+
+  // Check that the status update is resent.
+  AWAIT_EXPECT_EQ(expectedStatusUpdate, forwardedStatusUpdate2);
+
+  // The log is emptied after it has been replayed.
+  EXPECT_SOME_EQ(Bytes(0), os::stat::size(logPath));
+}
+
+
+class OperationStatusUpdateManager_BENCHMARK_Test
+  : public OperationStatusUpdateManagerTest,
+    public WithParamInterface<tuple<size_t, bool>> {};
+
+
+// The value tuples are defined as:
+// - streamCount
+// - whether group commit is enabled
+INSTANTIATE_TEST_CASE_P(
+    StreamCountGroupCommit,
+    OperationStatusUpdateManager_BENCHMARK_Test,
+    ::testing::Combine(
+        ::testing::Values(1000U, 10000U),
+        ::testing::Bool()));
+
+
+// This test measures the throughput of checkpointing a burst of status
+// updates and their acknowledgements across many streams, with and
+// without group commit.
+TEST_P(OperationStatusUpdateManager_BENCHMARK_Test, Throughput)
+{
+  size_t streamCount;
+  bool groupCommit;
+
+  tie(streamCount, groupCommit) = GetParam();
+
+  resetStatusUpdateManager(
+      groupCommit ? Option<string>(path::join(os::getcwd(), "log")) : None());
+
+  AWAIT_READY(statusUpdateManager->recover({}, true));
+
+  EXPECT_CALL(statusUpdateProcessor, update(_))
+    .WillRepeatedly(Return());
+
+  vector<UpdateOperationStatusMessage> statusUpdates;
+  statusUpdates.reserve(streamCount);
+
+  for (size_t i = 0; i < streamCount; i++) {
+    statusUpdates.push_back(createUpdateOperationStatusMessage(
+        id::UUID::random(),
+        id::UUID::random(),
+        OperationState::OPERATION_FINISHED));
+  }
+
+  const string mode = groupCommit ? "with" : "without";
+
+  Stopwatch watch;
+  watch.start();
+
+  vector<Future<Nothing>> updates;
+  foreach (const UpdateOperationStatusMessage& statusUpdate, statusUpdates) {
+    updates.push_back(statusUpdateManager->update(statusUpdate, true));
+  }
+
+  AWAIT_READY_FOR(process::collect(updates), Minutes(10));
+
+  cout << "Checkpointed " << streamCount << " status updates " << mode
+       << " group commit in " << watch.elapsed() << endl;
+
+  watch.start();
+
+  vector<Future<bool>> acknowledgements;
+  foreach (const UpdateOperationStatusMessage& statusUpdate, statusUpdates) {
+    acknowledgements.push_back(statusUpdateManager->acknowledgement(
+        id::UUID::fromBytes(statusUpdate.operation_uuid().value()).get(),
+        id::UUID::fromBytes(statusUpdate.status().uuid().value()).get()));
+  }
+
+  AWAIT_READY_FOR(process::collect(acknowledgements), Minutes(10));
+
+  cout << "Checkpointed " << streamCount << " acknowledgements " << mode
+       << " group commit in " << watch.elapsed() << endl;
+}
+
 } // namespace tests {
 } // namespace internal {
 } // namespace mesos {
@@ -14,6 +14,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <string>
 #include <queue>
 #include <vector>
@@ -29,9 +30,12 @@
 #include <mesos/v1/scheduler/scheduler.hpp>
 
 #include <process/clock.hpp>
+#include <process/collect.hpp>
+#include <process/dispatch.hpp>
 #include <process/future.hpp>
 #include <process/gmock.hpp>
 #include <process/gtest.hpp>
+#include <process/http.hpp>
 #include <process/owned.hpp>
 #include <process/pid.hpp>
 #include <process/queue.hpp>
@@ -40,7 +44,10 @@
 
 #include <stout/hashset.hpp>
 #include <stout/lambda.hpp>
+#include <stout/os.hpp>
+#include <stout/stringify.hpp>
 #include <stout/try.hpp>
+#include <stout/uuid.hpp>
 
 #include "internal/devolve.hpp"
 #include "internal/evolve.hpp"
@@ -65,6 +72,7 @@ using mesos::internal::slave::Slave;
 using mesos::master::detector::MasterDetector;
 using mesos::master::detector::StandaloneMasterDetector;
 
+using mesos::v1::scheduler::APIResult;
 using mesos::v1::scheduler::Call;
 using mesos::v1::scheduler::Event;
 using mesos::v1::scheduler::Mesos;
@@ -73,6 +81,7 @@ using process::Clock;
 using process::Future;
 using process::Owned;
 using process::PID;
+using process::Promise;
 using process::Queue;
 
 using process::http::OK;
@@ -1386,7 +1395,7 @@ TEST_P(SchedulerTest, Decline)
     .WillOnce(FutureArg<1>(&offers2));
 
   Future<Nothing> recoverResources =
-    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResources);
+    FUTURE_DISPATCH(_, &MesosAllocatorProcess::recoverResourcesBatch);
 
   {
     Call call;
@@ -2084,6 +2093,264 @@ TEST_P(SchedulerTest, Request)
 }
 
 
+// This test verifies that calls which exceed the pipelining window of
+// the non-subscribe connection are queued by the library and sent as
+// responses to earlier calls arrive, and that the responses are
+// returned in the order in which the calls were made.
+TEST_P(SchedulerTest, PipelinedCalls)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  auto scheduler = std::make_shared<v1::MockHTTPScheduler>();
+
+  Future<Nothing> connected;
+  EXPECT_CALL(*scheduler, connected(_))
+    .WillOnce(FutureSatisfy(&connected));
+
+  ContentType contentType = GetParam();
+
+  // Only allow two calls to be outstanding at the master.
+  const int window = 2;
+
+  os::setenv("MESOS_MAX_PIPELINED_CALLS", stringify(window));
+
+  v1::scheduler::TestMesos mesos(
+      master.get()->pid,
+      contentType,
+      scheduler);
+
+  os::unsetenv("MESOS_MAX_PIPELINED_CALLS");
+
+  AWAIT_READY(connected);
+
+  Future<Event::Subscribed> subscribed;
+  EXPECT_CALL(*scheduler, subscribed(_, _))
+    .WillOnce(FutureArg<1>(&subscribed));
+
+  EXPECT_CALL(*scheduler, heartbeat(_))
+    .WillRepeatedly(Return()); // Ignore heartbeats.
+
+  {
+    Call call;
+    call.set_type(Call::SUBSCRIBE);
+
+    Call::Subscribe* subscribe = call.mutable_subscribe();
+    subscribe->mutable_framework_info()->CopyFrom(v1::DEFAULT_FRAMEWORK_INFO);
+
+    mesos.send(call);
+  }
+
+  AWAIT_READY(subscribed);
+
+  v1::FrameworkID frameworkId(subscribed->framework_id());
+
+  const int calls = 10;
+
+  // The master handles a call before it sends the response. Hence,
+  // whenever a call arrives at the master, the master must have
+  // handled all but `window` of the calls which arrived before.
+  std::atomic<int> arrived(0);
+  std::atomic<int> handled(0);
+
+  vector<Future<Call>> arrivals;
+  vector<Future<Nothing>> requestResources;
+
+  for (int i = 0; i < calls; i++) {
+    arrivals.push_back(
+        FUTURE_HTTP_CALL(Call(), Call::REQUEST, _, contentType));
+
+    arrivals.back().onReady([&arrived, &handled, window](const Call&) {
+      EXPECT_LE(++arrived - handled.load(), window);
+    });
+
+    requestResources.push_back(
+        FUTURE_DISPATCH(_, &MesosAllocatorProcess::requestResources));
+
+    requestResources.back().onReady([&handled](const Nothing&) {
+      ++handled;
+    });
+  }
+
+  // Block the master actor so that the calls are not answered until
+  // the window is full.
+  Promise<Nothing> blocked;
+  Promise<Nothing> unblock;
+
+  process::dispatch(master.get()->pid, [&blocked, &unblock]() {
+    blocked.set(Nothing());
+    unblock.future().await();
+  });
+
+  AWAIT_READY(blocked.future());
+
+  vector<Future<APIResult>> results;
+
+  for (int i = 0; i < calls; i++) {
+    Call call;
+    call.mutable_framework_id()->CopyFrom(frameworkId);
+    call.set_type(Call::REQUEST);
+
+    // Create a dummy request.
+    Call::Request* request = call.mutable_request();
+    request->add_requests();
+
+    results.push_back(mesos.call(call));
+  }
+
+  // The expectations set last are matched first, so these are the
+  // arrivals of the first `window` calls.
+  for (int i = 0; i < window; i++) {
+    AWAIT_READY(arrivals[calls - 1 - i]);
+  }
+
+  unblock.set(Nothing());
+
+  // Each response must arrive after the responses to the calls which
+  // were made before it.
+  vector<Future<bool>> ordered;
+
+  for (size_t i = 1; i < results.size(); i++) {
+    Future<APIResult> previous = results[i - 1];
+
+    ordered.push_back(results[i]
+      .then([previous](const APIResult&) {
+        return previous.isReady();
+      }));
+  }
+
+  foreach (const Future<APIResult>& result, results) {
+    AWAIT_READY(result);
+    EXPECT_EQ(process::http::Status::ACCEPTED, result->status_code());
+  }
+
+  foreach (const Future<bool>& inOrder, ordered) {
+    AWAIT_EXPECT_TRUE(inOrder);
+  }
+
+  AWAIT_READY(collect(requestResources));
+
+  EXPECT_EQ(calls, arrived.load());
+}
+
+
+// This test verifies that an ACKNOWLEDGE call for a status update
+// which is already queued behind the pipelining window is coalesced
+// with the queued call.
+TEST_P(SchedulerTest, PipelinedAcknowledgementsCoalesced)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  auto scheduler = std::make_shared<v1::MockHTTPScheduler>();
+
+  Future<Nothing> connected;
+  EXPECT_CALL(*scheduler, connected(_))
+    .WillOnce(FutureSatisfy(&connected));
+
+  ContentType contentType = GetParam();
+
+  // Only allow a single call to be outstanding at the master.
+  os::setenv("MESOS_MAX_PIPELINED_CALLS", "1");
+
+  v1::scheduler::TestMesos mesos(
+      master.get()->pid,
+      contentType,
+      scheduler);
+
+  os::unsetenv("MESOS_MAX_PIPELINED_CALLS");
+
+  AWAIT_READY(connected);
+
+  Future<Event::Subscribed> subscribed;
+  EXPECT_CALL(*scheduler, subscribed(_, _))
+    .WillOnce(FutureArg<1>(&subscribed));
+
+  EXPECT_CALL(*scheduler, heartbeat(_))
+    .WillRepeatedly(Return()); // Ignore heartbeats.
+
+  {
+    Call call;
+    call.set_type(Call::SUBSCRIBE);
+
+    Call::Subscribe* subscribe = call.mutable_subscribe();
+    subscribe->mutable_framework_info()->CopyFrom(v1::DEFAULT_FRAMEWORK_INFO);
+
+    mesos.send(call);
+  }
+
+  AWAIT_READY(subscribed);
+
+  v1::FrameworkID frameworkId(subscribed->framework_id());
+
+  // Block the master actor so that the first call stays outstanding
+  // and the acknowledgements are queued behind it.
+  Promise<Nothing> blocked;
+  Promise<Nothing> unblock;
+
+  process::dispatch(master.get()->pid, [&blocked, &unblock]() {
+    blocked.set(Nothing());
+    unblock.future().await();
+  });
+
+  AWAIT_READY(blocked.future());
+
+  Future<Call> requestCall =
+    FUTURE_HTTP_CALL(Call(), Call::REQUEST, _, contentType);
+
+  Future<APIResult> result;
+
+  {
+    Call call;
+    call.mutable_framework_id()->CopyFrom(frameworkId);
+    call.set_type(Call::REQUEST);
+
+    // Create a dummy request.
+    Call::Request* request = call.mutable_request();
+    request->add_requests();
+
+    result = mesos.call(call);
+  }
+
+  AWAIT_READY(requestCall);
+
+  // The master ignores acknowledgements for unknown agents, which is
+  // fine since we only count the acknowledgements it receives.
+  Call acknowledgement;
+  acknowledgement.mutable_framework_id()->CopyFrom(frameworkId);
+  acknowledgement.set_type(Call::ACKNOWLEDGE);
+
+  Call::Acknowledge* acknowledge = acknowledgement.mutable_acknowledge();
+  acknowledge->mutable_agent_id()->set_value("agent");
+  acknowledge->mutable_task_id()->set_value("task");
+  acknowledge->set_uuid(id::UUID::random().toBytes());
+
+  Future<APIResult> acknowledged1 = mesos.call(acknowledgement);
+  Future<APIResult> acknowledged2 = mesos.call(acknowledgement);
+
+  unblock.set(Nothing());
+
+  AWAIT_READY(result);
+  EXPECT_EQ(process::http::Status::ACCEPTED, result->status_code());
+
+  AWAIT_READY(acknowledged1);
+  EXPECT_EQ(process::http::Status::ACCEPTED, acknowledged1->status_code());
+
+  AWAIT_READY(acknowledged2);
+  EXPECT_EQ(process::http::Status::ACCEPTED, acknowledged2->status_code());
+
+  // Wait for the master to process any further calls.
+  Clock::pause();
+  Clock::settle();
+  Clock::resume();
+
+  JSON::Object metrics = Metrics();
+
+  EXPECT_EQ(
+      1, metrics.values["master/messages_status_update_acknowledgement"]);
+}
+
+
 // This test verifies that the scheduler is able to force a reconnection with
 // the master.
 TEST_P(SchedulerTest, SchedulerReconnect)
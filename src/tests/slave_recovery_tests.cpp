@@ -19,6 +19,7 @@
 #endif // __WINDOWS__
 
 #include <string>
+#include <tuple>
 
 #include <gtest/gtest.h>
 
@@ -41,12 +42,14 @@
 #include <process/owned.hpp>
 #include <process/reap.hpp>
 
+#include <stout/fs.hpp>
 #include <stout/hashset.hpp>
 #include <stout/none.hpp>
 #include <stout/numify.hpp>
 #include <stout/option.hpp>
 #include <stout/os.hpp>
 #include <stout/path.hpp>
+#include <stout/stopwatch.hpp>
 #include <stout/uuid.hpp>
 
 #include <stout/os/killtree.hpp>
@@ -95,8 +98,13 @@ using mesos::slave::ContainerTermination;
 
 using mesos::v1::executor::Call;
 
+using std::cout;
+using std::endl;
+using std::make_tuple;
 using std::map;
 using std::string;
+using std::tie;
+using std::tuple;
 using std::vector;
 
 using testing::_;
@@ -105,6 +113,7 @@ using testing::DoAll;
 using testing::Eq;
 using testing::Return;
 using testing::SaveArg;
+using testing::WithParamInterface;
 
 namespace mesos {
 namespace internal {
@@ -157,6 +166,307 @@ TEST_F(SlaveStateTest, CheckpointRepeatedProtobufMessages)
 }
 
 
+// This test verifies that recovering the agent state in parallel does
+// not read the tasks of completed runs which are not the latest run of
+// their executor, while the tasks of all the other runs are recovered.
+TEST_F(SlaveStateTest, RecoverSkipsCompletedRuns)
+{
+  const string rootDir = path::join(sandbox.get(), "meta");
+
+  SlaveID slaveId;
+  slaveId.set_value("agent");
+
+  SlaveInfo slaveInfo;
+  slaveInfo.set_hostname("localhost");
+  slaveInfo.mutable_id()->CopyFrom(slaveId);
+
+  ASSERT_SOME(slave::state::checkpoint(
+      paths::getSlaveInfoPath(rootDir, slaveId), slaveInfo));
+
+  ASSERT_SOME(fs::symlink(
+      paths::getSlavePath(rootDir, slaveId),
+      paths::getLatestSlavePath(rootDir)));
+
+  const Resources resources = Resources::parse("cpus:0.1;mem:32").get();
+
+  // Each executor has a completed run, a run which is not completed
+  // (e.g., the agent failed before it removed the executor) and the
+  // latest run, all with a single task.
+  const size_t frameworkCount = 4;
+
+  ContainerID completed;
+  completed.set_value("completed");
+
+  ContainerID incomplete;
+  incomplete.set_value("incomplete");
+
+  ContainerID latest;
+  latest.set_value("latest");
+
+  const ExecutorInfo executorInfo = createExecutorInfo("executor", "exit 1");
+  const ExecutorID& executorId = executorInfo.executor_id();
+
+  for (size_t i = 0; i < frameworkCount; i++) {
+    FrameworkID frameworkId;
+    frameworkId.set_value("framework" + stringify(i));
+
+    FrameworkInfo frameworkInfo = DEFAULT_FRAMEWORK_INFO;
+    frameworkInfo.mutable_id()->CopyFrom(frameworkId);
+
+    ASSERT_SOME(slave::state::checkpoint(
+        paths::getFrameworkInfoPath(rootDir, slaveId, frameworkId),
+        frameworkInfo));
+
+    ASSERT_SOME(slave::state::checkpoint(
+        paths::getFrameworkPidPath(rootDir, slaveId, frameworkId),
+        string("scheduler@127.0.0.1:5050")));
+
+    ASSERT_SOME(slave::state::checkpoint(
+        paths::getExecutorInfoPath(rootDir, slaveId, frameworkId, executorId),
+        executorInfo));
+
+    foreach (const ContainerID& containerId,
+             vector<ContainerID>({completed, incomplete, latest})) {
+      const Task task = mesos::internal::protobuf::createTask(
+          createTask(slaveId, resources, "sleep 1000"),
+          TASK_RUNNING,
+          frameworkId);
+
+      ASSERT_SOME(slave::state::checkpoint(
+          paths::getTaskInfoPath(
+              rootDir,
+              slaveId,
+              frameworkId,
+              executorId,
+              containerId,
+              task.task_id()),
+          task));
+    }
+
+    ASSERT_SOME(slave::state::checkpoint(
+        paths::getExecutorSentinelPath(
+            rootDir, slaveId, frameworkId, executorId, completed),
+        string()));
+
+    ASSERT_SOME(fs::symlink(
+        paths::getExecutorRunPath(
+            rootDir, slaveId, frameworkId, executorId, latest),
+        paths::getExecutorLatestRunPath(
+            rootDir, slaveId, frameworkId, executorId)));
+  }
+
+  Try<slave::state::State> state = slave::state::recover(rootDir, true, 4);
+
+  ASSERT_SOME(state);
+  ASSERT_SOME(state->slave);
+  EXPECT_EQ(0u, state->errors);
+  ASSERT_EQ(frameworkCount, state->slave->frameworks.size());
+
+  foreachvalue (const slave::state::FrameworkState& framework,
+                state->slave->frameworks) {
+    ASSERT_TRUE(framework.executors.contains(executorId));
+
+    const slave::state::ExecutorState& executor =
+      framework.executors.at(executorId);
+
+    EXPECT_SOME_EQ(latest, executor.latest);
+    ASSERT_EQ(3u, executor.runs.size());
+
+    ASSERT_TRUE(executor.runs.contains(completed));
+    EXPECT_TRUE(executor.runs.at(completed).completed);
+    EXPECT_TRUE(executor.runs.at(completed).tasks.empty());
+
+    ASSERT_TRUE(executor.runs.contains(incomplete));
+    EXPECT_FALSE(executor.runs.at(incomplete).completed);
+    EXPECT_EQ(1u, executor.runs.at(incomplete).tasks.size());
+
+    ASSERT_TRUE(executor.runs.contains(latest));
+    EXPECT_FALSE(executor.runs.at(latest).completed);
+    EXPECT_EQ(1u, executor.runs.at(latest).tasks.size());
+  }
+}
+
+
+class SlaveStateRecovery_BENCHMARK_Test
+  : public TemporaryDirectoryTest,
+    public WithParamInterface<tuple<size_t, size_t, size_t, size_t>> {};
+
+
+// The value tuples are defined as:
+// - frameworkCount
+// - executorsPerFramework
+// - runsPerExecutor (all but the latest run are completed)
+// - tasksPerRun
+INSTANTIATE_TEST_CASE_P(
+    FrameworkExecutorRunTaskCount,
+    SlaveStateRecovery_BENCHMARK_Test,
+    ::testing::Values(
+        make_tuple(1, 1000, 10, 1),
+        make_tuple(10, 1000, 2, 1),
+        make_tuple(100, 100, 10, 5)));
+
+
+// This test builds a synthetic agent meta directory and measures the
+// time it takes to recover it with different recovery parallelism.
+TEST_P(SlaveStateRecovery_BENCHMARK_Test, Recover)
+{
+  size_t frameworkCount;
+  size_t executorsPerFramework;
+  size_t runsPerExecutor;
+  size_t tasksPerRun;
+
+  tie(frameworkCount,
+      executorsPerFramework,
+      runsPerExecutor,
+      tasksPerRun) = GetParam();
+
+  const string rootDir = path::join(sandbox.get(), "meta");
+
+  SlaveID slaveId;
+  slaveId.set_value("agent");
+
+  SlaveInfo slaveInfo;
+  slaveInfo.set_hostname("localhost");
+  slaveInfo.mutable_id()->CopyFrom(slaveId);
+
+  ASSERT_SOME(slave::state::checkpoint(
+      paths::getSlaveInfoPath(rootDir, slaveId), slaveInfo));
+
+  ASSERT_SOME(fs::symlink(
+      paths::getSlavePath(rootDir, slaveId),
+      paths::getLatestSlavePath(rootDir)));
+
+  const Resources resources = Resources::parse("cpus:0.1;mem:32").get();
+
+  Stopwatch watch;
+  watch.start();
+
+  for (size_t i = 0; i < frameworkCount; i++) {
+    FrameworkID frameworkId;
+    frameworkId.set_value("framework" + stringify(i));
+
+    FrameworkInfo frameworkInfo = DEFAULT_FRAMEWORK_INFO;
+    frameworkInfo.mutable_id()->CopyFrom(frameworkId);
+
+    ASSERT_SOME(slave::state::checkpoint(
+        paths::getFrameworkInfoPath(rootDir, slaveId, frameworkId),
+        frameworkInfo));
+
+    ASSERT_SOME(slave::state::checkpoint(
+        paths::getFrameworkPidPath(rootDir, slaveId, frameworkId),
+        string("scheduler@127.0.0.1:5050")));
+
+    for (size_t j = 0; j < executorsPerFramework; j++) {
+      ExecutorInfo executorInfo =
+        createExecutorInfo("executor" + stringify(j), "exit 1");
+
+      const ExecutorID& executorId = executorInfo.executor_id();
+
+      ASSERT_SOME(slave::state::checkpoint(
+          paths::getExecutorInfoPath(
+              rootDir, slaveId, frameworkId, executorId),
+          executorInfo));
+
+      for (size_t k = 0; k < runsPerExecutor; k++) {
+        ContainerID containerId;
+        containerId.set_value(id::UUID::random().toString());
+
+        for (size_t l = 0; l < tasksPerRun; l++) {
+          TaskInfo taskInfo = createTask(slaveId, resources, "sleep 1000");
+
+          const Task task = mesos::internal::protobuf::createTask(
+              taskInfo, TASK_RUNNING, frameworkId);
+
+          ASSERT_SOME(slave::state::checkpoint(
+              paths::getTaskInfoPath(
+                  rootDir,
+                  slaveId,
+                  frameworkId,
+                  executorId,
+                  containerId,
+                  task.task_id()),
+              task));
+
+          const StatusUpdate update =
+            mesos::internal::protobuf::createStatusUpdate(
+                frameworkId,
+                slaveId,
+                task.task_id(),
+                TASK_RUNNING,
+                TaskStatus::SOURCE_EXECUTOR,
+                id::UUID::random());
+
+          RepeatedPtrField<StatusUpdateRecord> records;
+
+          StatusUpdateRecord* record = records.Add();
+          record->set_type(StatusUpdateRecord::UPDATE);
+          record->mutable_update()->CopyFrom(update);
+
+          record = records.Add();
+          record->set_type(StatusUpdateRecord::ACK);
+          record->set_uuid(update.uuid());
+
+          ASSERT_SOME(::protobuf::write(
+              paths::getTaskUpdatesPath(
+                  rootDir,
+                  slaveId,
+                  frameworkId,
+                  executorId,
+                  containerId,
+                  task.task_id()),
+              records));
+        }
+
+        ASSERT_SOME(slave::state::checkpoint(
+            paths::getForkedPidPath(
+                rootDir, slaveId, frameworkId, executorId, containerId),
+            string("1")));
+
+        // All but the latest run are completed.
+        if (k + 1 < runsPerExecutor) {
+          ASSERT_SOME(slave::state::checkpoint(
+              paths::getExecutorSentinelPath(
+                  rootDir, slaveId, frameworkId, executorId, containerId),
+              string()));
+        } else {
+          ASSERT_SOME(fs::symlink(
+              paths::getExecutorRunPath(
+                  rootDir, slaveId, frameworkId, executorId, containerId),
+              paths::getExecutorLatestRunPath(
+                  rootDir, slaveId, frameworkId, executorId)));
+        }
+      }
+    }
+  }
+
+  cout << "Checkpointed " << frameworkCount << " frameworks with "
+       << frameworkCount * executorsPerFramework << " executors, "
+       << frameworkCount * executorsPerFramework * runsPerExecutor
+       << " runs and "
+       << frameworkCount * executorsPerFramework * runsPerExecutor * tasksPerRun
+       << " tasks in " << watch.elapsed() << endl;
+
+  const vector<size_t> parallelisms = {1u, 4u, 8u, 16u};
+
+  foreach (size_t parallelism, parallelisms) {
+    watch.start();
+
+    Try<slave::state::State> state =
+      slave::state::recover(rootDir, true, parallelism);
+
+    watch.stop();
+
+    ASSERT_SOME(state);
+    ASSERT_SOME(state->slave);
+    EXPECT_EQ(0u, state->errors);
+    EXPECT_EQ(frameworkCount, state->slave->frameworks.size());
+
+    cout << "Recovered agent state with parallelism " << parallelism
+         << " in " << watch.elapsed() << endl;
+  }
+}
+
+
 template <typename T>
 class SlaveRecoveryTest : public ContainerizerTest<T>
 {
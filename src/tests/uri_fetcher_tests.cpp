@@ -17,6 +17,7 @@
 #include <gmock/gmock.h>
 
 #include <process/future.hpp>
+#include <process/gmock.hpp>
 #include <process/gtest.hpp>
 #include <process/http.hpp>
 #include <process/process.hpp>
@@ -24,12 +25,14 @@
 #include <stout/check.hpp>
 #include <stout/duration.hpp>
 #include <stout/gtest.hpp>
+#include <stout/numify.hpp>
 #include <stout/os.hpp>
 #include <stout/path.hpp>
 
 #include <stout/os/exists.hpp>
 #include <stout/os/getcwd.hpp>
 #include <stout/os/ls.hpp>
+#include <stout/os/read.hpp>
 #include <stout/os/write.hpp>
 #include <stout/uri.hpp>
 
@@ -48,6 +51,7 @@ namespace http = process::http;
 
 using std::list;
 using std::string;
+using std::vector;
 
 using mesos::uri::DockerFetcherPlugin;
 
@@ -56,6 +60,8 @@ using process::Owned;
 using process::Process;
 
 using testing::_;
+using testing::DoAll;
+using testing::Invoke;
 using testing::Return;
 
 namespace mesos {
@@ -74,6 +80,51 @@ public:
 };
 
 
+// Returns a response with the given content, or with the byte range
+// of it which is requested.
+static http::Response serveContent(
+    const string& content,
+    const http::Request& request)
+{
+  Option<string> range = request.headers.get("Range");
+  if (range.isNone()) {
+    return http::OK(content);
+  }
+
+  vector<string> tokens = strings::tokenize(
+      strings::remove(range.get(), "bytes=", strings::PREFIX), "-");
+
+  CHECK_EQ(2u, tokens.size());
+
+  const size_t first = numify<size_t>(tokens[0]).get();
+  const size_t last =
+    std::min(numify<size_t>(tokens[1]).get(), content.size() - 1);
+
+  http::Response response(
+      content.substr(first, last - first + 1),
+      http::Status::PARTIAL_CONTENT);
+
+  response.headers["Content-Range"] =
+    "bytes " + stringify(first) + "-" + stringify(last) + "/" +
+    stringify(content.size());
+
+  return response;
+}
+
+
+// Returns content which is unlikely to be reassembled correctly if
+// parts of it end up at the wrong offset.
+static string generate(size_t size)
+{
+  string content(size, '\0');
+  for (size_t i = 0; i < size; i++) {
+    content[i] = static_cast<char>('a' + (i / 7 + i % 251) % 26);
+  }
+
+  return content;
+}
+
+
 class CurlFetcherPluginTest : public TemporaryDirectoryTest
 {
 protected:
@@ -152,6 +203,114 @@ TEST_F(CurlFetcherPluginTest, CURL_InvokeFetchByName)
 }
 
 
+// This test verifies that HTTP downloads reuse the connection to the
+// server.
+TEST_F(CurlFetcherPluginTest, ReuseConnection)
+{
+  URI uri = uri::http(
+      stringify(server.self().address.ip),
+      "/TestHttpServer/test",
+      server.self().address.port);
+
+  Future<http::Request> request1;
+  Future<http::Request> request2;
+  EXPECT_CALL(server, test(_))
+    .WillOnce(DoAll(FutureArg<0>(&request1), Return(http::OK("test"))))
+    .WillOnce(DoAll(FutureArg<0>(&request2), Return(http::OK("test"))));
+
+  Try<Owned<uri::Fetcher>> fetcher = uri::fetcher::create();
+  ASSERT_SOME(fetcher);
+
+  AWAIT_READY(fetcher.get()->fetch(uri, os::getcwd()));
+  AWAIT_READY(fetcher.get()->fetch(uri, os::getcwd()));
+
+  AWAIT_READY(request1);
+  AWAIT_READY(request2);
+
+  ASSERT_SOME(request1->client);
+  ASSERT_SOME(request2->client);
+  EXPECT_EQ(request1->client.get(), request2->client.get());
+}
+
+
+// This test verifies that a file which is larger than a download
+// range is downloaded in parallel ranges, and reassembled correctly.
+TEST_F(CurlFetcherPluginTest, RangeDownload)
+{
+  URI uri = uri::http(
+      stringify(server.self().address.ip),
+      "/TestHttpServer/test",
+      server.self().address.port);
+
+  // The file spans three ranges of 8MB.
+  const string content = generate(Megabytes(20).bytes());
+
+  EXPECT_CALL(server, test(_))
+    .Times(3)
+    .WillRepeatedly(Invoke([&content](const http::Request& request) {
+      return serveContent(content, request);
+    }));
+
+  Try<Owned<uri::Fetcher>> fetcher = uri::fetcher::create();
+  ASSERT_SOME(fetcher);
+
+  AWAIT_READY(fetcher.get()->fetch(uri, os::getcwd()));
+
+  Try<string> read = os::read(path::join(os::getcwd(), "test"));
+  ASSERT_SOME(read);
+  EXPECT_TRUE(read.get() == content);
+}
+
+
+// This test verifies that a download which fails part way through is
+// resumed from where it stopped.
+TEST_F(CurlFetcherPluginTest, ResumeDownload)
+{
+  URI uri = uri::http(
+      stringify(server.self().address.ip),
+      "/TestHttpServer/test",
+      server.self().address.port);
+
+  const string content = generate(Kilobytes(64).bytes());
+  const size_t sent = content.size() / 2;
+
+  // The first response breaks off after half of the content.
+  http::Pipe pipe;
+  http::Response broken(http::Status::PARTIAL_CONTENT);
+  broken.type = http::Response::PIPE;
+  broken.reader = pipe.reader();
+  broken.headers["Content-Range"] =
+    "bytes 0-" + stringify(content.size() - 1) + "/" +
+    stringify(content.size());
+
+  pipe.writer().write(content.substr(0, sent));
+  pipe.writer().fail("Broken");
+
+  Future<http::Request> resumed;
+  EXPECT_CALL(server, test(_))
+    .WillOnce(Return(broken))
+    .WillOnce(DoAll(
+        FutureArg<0>(&resumed),
+        Invoke([&content](const http::Request& request) {
+          return serveContent(content, request);
+        })));
+
+  Try<Owned<uri::Fetcher>> fetcher = uri::fetcher::create();
+  ASSERT_SOME(fetcher);
+
+  AWAIT_READY(fetcher.get()->fetch(uri, os::getcwd()));
+
+  AWAIT_READY(resumed);
+  EXPECT_SOME_EQ(
+      "bytes=" + stringify(sent) + "-" + stringify(content.size() - 1),
+      resumed->headers.get("Range"));
+
+  Try<string> read = os::read(path::join(os::getcwd(), "test"));
+  ASSERT_SOME(read);
+  EXPECT_TRUE(read.get() == content);
+}
+
+
 class HadoopFetcherPluginTest : public TemporaryDirectoryTest
 {
 public:
@@ -290,6 +449,80 @@ static constexpr char TEST_DIGEST[] = "sha256:a3ed95caeb02ffe68cdd9fd844066"
 class DockerFetcherPluginTest : public TemporaryDirectoryTest {};
 
 
+// A Docker registry which requires a bearer token to pull blobs, and
+// redirects blob requests to its storage.
+class TestRegistry : public Process<TestRegistry>
+{
+public:
+  TestRegistry() : ProcessBase("v2")
+  {
+    route("/library/busybox/blobs", None(), &TestRegistry::blob);
+    route("/storage", None(), &TestRegistry::storage);
+    route("/token", None(), &TestRegistry::token);
+  }
+
+  Future<http::Response> blob(const http::Request& request)
+  {
+    if (request.headers.get("Authorization") != string("Bearer token")) {
+      http::Response response(http::Status::UNAUTHORIZED);
+      response.headers["WWW-Authenticate"] =
+        "Bearer realm=\"http://" + stringify(self().address) + "/v2/token\","
+        "service=\"registry\","
+        "scope=\"repository:library/busybox:pull\"";
+
+      return response;
+    }
+
+    return http::TemporaryRedirect("/v2/storage");
+  }
+
+  Future<http::Response> storage(const http::Request& request)
+  {
+    return serveContent("blob", request);
+  }
+
+  Future<http::Response> token(const http::Request& request)
+  {
+    if (request.url.query.get("service") != string("registry") ||
+        request.url.query.get("scope") !=
+          string("repository:library/busybox:pull")) {
+      return http::BadRequest();
+    }
+
+    return http::OK("{\"token\": \"token\"}");
+  }
+};
+
+
+// This test verifies that the docker fetcher plugin pulls a blob from
+// a registry over HTTP, which requires requesting a bearer token and
+// following a redirect to the storage of the registry.
+TEST_F(DockerFetcherPluginTest, FetchBlobFromHttpRegistry)
+{
+  TestRegistry registry;
+  spawn(registry);
+
+  URI uri = uri::docker::blob(
+      "library/busybox",
+      "sha256:1234",
+      stringify(registry.self().address.ip),
+      "http",
+      registry.self().address.port);
+
+  Try<Owned<uri::Fetcher>> fetcher = uri::fetcher::create();
+  ASSERT_SOME(fetcher);
+
+  AWAIT_READY_FOR(fetcher.get()->fetch(uri, os::getcwd()), Seconds(60));
+
+  EXPECT_SOME_EQ(
+      "blob",
+      os::read(DockerFetcherPlugin::getBlobPath(os::getcwd(), "sha256:1234")));
+
+  terminate(registry);
+  wait(registry);
+}
+
+
 TEST_F(DockerFetcherPluginTest, INTERNET_CURL_FetchManifest)
 {
   URI uri = uri::docker::manifest(
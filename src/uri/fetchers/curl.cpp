@@ -33,6 +33,8 @@
 #include <stout/os/constants.hpp>
 #include <stout/os/mkdir.hpp>
 
+#include "uri/http_client.hpp"
+
 #include "uri/fetchers/curl.hpp"
 
 namespace http = process::http;
@@ -87,27 +89,12 @@ string CurlFetcherPlugin::name() const
 }
 
 
-Future<Nothing> CurlFetcherPlugin::fetch(
-    const URI& uri,
-    const string& directory,
-    const Option<string>& data) const
+// Uses the curl command to download the given URL into `output`.
+static Future<Nothing> curl(
+    const string& url,
+    const string& output,
+    const Option<Duration>& stallTimeout)
 {
-  // TODO(jieyu): Validate the given URI.
-
-  if (!uri.has_path()) {
-    return Failure("URI path is not specified");
-  }
-
-  Try<Nothing> mkdir = os::mkdir(directory);
-  if (mkdir.isError()) {
-    return Failure(
-        "Failed to create directory '" +
-        directory + "': " + mkdir.error());
-  }
-
-  // TODO(jieyu): Allow user to specify the name of the output file.
-  const string output =
-    path::join(directory, Path(path::from_uri(uri.path())).basename());
 #ifndef __WINDOWS__
   const string curl = "curl";
 #else
@@ -121,16 +108,15 @@ Future<Nothing> CurlFetcherPlugin::fetch(
     "-L",                 // Follow HTTP 3xx redirects.
     "-w", "%{http_code}", // Display HTTP response code on stdout.
     "-o", output,         // Write output to the file.
-    strings::trim(stringify(uri))
+    url
   };
 
   // Add a timeout for curl to abort when the download speed keeps low
   // (1 byte per second by default) for the specified duration. See:
   // https://curl.haxx.se/docs/manpage.html#-y
-  if (flags.curl_stall_timeout.isSome()) {
+  if (stallTimeout.isSome()) {
     argv.push_back("-y");
-    argv.push_back(
-        std::to_string(static_cast<long>(flags.curl_stall_timeout->secs())));
+    argv.push_back(std::to_string(static_cast<long>(stallTimeout->secs())));
   }
 
   Try<Subprocess> s = subprocess(
@@ -197,5 +183,54 @@ Future<Nothing> CurlFetcherPlugin::fetch(
     });
 }
 
+
+Future<Nothing> CurlFetcherPlugin::fetch(
+    const URI& uri,
+    const string& directory,
+    const Option<string>& data) const
+{
+  // TODO(jieyu): Validate the given URI.
+
+  if (!uri.has_path()) {
+    return Failure("URI path is not specified");
+  }
+
+  Try<Nothing> mkdir = os::mkdir(directory);
+  if (mkdir.isError()) {
+    return Failure(
+        "Failed to create directory '" +
+        directory + "': " + mkdir.error());
+  }
+
+  // TODO(jieyu): Allow user to specify the name of the output file.
+  const string output =
+    path::join(directory, Path(path::from_uri(uri.path())).basename());
+
+  const string url = strings::trim(stringify(uri));
+
+  if (!HttpClient::supports(url)) {
+    return curl(url, output, flags.curl_stall_timeout);
+  }
+
+  const Option<Duration> stallTimeout = flags.curl_stall_timeout;
+
+  return client->download(url, output)
+    .then([output, stallTimeout](
+        const http::Response& response) -> Future<Nothing> {
+      if (response.code == http::Status::OK) {
+        return Nothing();
+      }
+
+      // Redirects to URLs which can't be fetched in-process are left
+      // to the curl command.
+      Option<string> location = response.headers.get("Location");
+      if (response.code / 100 == 3 && location.isSome()) {
+        return curl(location.get(), output, stallTimeout);
+      }
+
+      return Failure("Unexpected HTTP response code: " + response.status);
+    });
+}
+
 } // namespace uri {
 } // namespace mesos {
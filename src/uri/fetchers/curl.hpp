@@ -24,6 +24,8 @@
 
 #include <mesos/uri/fetcher.hpp>
 
+#include "uri/http_client.hpp"
+
 namespace mesos {
 namespace uri {
 
@@ -54,9 +56,14 @@ public:
       const Option<std::string>& data = None()) const override;
 
 private:
-  explicit CurlFetcherPlugin(const Flags& _flags) : flags(_flags) {}
+  explicit CurlFetcherPlugin(const Flags& _flags)
+    : flags(_flags),
+      client(new HttpClient(_flags.curl_stall_timeout)) {}
 
   const Flags flags;
+
+  // Used for the URLs which can be fetched in-process.
+  process::Owned<HttpClient> client;
 };
 
 } // namespace uri {
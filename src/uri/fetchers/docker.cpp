@@ -38,6 +38,7 @@
 
 #include <mesos/docker/spec.hpp>
 
+#include "uri/http_client.hpp"
 #include "uri/utils.hpp"
 
 #include "uri/fetchers/docker.hpp"
@@ -345,12 +346,9 @@ static Future<int> download(
 }
 
 
-static Future<int> download(
-    const URI& uri,
-    const string& url,
-    const string& directory,
-    const http::Headers& headers,
-    const Option<Duration>& stallTimeout)
+// Returns the path in `directory` which the blob with the given URI
+// is downloaded to.
+static string getBlobPath(const URI& uri, const string& directory)
 {
   string blobSum;
 
@@ -361,11 +359,18 @@ static Future<int> download(
     blobSum = uri.path().substr(lastSlash + 1);
   }
 
-  return download(
-      url,
-      DockerFetcherPlugin::getBlobPath(directory, blobSum),
-      headers,
-      stallTimeout);
+  return DockerFetcherPlugin::getBlobPath(directory, blobSum);
+}
+
+
+static Future<int> download(
+    const URI& uri,
+    const string& url,
+    const string& directory,
+    const http::Headers& headers,
+    const Option<Duration>& stallTimeout)
+{
+  return download(url, getBlobPath(uri, directory), headers, stallTimeout);
 }
 
 
@@ -436,7 +441,8 @@ public:
       const Option<Duration>& _stallTimeout)
     : ProcessBase(process::ID::generate("docker-fetcher-plugin")),
       auths(_auths),
-      stallTimeout(_stallTimeout) {}
+      stallTimeout(_stallTimeout),
+      client(_stallTimeout) {}
 
   Future<Nothing> fetch(
       const URI& uri,
@@ -481,7 +487,8 @@ private:
       const URI& uri,
       const string& directory,
       const URI& blobUri,
-      const http::Headers& basicAuthHeaders);
+      const http::Headers& basicAuthHeaders,
+      const http::Response& response);
 
 #ifdef __WINDOWS__
   Future<Nothing> urlFetchBlob(
@@ -507,6 +514,19 @@ private:
   URI getManifestUri(const URI& uri);
   URI getBlobUri(const URI& uri);
 
+  // Sends a GET request and returns the response. The request is sent
+  // in-process if possible and with the curl command otherwise.
+  Future<http::Response> get(const string& url, const http::Headers& headers);
+  Future<http::Response> get(const URI& uri, const http::Headers& headers);
+
+  // Downloads the blob with the given URI from `url` into `directory`.
+  // The response is returned without body.
+  Future<http::Response> downloadBlob(
+      const URI& uri,
+      const string& url,
+      const string& directory,
+      const http::Headers& headers);
+
   // This is a lookup table for credentials in docker config file,
   // keyed by registry URL.
   // For example, "https://index.docker.io/v1/" -> spec::Config::Auth
@@ -514,6 +534,10 @@ private:
 
   // Timeout for curl to wait when a net download stalls.
   const Option<Duration> stallTimeout;
+
+  // Client for the requests which can be sent in-process. It keeps
+  // the connections to the registries open between requests.
+  HttpClient client;
 };
 
 
@@ -690,7 +714,7 @@ Future<Nothing> DockerFetcherPluginProcess::fetch(
     {"Accept", "application/vnd.docker.distribution.manifest.v1+json"}
   };
 
-  return curl(manifestUri, manifestHeaders + basicAuthHeaders, stallTimeout)
+  return get(manifestUri, manifestHeaders + basicAuthHeaders)
     .then(defer(self(),
                 &Self::_fetch,
                 uri,
@@ -715,7 +739,7 @@ Future<Nothing> DockerFetcherPluginProcess::_fetch(
     return getAuthHeader(manifestUri, basicAuthHeaders, response)
       .then(defer(self(), [=](
           const http::Headers& authHeaders) -> Future<Nothing> {
-        return curl(manifestUri, manifestHeaders + authHeaders, stallTimeout)
+        return get(manifestUri, manifestHeaders + authHeaders)
           .then(defer(self(),
                       &Self::__fetch,
                       uri,
@@ -758,7 +782,7 @@ Future<Nothing> DockerFetcherPluginProcess::__fetch(
     {"Accept", "application/vnd.docker.distribution.manifest.v2+json"}
   };
 
-  return curl(manifestUri, s2ManifestHeaders + authHeaders, stallTimeout)
+  return get(manifestUri, s2ManifestHeaders + authHeaders)
       .then(defer(self(), [=](const http::Response& response)
           -> Future<Nothing> {
         Try<spec::v2_2::ImageManifest> manifest =
@@ -936,22 +960,21 @@ Future<Nothing> DockerFetcherPluginProcess::fetchBlob(
 {
   URI blobUri = getBlobUri(uri);
 
-  return download(
+  return downloadBlob(
       blobUri,
       strings::trim(stringify(blobUri)),
       directory,
-      authHeaders,
-      stallTimeout)
-    .then(defer(self(), [=](int code) -> Future<Nothing> {
-      if (code == http::Status::UNAUTHORIZED) {
+      authHeaders)
+    .then(defer(self(), [=](const http::Response& response) -> Future<Nothing> {
+      if (response.code == http::Status::UNAUTHORIZED) {
         // If we get a '401 Unauthorized', we assume that 'authHeaders'
         // is either empty or contains the 'Basic' credential, and we
         // can use it to request an auth token.
         // TODO(chhsiao): What if 'authHeaders' has an expired token?
-        return _fetchBlob(uri, directory, blobUri, authHeaders);
+        return _fetchBlob(uri, directory, blobUri, authHeaders, response);
       }
 
-      if (code == http::Status::OK) {
+      if (response.code == http::Status::OK) {
         return Nothing();
       }
 
@@ -959,7 +982,7 @@ Future<Nothing> DockerFetcherPluginProcess::fetchBlob(
       return urlFetchBlob(uri, directory, blobUri, authHeaders);
 #else
       return Failure(
-          "Unexpected HTTP response '" + http::Status::string(code) + "' "
+          "Unexpected HTTP response '" + response.status + "' "
           "when trying to download the blob");
 #endif
     }));
@@ -970,13 +993,18 @@ Future<Nothing> DockerFetcherPluginProcess::_fetchBlob(
     const URI& uri,
     const string& directory,
     const URI& blobUri,
-    const http::Headers& basicAuthHeaders)
+    const http::Headers& basicAuthHeaders,
+    const http::Response& unauthorized)
 {
-  // TODO(jieyu): This extra 'curl' call can be avoided if we can get
-  // HTTP headers from 'download'. Currently, 'download' only returns
-  // the HTTP response code because we don't support parsing HTTP
-  // headers alone. Revisit this once that's supported.
-  return curl(blobUri, basicAuthHeaders, stallTimeout)
+  // A blob downloaded with the curl command only returns the HTTP
+  // response code, so we need an extra request to get the headers of
+  // the '401 Unauthorized' response.
+  Future<http::Response> challenge =
+    unauthorized.headers.contains("WWW-Authenticate")
+      ? unauthorized
+      : get(blobUri, basicAuthHeaders);
+
+  return challenge
     .then(defer(self(), [=](const http::Response& response) -> Future<Nothing> {
       // We expect a '401 Unauthorized' response here since the
       // 'download' with the same URI returns a '401 Unauthorized'.
@@ -989,14 +1017,14 @@ Future<Nothing> DockerFetcherPluginProcess::_fetchBlob(
       return getAuthHeader(blobUri, basicAuthHeaders, response)
         .then(defer(self(), [=](
             const http::Headers& authHeaders) -> Future<Nothing> {
-          return download(
+          return downloadBlob(
               blobUri,
               strings::trim(stringify(blobUri)),
               directory,
-              authHeaders,
-              stallTimeout)
-            .then(defer(self(), [=](int code) -> Future<Nothing> {
-              if (code == http::Status::OK) {
+              authHeaders)
+            .then(defer(self(), [=](
+                const http::Response& response) -> Future<Nothing> {
+              if (response.code == http::Status::OK) {
                 return Nothing();
               }
 
@@ -1004,7 +1032,7 @@ Future<Nothing> DockerFetcherPluginProcess::_fetchBlob(
               return urlFetchBlob(uri, directory, blobUri, authHeaders);
 #else
               return Failure(
-                  "Unexpected HTTP response '" + http::Status::string(code) +
+                  "Unexpected HTTP response '" + response.status +
                   "' when trying to download blob '" +
                   strings::trim(stringify(blobUri)) +
                   "' with schema 1 manifest");
@@ -1066,14 +1094,15 @@ Future<Nothing> DockerFetcherPluginProcess::_urlFetchBlob(
 
   string url = urls.back();
   urls.pop_back();
-  return download(blobUri, url, directory, authHeaders, stallTimeout)
-      .then(defer(self(), [=](int code) -> Future<Nothing> {
-        if (code == http::Status::OK) {
+  return downloadBlob(blobUri, url, directory, authHeaders)
+      .then(defer(self(), [=](const http::Response& response)
+          -> Future<Nothing> {
+        if (response.code == http::Status::OK) {
           return Nothing();
         }
 
         LOG(WARNING) << "Unexpected HTTP response '"
-                      << http::Status::string(code)
+                      << response.status
                       << "' when trying to download blob '"
                       << strings::trim(stringify(blobUri))
                       << "' from '" << url
@@ -1136,7 +1165,7 @@ Future<http::Headers> DockerFetcherPluginProcess::getAuthHeader(
       "service=" + authParam.at("service") + "&" +
       "scope=" + authParam.at("scope");
 
-    return curl(authServerUri, basicAuthHeaders, stallTimeout)
+    return get(authServerUri, basicAuthHeaders)
       .then([authServerUri](
           const http::Response& response) -> Future<http::Headers> {
         if (response.code != http::Status::OK) {
@@ -1202,5 +1231,72 @@ URI DockerFetcherPluginProcess::getBlobUri(const URI& uri)
       (uri.has_port() ? Option<int>(uri.port()) : None()));
 }
 
+
+Future<http::Response> DockerFetcherPluginProcess::get(
+    const string& url,
+    const http::Headers& headers)
+{
+  if (!HttpClient::supports(url)) {
+    return curl(url, headers, stallTimeout);
+  }
+
+  const Option<Duration> stallTimeout = this->stallTimeout;
+
+  return client.get(url, headers)
+    .then([headers, stallTimeout](
+        const http::Response& response) -> Future<http::Response> {
+      // Redirects to URLs which can't be fetched in-process are left
+      // to the curl command.
+      Option<string> location = response.headers.get("Location");
+      if (response.code / 100 == 3 && location.isSome()) {
+        return curl(location.get(), headers, stallTimeout);
+      }
+
+      return response;
+    });
+}
+
+
+Future<http::Response> DockerFetcherPluginProcess::get(
+    const URI& uri,
+    const http::Headers& headers)
+{
+  return get(strings::trim(stringify(uri)), headers);
+}
+
+
+Future<http::Response> DockerFetcherPluginProcess::downloadBlob(
+    const URI& uri,
+    const string& url,
+    const string& directory,
+    const http::Headers& headers)
+{
+  if (!HttpClient::supports(url)) {
+    return download(uri, url, directory, headers, stallTimeout)
+      .then([](int code) { return http::Response(code); });
+  }
+
+  const string blobPath = getBlobPath(uri, directory);
+  const Option<Duration> stallTimeout = this->stallTimeout;
+
+  return client.download(url, blobPath, headers)
+    .then([blobPath, stallTimeout](
+        const http::Response& response) -> Future<http::Response> {
+      // Redirects to URLs which can't be fetched in-process are left
+      // to the curl command. Headers are not attached because the
+      // redirected request is already authenticated.
+      Option<string> location = response.headers.get("Location");
+      if (response.code / 100 == 3 && location.isSome()) {
+        return download(location.get(), blobPath, http::Headers(), stallTimeout)
+          .then([](int code) { return http::Response(code); });
+      }
+
+      // Only the response code is needed for a successful download,
+      // but the headers of a '401 Unauthorized' response are needed
+      // to request an auth token.
+      return response;
+    });
+}
+
 } // namespace uri {
 } // namespace mesos {
@@ -0,0 +1,858 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <process/collect.hpp>
+#include <process/defer.hpp>
+#include <process/dispatch.hpp>
+#include <process/id.hpp>
+#include <process/loop.hpp>
+#include <process/process.hpp>
+
+#ifdef USE_SSL_SOCKET
+#include <process/ssl/flags.hpp>
+#endif // USE_SSL_SOCKET
+
+#include <stout/bytes.hpp>
+#include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/lambda.hpp>
+#include <stout/numify.hpp>
+#include <stout/stringify.hpp>
+#include <stout/strings.hpp>
+
+#include <stout/os/close.hpp>
+#include <stout/os/getenv.hpp>
+#include <stout/os/lseek.hpp>
+#include <stout/os/open.hpp>
+#include <stout/os/write.hpp>
+
+#include "uri/http_client.hpp"
+
+namespace http = process::http;
+
+using std::deque;
+using std::list;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+using process::Break;
+using process::Continue;
+using process::ControlFlow;
+using process::Failure;
+using process::Future;
+using process::Owned;
+using process::Process;
+using process::Promise;
+
+namespace mesos {
+namespace uri {
+
+// The maximum number of connections to a single host. This also
+// bounds the number of ranges of a file which are downloaded in
+// parallel.
+constexpr size_t MAX_CONNECTIONS_PER_HOST = 8;
+
+// The size of the byte ranges which files are downloaded in.
+constexpr Bytes DOWNLOAD_RANGE_SIZE = Megabytes(8);
+
+// The number of times a range is resumed after it failed part way
+// through, before the download is considered to have failed.
+constexpr size_t MAX_RANGE_RETRIES = 3;
+
+// The maximum number of redirects which are followed, like curl's
+// '--max-redirs'.
+constexpr size_t MAX_REDIRECTS = 20;
+
+
+// Parses an absolute 'http' or 'https' URL. As libprocess sends the
+// path of a URL verbatim in the request line, the path of the returned
+// URL includes the query, so that the query is not encoded again.
+static Try<http::URL> parse(const string& _url)
+{
+  Try<http::URL> url = http::URL::parse(strings::trim(_url));
+  if (url.isError()) {
+    return url;
+  }
+
+  if (url->scheme != string("http") && url->scheme != string("https")) {
+    return Error("Unsupported URL scheme");
+  }
+
+  // NOTE: `http::URL::parse` neither supports user information nor
+  // IPv6 literals in the authority, nor does it split off a query
+  // which is not preceded by a path.
+  CHECK_SOME(url->domain);
+  if (url->domain->find_first_of("@[]?#") != string::npos) {
+    return Error("Unsupported URL authority '" + url->domain.get() + "'");
+  }
+
+  // Like curl, don't send the fragment.
+  url->path = url->path.substr(0, url->path.find('#'));
+
+  return url;
+}
+
+
+// Resolves the 'Location' of a redirect against the URL which was
+// redirected.
+static Try<http::URL> resolve(const http::URL& url, const string& location)
+{
+  if (strings::contains(location, "://")) {
+    return parse(location);
+  }
+
+  if (strings::startsWith(location, "//")) {
+    return parse(url.scheme.get() + ":" + location);
+  }
+
+  http::URL resolved = url;
+
+  if (strings::startsWith(location, "/")) {
+    resolved.path = location;
+  } else {
+    const string path = url.path.substr(0, url.path.find('?'));
+    resolved.path = path.substr(0, path.find_last_of('/') + 1) + location;
+  }
+
+  resolved.path = resolved.path.substr(0, resolved.path.find('#'));
+
+  return resolved;
+}
+
+
+// Returns the key of the connection pool used for the given URL.
+static string key(const http::URL& url)
+{
+  return url.scheme.get() + "://" + url.domain.get() + ":" +
+         stringify(url.port.get());
+}
+
+
+static bool isRedirect(uint16_t code)
+{
+  return code == http::Status::MOVED_PERMANENTLY ||
+         code == http::Status::FOUND ||
+         code == http::Status::SEE_OTHER ||
+         code == http::Status::TEMPORARY_REDIRECT ||
+         code == 308; // Permanent Redirect, see RFC 7538.
+}
+
+
+// Returns whether the connection a response was received on can be
+// used for another request.
+static bool isPersistent(const http::Response& response)
+{
+  Option<string> connection = response.headers.get("Connection");
+
+  return connection.isNone() || strings::lower(connection.get()) != "close";
+}
+
+
+// Parses a 'Content-Range' header of the form
+// 'bytes <first>-<last>/<length>'.
+static Try<vector<size_t>> parseContentRange(const string& value)
+{
+  if (!strings::startsWith(value, "bytes ")) {
+    return Error("Unsupported range unit");
+  }
+
+  const vector<string> tokens =
+    strings::tokenize(strings::remove(value, "bytes ", strings::PREFIX), "-/");
+
+  if (tokens.size() != 3) {
+    return Error("Malformed range");
+  }
+
+  vector<size_t> result;
+  foreach (const string& token, tokens) {
+    Try<size_t> number = numify<size_t>(strings::trim(token));
+    if (number.isError()) {
+      return Error("Malformed range: " + number.error());
+    }
+
+    result.push_back(number.get());
+  }
+
+  if (result[0] > result[1] || result[1] >= result[2]) {
+    return Error("Invalid range");
+  }
+
+  return result;
+}
+
+
+class HttpClientProcess : public Process<HttpClientProcess>
+{
+public:
+  explicit HttpClientProcess(const Option<Duration>& _stallTimeout)
+    : ProcessBase(process::ID::generate("uri-http-client")),
+      stallTimeout(_stallTimeout) {}
+
+  Future<http::Response> get(
+      const string& url,
+      const http::Headers& headers);
+
+  Future<http::Response> download(
+      const string& url,
+      const string& path,
+      const http::Headers& headers);
+
+private:
+  // A response which is received on a pooled connection.
+  struct Stream
+  {
+    // The URL and the headers of the request, after redirects.
+    http::URL url;
+    http::Headers headers;
+
+    http::Connection connection;
+
+    // The response, whose body is streamed.
+    http::Response response;
+  };
+
+  // A request waiting for a connection to a host.
+  struct Waiter
+  {
+    http::URL url;
+    Owned<Promise<http::Connection>> promise;
+  };
+
+  // The connections to a host.
+  struct Pool
+  {
+    // The number of open connections, including the idle ones.
+    size_t size = 0;
+
+    // NOTE: This is a list as connections are not assignable.
+    list<http::Connection> idle;
+    deque<Waiter> waiters;
+  };
+
+  Future<http::Connection> acquire(const http::URL& url);
+  Future<http::Connection> connect(const http::URL& url);
+
+  // Returns a connection to its pool once its response has been read.
+  // A connection which is not reusable is closed instead.
+  void release(http::Connection connection, const string& key, bool reuse);
+
+  void disconnected(http::Connection connection, const string& key);
+
+  // Sends a GET request on a pooled connection. Requests which fail
+  // are retried once, as an idle connection might have been closed
+  // by the server in the meantime.
+  Future<Stream> send(
+      const http::URL& url,
+      const http::Headers& headers,
+      bool retry = true);
+
+  // Sends a GET request and follows redirects.
+  Future<Stream> request(
+      const http::URL& url,
+      const http::Headers& headers,
+      size_t redirects = 0);
+
+  // Reads the streamed body of the response and releases the
+  // connection it was received on.
+  Future<http::Response> receive(const Stream& stream);
+
+  // Reads the streamed body of a response, handing each chunk of data
+  // to `consume`. Fails if no data arrives within the stall timeout.
+  Future<Nothing> read(
+      http::Pipe::Reader reader,
+      const lambda::function<Try<Nothing>(const string&)>& consume);
+
+  Future<http::Response> _download(const string& path, const Stream& stream);
+
+  // Requests the byte range [`offset`, `last`] of a file and writes it
+  // into `path`.
+  Future<Nothing> range(
+      const http::URL& url,
+      const http::Headers& headers,
+      const string& path,
+      size_t offset,
+      size_t last,
+      size_t retries);
+
+  // Writes the body of the response, which is expected to start at
+  // `offset` of the file, into `path`. If the byte range is known, a
+  // response which fails part way through is resumed with a request
+  // for the rest of the range.
+  Future<Nothing> write(
+      const Stream& stream,
+      const string& path,
+      size_t offset,
+      const Option<size_t>& last,
+      size_t retries);
+
+  const Option<Duration> stallTimeout;
+
+  hashmap<string, Pool> pools;
+};
+
+
+Future<http::Response> HttpClientProcess::get(
+    const string& url,
+    const http::Headers& headers)
+{
+  Try<http::URL> _url = parse(url);
+  if (_url.isError()) {
+    return Failure("Failed to parse URL '" + url + "': " + _url.error());
+  }
+
+  return request(_url.get(), headers)
+    .then(defer(self(), &Self::receive, lambda::_1));
+}
+
+
+Future<http::Response> HttpClientProcess::download(
+    const string& url,
+    const string& path,
+    const http::Headers& headers)
+{
+  Try<http::URL> _url = parse(url);
+  if (_url.isError()) {
+    return Failure("Failed to parse URL '" + url + "': " + _url.error());
+  }
+
+  // Request the first range only. If the server supports ranges, the
+  // response tells us the size of the file, so that the rest of it can
+  // be requested in parallel. We don't send a HEAD request instead,
+  // because some registries redirect blob requests to signed URLs
+  // which are only valid for GET requests.
+  http::Headers _headers = headers;
+  _headers["Range"] =
+    "bytes=0-" + stringify(DOWNLOAD_RANGE_SIZE.bytes() - 1);
+
+  return request(_url.get(), _headers)
+    .then(defer(self(), &Self::_download, path, lambda::_1));
+}
+
+
+Future<http::Response> HttpClientProcess::_download(
+    const string& path,
+    const Stream& stream)
+{
+  const http::Response& response = stream.response;
+
+  if (response.code != http::Status::OK &&
+      response.code != http::Status::PARTIAL_CONTENT) {
+    // An empty file cannot satisfy any range.
+    if (response.code == http::Status::REQUESTED_RANGE_NOT_SATISFIABLE &&
+        response.headers.get("Content-Range") == string("bytes */0")) {
+      return receive(stream)
+        .then([path]() -> Future<http::Response> {
+          Try<Nothing> write = os::write(path, "");
+          if (write.isError()) {
+            return Failure(
+                "Failed to write '" + path + "': " + write.error());
+          }
+
+          return http::OK();
+        });
+    }
+
+    return receive(stream);
+  }
+
+  Try<int_fd> fd = os::open(
+      path,
+      O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+      S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+  if (fd.isError()) {
+    release(stream.connection, key(stream.url), false);
+    return Failure("Failed to open '" + path + "': " + fd.error());
+  }
+
+  os::close(fd.get());
+
+  // The server does not support ranges and sends the whole file.
+  if (response.code == http::Status::OK) {
+    return write(stream, path, 0, None(), 0)
+      .then([]() -> http::Response { return http::OK(); });
+  }
+
+  Option<string> contentRange = response.headers.get("Content-Range");
+
+  Try<vector<size_t>> range = contentRange.isSome()
+    ? parseContentRange(contentRange.get())
+    : Error("Missing 'Content-Range' header");
+
+  if (range.isSome() && range->at(0) != 0) {
+    range = Error("Unexpected range '" + contentRange.get() + "'");
+  }
+
+  if (range.isError()) {
+    release(stream.connection, key(stream.url), false);
+    return Failure("Unexpected partial content: " + range.error());
+  }
+
+  const size_t last = range->at(1);
+  const size_t length = range->at(2);
+
+  vector<Future<Nothing>> futures;
+  futures.push_back(write(stream, path, 0, last, 0));
+
+  for (size_t offset = last + 1;
+       offset < length;
+       offset += DOWNLOAD_RANGE_SIZE.bytes()) {
+    futures.push_back(this->range(
+        stream.url,
+        stream.headers,
+        path,
+        offset,
+        std::min(offset + DOWNLOAD_RANGE_SIZE.bytes(), length) - 1,
+        0));
+  }
+
+  return collect(futures)
+    .then([]() -> http::Response { return http::OK(); });
+}
+
+
+Future<Nothing> HttpClientProcess::range(
+    const http::URL& url,
+    const http::Headers& headers,
+    const string& path,
+    size_t offset,
+    size_t last,
+    size_t retries)
+{
+  http::Headers _headers = headers;
+  _headers["Range"] = "bytes=" + stringify(offset) + "-" + stringify(last);
+
+  return send(url, _headers)
+    .then(defer(self(), [=](const Stream& stream) -> Future<Nothing> {
+      Option<string> contentRange =
+        stream.response.headers.get("Content-Range");
+
+      Try<vector<size_t>> range = contentRange.isSome()
+        ? parseContentRange(contentRange.get())
+        : Error("Missing 'Content-Range' header");
+
+      if (stream.response.code != http::Status::PARTIAL_CONTENT ||
+          range.isError() ||
+          range->at(0) != offset ||
+          range->at(1) != last) {
+        release(stream.connection, key(stream.url), false);
+        return Failure(
+            "Unexpected HTTP response '" + stream.response.status + "' " +
+            "when requesting bytes " + stringify(offset) + "-" +
+            stringify(last) + " of '" + stringify(url) + "'");
+      }
+
+      return write(stream, path, offset, last, retries);
+    }));
+}
+
+
+Future<Nothing> HttpClientProcess::write(
+    const Stream& stream,
+    const string& path,
+    size_t offset,
+    const Option<size_t>& last,
+    size_t retries)
+{
+  Try<int_fd> fd = os::open(path, O_WRONLY | O_CLOEXEC);
+  if (fd.isError()) {
+    release(stream.connection, key(stream.url), false);
+    return Failure("Failed to open '" + path + "': " + fd.error());
+  }
+
+  Try<off_t> seek = os::lseek(fd.get(), offset, SEEK_SET);
+  if (seek.isError()) {
+    os::close(fd.get());
+    release(stream.connection, key(stream.url), false);
+    return Failure("Failed to seek in '" + path + "': " + seek.error());
+  }
+
+  const int_fd _fd = fd.get();
+  shared_ptr<size_t> written(new size_t(0));
+
+  CHECK_SOME(stream.response.reader);
+
+  return read(
+      stream.response.reader.get(),
+      [=](const string& data) -> Try<Nothing> {
+        if (last.isSome() && offset + *written + data.size() > last.get() + 1) {
+          return Error("Received more data than requested");
+        }
+
+        Try<Nothing> write = os::write(_fd, data);
+        if (write.isError()) {
+          return Error("Failed to write '" + path + "': " + write.error());
+        }
+
+        *written += data.size();
+        return Nothing();
+      })
+    .then([=]() -> Future<Nothing> {
+      if (last.isSome() && offset + *written != last.get() + 1) {
+        return Failure("Response ended prematurely");
+      }
+
+      return Nothing();
+    })
+    .onAny(defer(self(), [=](const Future<Nothing>& future) {
+      os::close(_fd);
+      release(
+          stream.connection,
+          key(stream.url),
+          future.isReady() && isPersistent(stream.response));
+    }))
+    .repair(defer(self(), [=](
+        const Future<Nothing>& future) -> Future<Nothing> {
+      if (last.isNone() || retries >= MAX_RANGE_RETRIES) {
+        return future;
+      }
+
+      LOG(WARNING) << "Resuming download of '" << stringify(stream.url)
+                   << "' at byte " << offset + *written << ": "
+                   << future.failure();
+
+      return range(
+          stream.url,
+          stream.headers,
+          path,
+          offset + *written,
+          last.get(),
+          retries + 1);
+    }));
+}
+
+
+Future<HttpClientProcess::Stream> HttpClientProcess::request(
+    const http::URL& url,
+    const http::Headers& headers,
+    size_t redirects)
+{
+  return send(url, headers)
+    .then(defer(self(), [=](Stream stream) -> Future<Stream> {
+      Option<string> location = stream.response.headers.get("Location");
+      if (!isRedirect(stream.response.code) || location.isNone()) {
+        return stream;
+      }
+
+      Try<http::URL> redirect = resolve(url, location.get());
+      if (redirect.isError()) {
+        return stream;
+      }
+
+      // Redirects to URLs which can't be fetched in-process are left
+      // to the caller.
+      if (!HttpClient::supports(stringify(redirect.get()))) {
+        stream.response.headers["Location"] = stringify(redirect.get());
+        return stream;
+      }
+
+      if (redirects >= MAX_REDIRECTS) {
+        release(stream.connection, key(stream.url), false);
+        return Failure(
+            "Exceeded the maximum of " + stringify(MAX_REDIRECTS) +
+            " redirects");
+      }
+
+      // Like curl, don't send credentials to other hosts.
+      http::Headers _headers = headers;
+      if (key(redirect.get()) != key(url)) {
+        _headers.erase("Authorization");
+      }
+
+      return receive(stream)
+        .then(defer(self(), [=]() {
+          return request(redirect.get(), _headers, redirects + 1);
+        }));
+    }));
+}
+
+
+Future<HttpClientProcess::Stream> HttpClientProcess::send(
+    const http::URL& url,
+    const http::Headers& headers,
+    bool retry)
+{
+  return acquire(url)
+    .then(defer(self(), [=](http::Connection connection) -> Future<Stream> {
+      http::Request request;
+      request.method = "GET";
+      request.url = url;
+      request.headers = headers;
+      request.keepAlive = true;
+
+      return connection.send(request, true)
+        .onAny(defer(self(), [=](const Future<http::Response>& response) {
+          if (!response.isReady()) {
+            release(connection, key(url), false);
+          }
+        }))
+        .then([=](const http::Response& response) -> Stream {
+          return Stream{url, headers, connection, response};
+        });
+    }))
+    .repair(defer(self(), [=](const Future<Stream>& stream) -> Future<Stream> {
+      if (!retry) {
+        return stream;
+      }
+
+      return send(url, headers, false);
+    }));
+}
+
+
+Future<http::Response> HttpClientProcess::receive(const Stream& stream)
+{
+  http::Response response = stream.response;
+  response.type = http::Response::BODY;
+  response.reader = None();
+
+  if (stream.response.reader.isNone()) {
+    release(stream.connection, key(stream.url), isPersistent(response));
+    return response;
+  }
+
+  shared_ptr<string> body(new string());
+
+  return read(
+      stream.response.reader.get(),
+      [body](const string& data) -> Try<Nothing> {
+        body->append(data);
+        return Nothing();
+      })
+    .onAny(defer(self(), [=](const Future<Nothing>& future) {
+      release(
+          stream.connection,
+          key(stream.url),
+          future.isReady() && isPersistent(response));
+    }))
+    .then([=]() mutable {
+      response.body = *body;
+      return response;
+    });
+}
+
+
+Future<Nothing> HttpClientProcess::read(
+    http::Pipe::Reader reader,
+    const lambda::function<Try<Nothing>(const string&)>& consume)
+{
+  const Option<Duration> timeout = stallTimeout;
+
+  return process::loop(
+      self(),
+      [=]() mutable -> Future<string> {
+        if (timeout.isNone()) {
+          return reader.read();
+        }
+
+        return reader.read()
+          .after(timeout.get(), [timeout](Future<string> data) {
+            data.discard();
+            return Failure(
+                "No data received for " + stringify(timeout.get()));
+          });
+      },
+      [=](const string& data) mutable -> Future<ControlFlow<Nothing>> {
+        if (data.empty()) {
+          return Break();
+        }
+
+        Try<Nothing> consumed = consume(data);
+        if (consumed.isError()) {
+          reader.close();
+          return Failure(consumed.error());
+        }
+
+        return Continue();
+      });
+}
+
+
+Future<http::Connection> HttpClientProcess::acquire(const http::URL& url)
+{
+  Pool& pool = pools[key(url)];
+
+  while (!pool.idle.empty()) {
+    http::Connection connection = pool.idle.back();
+    pool.idle.pop_back();
+
+    if (connection.disconnected().isPending()) {
+      return connection;
+    }
+
+    pool.size--;
+  }
+
+  if (pool.size < MAX_CONNECTIONS_PER_HOST) {
+    return connect(url);
+  }
+
+  Owned<Promise<http::Connection>> promise(new Promise<http::Connection>());
+  pool.waiters.push_back(Waiter{url, promise});
+
+  return promise->future();
+}
+
+
+Future<http::Connection> HttpClientProcess::connect(const http::URL& url)
+{
+  const string _key = key(url);
+
+  pools[_key].size++;
+
+  return http::connect(url)
+    .onAny(defer(self(), [=](const Future<http::Connection>& connection) {
+      if (!connection.isReady()) {
+        Pool& pool = pools[_key];
+        pool.size--;
+
+        // Let the next waiter make its own attempt to connect.
+        if (!pool.waiters.empty()) {
+          Waiter waiter = pool.waiters.front();
+          pool.waiters.pop_front();
+          waiter.promise->associate(connect(waiter.url));
+        }
+      }
+    }));
+}
+
+
+void HttpClientProcess::release(
+    http::Connection connection,
+    const string& key,
+    bool reuse)
+{
+  Pool& pool = pools[key];
+
+  if (reuse && connection.disconnected().isPending()) {
+    if (!pool.waiters.empty()) {
+      Waiter waiter = pool.waiters.front();
+      pool.waiters.pop_front();
+      waiter.promise->set(connection);
+      return;
+    }
+
+    pool.idle.push_back(connection);
+
+    // Close idle connections as soon as the server closes them.
+    connection.disconnected()
+      .onAny(defer(self(), &Self::disconnected, connection, key));
+
+    return;
+  }
+
+  connection.disconnect();
+  pool.size--;
+
+  if (!pool.waiters.empty()) {
+    Waiter waiter = pool.waiters.front();
+    pool.waiters.pop_front();
+    waiter.promise->associate(connect(waiter.url));
+  }
+}
+
+
+void HttpClientProcess::disconnected(
+    http::Connection connection,
+    const string& key)
+{
+  Pool& pool = pools[key];
+
+  auto it = std::find(pool.idle.begin(), pool.idle.end(), connection);
+  if (it != pool.idle.end()) {
+    pool.idle.erase(it);
+    pool.size--;
+  }
+}
+
+
+bool HttpClient::supports(const string& url)
+{
+  Try<http::URL> _url = parse(url);
+  if (_url.isError()) {
+    return false;
+  }
+
+  // libprocess does not go through proxies, so requests which curl
+  // would send through a proxy are left to curl.
+  const string scheme = _url->scheme.get();
+  if (os::getenv(scheme + "_proxy").isSome() ||
+      os::getenv(strings::upper(scheme) + "_PROXY").isSome() ||
+      os::getenv("all_proxy").isSome() ||
+      os::getenv("ALL_PROXY").isSome()) {
+    return false;
+  }
+
+  if (scheme == "https") {
+#ifdef USE_SSL_SOCKET
+    // Only use libprocess for HTTPS if it verifies the certificates of
+    // servers, as curl does.
+    return process::network::openssl::flags().enabled &&
+           process::network::openssl::flags().verify_cert;
+#else
+    return false;
+#endif // USE_SSL_SOCKET
+  }
+
+  return true;
+}
+
+
+HttpClient::HttpClient(const Option<Duration>& stallTimeout)
+  : process(new HttpClientProcess(stallTimeout))
+{
+  spawn(process.get());
+}
+
+
+HttpClient::~HttpClient()
+{
+  terminate(process.get());
+  wait(process.get());
+}
+
+
+Future<http::Response> HttpClient::get(
+    const string& url,
+    const http::Headers& headers) const
+{
+  return dispatch(process.get(), &HttpClientProcess::get, url, headers);
+}
+
+
+Future<http::Response> HttpClient::download(
+    const string& url,
+    const string& path,
+    const http::Headers& headers) const
+{
+  return dispatch(
+      process.get(),
+      &HttpClientProcess::download,
+      url,
+      path,
+      headers);
+}
+
+} // namespace uri {
+} // namespace mesos {
@@ -0,0 +1,90 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __URI_HTTP_CLIENT_HPP__
+#define __URI_HTTP_CLIENT_HPP__
+
+#include <string>
+
+#include <process/future.hpp>
+#include <process/http.hpp>
+#include <process/owned.hpp>
+
+#include <stout/duration.hpp>
+#include <stout/none.hpp>
+#include <stout/option.hpp>
+
+namespace mesos {
+namespace uri {
+
+// Forward declaration.
+class HttpClientProcess;
+
+
+// An in-process HTTP client used by the URI fetcher plugins instead of
+// forking a curl command for every request. The client keeps a pool
+// of persistent connections per host, which also bounds the number of
+// concurrent requests to that host. Large files are downloaded in
+// parallel byte ranges if the server supports them, and a range which
+// fails part way through is resumed from where it stopped.
+//
+// NOTE: Only URLs for which `supports()` returns true can be fetched
+// with this client; the others still need the curl command.
+class HttpClient
+{
+public:
+  // Returns whether the given URL can be fetched in-process. This is
+  // the case for 'http' URLs and, if libprocess verifies the server
+  // certificates, for 'https' URLs. URLs which have user information
+  // or which curl would send through a proxy are not supported.
+  static bool supports(const std::string& url);
+
+  // `stallTimeout` is the amount of time to wait for more data of a
+  // response before the request is considered to have failed.
+  explicit HttpClient(const Option<Duration>& stallTimeout = None());
+
+  ~HttpClient();
+
+  // Sends a GET request for the given URL and returns the response
+  // including its body. Redirects are followed, except for redirects
+  // to URLs which are not supported: those are returned, with the
+  // 'Location' header resolved into an absolute URL.
+  process::Future<process::http::Response> get(
+      const std::string& url,
+      const process::http::Headers& headers =
+        process::http::Headers()) const;
+
+  // Downloads the given URL into `path`, following redirects like
+  // `get()`. On success, a '200 OK' response without body is returned.
+  // For any other response, the file is not written and the response
+  // is returned including its body.
+  process::Future<process::http::Response> download(
+      const std::string& url,
+      const std::string& path,
+      const process::http::Headers& headers =
+        process::http::Headers()) const;
+
+private:
+  HttpClient(const HttpClient&) = delete;
+  HttpClient& operator=(const HttpClient&) = delete;
+
+  process::Owned<HttpClientProcess> process;
+};
+
+} // namespace uri {
+} // namespace mesos {
+
+#endif // __URI_HTTP_CLIENT_HPP__